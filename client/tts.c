@@ -376,10 +376,9 @@ int tts_get_state(tts_h tts, tts_state_e* state)
 	return TTS_ERROR_NONE;
 }
 
-int tts_add_text(tts_h tts, const char* text, const char* language, tts_voice_type_e voice_type, tts_speed_e speed, int* utt_id)
+static int __tts_add_text(tts_h tts, const char* text, const char* language, tts_voice_type_e voice_type, tts_speed_e speed, 
+			  int priority, int deadline, int max_staleness, int* utt_id)
 {
-	SLOG(LOG_DEBUG, TAG_TTSC, "===== Add text");
-
 	if (NULL == tts || NULL == utt_id) {
 		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Input parameter is null");
 		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
@@ -416,7 +415,7 @@ int tts_add_text(tts_h tts, const char* text, const char* language, tts_voice_ty
 
 	/* do request */
 	int ret = 0;
-	ret = tts_dbus_request_add_text(client->uid, text, temp, voice_type, speed, client->current_utt_id);
+	ret = tts_dbus_request_add_text(client->uid, text, temp, voice_type, speed, client->current_utt_id, priority, deadline, max_staleness);
 	if (0 != ret) {
 		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] result : %d", ret);
 	}
@@ -432,6 +431,237 @@ int tts_add_text(tts_h tts, const char* text, const char* language, tts_voice_ty
 	return ret;
 }
 
+int tts_add_text(tts_h tts, const char* text, const char* language, tts_voice_type_e voice_type, tts_speed_e speed, int* utt_id)
+{
+	SLOG(LOG_DEBUG, TAG_TTSC, "===== Add text");
+
+	return __tts_add_text(tts, text, language, voice_type, speed, TTS_PRIORITY_CLIENT_DEFAULT, 0, 0, utt_id);
+}
+
+int tts_add_text_with_priority(tts_h tts, const char* text, const char* language, tts_voice_type_e voice_type, tts_speed_e speed, 
+			       tts_priority_e priority, int* utt_id)
+{
+	SLOG(LOG_DEBUG, TAG_TTSC, "===== Add text with priority");
+
+	if (TTS_PRIORITY_LOW > priority || TTS_PRIORITY_CRITICAL < priority) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Priority is not valid : %d", priority);
+		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSC, " ");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	return __tts_add_text(tts, text, language, voice_type, speed, priority, 0, 0, utt_id);
+}
+
+int tts_add_text_with_deadline(tts_h tts, const char* text, const char* language, tts_voice_type_e voice_type, tts_speed_e speed, 
+			       int deadline, int max_staleness, int* utt_id)
+{
+	SLOG(LOG_DEBUG, TAG_TTSC, "===== Add text with deadline");
+
+	if (0 > deadline || 0 > max_staleness) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Deadline(%d) or max staleness(%d) is not valid", deadline, max_staleness);
+		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSC, " ");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	return __tts_add_text(tts, text, language, voice_type, speed, TTS_PRIORITY_CLIENT_DEFAULT, deadline, max_staleness, utt_id);
+}
+
+int tts_set_priority(tts_h tts, tts_priority_e priority)
+{
+	SLOG(LOG_DEBUG, TAG_TTSC, "===== Set priority");
+
+	if (NULL == tts || TTS_PRIORITY_LOW > priority || TTS_PRIORITY_CRITICAL < priority) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Input parameter is not valid");
+		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSC, " ");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	tts_client_s* client = tts_client_get(tts);
+
+	if (NULL == client) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] A handle is not valid");
+		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSC, " ");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	if (TTS_STATE_CREATED == client->current_state) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Current state is 'CREATED'."); 
+		return TTS_ERROR_INVALID_STATE;
+	}
+
+	int ret = 0;
+	ret = tts_dbus_request_set_priority(client->uid, priority);
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] result : %d", ret);
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+	SLOG(LOG_DEBUG, TAG_TTSC, " ");
+
+	return ret;
+}
+
+int tts_add_template(tts_h tts, const char* text_template)
+{
+	SLOG(LOG_DEBUG, TAG_TTSC, "===== Add template");
+
+	if (NULL == tts || NULL == text_template) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Input parameter is null");
+		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSC, " ");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	tts_client_s* client = tts_client_get(tts);
+
+	if (NULL == client) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] A handle is not valid");
+		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSC, " ");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	if (TTS_STATE_CREATED == client->current_state) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Current state is 'CREATED'."); 
+		return TTS_ERROR_INVALID_STATE;
+	}
+
+	int ret = 0;
+	ret = tts_dbus_request_add_template(client->uid, text_template);
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] result : %d", ret);
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+	SLOG(LOG_DEBUG, TAG_TTSC, " ");
+
+	return ret;
+}
+
+int tts_open_stream(tts_h tts, const char* language, tts_voice_type_e voice_type, tts_speed_e speed, int* utt_id)
+{
+	SLOG(LOG_DEBUG, TAG_TTSC, "===== Open stream");
+
+	if (NULL == tts || NULL == utt_id) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Input parameter is null");
+		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSC, " ");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	tts_client_s* client = tts_client_get(tts);
+
+	if (NULL == client) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] A handle is not valid");
+		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSC, " ");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	if (TTS_STATE_CREATED == client->current_state) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Current state is 'CREATED'."); 
+		return TTS_ERROR_INVALID_STATE;
+	}
+
+	client->current_utt_id ++;
+	if (client->current_utt_id == 10000) {
+		client->current_utt_id = 1;
+	}
+
+	int ret = 0;
+	ret = tts_dbus_request_open_stream(client->uid, (NULL == language) ? "default" : language, voice_type, speed, client->current_utt_id);
+	if (0 == ret) {
+		*utt_id = client->current_utt_id;
+	}
+
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] result : %d", ret);
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+	SLOG(LOG_DEBUG, TAG_TTSC, " ");
+
+	return ret;
+}
+
+int tts_push_stream(tts_h tts, const char* text)
+{
+	SLOG(LOG_DEBUG, TAG_TTSC, "===== Push stream");
+
+	if (NULL == tts || NULL == text) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Input parameter is null");
+		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSC, " ");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	tts_client_s* client = tts_client_get(tts);
+
+	if (NULL == client) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] A handle is not valid");
+		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSC, " ");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	if (TTS_STATE_CREATED == client->current_state) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Current state is 'CREATED'."); 
+		return TTS_ERROR_INVALID_STATE;
+	}
+
+	int ret = 0;
+	ret = tts_dbus_request_push_stream(client->uid, text);
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] result : %d", ret);
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+	SLOG(LOG_DEBUG, TAG_TTSC, " ");
+
+	return ret;
+}
+
+int tts_close_stream(tts_h tts)
+{
+	SLOG(LOG_DEBUG, TAG_TTSC, "===== Close stream");
+
+	if (NULL == tts) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Input parameter is null");
+		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSC, " ");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	tts_client_s* client = tts_client_get(tts);
+
+	if (NULL == client) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] A handle is not valid");
+		SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSC, " ");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	if (TTS_STATE_CREATED == client->current_state) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Current state is 'CREATED'."); 
+		return TTS_ERROR_INVALID_STATE;
+	}
+
+	int ret = 0;
+	ret = tts_dbus_request_close_stream(client->uid);
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] result : %d", ret);
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSC, "=====");
+	SLOG(LOG_DEBUG, TAG_TTSC, " ");
+
+	return ret;
+}
+
 int tts_play(tts_h tts)
 {
 	SLOG(LOG_DEBUG, TAG_TTSC, "===== Play tts");
@@ -43,7 +43,10 @@ typedef enum {
 	TTS_ERROR_INVALID_VOICE		= -0x0100022,	/**< Invalid voice */
 	TTS_ERROR_ENGINE_NOT_FOUND	= -0x0100023,	/**< No available engine  */
 	TTS_ERROR_TIMED_OUT		= -0x0100024,	/**< No answer from the daemon */
-	TTS_ERROR_OPERATION_FAILED	= -0x0100025	/**< Operation failed  */
+	TTS_ERROR_OPERATION_FAILED	= -0x0100025,	/**< Operation failed  */
+	TTS_ERROR_UTTERANCE_EXPIRED	= -0x0100026,	/**< Utterance is dropped, because it is not spoken before max staleness */
+	TTS_ERROR_SYNTHESIS_TIMED_OUT	= -0x0100027,	/**< Utterance is dropped, because engine does not finish its synthesis in time */
+	TTS_ERROR_QUEUE_FULL		= -0x0100028	/**< Text is not added, because estimated audio of queued texts is too long */
 } tts_error_e;
 
 /** 
@@ -81,6 +84,18 @@ typedef enum {
 	TTS_STATE_PAUSED		/**< 'PAUSED' state*/
 }tts_state_e;
 
+/** 
+* @brief Enumerations of priority.
+* @details Text of higher priority is synthesized and played before text of lower priority. 
+*	A client of lower priority is paused while a client of higher priority plays, and resumed after that.
+*/
+typedef enum {
+	TTS_PRIORITY_LOW = 0,		/**< Background reading */
+	TTS_PRIORITY_NORMAL,		/**< Default priority */
+	TTS_PRIORITY_HIGH,		/**< Notification */
+	TTS_PRIORITY_CRITICAL		/**< Alert */
+} tts_priority_e;
+
 /** 
 * @brief A structure of handle for identification
 */
@@ -323,12 +338,178 @@ int tts_get_state(tts_h tts, tts_state_e* state);
 * @retval #TTS_ERROR_INVALID_VOICE Invalid voice about language, voice type
 * @retval #TTS_ERROR_OUT_OF_MEMORY Out of memory
 * @retval #TTS_ERROR_OPERATION_FAILED Operation failure
+* @retval #TTS_ERROR_QUEUE_FULL Audio of queued texts is longer than the daemon accepts
 *
 * @pre The state should be #TTS_STATE_READY, #TTS_STATE_PLAYING or #TTS_STATE_PAUSED.
 * @see tts_get_max_text_count()
 */
 int tts_add_text(tts_h tts, const char* text, const char* language, tts_voice_type_e voice_type, tts_speed_e speed, int* utt_id);
 
+/**
+* @brief Adds a text to the queue with priority.
+*
+* @details Text of higher priority is played before queued text of lower priority. 
+*	If the text of lower priority is being synthesized, it is canceled and synthesized again later.
+*
+* @param[in] tts The handle for TTS
+* @param[in] text A input text
+* @param[in] language The language selected from the foreach function
+* @param[in] voice_type The voice type selected from the foreach function
+* @param[in] speed A speaking speed
+* @param[in] priority The priority of text
+* @param[out] utt_id The utterance ID passed to the callback function
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTS_ERROR_NONE Successful
+* @retval #TTS_ERROR_INVALID_PARAMETER Invalid parameter
+* @retval #TTS_ERROR_INVALID_VOICE Invalid voice about language, voice type
+* @retval #TTS_ERROR_OUT_OF_MEMORY Out of memory
+* @retval #TTS_ERROR_OPERATION_FAILED Operation failure
+* @retval #TTS_ERROR_QUEUE_FULL Audio of queued texts is longer than the daemon accepts
+*
+* @pre The state should be #TTS_STATE_READY, #TTS_STATE_PLAYING or #TTS_STATE_PAUSED.
+* @see tts_add_text()
+* @see tts_set_priority()
+*/
+int tts_add_text_with_priority(tts_h tts, const char* text, const char* language, tts_voice_type_e voice_type, tts_speed_e speed, 
+			       tts_priority_e priority, int* utt_id);
+
+/**
+* @brief Adds a text to the queue with deadline and max staleness.
+*
+* @details Texts of the same priority are synthesized in order of deadline, earliest first, 
+*	and texts without deadline follow them. \n
+*	If the text is not started within max staleness, it is dropped without synthesis 
+*	and the error callback is called with #TTS_ERROR_UTTERANCE_EXPIRED and its utterance ID.
+*
+* @param[in] tts The handle for TTS
+* @param[in] text A input text
+* @param[in] language The language selected from the foreach function
+* @param[in] voice_type The voice type selected from the foreach function
+* @param[in] speed A speaking speed
+* @param[in] deadline The time in milliseconds from now when the text should be spoken, 0 if none
+* @param[in] max_staleness The time in milliseconds from now after which the text is useless, 0 if none
+* @param[out] utt_id The utterance ID passed to the callback function
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTS_ERROR_NONE Successful
+* @retval #TTS_ERROR_INVALID_PARAMETER Invalid parameter
+* @retval #TTS_ERROR_INVALID_VOICE Invalid voice about language, voice type
+* @retval #TTS_ERROR_OUT_OF_MEMORY Out of memory
+* @retval #TTS_ERROR_OPERATION_FAILED Operation failure
+* @retval #TTS_ERROR_QUEUE_FULL Audio of queued texts is longer than the daemon accepts
+*
+* @pre The state should be #TTS_STATE_READY, #TTS_STATE_PLAYING or #TTS_STATE_PAUSED.
+* @see tts_add_text()
+* @see tts_set_error_cb()
+*/
+int tts_add_text_with_deadline(tts_h tts, const char* text, const char* language, tts_voice_type_e voice_type, tts_speed_e speed, 
+			       int deadline, int max_staleness, int* utt_id);
+
+/**
+* @brief Sets the priority of client. The default is #TTS_PRIORITY_NORMAL.
+*
+* @details Text added by tts_add_text() has the priority of client. \n
+*	When a client of higher priority plays, the playing client of lower priority is changed to #TTS_STATE_PAUSED 
+*	and changed to #TTS_STATE_PLAYING again after that. 
+*	A client of lower priority which starts to play keeps #TTS_STATE_PLAYING and waits until the client of higher priority finishes.
+*
+* @param[in] tts The handle for TTS
+* @param[in] priority The priority of client
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTS_ERROR_NONE Successful
+* @retval #TTS_ERROR_INVALID_PARAMETER Invalid parameter
+* @retval #TTS_ERROR_INVALID_STATE Invalid state
+* @retval #TTS_ERROR_OPERATION_FAILED Operation failure
+*
+* @pre The state should be #TTS_STATE_READY, #TTS_STATE_PLAYING or #TTS_STATE_PAUSED.
+* @see tts_add_text_with_priority()
+*/
+int tts_set_priority(tts_h tts, tts_priority_e priority);
+
+/**
+* @brief Adds a text template for prompts which differ only in some words.
+*
+* @details "%s" in the template marks a variable part, e.g. "You have %s new messages". \n
+*	When a text added by tts_add_text() matches a template, the fixed parts are synthesized once and reused, 
+*	and only the variable parts are synthesized.
+*
+* @param[in] tts The handle for TTS
+* @param[in] text_template A template text with one or more "%s"
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTS_ERROR_NONE Successful
+* @retval #TTS_ERROR_INVALID_PARAMETER Invalid parameter or template without fixed text
+* @retval #TTS_ERROR_INVALID_STATE Invalid state
+* @retval #TTS_ERROR_OUT_OF_MEMORY Too many templates
+* @retval #TTS_ERROR_OPERATION_FAILED Operation failure
+*
+* @pre The state should be #TTS_STATE_READY, #TTS_STATE_PLAYING or #TTS_STATE_PAUSED.
+* @see tts_add_text()
+*/
+int tts_add_template(tts_h tts, const char* text_template);
+
+/**
+* @brief Opens a text stream which is spoken as one utterance while its text is still being written.
+*
+* @details Text is given by tts_push_stream() in pieces, e.g. tokens from a text generator, 
+*	and synthesis starts before the whole text is known. \n
+*	The stream waits in the queue like text added by tts_add_text(), and tts_close_stream() ends the utterance.
+*
+* @param[in] tts The handle for TTS
+* @param[in] language The language selected from the foreach function
+* @param[in] voice_type The voice type
+* @param[in] speed A speaking speed
+* @param[out] utt_id The utterance ID passed to the callback function
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTS_ERROR_NONE Successful
+* @retval #TTS_ERROR_INVALID_PARAMETER Invalid parameter
+* @retval #TTS_ERROR_INVALID_STATE Invalid state or stream is already opened
+* @retval #TTS_ERROR_INVALID_VOICE Invalid voice about language, voice type
+* @retval #TTS_ERROR_OPERATION_FAILED Operation failure
+*
+* @pre The state should be #TTS_STATE_READY, #TTS_STATE_PLAYING or #TTS_STATE_PAUSED.
+* @see tts_push_stream()
+* @see tts_close_stream()
+*/
+int tts_open_stream(tts_h tts, const char* language, tts_voice_type_e voice_type, tts_speed_e speed, int* utt_id);
+
+/**
+* @brief Appends text to the opened stream.
+*
+* @param[in] tts The handle for TTS
+* @param[in] text A piece of text
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTS_ERROR_NONE Successful
+* @retval #TTS_ERROR_INVALID_PARAMETER Invalid parameter
+* @retval #TTS_ERROR_INVALID_STATE Invalid state or stream is not opened
+* @retval #TTS_ERROR_OPERATION_FAILED Operation failure
+*
+* @pre tts_open_stream() should be called.
+* @see tts_open_stream()
+*/
+int tts_push_stream(tts_h tts, const char* text);
+
+/**
+* @brief Closes the opened stream. The utterance is completed after the remaining text is spoken.
+*
+* @param[in] tts The handle for TTS
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTS_ERROR_NONE Successful
+* @retval #TTS_ERROR_INVALID_PARAMETER Invalid parameter
+* @retval #TTS_ERROR_INVALID_STATE Invalid state or stream is not opened
+* @retval #TTS_ERROR_OPERATION_FAILED Operation failure
+*
+* @pre tts_open_stream() should be called.
+* @see tts_open_stream()
+* @see tts_utterance_completed_cb()
+*/
+int tts_close_stream(tts_h tts);
+
 /**
 * @brief Starts synthesizing voice from text and plays synthesized audio data.
 *
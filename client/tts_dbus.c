@@ -664,7 +664,8 @@ int tts_dbus_request_get_default_voice(int uid , char** lang, tts_voice_type_e*
 }
 
 
-int tts_dbus_request_add_text(int uid, const char* text, const char* lang, int vctype, int speed, int uttid)
+int tts_dbus_request_add_text(int uid, const char* text, const char* lang, int vctype, int speed, int uttid, int priority, 
+			      int deadline, int staleness)
 {
 	if (NULL == text || NULL == lang) {
 		SLOG(LOG_ERROR, TAG_TTSC, "Input parameter is NULL");
@@ -688,8 +689,8 @@ int tts_dbus_request_add_text(int uid, const char* text, const char* lang, int v
 
 		return TTS_ERROR_OPERATION_FAILED;
 	} else {
-		SLOG(LOG_DEBUG, TAG_TTSC, ">>>> Request tts add text : uid(%d), text(%s), lang(%s), type(%d), speed(%d), id(%d)", 
-			uid, text, lang, vctype, speed, uttid);
+		SLOG(LOG_DEBUG, TAG_TTSC, ">>>> Request tts add text : uid(%d), text(%s), lang(%s), type(%d), speed(%d), id(%d), priority(%d), deadline(%d), staleness(%d)", 
+			uid, text, lang, vctype, speed, uttid, priority, deadline, staleness);
 	}
 
 	if (true != dbus_message_append_args( msg, 
@@ -699,6 +700,9 @@ int tts_dbus_request_add_text(int uid, const char* text, const char* lang, int v
 		DBUS_TYPE_INT32, &vctype,
 		DBUS_TYPE_INT32, &speed,
 		DBUS_TYPE_INT32, &uttid,
+		DBUS_TYPE_INT32, &priority,
+		DBUS_TYPE_INT32, &deadline,
+		DBUS_TYPE_INT32, &staleness,
 		DBUS_TYPE_INVALID)) {
 		dbus_message_unref(msg);
 		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Fail to append args"); 
@@ -937,3 +941,360 @@ int tts_dbus_request_pause(int uid)
 
 	return result;
 }
+
+int tts_dbus_request_add_template(int uid, const char* text_template)
+{
+	if (NULL == text_template) {
+		SLOG(LOG_ERROR, TAG_TTSC, "Input parameter is NULL");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	DBusMessage* msg;
+	DBusError err;
+	dbus_error_init(&err);
+
+	msg = dbus_message_new_method_call(
+		TTS_SERVER_SERVICE_NAME, 
+		TTS_SERVER_SERVICE_OBJECT_PATH, 
+		TTS_SERVER_SERVICE_INTERFACE, 
+		TTS_METHOD_ADD_TEMPLATE);
+
+	if (NULL == msg) { 
+		SLOG(LOG_ERROR, TAG_TTSC, ">>>> Request tts add template : Fail to make message"); 
+		if (dbus_error_is_set(&err))  
+			SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+
+		return TTS_ERROR_OPERATION_FAILED;
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSC, ">>>> Request tts add template : uid(%d), template(%s)", uid, text_template);
+	}
+
+	if (true != dbus_message_append_args( msg, 
+		DBUS_TYPE_INT32, &uid,
+		DBUS_TYPE_STRING, &text_template,
+		DBUS_TYPE_INVALID)) {
+		dbus_message_unref(msg);
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Fail to append args"); 
+
+		return TTS_ERROR_OPERATION_FAILED;
+	}
+
+	DBusMessage* result_msg;
+	int result = TTS_ERROR_OPERATION_FAILED;
+
+	result_msg = dbus_connection_send_with_reply_and_block(g_conn, msg, 5000, &err);
+	dbus_message_unref(msg);
+
+	if (dbus_error_is_set(&err))  
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+
+	if (NULL != result_msg) {
+		dbus_message_get_args(result_msg, &err,
+			DBUS_TYPE_INT32, &result,
+			DBUS_TYPE_INVALID);
+
+		if (dbus_error_is_set(&err)) { 
+			SLOG(LOG_ERROR, TAG_TTSC, "<<<< tts add template : Get arguments error (%s)\n", err.message);
+			dbus_error_free(&err); 
+			result = TTS_ERROR_OPERATION_FAILED;
+		}
+		dbus_message_unref(result_msg);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSC, "<<<< Result message is NULL ");
+		if (dbus_error_is_set(&err))  
+			SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+		tts_dbus_reconnect();
+	}
+
+	if (0 == result) {
+		SLOG(LOG_DEBUG, TAG_TTSC, "<<<< tts add template : result(%d) \n", result);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSC, "<<<< tts add template : result(%d) \n", result);
+	}
+
+	return result;
+}
+
+int tts_dbus_request_set_priority(int uid, int priority)
+{
+	DBusMessage* msg;
+	DBusError err;
+	dbus_error_init(&err);
+
+	msg = dbus_message_new_method_call(
+		TTS_SERVER_SERVICE_NAME, 
+		TTS_SERVER_SERVICE_OBJECT_PATH, 
+		TTS_SERVER_SERVICE_INTERFACE, 
+		TTS_METHOD_SET_PRIORITY);
+
+	if (NULL == msg) { 
+		SLOG(LOG_ERROR, TAG_TTSC, ">>>> Request tts set priority : Fail to make message"); 
+		if (dbus_error_is_set(&err))  
+			SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+
+		return TTS_ERROR_OPERATION_FAILED;
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSC, ">>>> Request tts set priority : uid(%d), priority(%d)", uid, priority);
+	}
+
+	if (true != dbus_message_append_args( msg, 
+		DBUS_TYPE_INT32, &uid,
+		DBUS_TYPE_INT32, &priority,
+		DBUS_TYPE_INVALID)) {
+		dbus_message_unref(msg);
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Fail to append args"); 
+
+		return TTS_ERROR_OPERATION_FAILED;
+	}
+
+	DBusMessage* result_msg;
+	int result = TTS_ERROR_OPERATION_FAILED;
+
+	result_msg = dbus_connection_send_with_reply_and_block(g_conn, msg, 5000, &err);
+	dbus_message_unref(msg);
+
+	if (dbus_error_is_set(&err))  
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+
+	if (NULL != result_msg) {
+		dbus_message_get_args(result_msg, &err,
+			DBUS_TYPE_INT32, &result,
+			DBUS_TYPE_INVALID);
+
+		if (dbus_error_is_set(&err)) { 
+			SLOG(LOG_ERROR, TAG_TTSC, "<<<< tts set priority : Get arguments error (%s)\n", err.message);
+			dbus_error_free(&err); 
+			result = TTS_ERROR_OPERATION_FAILED;
+		}
+		dbus_message_unref(result_msg);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSC, "<<<< Result message is NULL ");
+		if (dbus_error_is_set(&err))  
+			SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+		tts_dbus_reconnect();
+	}
+
+	if (0 == result) {
+		SLOG(LOG_DEBUG, TAG_TTSC, "<<<< tts set priority : result(%d) \n", result);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSC, "<<<< tts set priority : result(%d) \n", result);
+	}
+
+	return result;
+}
+
+int tts_dbus_request_open_stream(int uid, const char* lang, int vctype, int speed, int uttid)
+{
+	if (NULL == lang) {
+		SLOG(LOG_ERROR, TAG_TTSC, "Input parameter is NULL");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	DBusMessage* msg;
+	DBusError err;
+	dbus_error_init(&err);
+
+	msg = dbus_message_new_method_call(
+		TTS_SERVER_SERVICE_NAME, 
+		TTS_SERVER_SERVICE_OBJECT_PATH, 
+		TTS_SERVER_SERVICE_INTERFACE, 
+		TTS_METHOD_OPEN_STREAM);
+
+	if (NULL == msg) { 
+		SLOG(LOG_ERROR, TAG_TTSC, ">>>> Request tts open stream : Fail to make message"); 
+		if (dbus_error_is_set(&err))  
+			SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+
+		return TTS_ERROR_OPERATION_FAILED;
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSC, ">>>> Request tts open stream : uid(%d), lang(%s), type(%d), speed(%d), uttid(%d)", uid, lang, vctype, speed, uttid);
+	}
+
+	if (true != dbus_message_append_args( msg, 
+		DBUS_TYPE_INT32, &uid,
+		DBUS_TYPE_STRING, &lang,
+		DBUS_TYPE_INT32, &vctype,
+		DBUS_TYPE_INT32, &speed,
+		DBUS_TYPE_INT32, &uttid,
+		DBUS_TYPE_INVALID)) {
+		dbus_message_unref(msg);
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Fail to append args"); 
+
+		return TTS_ERROR_OPERATION_FAILED;
+	}
+
+	DBusMessage* result_msg;
+	int result = TTS_ERROR_OPERATION_FAILED;
+
+	result_msg = dbus_connection_send_with_reply_and_block(g_conn, msg, 5000, &err);
+	dbus_message_unref(msg);
+
+	if (dbus_error_is_set(&err))  
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+
+	if (NULL != result_msg) {
+		dbus_message_get_args(result_msg, &err,
+			DBUS_TYPE_INT32, &result,
+			DBUS_TYPE_INVALID);
+
+		if (dbus_error_is_set(&err)) { 
+			SLOG(LOG_ERROR, TAG_TTSC, "<<<< tts open stream : Get arguments error (%s)\n", err.message);
+			dbus_error_free(&err); 
+			result = TTS_ERROR_OPERATION_FAILED;
+		}
+		dbus_message_unref(result_msg);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSC, "<<<< Result message is NULL ");
+		if (dbus_error_is_set(&err))  
+			SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+		tts_dbus_reconnect();
+	}
+
+	if (0 == result) {
+		SLOG(LOG_DEBUG, TAG_TTSC, "<<<< tts open stream : result(%d) \n", result);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSC, "<<<< tts open stream : result(%d) \n", result);
+	}
+
+	return result;
+}
+
+int tts_dbus_request_push_stream(int uid, const char* text)
+{
+	if (NULL == text) {
+		SLOG(LOG_ERROR, TAG_TTSC, "Input parameter is NULL");
+		return TTS_ERROR_INVALID_PARAMETER;
+	}
+
+	DBusMessage* msg;
+	DBusError err;
+	dbus_error_init(&err);
+
+	msg = dbus_message_new_method_call(
+		TTS_SERVER_SERVICE_NAME, 
+		TTS_SERVER_SERVICE_OBJECT_PATH, 
+		TTS_SERVER_SERVICE_INTERFACE, 
+		TTS_METHOD_PUSH_STREAM);
+
+	if (NULL == msg) { 
+		SLOG(LOG_ERROR, TAG_TTSC, ">>>> Request tts push stream : Fail to make message"); 
+		if (dbus_error_is_set(&err))  
+			SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+
+		return TTS_ERROR_OPERATION_FAILED;
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSC, ">>>> Request tts push stream : uid(%d), text(%s)", uid, text);
+	}
+
+	if (true != dbus_message_append_args( msg, 
+		DBUS_TYPE_INT32, &uid,
+		DBUS_TYPE_STRING, &text,
+		DBUS_TYPE_INVALID)) {
+		dbus_message_unref(msg);
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Fail to append args"); 
+
+		return TTS_ERROR_OPERATION_FAILED;
+	}
+
+	DBusMessage* result_msg;
+	int result = TTS_ERROR_OPERATION_FAILED;
+
+	result_msg = dbus_connection_send_with_reply_and_block(g_conn, msg, 5000, &err);
+	dbus_message_unref(msg);
+
+	if (dbus_error_is_set(&err))  
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+
+	if (NULL != result_msg) {
+		dbus_message_get_args(result_msg, &err,
+			DBUS_TYPE_INT32, &result,
+			DBUS_TYPE_INVALID);
+
+		if (dbus_error_is_set(&err)) { 
+			SLOG(LOG_ERROR, TAG_TTSC, "<<<< tts push stream : Get arguments error (%s)\n", err.message);
+			dbus_error_free(&err); 
+			result = TTS_ERROR_OPERATION_FAILED;
+		}
+		dbus_message_unref(result_msg);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSC, "<<<< Result message is NULL ");
+		if (dbus_error_is_set(&err))  
+			SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+		tts_dbus_reconnect();
+	}
+
+	if (0 == result) {
+		SLOG(LOG_DEBUG, TAG_TTSC, "<<<< tts push stream : result(%d) \n", result);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSC, "<<<< tts push stream : result(%d) \n", result);
+	}
+
+	return result;
+}
+
+int tts_dbus_request_close_stream(int uid)
+{
+	DBusMessage* msg;
+	DBusError err;
+	dbus_error_init(&err);
+
+	msg = dbus_message_new_method_call(
+		TTS_SERVER_SERVICE_NAME, 
+		TTS_SERVER_SERVICE_OBJECT_PATH, 
+		TTS_SERVER_SERVICE_INTERFACE, 
+		TTS_METHOD_CLOSE_STREAM);
+
+	if (NULL == msg) { 
+		SLOG(LOG_ERROR, TAG_TTSC, ">>>> Request tts close stream : Fail to make message"); 
+		if (dbus_error_is_set(&err))  
+			SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+
+		return TTS_ERROR_OPERATION_FAILED;
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSC, ">>>> Request tts close stream : uid(%d)", uid);
+	}
+
+	if (true != dbus_message_append_args( msg, 
+		DBUS_TYPE_INT32, &uid,
+		DBUS_TYPE_INVALID)) {
+		dbus_message_unref(msg);
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] Fail to append args"); 
+
+		return TTS_ERROR_OPERATION_FAILED;
+	}
+
+	DBusMessage* result_msg;
+	int result = TTS_ERROR_OPERATION_FAILED;
+
+	result_msg = dbus_connection_send_with_reply_and_block(g_conn, msg, 5000, &err);
+	dbus_message_unref(msg);
+
+	if (dbus_error_is_set(&err))  
+		SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+
+	if (NULL != result_msg) {
+		dbus_message_get_args(result_msg, &err,
+			DBUS_TYPE_INT32, &result,
+			DBUS_TYPE_INVALID);
+
+		if (dbus_error_is_set(&err)) { 
+			SLOG(LOG_ERROR, TAG_TTSC, "<<<< tts close stream : Get arguments error (%s)\n", err.message);
+			dbus_error_free(&err); 
+			result = TTS_ERROR_OPERATION_FAILED;
+		}
+		dbus_message_unref(result_msg);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSC, "<<<< Result message is NULL ");
+		if (dbus_error_is_set(&err))  
+			SLOG(LOG_ERROR, TAG_TTSC, "[ERROR] %s", err.message);
+		tts_dbus_reconnect();
+	}
+
+	if (0 == result) {
+		SLOG(LOG_DEBUG, TAG_TTSC, "<<<< tts close stream : result(%d) \n", result);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSC, "<<<< tts close stream : result(%d) \n", result);
+	}
+
+	return result;
+}
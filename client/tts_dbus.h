@@ -36,7 +36,8 @@ int tts_dbus_request_get_support_voice(int uid, tts_h tts, tts_supported_voice_c
 
 int tts_dbus_request_get_default_voice(int uid , char** lang, tts_voice_type_e* vctype);
 
-int tts_dbus_request_add_text(int uid, const char* text, const char* lang, int vctype, int speed, int uttid); 
+int tts_dbus_request_add_text(int uid, const char* text, const char* lang, int vctype, int speed, int uttid, int priority, 
+			      int deadline, int staleness); 
 
 int tts_dbus_request_remove_all_text(int uid); 
 
@@ -47,6 +48,16 @@ int tts_dbus_request_stop(int uid);
 
 int tts_dbus_request_pause(int uid);
 
+int tts_dbus_request_add_template(int uid, const char* text_template);
+
+int tts_dbus_request_set_priority(int uid, int priority);
+
+int tts_dbus_request_open_stream(int uid, const char* lang, int vctype, int speed, int uttid);
+
+int tts_dbus_request_push_stream(int uid, const char* text);
+
+int tts_dbus_request_close_stream(int uid);
+
 #ifdef __cplusplus
 }
 #endif
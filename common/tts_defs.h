@@ -49,6 +49,11 @@ extern "C" {
 #define TTS_METHOD_PLAY			"tts_method_play"
 #define TTS_METHOD_STOP			"tts_method_stop"
 #define TTS_METHOD_PAUSE		"tts_method_pause"
+#define TTS_METHOD_ADD_TEMPLATE		"tts_method_add_template"
+#define TTS_METHOD_SET_PRIORITY		"tts_method_set_priority"
+#define TTS_METHOD_OPEN_STREAM		"tts_method_open_stream"
+#define TTS_METHOD_PUSH_STREAM		"tts_method_push_stream"
+#define TTS_METHOD_CLOSE_STREAM		"tts_method_close_stream"
 
 #define TTSD_METHOD_HELLO		"ttsd_method_hello"
 #define TTSD_METHOD_UTTERANCE_STARTED	"ttsd_method_utterance_started"
@@ -57,6 +62,9 @@ extern "C" {
 #define TTSD_METHOD_SET_STATE		"ttsd_method_set_state"
 #define TTSD_METHOD_GET_STATE		"ttsd_method_get_state"
 
+/* Priority of utterance which follows the priority of client */
+#define TTS_PRIORITY_CLIENT_DEFAULT	-1
+
 /******************************************************************************************
 * Message Definition for Setting
 *******************************************************************************************/
@@ -0,0 +1,880 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+/*
+* Synthetic engine for load and latency tests of the daemon.
+*
+* It makes deterministic PCM from text without any voice data. A character is a square wave whose pitch
+* depends on the character, and the same text always gives the same audio. Timing of results is controlled
+* by engine settings, which are also read from environment variables of the daemon when the engine is loaded.
+* Texts of a batch after the first one start without first_latency, as the voice is already set up.
+*
+*	first_latency	TTS_MOCK_FIRST_LATENCY	msec from start of synthesis to first audio
+*	rtf		TTS_MOCK_RTF		real-time factor, time to make audio / duration of audio
+*	chunk_size	TTS_MOCK_CHUNK_SIZE	bytes of audio in a result, 0 to use chunk size of daemon
+*	char_duration	TTS_MOCK_CHAR_DURATION	msec of audio for a character at normal speed
+*	fail_rate	TTS_MOCK_FAIL_RATE	percent of requests which fail
+*	fail_chunk	TTS_MOCK_FAIL_CHUNK	results before the failure, -1 to fail in start of synthesis
+*	cancel_delay	TTS_MOCK_CANCEL_DELAY	msec which cancel of synthesis takes
+*	preload_latency	TTS_MOCK_PRELOAD_LATENCY	msec which preload of voice takes
+*	seed		TTS_MOCK_SEED		seed of failure injection
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <dlog.h>
+
+#include "ttsp.h"
+
+#define TAG_MOCK		"ttsp-mock"
+
+#define MOCK_ENGINE_UUID	"5E3C1D9A-7B2F-4A60-8C41-D2F6A90B3E17"
+#define MOCK_ENGINE_NAME	"Mock TTS Engine"
+
+#define MOCK_SAMPLE_RATE	16000
+#define MOCK_CHUNK_SIZE_DEFAULT	4096
+#define MOCK_AMPLITUDE		3000
+
+typedef struct {
+	const char*	language;
+	ttsp_voice_type_e type;
+} mock_voice_s;
+
+static const mock_voice_s g_voices[] = {
+	{"en_US", TTSP_VOICE_TYPE_FEMALE},
+	{"en_US", TTSP_VOICE_TYPE_MALE},
+	{"ko_KR", TTSP_VOICE_TYPE_FEMALE},
+	{"de_DE", TTSP_VOICE_TYPE_MALE},
+	{"fr_FR", TTSP_VOICE_TYPE_FEMALE},
+};
+
+#define MOCK_VOICE_COUNT	(int)(sizeof(g_voices) / sizeof(g_voices[0]))
+
+typedef struct {
+	int		first_latency;
+	double		rtf;
+	int		chunk_size;
+	int		char_duration;
+	int		fail_rate;
+	int		fail_chunk;
+	int		cancel_delay;
+	int		preload_latency;
+	unsigned int	seed;
+} mock_config_s;
+
+/* Request which the worker thread synthesizes */
+typedef struct {
+	bool		is_active;
+	bool		is_stream;
+	bool		is_closed;		/**< No more text of stream */
+	bool		is_fail;
+	bool		is_batched;		/**< Started after other text of batch */
+	bool		is_ended;		/**< Last result is sent */
+	int		speed_rate;		/**< Percent of audio duration for speed */
+	void*		user_data;
+	char*		text;
+	size_t		text_len;
+	unsigned long	sample_pos;		/**< Samples which are already sent */
+	int		chunk_count;
+} mock_job_s;
+
+static mock_config_s g_config = {0, 0.0, 0, 60, 0, 0, 0, 0, 1};
+
+static ttspe_result_cb g_result_cb = NULL;
+
+static ttspd_alloc_buffer g_alloc_buffer = NULL;
+static unsigned int g_daemon_chunk_size = 0;
+
+static bool g_is_initialized = false;
+
+static mock_job_s g_job;
+
+/* Texts of batch which wait for the current job */
+static mock_job_s* g_batch = NULL;
+static int g_batch_count = 0;
+static int g_batch_next = 0;
+
+static bool g_is_canceled = false;
+static bool g_is_exit = false;
+
+static pthread_t g_worker;
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_cond;
+
+
+static long long __mock_get_time()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static void __mock_sleep(int msec)
+{
+	if (0 < msec) {
+		struct timespec ts = {msec / 1000, (msec % 1000) * 1000000L};
+		nanosleep(&ts, NULL);
+	}
+}
+
+/* Wait for signal or until the time. It should be called with mutex locked. */
+static void __mock_wait_until(long long msec)
+{
+	struct timespec ts;
+	ts.tv_sec = msec / 1000;
+	ts.tv_nsec = (msec % 1000) * 1000000L;
+	pthread_cond_timedwait(&g_cond, &g_mutex, &ts);
+}
+
+static int __mock_get_chunk_size()
+{
+	int size = g_config.chunk_size;
+	if (0 >= size)
+		size = (0 < g_daemon_chunk_size) ? (int)g_daemon_chunk_size : MOCK_CHUNK_SIZE_DEFAULT;
+
+	/* whole samples */
+	return (size < 2) ? 2 : size & ~1;
+}
+
+static int __mock_get_speed_rate(ttsp_speed_e speed)
+{
+	switch (speed) {
+	case TTSP_SPEED_VERY_SLOW:	return 150;
+	case TTSP_SPEED_SLOW:		return 125;
+	case TTSP_SPEED_FAST:		return 80;
+	case TTSP_SPEED_VERY_FAST:	return 60;
+	default:			return 100;
+	}
+}
+
+static unsigned long __mock_get_samples_per_char(const mock_job_s* job)
+{
+	unsigned long samples = (unsigned long)g_config.char_duration * MOCK_SAMPLE_RATE / 1000 * job->speed_rate / 100;
+	return (0 < samples) ? samples : 1;
+}
+
+/* Square wave of the character, silence for spaces and punctuation */
+static void __mock_make_audio(const mock_job_s* job, unsigned long pos, short* samples, unsigned int count)
+{
+	unsigned long per_char = __mock_get_samples_per_char(job);
+	unsigned int i;
+
+	for (i = 0; i < count; i++) {
+		unsigned long n = pos + i;
+		unsigned char ch = (unsigned char)job->text[n / per_char];
+
+		if (ch <= ' ' || NULL != strchr(".,!?;:", ch)) {
+			samples[i] = 0;
+			continue;
+		}
+
+		unsigned long period = MOCK_SAMPLE_RATE / (150 + (ch % 32) * 15);
+		samples[i] = ((n % period) < period / 2) ? MOCK_AMPLITUDE : -MOCK_AMPLITUDE;
+	}
+}
+
+static void __mock_clear_job()
+{
+	if (NULL != g_job.text)
+		free(g_job.text);
+
+	memset(&g_job, 0, sizeof(mock_job_s));
+}
+
+static void __mock_clear_batch()
+{
+	int i;
+	for (i = g_batch_next; i < g_batch_count; i++) {
+		if (NULL != g_batch[i].text)
+			free(g_batch[i].text);
+	}
+
+	if (NULL != g_batch)
+		free(g_batch);
+
+	g_batch = NULL;
+	g_batch_count = 0;
+	g_batch_next = 0;
+}
+
+/* Canceled texts of batch get cancel event, current job is still active so that cancel waits for them */
+static void __mock_cancel_batch()
+{
+	int count = g_batch_count - g_batch_next + 1;
+	void** user_data = (void**)calloc(count, sizeof(void*));
+	if (NULL == user_data) {
+		__mock_clear_batch();
+		return;
+	}
+
+	/* current job may be finished before cancel */
+	int i;
+	count = 0;
+	if (false == g_job.is_ended)
+		user_data[count++] = g_job.user_data;
+	for (i = g_batch_next; i < g_batch_count; i++)
+		user_data[count++] = g_batch[i].user_data;
+
+	__mock_clear_batch();
+
+	pthread_mutex_unlock(&g_mutex);
+	for (i = 0; i < count; i++)
+		g_result_cb(TTSP_RESULT_EVENT_CANCEL, NULL, 0, user_data[i]);
+	pthread_mutex_lock(&g_mutex);
+
+	free(user_data);
+}
+
+/* Make audio of result. Buffer of daemon belongs to daemon after callback, so it is not freed. */
+static void* __mock_make_result(const mock_job_s* job, unsigned int size, bool* is_daemon_buffer)
+{
+	void* data = NULL;
+
+	*is_daemon_buffer = false;
+	if (0 == size)
+		return NULL;
+
+	if (NULL != g_alloc_buffer) {
+		data = g_alloc_buffer(size);
+		*is_daemon_buffer = (NULL != data);
+	}
+	if (NULL == data)
+		data = malloc(size);
+
+	if (NULL != data)
+		__mock_make_audio(job, job->sample_pos, (short*)data, size / 2);
+
+	return data;
+}
+
+static void* __mock_worker(void* arg)
+{
+	pthread_mutex_lock(&g_mutex);
+
+	while (false == g_is_exit) {
+		if (false == g_job.is_active) {
+			pthread_cond_wait(&g_cond, &g_mutex);
+			continue;
+		}
+
+		long long due = __mock_get_time() + (true == g_job.is_batched ? 0 : g_config.first_latency);
+
+		while (false == g_is_canceled && false == g_is_exit) {
+			unsigned long per_char = __mock_get_samples_per_char(&g_job);
+			unsigned long total = g_job.text_len * per_char;
+			bool is_last_text = (false == g_job.is_stream || true == g_job.is_closed);
+
+			/* stream waits for text */
+			if (g_job.sample_pos >= total && false == is_last_text) {
+				pthread_cond_wait(&g_cond, &g_mutex);
+				if (due < __mock_get_time())
+					due = __mock_get_time();
+				continue;
+			}
+
+			if (__mock_get_time() < due) {
+				__mock_wait_until(due);
+				continue;
+			}
+
+			unsigned int chunk = (unsigned int)__mock_get_chunk_size();
+			unsigned long count = total - g_job.sample_pos;
+			if (count > chunk / 2)
+				count = chunk / 2;
+
+			bool is_end = (true == is_last_text && g_job.sample_pos + count >= total);
+			ttsp_result_event_e event = TTSP_RESULT_EVENT_CONTINUE;
+			if (true == g_job.is_fail && g_job.chunk_count >= g_config.fail_chunk) {
+				event = TTSP_RESULT_EVENT_FAIL;
+				count = 0;
+				is_end = true;
+			} else if (0 == g_job.chunk_count) {
+				event = TTSP_RESULT_EVENT_START;
+			} else if (true == is_end) {
+				event = TTSP_RESULT_EVENT_FINISH;
+			}
+
+			/* text of stream can be changed while callback, so audio is made with mutex */
+			bool is_daemon_buffer = false;
+			unsigned int size = (unsigned int)count * 2;
+			void* data = __mock_make_result(&g_job, size, &is_daemon_buffer);
+			if (0 < size && NULL == data) {
+				SLOG(LOG_ERROR, TAG_MOCK, "[Mock ERROR] Fail to allocate buffer");
+				event = TTSP_RESULT_EVENT_FAIL;
+				size = 0;
+				is_end = true;
+			}
+
+			void* user_data = g_job.user_data;
+			g_job.sample_pos += count;
+			g_job.chunk_count++;
+
+			pthread_mutex_unlock(&g_mutex);
+			bool ret = g_result_cb(event, data, size, user_data);
+			if (true == is_end && TTSP_RESULT_EVENT_START == event)
+				ret = g_result_cb(TTSP_RESULT_EVENT_FINISH, NULL, 0, user_data);
+			pthread_mutex_lock(&g_mutex);
+
+			if (false == is_daemon_buffer && NULL != data)
+				free(data);
+
+			if (true == is_end) {
+				g_job.is_ended = true;
+				break;
+			}
+			if (false == ret)
+				break;
+
+			/* audio of chunk takes rtf times of its duration */
+			due += (long long)((double)count * 1000 / MOCK_SAMPLE_RATE * g_config.rtf);
+		}
+
+		SLOG(LOG_DEBUG, TAG_MOCK, "[Mock] Synthesis is done : chunks(%d), canceled(%s)",
+			g_job.chunk_count, g_is_canceled ? "true" : "false");
+
+		if (NULL != g_batch) {
+			if (true == g_is_canceled) {
+				__mock_cancel_batch();
+			} else if (g_batch_next < g_batch_count) {
+				/* next text of batch */
+				__mock_clear_job();
+				g_job = g_batch[g_batch_next];
+				memset(&g_batch[g_batch_next], 0, sizeof(mock_job_s));
+				g_batch_next++;
+				continue;
+			} else {
+				__mock_clear_batch();
+			}
+		}
+
+		__mock_clear_job();
+		g_is_canceled = false;
+		pthread_cond_broadcast(&g_cond);
+	}
+
+	pthread_mutex_unlock(&g_mutex);
+
+	return NULL;
+}
+
+static int __mock_start_job(const char* language, ttsp_voice_type_e type, const char* text, bool is_stream,
+			    ttsp_speed_e speed, void* user_data)
+{
+	if (false == g_is_initialized)
+		return TTSP_ERROR_INVALID_STATE;
+
+	if (NULL == language || NULL == text)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	int i;
+	for (i = 0; i < MOCK_VOICE_COUNT; i++) {
+		if (0 == strcmp(g_voices[i].language, language) && g_voices[i].type == type)
+			break;
+	}
+	if (MOCK_VOICE_COUNT == i)
+		return TTSP_ERROR_INVALID_VOICE;
+
+	pthread_mutex_lock(&g_mutex);
+
+	if (true == g_job.is_active) {
+		pthread_mutex_unlock(&g_mutex);
+		return TTSP_ERROR_INVALID_STATE;
+	}
+
+	bool is_fail = (int)(rand_r(&g_config.seed) % 100) < g_config.fail_rate;
+	if (true == is_fail && 0 > g_config.fail_chunk) {
+		pthread_mutex_unlock(&g_mutex);
+		SLOG(LOG_WARN, TAG_MOCK, "[Mock] Injected failure in start of synthesis");
+		return TTSP_ERROR_OPERATION_FAILED;
+	}
+
+	g_job.text = strdup(text);
+	if (NULL == g_job.text) {
+		pthread_mutex_unlock(&g_mutex);
+		return TTSP_ERROR_OUT_OF_MEMORY;
+	}
+
+	g_job.is_active = true;
+	g_job.is_stream = is_stream;
+	g_job.is_fail = is_fail;
+	g_job.speed_rate = __mock_get_speed_rate(speed);
+	g_job.user_data = user_data;
+	g_job.text_len = strlen(text);
+
+	pthread_cond_broadcast(&g_cond);
+	pthread_mutex_unlock(&g_mutex);
+
+	return TTSP_ERROR_NONE;
+}
+
+/*
+* Engine functions
+*/
+
+static int __mock_initialize(ttspe_result_cb callback)
+{
+	if (NULL == callback)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	if (true == g_is_initialized)
+		return TTSP_ERROR_INVALID_STATE;
+
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&g_cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	g_result_cb = callback;
+	g_is_exit = false;
+	g_is_canceled = false;
+	memset(&g_job, 0, sizeof(mock_job_s));
+
+	if (0 != pthread_create(&g_worker, NULL, __mock_worker, NULL)) {
+		SLOG(LOG_ERROR, TAG_MOCK, "[Mock ERROR] Fail to create worker thread");
+		pthread_cond_destroy(&g_cond);
+		return TTSP_ERROR_OPERATION_FAILED;
+	}
+
+	g_is_initialized = true;
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __mock_deinitialize(void)
+{
+	if (false == g_is_initialized)
+		return TTSP_ERROR_INVALID_STATE;
+
+	pthread_mutex_lock(&g_mutex);
+	g_is_exit = true;
+	pthread_cond_broadcast(&g_cond);
+	pthread_mutex_unlock(&g_mutex);
+
+	pthread_join(g_worker, NULL);
+	pthread_cond_destroy(&g_cond);
+
+	__mock_clear_job();
+	__mock_clear_batch();
+	g_is_initialized = false;
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __mock_foreach_voices(ttspe_supported_voice_cb callback, void* user_data)
+{
+	if (NULL == callback)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	int i;
+	for (i = 0; i < MOCK_VOICE_COUNT; i++) {
+		if (false == callback(g_voices[i].language, g_voices[i].type, user_data))
+			break;
+	}
+
+	return TTSP_ERROR_NONE;
+}
+
+static bool __mock_is_valid_voice(const char* language, ttsp_voice_type_e type)
+{
+	if (NULL == language)
+		return false;
+
+	int i;
+	for (i = 0; i < MOCK_VOICE_COUNT; i++) {
+		if (0 == strcmp(g_voices[i].language, language) && g_voices[i].type == type)
+			return true;
+	}
+
+	return false;
+}
+
+static int __mock_get_audio_format(ttsp_audio_type_e* audio_type, int* rate, int* channel)
+{
+	if (NULL == audio_type || NULL == rate || NULL == channel)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	*audio_type = TTSP_AUDIO_TYPE_RAW;
+	*rate = MOCK_SAMPLE_RATE;
+	*channel = 1;
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __mock_start_synthesis(const char* language, ttsp_voice_type_e type, const char* text, ttsp_speed_e speed, void* user_data)
+{
+	return __mock_start_job(language, type, text, false, speed, user_data);
+}
+
+/* Texts are synthesized one by one by the worker, results of each text are sent in order */
+static int __mock_start_batch(const ttsp_batch_item_s* items, int count)
+{
+	if (false == g_is_initialized)
+		return TTSP_ERROR_INVALID_STATE;
+
+	if (NULL == items || 0 >= count)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	int i;
+	for (i = 0; i < count; i++) {
+		if (NULL == items[i].text)
+			return TTSP_ERROR_INVALID_PARAMETER;
+		if (false == __mock_is_valid_voice(items[i].language, items[i].type))
+			return TTSP_ERROR_INVALID_VOICE;
+	}
+
+	pthread_mutex_lock(&g_mutex);
+
+	if (true == g_job.is_active) {
+		pthread_mutex_unlock(&g_mutex);
+		return TTSP_ERROR_INVALID_STATE;
+	}
+
+	mock_job_s* batch = (mock_job_s*)calloc(count, sizeof(mock_job_s));
+	if (NULL == batch) {
+		pthread_mutex_unlock(&g_mutex);
+		return TTSP_ERROR_OUT_OF_MEMORY;
+	}
+
+	for (i = 0; i < count; i++) {
+		mock_job_s* job = &batch[i];
+
+		job->is_fail = (int)(rand_r(&g_config.seed) % 100) < g_config.fail_rate;
+		job->text = strdup(items[i].text);
+
+		/* no text is started if any of them fails */
+		if ((true == job->is_fail && 0 > g_config.fail_chunk) || NULL == job->text) {
+			int ret = (NULL == job->text) ? TTSP_ERROR_OUT_OF_MEMORY : TTSP_ERROR_OPERATION_FAILED;
+			int j;
+			for (j = 0; j <= i; j++) {
+				if (NULL != batch[j].text)
+					free(batch[j].text);
+			}
+			free(batch);
+			pthread_mutex_unlock(&g_mutex);
+
+			SLOG(LOG_WARN, TAG_MOCK, "[Mock] Fail to start batch : result(%d)", ret);
+			return ret;
+		}
+
+		job->is_active = true;
+		job->is_batched = (0 < i);
+		job->speed_rate = __mock_get_speed_rate(items[i].speed);
+		job->user_data = items[i].user_data;
+		job->text_len = strlen(items[i].text);
+	}
+
+	g_job = batch[0];
+	memset(&batch[0], 0, sizeof(mock_job_s));
+
+	g_batch = batch;
+	g_batch_count = count;
+	g_batch_next = 1;
+
+	pthread_cond_broadcast(&g_cond);
+	pthread_mutex_unlock(&g_mutex);
+
+	return TTSP_ERROR_NONE;
+}
+
+/* Audio is made at fixed duration per character, so estimation is exact except latency of threads */
+static int __mock_estimate_cost(const char* language, ttsp_voice_type_e type, const char* text, ttsp_speed_e speed,
+				int* synth_msec, int* audio_msec)
+{
+	if (NULL == text || NULL == synth_msec || NULL == audio_msec)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	if (false == __mock_is_valid_voice(language, type))
+		return TTSP_ERROR_INVALID_VOICE;
+
+	double audio = (double)strlen(text) * g_config.char_duration * __mock_get_speed_rate(speed) / 100;
+
+	*audio_msec = (int)audio;
+	*synth_msec = g_config.first_latency + (int)(audio * g_config.rtf);
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __mock_cancel_synthesis(void)
+{
+	if (false == g_is_initialized)
+		return TTSP_ERROR_INVALID_STATE;
+
+	pthread_mutex_lock(&g_mutex);
+
+	if (false == g_job.is_active) {
+		pthread_mutex_unlock(&g_mutex);
+		return TTSP_ERROR_NONE;
+	}
+
+	g_is_canceled = true;
+	pthread_cond_broadcast(&g_cond);
+
+	/* called in result callback, worker stops after the callback */
+	if (pthread_equal(pthread_self(), g_worker)) {
+		pthread_mutex_unlock(&g_mutex);
+		return TTSP_ERROR_NONE;
+	}
+
+	while (true == g_job.is_active)
+		pthread_cond_wait(&g_cond, &g_mutex);
+
+	pthread_mutex_unlock(&g_mutex);
+
+	/* slow engine */
+	__mock_sleep(g_config.cancel_delay);
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __mock_foreach_engine_settings(ttspe_engine_setting_cb callback, void* user_data)
+{
+	if (NULL == callback)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	char value[32];
+	const struct {
+		const char* key;
+		int value;
+	} items[] = {
+		{"first_latency", g_config.first_latency},
+		{"chunk_size", g_config.chunk_size},
+		{"char_duration", g_config.char_duration},
+		{"fail_rate", g_config.fail_rate},
+		{"fail_chunk", g_config.fail_chunk},
+		{"cancel_delay", g_config.cancel_delay},
+		{"preload_latency", g_config.preload_latency},
+		{"seed", (int)g_config.seed},
+	};
+
+	snprintf(value, sizeof(value), "%.3f", g_config.rtf);
+	if (false == callback("rtf", value, user_data))
+		return TTSP_ERROR_NONE;
+
+	unsigned int i;
+	for (i = 0; i < sizeof(items) / sizeof(items[0]); i++) {
+		snprintf(value, sizeof(value), "%d", items[i].value);
+		if (false == callback(items[i].key, value, user_data))
+			break;
+	}
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __mock_set_engine_setting(const char* key, const char* value)
+{
+	if (NULL == key || NULL == value)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	int ret = TTSP_ERROR_NONE;
+
+	pthread_mutex_lock(&g_mutex);
+
+	if (0 == strcmp(key, "rtf")) {
+		double rtf = strtod(value, NULL);
+		if (0 > rtf)
+			ret = TTSP_ERROR_INVALID_PARAMETER;
+		else
+			g_config.rtf = rtf;
+	} else {
+		int number = atoi(value);
+		int* target = NULL;
+
+		if (0 == strcmp(key, "first_latency"))		target = &g_config.first_latency;
+		else if (0 == strcmp(key, "chunk_size"))	target = &g_config.chunk_size;
+		else if (0 == strcmp(key, "char_duration"))	target = &g_config.char_duration;
+		else if (0 == strcmp(key, "fail_rate"))		target = &g_config.fail_rate;
+		else if (0 == strcmp(key, "fail_chunk"))	target = &g_config.fail_chunk;
+		else if (0 == strcmp(key, "cancel_delay"))	target = &g_config.cancel_delay;
+		else if (0 == strcmp(key, "preload_latency"))	target = &g_config.preload_latency;
+
+		if (0 == strcmp(key, "seed")) {
+			g_config.seed = (unsigned int)number;
+		} else if (NULL == target) {
+			ret = TTSP_ERROR_INVALID_PARAMETER;
+		} else if (0 > number && target != &g_config.fail_chunk) {
+			ret = TTSP_ERROR_INVALID_PARAMETER;
+		} else {
+			*target = number;
+		}
+	}
+
+	pthread_mutex_unlock(&g_mutex);
+
+	if (TTSP_ERROR_NONE == ret) {
+		SLOG(LOG_DEBUG, TAG_MOCK, "[Mock] Set setting : %s(%s)", key, value);
+	} else {
+		SLOG(LOG_ERROR, TAG_MOCK, "[Mock ERROR] Invalid setting : %s(%s)", key, value);
+	}
+
+	return ret;
+}
+
+static int __mock_preload_voice(const char* language, ttsp_voice_type_e type)
+{
+	if (false == g_is_initialized)
+		return TTSP_ERROR_INVALID_STATE;
+
+	if (false == __mock_is_valid_voice(language, type))
+		return TTSP_ERROR_INVALID_VOICE;
+
+	__mock_sleep(g_config.preload_latency);
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __mock_open_stream(const char* language, ttsp_voice_type_e type, ttsp_speed_e speed, void* user_data)
+{
+	return __mock_start_job(language, type, "", true, speed, user_data);
+}
+
+static int __mock_push_stream(const char* text)
+{
+	if (NULL == text)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	pthread_mutex_lock(&g_mutex);
+
+	if (false == g_job.is_active || false == g_job.is_stream || true == g_job.is_closed) {
+		pthread_mutex_unlock(&g_mutex);
+		return TTSP_ERROR_INVALID_STATE;
+	}
+
+	size_t len = strlen(text);
+	char* temp = (char*)realloc(g_job.text, g_job.text_len + len + 1);
+	if (NULL == temp) {
+		pthread_mutex_unlock(&g_mutex);
+		return TTSP_ERROR_OUT_OF_MEMORY;
+	}
+
+	memcpy(temp + g_job.text_len, text, len + 1);
+	g_job.text = temp;
+	g_job.text_len += len;
+
+	pthread_cond_broadcast(&g_cond);
+	pthread_mutex_unlock(&g_mutex);
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __mock_close_stream(void)
+{
+	pthread_mutex_lock(&g_mutex);
+
+	if (false == g_job.is_active || false == g_job.is_stream || true == g_job.is_closed) {
+		pthread_mutex_unlock(&g_mutex);
+		return TTSP_ERROR_INVALID_STATE;
+	}
+
+	g_job.is_closed = true;
+
+	pthread_cond_broadcast(&g_cond);
+	pthread_mutex_unlock(&g_mutex);
+
+	return TTSP_ERROR_NONE;
+}
+
+static void __mock_read_env(const char* name, const char* key)
+{
+	const char* value = getenv(name);
+	if (NULL != value)
+		__mock_set_engine_setting(key, value);
+}
+
+/*
+* Plugin interface
+*/
+
+int ttsp_get_engine_info(ttsp_engine_info_cb callback, void* user_data)
+{
+	if (NULL == callback)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	callback(MOCK_ENGINE_UUID, MOCK_ENGINE_NAME, NULL, false, user_data);
+
+	return TTSP_ERROR_NONE;
+}
+
+int ttsp_load_engine(ttspd_funcs_s* pdfuncs, ttspe_funcs_s* pefuncs)
+{
+	if (NULL == pdfuncs || NULL == pefuncs)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	/* buffers of daemon are used if daemon provides them */
+	g_alloc_buffer = NULL;
+	g_daemon_chunk_size = 0;
+	if (TTSP_VERSION_2 <= pdfuncs->version && TTSPD_FUNCS_V2_SIZE <= pdfuncs->size) {
+		g_alloc_buffer = pdfuncs->alloc_buffer;
+		g_daemon_chunk_size = pdfuncs->chunk_size;
+	}
+
+	__mock_read_env("TTS_MOCK_FIRST_LATENCY", "first_latency");
+	__mock_read_env("TTS_MOCK_RTF", "rtf");
+	__mock_read_env("TTS_MOCK_CHUNK_SIZE", "chunk_size");
+	__mock_read_env("TTS_MOCK_CHAR_DURATION", "char_duration");
+	__mock_read_env("TTS_MOCK_FAIL_RATE", "fail_rate");
+	__mock_read_env("TTS_MOCK_FAIL_CHUNK", "fail_chunk");
+	__mock_read_env("TTS_MOCK_CANCEL_DELAY", "cancel_delay");
+	__mock_read_env("TTS_MOCK_PRELOAD_LATENCY", "preload_latency");
+	__mock_read_env("TTS_MOCK_SEED", "seed");
+
+	memset(pefuncs, 0, sizeof(ttspe_funcs_s));
+	pefuncs->size = sizeof(ttspe_funcs_s);
+	pefuncs->version = TTSP_VERSION_3;
+
+	pefuncs->initialize = __mock_initialize;
+	pefuncs->deinitialize = __mock_deinitialize;
+	pefuncs->foreach_voices = __mock_foreach_voices;
+	pefuncs->is_valid_voice = __mock_is_valid_voice;
+	pefuncs->get_audio_format = __mock_get_audio_format;
+	pefuncs->start_synth = __mock_start_synthesis;
+	pefuncs->cancel_synth = __mock_cancel_synthesis;
+	pefuncs->foreach_engine_setting = __mock_foreach_engine_settings;
+	pefuncs->set_engine_setting = __mock_set_engine_setting;
+
+	pefuncs->capability = TTSP_CAPABILITY_THREAD_SAFE;
+	pefuncs->chunk_size = (unsigned int)g_config.chunk_size;
+	pefuncs->preload_voice = __mock_preload_voice;
+	pefuncs->open_stream = __mock_open_stream;
+	pefuncs->push_stream = __mock_push_stream;
+	pefuncs->close_stream = __mock_close_stream;
+	pefuncs->estimate_cost = __mock_estimate_cost;
+	pefuncs->start_batch = __mock_start_batch;
+
+	SLOG(LOG_DEBUG, TAG_MOCK, "[Mock] Load engine : first latency(%d), rtf(%.3f), chunk size(%d), fail rate(%d), cancel delay(%d)",
+		g_config.first_latency, g_config.rtf, __mock_get_chunk_size(), g_config.fail_rate, g_config.cancel_delay);
+
+	return TTSP_ERROR_NONE;
+}
+
+void ttsp_unload_engine(void)
+{
+	if (true == g_is_initialized)
+		__mock_deinitialize();
+
+	g_alloc_buffer = NULL;
+}
+
+/* Exported so that daemon gives buffers of version 2 in ttsp_load_engine() */
+int ttsp_get_capability(int* capability)
+{
+	if (NULL == capability)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	*capability = TTSP_CAPABILITY_THREAD_SAFE;
+
+	return TTSP_ERROR_NONE;
+}
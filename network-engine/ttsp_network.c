@@ -0,0 +1,1344 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+/*
+* Network engine adapter.
+*
+* Engine which synthesizes text on a TTS server over HTTP/1.1, so that a cloud engine needs only a server
+* or a proxy of this protocol instead of its own plugin.
+*
+*	POST <path>?lang=<language>&type=<voice type>&speed=<speed> HTTP/1.1
+*	Content-Type: text/plain; charset=utf-8
+*
+*	<text>
+*
+* Response body is raw 16 bit little endian mono PCM with Content-Length or chunked transfer encoding,
+* and it is passed to the daemon as soon as it arrives. Status other than 200 fails the synthesis.
+*
+* Connections are kept alive in a pool, and requests are pipelined on a connection which has been reused
+* once. Cancel aborts connections which have requests in flight. Request which has no response yet is sent
+* again on other connection if its connection is closed. Settings are also read from environment variables.
+*
+*	url		TTS_NETWORK_URL			http://host[:port]/path of server
+*	voices		TTS_NETWORK_VOICES		voices of server, "language:type" separated by ','
+*	sample_rate	TTS_NETWORK_SAMPLE_RATE		sample rate of audio
+*	max_connections	TTS_NETWORK_MAX_CONNECTIONS	connections to server at once
+*	pipeline_depth	TTS_NETWORK_PIPELINE_DEPTH	requests on a connection waiting for response
+*	connect_timeout	TTS_NETWORK_CONNECT_TIMEOUT	msec to connect
+*	read_timeout	TTS_NETWORK_READ_TIMEOUT	msec without data while response is waited
+*	idle_timeout	TTS_NETWORK_IDLE_TIMEOUT	msec which idle connection is kept
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <dlog.h>
+
+#include "ttsp.h"
+
+#define TAG_NET			"ttsp-network"
+
+#define NET_ENGINE_UUID		"A41F0C6E-3D8B-4E27-9F15-6B2C7D8E9A03"
+#define NET_ENGINE_NAME		"Network TTS Engine"
+
+#define NET_URL_DEFAULT		"http://127.0.0.1:8080/synthesize"
+#define NET_VOICES_DEFAULT	"en_US:2"
+#define NET_VOICE_MAX		32
+#define NET_LANGUAGE_MAX	16
+#define NET_CONNECTION_MAX	8
+#define NET_RETRY_MAX		1
+#define NET_READ_SIZE		16384
+#define NET_HEADER_MAX		8192
+#define NET_LINE_MAX		256
+
+typedef struct {
+	char			language[NET_LANGUAGE_MAX];
+	ttsp_voice_type_e	type;
+} net_voice_s;
+
+typedef struct {
+	int		sample_rate;
+	int		max_connections;
+	int		pipeline_depth;
+	int		connect_timeout;
+	int		read_timeout;
+	int		idle_timeout;
+} net_config_s;
+
+/* Request of a text, owned by pending queue or by a connection */
+typedef struct net_request_s {
+	struct net_request_s*	next;
+	void*		user_data;
+	char*		data;		/**< Whole HTTP request */
+	size_t		size;
+	int		retry;
+	int		chunk_count;	/**< Results passed to daemon */
+	bool		is_answered;	/**< Response of the request is being received */
+} net_request_s;
+
+typedef enum {
+	NET_PARSE_STATUS = 0,
+	NET_PARSE_HEADER,
+	NET_PARSE_BODY,
+	NET_PARSE_CHUNK_SIZE,
+	NET_PARSE_CHUNK_DATA,
+	NET_PARSE_CHUNK_END,
+	NET_PARSE_TRAILER
+} net_parse_e;
+
+typedef struct {
+	int		fd;			/**< -1 if the slot is not used */
+	bool		is_connected;
+	bool		is_reused;		/**< A response is received with keep-alive, pipelining is allowed */
+	long long	deadline;		/**< msec, connect, read or idle timeout */
+
+	/* requests in order of responses, the first one is being answered */
+	net_request_s*	head;
+	net_request_s*	tail;
+	int		count;
+
+	/* requests which are not written yet */
+	char*		out;
+	size_t		out_len;
+	size_t		out_pos;
+
+	/* response parser */
+	net_parse_e	parse;
+	char		line[NET_HEADER_MAX];
+	size_t		line_len;
+	int		status;
+	bool		is_chunked;
+	bool		is_close;		/**< Server closes connection after response */
+	long long	body_left;		/**< Bytes of body or chunk, -1 until connection is closed */
+	unsigned char	odd_byte;		/**< Half of sample split by network */
+	bool		has_odd_byte;
+} net_conn_s;
+
+static net_config_s g_config = {16000, 2, 4, 3000, 10000, 30000};
+
+static char* g_url = NULL;
+static char* g_host = NULL;
+static char* g_port = NULL;
+static char* g_path = NULL;
+
+static net_voice_s g_voices[NET_VOICE_MAX];
+static int g_voice_count = 0;
+
+static ttspe_result_cb g_result_cb = NULL;
+
+static ttspd_alloc_buffer g_alloc_buffer = NULL;
+static unsigned int g_daemon_chunk_size = 0;
+
+static bool g_is_initialized = false;
+
+/* Requests which are not given to connection yet */
+static net_request_s* g_pending_head = NULL;
+static net_request_s* g_pending_tail = NULL;
+
+static net_conn_s g_conns[NET_CONNECTION_MAX];
+
+/* Cancel is requested by increasing generation, and the I/O thread answers with the same number */
+static unsigned int g_cancel_gen = 0;
+static unsigned int g_cancel_done = 0;
+
+static bool g_is_exit = false;
+static bool g_is_preconnect = false;
+static int g_wake_pipe[2] = {-1, -1};
+
+static pthread_t g_io_thread;
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_cond = PTHREAD_COND_INITIALIZER;
+
+
+static long long __net_get_time()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static void __net_wake_up()
+{
+	char ch = 0;
+	if (0 <= g_wake_pipe[1] && 0 > write(g_wake_pipe[1], &ch, 1) && EAGAIN != errno)
+		SLOG(LOG_WARN, TAG_NET, "[Network WARNING] Fail to wake up I/O thread : %s", strerror(errno));
+}
+
+/*
+* Settings
+*/
+
+/* Split url to host, port and path. Only http is supported, TLS is terminated by a local proxy. */
+static int __net_parse_url(const char* url)
+{
+	const char* scheme = "http://";
+	if (0 != strncasecmp(url, scheme, strlen(scheme)))
+		return -1;
+
+	const char* host = url + strlen(scheme);
+	const char* path = strchr(host, '/');
+	if (NULL == path)
+		path = host + strlen(host);
+
+	const char* port = memchr(host, ':', path - host);
+	const char* host_end = (NULL != port) ? port : path;
+	if (host_end == host)
+		return -1;
+
+	free(g_host);
+	free(g_port);
+	free(g_path);
+
+	g_host = strndup(host, host_end - host);
+	g_port = (NULL != port) ? strndup(port + 1, path - port - 1) : strdup("80");
+	g_path = strdup('\0' != path[0] ? path : "/");
+
+	return 0;
+}
+
+static int __net_parse_voices(const char* value)
+{
+	net_voice_s voices[NET_VOICE_MAX];
+	int count = 0;
+	const char* item = value;
+
+	while ('\0' != *item && count < NET_VOICE_MAX) {
+		const char* end = strchr(item, ',');
+		if (NULL == end)
+			end = item + strlen(item);
+
+		const char* colon = memchr(item, ':', end - item);
+		size_t len = (NULL != colon) ? (size_t)(colon - item) : (size_t)(end - item);
+		if (0 == len || NET_LANGUAGE_MAX <= len)
+			return -1;
+
+		memcpy(voices[count].language, item, len);
+		voices[count].language[len] = '\0';
+		voices[count].type = (NULL != colon) ? (ttsp_voice_type_e)atoi(colon + 1) : TTSP_VOICE_TYPE_FEMALE;
+		if (TTSP_VOICE_TYPE_MALE > voices[count].type || TTSP_VOICE_TYPE_USER3 < voices[count].type)
+			return -1;
+
+		count++;
+		item = ('\0' != *end) ? end + 1 : end;
+	}
+
+	if (0 == count)
+		return -1;
+
+	memcpy(g_voices, voices, sizeof(net_voice_s) * count);
+	g_voice_count = count;
+
+	return 0;
+}
+
+static int __net_set_setting(const char* key, const char* value)
+{
+	if (0 == strcmp(key, "url")) {
+		if (0 != __net_parse_url(value))
+			return TTSP_ERROR_INVALID_PARAMETER;
+		free(g_url);
+		g_url = strdup(value);
+		return TTSP_ERROR_NONE;
+	}
+
+	if (0 == strcmp(key, "voices"))
+		return (0 == __net_parse_voices(value)) ? TTSP_ERROR_NONE : TTSP_ERROR_INVALID_PARAMETER;
+
+	int number = atoi(value);
+	int* target = NULL;
+
+	if (0 == strcmp(key, "sample_rate"))		target = &g_config.sample_rate;
+	else if (0 == strcmp(key, "max_connections"))	target = &g_config.max_connections;
+	else if (0 == strcmp(key, "pipeline_depth"))	target = &g_config.pipeline_depth;
+	else if (0 == strcmp(key, "connect_timeout"))	target = &g_config.connect_timeout;
+	else if (0 == strcmp(key, "read_timeout"))	target = &g_config.read_timeout;
+	else if (0 == strcmp(key, "idle_timeout"))	target = &g_config.idle_timeout;
+
+	if (NULL == target || 0 >= number)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	if (&g_config.max_connections == target && NET_CONNECTION_MAX < number)
+		number = NET_CONNECTION_MAX;
+
+	*target = number;
+
+	return TTSP_ERROR_NONE;
+}
+
+/*
+* Requests
+*/
+
+static void __net_append_encoded(char* out, size_t size, const char* value)
+{
+	size_t len = strlen(out);
+
+	while ('\0' != *value && len + 4 < size) {
+		unsigned char ch = (unsigned char)*value++;
+		if (isalnum(ch) || '_' == ch || '-' == ch || '.' == ch) {
+			out[len++] = ch;
+		} else {
+			len += snprintf(out + len, size - len, "%%%02X", ch);
+		}
+	}
+	out[len] = '\0';
+}
+
+static net_request_s* __net_new_request(const char* language, ttsp_voice_type_e type, const char* text, ttsp_speed_e speed, void* user_data)
+{
+	char target[NET_LINE_MAX];
+	snprintf(target, sizeof(target), "%s%slang=", g_path, (NULL != strchr(g_path, '?')) ? "&" : "?");
+	__net_append_encoded(target, sizeof(target), language);
+	snprintf(target + strlen(target), sizeof(target) - strlen(target), "&type=%d&speed=%d", type, speed);
+
+	size_t text_len = strlen(text);
+	char head[NET_HEADER_MAX];
+	int head_len = snprintf(head, sizeof(head),
+		"POST %s HTTP/1.1\r\n"
+		"Host: %s:%s\r\n"
+		"Content-Type: text/plain; charset=utf-8\r\n"
+		"Content-Length: %zu\r\n"
+		"Connection: keep-alive\r\n"
+		"\r\n", target, g_host, g_port, text_len);
+	if (0 > head_len || (int)sizeof(head) <= head_len)
+		return NULL;
+
+	net_request_s* request = (net_request_s*)calloc(1, sizeof(net_request_s));
+	if (NULL == request)
+		return NULL;
+
+	request->size = head_len + text_len;
+	request->data = (char*)malloc(request->size);
+	if (NULL == request->data) {
+		free(request);
+		return NULL;
+	}
+
+	memcpy(request->data, head, head_len);
+	memcpy(request->data + head_len, text, text_len);
+	request->user_data = user_data;
+
+	return request;
+}
+
+static void __net_free_request(net_request_s* request)
+{
+	free(request->data);
+	free(request);
+}
+
+/* Last event of request. It is called in I/O thread without mutex. */
+static void __net_finish_request(net_request_s* request, ttsp_result_event_e event)
+{
+	g_result_cb(event, NULL, 0, request->user_data);
+	__net_free_request(request);
+}
+
+/* Put requests back in front of pending queue, in order */
+static void __net_requeue(net_request_s* first)
+{
+	net_request_s* fail_list = NULL;
+	net_request_s* last = NULL;
+	net_request_s* request = first;
+	net_request_s* retry_head = NULL;
+
+	while (NULL != request) {
+		net_request_s* next = request->next;
+		request->next = NULL;
+
+		if (NET_RETRY_MAX < ++request->retry) {
+			request->next = fail_list;
+			fail_list = request;
+		} else {
+			if (NULL == retry_head)
+				retry_head = request;
+			else
+				last->next = request;
+			last = request;
+		}
+		request = next;
+	}
+
+	if (NULL != retry_head) {
+		pthread_mutex_lock(&g_mutex);
+		last->next = g_pending_head;
+		g_pending_head = retry_head;
+		if (NULL == g_pending_tail)
+			g_pending_tail = last;
+		pthread_mutex_unlock(&g_mutex);
+	}
+
+	while (NULL != fail_list) {
+		net_request_s* next = fail_list->next;
+		SLOG(LOG_ERROR, TAG_NET, "[Network ERROR] Request fails after retry");
+		__net_finish_request(fail_list, TTSP_RESULT_EVENT_FAIL);
+		fail_list = next;
+	}
+}
+
+/*
+* Connections, used only in I/O thread
+*/
+
+static void __net_reset_parser(net_conn_s* conn)
+{
+	conn->parse = NET_PARSE_STATUS;
+	conn->line_len = 0;
+	conn->status = 0;
+	conn->is_chunked = false;
+	conn->is_close = false;
+	conn->body_left = -1;
+	conn->has_odd_byte = false;
+}
+
+/* Close connection. Requests without response are returned, they can be sent again. */
+static net_request_s* __net_close_conn(net_conn_s* conn)
+{
+	if (0 <= conn->fd)
+		close(conn->fd);
+
+	net_request_s* requests = conn->head;
+
+	free(conn->out);
+	memset(conn, 0, sizeof(net_conn_s));
+	conn->fd = -1;
+
+	return requests;
+}
+
+/* Connection is broken. Request being answered fails, others are sent again. */
+static void __net_abort_conn(net_conn_s* conn, const char* reason, bool is_head_failed)
+{
+	SLOG(LOG_WARN, TAG_NET, "[Network WARNING] Connection is closed : %s, requests(%d)", reason, conn->count);
+
+	net_request_s* requests = __net_close_conn(conn);
+
+	if (NULL != requests && (true == is_head_failed || true == requests->is_answered)) {
+		net_request_s* answered = requests;
+		requests = requests->next;
+		__net_finish_request(answered, TTSP_RESULT_EVENT_FAIL);
+	}
+
+	__net_requeue(requests);
+}
+
+static int __net_open_conn(net_conn_s* conn)
+{
+	struct addrinfo hints;
+	struct addrinfo* result = NULL;
+	char host[NET_LINE_MAX];
+	char port[NET_LANGUAGE_MAX];
+
+	/* url can be changed by setting */
+	pthread_mutex_lock(&g_mutex);
+	snprintf(host, sizeof(host), "%s", g_host);
+	snprintf(port, sizeof(port), "%s", g_port);
+	pthread_mutex_unlock(&g_mutex);
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	int ret = getaddrinfo(host, port, &hints, &result);
+	if (0 != ret || NULL == result) {
+		SLOG(LOG_ERROR, TAG_NET, "[Network ERROR] Fail to resolve %s : %s", host, gai_strerror(ret));
+		return -1;
+	}
+
+	int fd = socket(result->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (0 > fd) {
+		freeaddrinfo(result);
+		return -1;
+	}
+
+	int flag = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+	ret = connect(fd, result->ai_addr, result->ai_addrlen);
+	freeaddrinfo(result);
+
+	if (0 != ret && EINPROGRESS != errno) {
+		SLOG(LOG_ERROR, TAG_NET, "[Network ERROR] Fail to connect %s:%s : %s", host, port, strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	memset(conn, 0, sizeof(net_conn_s));
+	conn->fd = fd;
+	conn->is_connected = (0 == ret);
+	conn->deadline = __net_get_time() + g_config.connect_timeout;
+	__net_reset_parser(conn);
+
+	SLOG(LOG_DEBUG, TAG_NET, "[Network] Open connection to %s:%s", host, port);
+
+	return 0;
+}
+
+static int __net_add_to_conn(net_conn_s* conn, net_request_s* request)
+{
+	char* out = (char*)realloc(conn->out, conn->out_len + request->size);
+	if (NULL == out)
+		return -1;
+
+	memcpy(out + conn->out_len, request->data, request->size);
+	conn->out = out;
+	conn->out_len += request->size;
+
+	request->next = NULL;
+	if (NULL == conn->tail)
+		conn->head = request;
+	else
+		conn->tail->next = request;
+	conn->tail = request;
+
+	/* idle connection starts to wait for response */
+	if (0 == conn->count++ && true == conn->is_connected)
+		conn->deadline = __net_get_time() + g_config.read_timeout;
+
+	return 0;
+}
+
+static int __net_count_conns()
+{
+	int count = 0;
+	int i;
+
+	for (i = 0; i < NET_CONNECTION_MAX; i++) {
+		if (0 <= g_conns[i].fd)
+			count++;
+	}
+
+	return count;
+}
+
+/* Idle connection first, then new connection, then pipelining on reused connection */
+static net_conn_s* __net_select_conn()
+{
+	net_conn_s* best = NULL;
+	net_conn_s* free_slot = NULL;
+	int open_count = 0;
+	int i;
+
+	for (i = 0; i < NET_CONNECTION_MAX; i++) {
+		net_conn_s* conn = &g_conns[i];
+		if (0 > conn->fd) {
+			if (NULL == free_slot)
+				free_slot = conn;
+			continue;
+		}
+
+		open_count++;
+		if (0 == conn->count)
+			return conn;
+
+		if (true == conn->is_reused && false == conn->is_close && conn->count < g_config.pipeline_depth &&
+		    (NULL == best || conn->count < best->count))
+			best = conn;
+	}
+
+	if (NULL != free_slot && open_count < g_config.max_connections) {
+		if (0 == __net_open_conn(free_slot))
+			return free_slot;
+	}
+
+	return best;
+}
+
+/* Give pending requests to connections. Request fails if server is not reachable. */
+static void __net_dispatch()
+{
+	while (true) {
+		pthread_mutex_lock(&g_mutex);
+		net_request_s* request = g_pending_head;
+		pthread_mutex_unlock(&g_mutex);
+
+		if (NULL == request)
+			return;
+
+		net_conn_s* conn = __net_select_conn();
+		bool is_unreachable = (NULL == conn && 0 == __net_count_conns());
+
+		if (NULL == conn && false == is_unreachable)
+			return;
+
+		pthread_mutex_lock(&g_mutex);
+		g_pending_head = request->next;
+		if (NULL == g_pending_head)
+			g_pending_tail = NULL;
+		pthread_mutex_unlock(&g_mutex);
+
+		if (true == is_unreachable || 0 != __net_add_to_conn(conn, request)) {
+			__net_finish_request(request, TTSP_RESULT_EVENT_FAIL);
+		}
+	}
+}
+
+/*
+* Response
+*/
+
+/* Pass body of response to daemon in pieces of its chunk size. Returns false if daemon does not want more. */
+static bool __net_emit(net_conn_s* conn, const char* data, size_t len)
+{
+	net_request_s* request = conn->head;
+
+	/* body of error is dropped */
+	if (200 != conn->status)
+		return true;
+
+	while (0 < len) {
+		size_t size = (len + (true == conn->has_odd_byte ? 1 : 0)) & ~(size_t)1;
+		if (0 < g_daemon_chunk_size && size > g_daemon_chunk_size)
+			size = g_daemon_chunk_size & ~1u;
+
+		if (0 == size) {
+			conn->odd_byte = (unsigned char)data[0];
+			conn->has_odd_byte = true;
+			return true;
+		}
+
+		bool is_daemon_buffer = false;
+		char* buffer = NULL;
+		if (NULL != g_alloc_buffer) {
+			buffer = (char*)g_alloc_buffer((unsigned int)size);
+			is_daemon_buffer = (NULL != buffer);
+		}
+		if (NULL == buffer)
+			buffer = (char*)malloc(size);
+		if (NULL == buffer)
+			return false;
+
+		size_t used = size;
+		if (true == conn->has_odd_byte) {
+			buffer[0] = (char)conn->odd_byte;
+			memcpy(buffer + 1, data, size - 1);
+			conn->has_odd_byte = false;
+			used = size - 1;
+		} else {
+			memcpy(buffer, data, size);
+		}
+		data += used;
+		len -= used;
+
+		ttsp_result_event_e event = (0 == request->chunk_count++) ? TTSP_RESULT_EVENT_START : TTSP_RESULT_EVENT_CONTINUE;
+		bool ret = g_result_cb(event, buffer, (unsigned int)size, request->user_data);
+
+		/* buffer of daemon belongs to daemon after callback */
+		if (false == is_daemon_buffer)
+			free(buffer);
+
+		if (false == ret)
+			return false;
+	}
+
+	return true;
+}
+
+/* Response of head request is done. Returns true if connection should be closed. */
+static bool __net_complete_response(net_conn_s* conn)
+{
+	net_request_s* request = conn->head;
+	bool is_ok = (200 == conn->status);
+	bool is_close = conn->is_close;
+
+	conn->head = request->next;
+	if (NULL == conn->head)
+		conn->tail = NULL;
+	conn->count--;
+
+	__net_reset_parser(conn);
+	if (false == is_close)
+		conn->is_reused = true;
+	conn->deadline = __net_get_time() + ((0 < conn->count) ? g_config.read_timeout : g_config.idle_timeout);
+
+	if (false == is_ok)
+		SLOG(LOG_ERROR, TAG_NET, "[Network ERROR] Server fails synthesis : status(%d)", conn->status);
+
+	__net_finish_request(request, (true == is_ok) ? TTSP_RESULT_EVENT_FINISH : TTSP_RESULT_EVENT_FAIL);
+
+	return is_close;
+}
+
+/* Returns 0 to go on, 1 if response is done, -1 on protocol error */
+static int __net_handle_line(net_conn_s* conn, const char* line)
+{
+	switch (conn->parse) {
+	case NET_PARSE_STATUS: {
+		int minor = 0;
+		if (2 != sscanf(line, "HTTP/1.%d %d", &minor, &conn->status))
+			return -1;
+		conn->is_close = (0 == minor);
+		conn->parse = NET_PARSE_HEADER;
+		return 0;
+	}
+
+	case NET_PARSE_HEADER:
+		if ('\0' == line[0]) {
+			/* interim response */
+			if (100 <= conn->status && 200 > conn->status) {
+				__net_reset_parser(conn);
+				return 0;
+			}
+
+			if (204 == conn->status || 304 == conn->status || 0 == conn->body_left)
+				return 1;
+
+			if (true == conn->is_chunked) {
+				conn->parse = NET_PARSE_CHUNK_SIZE;
+			} else {
+				/* body without length ends with connection */
+				if (0 > conn->body_left)
+					conn->is_close = true;
+				conn->parse = NET_PARSE_BODY;
+			}
+			return 0;
+		}
+
+		if (0 == strncasecmp(line, "Content-Length:", strlen("Content-Length:"))) {
+			conn->body_left = atoll(line + strlen("Content-Length:"));
+		} else if (0 == strncasecmp(line, "Transfer-Encoding:", strlen("Transfer-Encoding:"))) {
+			conn->is_chunked = (NULL != strcasestr(line, "chunked"));
+		} else if (0 == strncasecmp(line, "Connection:", strlen("Connection:"))) {
+			if (NULL != strcasestr(line, "close"))
+				conn->is_close = true;
+			else if (NULL != strcasestr(line, "keep-alive"))
+				conn->is_close = false;
+		}
+		return 0;
+
+	case NET_PARSE_CHUNK_SIZE: {
+		char* end = NULL;
+		long long size = strtoll(line, &end, 16);
+		if (end == line || 0 > size)
+			return -1;
+
+		conn->body_left = size;
+		conn->parse = (0 == size) ? NET_PARSE_TRAILER : NET_PARSE_CHUNK_DATA;
+		return 0;
+	}
+
+	case NET_PARSE_CHUNK_END:
+		if ('\0' != line[0])
+			return -1;
+		conn->parse = NET_PARSE_CHUNK_SIZE;
+		return 0;
+
+	case NET_PARSE_TRAILER:
+		return ('\0' == line[0]) ? 1 : 0;
+
+	default:
+		return -1;
+	}
+}
+
+/* Returns 0 to go on, 1 if connection should be closed, -1 on error */
+static int __net_handle_input(net_conn_s* conn, const char* data, size_t len)
+{
+	size_t pos = 0;
+
+	while (pos < len) {
+		if (NULL == conn->head)
+			return -1;
+
+		conn->head->is_answered = true;
+
+		if (NET_PARSE_BODY == conn->parse || NET_PARSE_CHUNK_DATA == conn->parse) {
+			size_t count = len - pos;
+			if (0 <= conn->body_left && (long long)count > conn->body_left)
+				count = (size_t)conn->body_left;
+
+			if (false == __net_emit(conn, data + pos, count))
+				return -1;
+
+			pos += count;
+			if (0 <= conn->body_left)
+				conn->body_left -= count;
+
+			if (0 == conn->body_left) {
+				if (NET_PARSE_CHUNK_DATA == conn->parse) {
+					conn->parse = NET_PARSE_CHUNK_END;
+				} else if (true == __net_complete_response(conn)) {
+					return 1;
+				}
+			}
+			continue;
+		}
+
+		char ch = data[pos++];
+		if ('\n' != ch) {
+			if (conn->line_len + 1 >= sizeof(conn->line))
+				return -1;
+			conn->line[conn->line_len++] = ch;
+			continue;
+		}
+
+		if (0 < conn->line_len && '\r' == conn->line[conn->line_len - 1])
+			conn->line_len--;
+		conn->line[conn->line_len] = '\0';
+		conn->line_len = 0;
+
+		int ret = __net_handle_line(conn, conn->line);
+		if (0 > ret)
+			return -1;
+
+		if (1 == ret && true == __net_complete_response(conn))
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+* I/O thread
+*/
+
+/* Abort connections which have requests in flight, and cancel all requests */
+static void __net_cancel_all(net_request_s* pending, bool is_exit)
+{
+	net_request_s* list = pending;
+	int count = 0;
+	int i;
+
+	for (i = 0; i < NET_CONNECTION_MAX; i++) {
+		net_conn_s* conn = &g_conns[i];
+		if (0 > conn->fd || (0 == conn->count && false == is_exit))
+			continue;
+
+		net_request_s* requests = __net_close_conn(conn);
+		while (NULL != requests) {
+			net_request_s* next = requests->next;
+			requests->next = list;
+			list = requests;
+			requests = next;
+		}
+	}
+
+	while (NULL != list) {
+		net_request_s* next = list->next;
+		__net_finish_request(list, TTSP_RESULT_EVENT_CANCEL);
+		list = next;
+		count++;
+	}
+
+	SLOG(LOG_DEBUG, TAG_NET, "[Network] Requests are canceled : count(%d)", count);
+}
+
+static void __net_handle_conn(net_conn_s* conn, short revents, char* buffer, size_t size)
+{
+	if (false == conn->is_connected) {
+		if (0 == (revents & (POLLOUT | POLLERR | POLLHUP)))
+			return;
+
+		int error = 0;
+		socklen_t len = sizeof(error);
+		if (0 != getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &error, &len) || 0 != error) {
+			__net_abort_conn(conn, "fail to connect", false);
+			return;
+		}
+
+		conn->is_connected = true;
+		conn->deadline = __net_get_time() + ((0 < conn->count) ? g_config.read_timeout : g_config.idle_timeout);
+	}
+
+	if (0 != (revents & POLLOUT) && conn->out_pos < conn->out_len) {
+		ssize_t written = send(conn->fd, conn->out + conn->out_pos, conn->out_len - conn->out_pos, MSG_NOSIGNAL);
+		if (0 > written && EAGAIN != errno && EINTR != errno) {
+			__net_abort_conn(conn, "fail to send", false);
+			return;
+		}
+
+		if (0 < written)
+			conn->out_pos += written;
+
+		if (conn->out_pos == conn->out_len) {
+			free(conn->out);
+			conn->out = NULL;
+			conn->out_len = 0;
+			conn->out_pos = 0;
+		}
+	}
+
+	if (0 == (revents & (POLLIN | POLLHUP | POLLERR)))
+		return;
+
+	ssize_t count = recv(conn->fd, buffer, size, 0);
+	if (0 > count) {
+		if (EAGAIN != errno && EINTR != errno)
+			__net_abort_conn(conn, "fail to receive", false);
+		return;
+	}
+
+	if (0 == count) {
+		/* body without length is done by end of connection */
+		if (NULL != conn->head && NET_PARSE_BODY == conn->parse && 0 > conn->body_left) {
+			__net_complete_response(conn);
+			__net_requeue(__net_close_conn(conn));
+		} else if (0 < conn->count) {
+			__net_abort_conn(conn, "closed by server", false);
+		} else {
+			__net_close_conn(conn);
+		}
+		return;
+	}
+
+	if (0 < conn->count)
+		conn->deadline = __net_get_time() + g_config.read_timeout;
+
+	int ret = __net_handle_input(conn, buffer, (size_t)count);
+	if (0 > ret) {
+		__net_abort_conn(conn, "invalid response", false);
+	} else if (1 == ret) {
+		/* requests after the response are sent again on other connection */
+		__net_requeue(__net_close_conn(conn));
+	}
+}
+
+static void* __net_io_thread(void* arg)
+{
+	char* buffer = (char*)malloc(NET_READ_SIZE);
+	if (NULL == buffer)
+		return NULL;
+
+	while (true) {
+		pthread_mutex_lock(&g_mutex);
+		bool is_exit = g_is_exit;
+		bool is_preconnect = g_is_preconnect;
+		unsigned int cancel_gen = g_cancel_gen;
+		bool is_canceled = (cancel_gen != g_cancel_done);
+		net_request_s* pending = NULL;
+
+		if (true == is_exit || true == is_canceled) {
+			pending = g_pending_head;
+			g_pending_head = NULL;
+			g_pending_tail = NULL;
+		}
+		g_is_preconnect = false;
+		pthread_mutex_unlock(&g_mutex);
+
+		if (true == is_exit || true == is_canceled) {
+			__net_cancel_all(pending, is_exit);
+
+			pthread_mutex_lock(&g_mutex);
+			g_cancel_done = cancel_gen;
+			pthread_cond_broadcast(&g_cond);
+			pthread_mutex_unlock(&g_mutex);
+
+			if (true == is_exit)
+				break;
+		}
+
+		/* connection is ready before first text */
+		if (true == is_preconnect && 0 == __net_count_conns())
+			__net_open_conn(&g_conns[0]);
+
+		__net_dispatch();
+
+		struct pollfd fds[NET_CONNECTION_MAX + 1];
+		net_conn_s* conns[NET_CONNECTION_MAX + 1];
+		int count = 1;
+		int i;
+
+		fds[0].fd = g_wake_pipe[0];
+		fds[0].events = POLLIN;
+		fds[0].revents = 0;
+		conns[0] = NULL;
+
+		long long now = __net_get_time();
+		long long next = -1;
+
+		for (i = 0; i < NET_CONNECTION_MAX; i++) {
+			net_conn_s* conn = &g_conns[i];
+			if (0 > conn->fd)
+				continue;
+
+			fds[count].fd = conn->fd;
+			fds[count].events = (true == conn->is_connected) ? POLLIN : 0;
+			if (false == conn->is_connected || conn->out_pos < conn->out_len)
+				fds[count].events |= POLLOUT;
+			fds[count].revents = 0;
+			conns[count] = conn;
+			count++;
+
+			if (0 > next || conn->deadline < next)
+				next = conn->deadline;
+		}
+
+		int timeout = -1;
+		if (0 <= next)
+			timeout = (next > now) ? (int)(next - now) : 0;
+
+		if (0 > poll(fds, count, timeout) && EINTR != errno) {
+			SLOG(LOG_ERROR, TAG_NET, "[Network ERROR] Fail to poll : %s", strerror(errno));
+			continue;
+		}
+
+		if (0 != (fds[0].revents & POLLIN)) {
+			char drain[64];
+			while (0 < read(g_wake_pipe[0], drain, sizeof(drain)));
+		}
+
+		for (i = 1; i < count; i++) {
+			net_conn_s* conn = conns[i];
+			if (0 != fds[i].revents)
+				__net_handle_conn(conn, fds[i].revents, buffer, NET_READ_SIZE);
+
+			if (0 > conn->fd || __net_get_time() < conn->deadline)
+				continue;
+
+			if (0 == conn->count) {
+				SLOG(LOG_DEBUG, TAG_NET, "[Network] Close idle connection");
+				__net_close_conn(conn);
+			} else {
+				__net_abort_conn(conn, "timeout", true);
+			}
+		}
+	}
+
+	free(buffer);
+
+	return NULL;
+}
+
+/*
+* Engine functions
+*/
+
+static int __net_initialize(ttspe_result_cb callback)
+{
+	if (NULL == callback)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	if (true == g_is_initialized)
+		return TTSP_ERROR_INVALID_STATE;
+
+	if (0 != pipe2(g_wake_pipe, O_NONBLOCK | O_CLOEXEC)) {
+		SLOG(LOG_ERROR, TAG_NET, "[Network ERROR] Fail to create pipe : %s", strerror(errno));
+		return TTSP_ERROR_OPERATION_FAILED;
+	}
+
+	int i;
+	for (i = 0; i < NET_CONNECTION_MAX; i++) {
+		memset(&g_conns[i], 0, sizeof(net_conn_s));
+		g_conns[i].fd = -1;
+	}
+
+	g_result_cb = callback;
+	g_is_exit = false;
+	g_cancel_done = g_cancel_gen;
+
+	if (0 != pthread_create(&g_io_thread, NULL, __net_io_thread, NULL)) {
+		SLOG(LOG_ERROR, TAG_NET, "[Network ERROR] Fail to create I/O thread");
+		close(g_wake_pipe[0]);
+		close(g_wake_pipe[1]);
+		g_wake_pipe[0] = g_wake_pipe[1] = -1;
+		return TTSP_ERROR_OPERATION_FAILED;
+	}
+
+	g_is_initialized = true;
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __net_deinitialize(void)
+{
+	if (false == g_is_initialized)
+		return TTSP_ERROR_INVALID_STATE;
+
+	pthread_mutex_lock(&g_mutex);
+	g_is_exit = true;
+	pthread_mutex_unlock(&g_mutex);
+
+	__net_wake_up();
+	pthread_join(g_io_thread, NULL);
+
+	close(g_wake_pipe[0]);
+	close(g_wake_pipe[1]);
+	g_wake_pipe[0] = g_wake_pipe[1] = -1;
+
+	g_is_initialized = false;
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __net_foreach_voices(ttspe_supported_voice_cb callback, void* user_data)
+{
+	if (NULL == callback)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	int i;
+	for (i = 0; i < g_voice_count; i++) {
+		if (false == callback(g_voices[i].language, g_voices[i].type, user_data))
+			break;
+	}
+
+	return TTSP_ERROR_NONE;
+}
+
+static bool __net_is_valid_voice(const char* language, ttsp_voice_type_e type)
+{
+	if (NULL == language)
+		return false;
+
+	int i;
+	for (i = 0; i < g_voice_count; i++) {
+		if (0 == strcmp(g_voices[i].language, language) && g_voices[i].type == type)
+			return true;
+	}
+
+	return false;
+}
+
+static int __net_get_audio_format(ttsp_audio_type_e* audio_type, int* rate, int* channel)
+{
+	if (NULL == audio_type || NULL == rate || NULL == channel)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	*audio_type = TTSP_AUDIO_TYPE_RAW;
+	*rate = g_config.sample_rate;
+	*channel = 1;
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __net_start_synthesis(const char* language, ttsp_voice_type_e type, const char* text, ttsp_speed_e speed, void* user_data)
+{
+	if (false == g_is_initialized)
+		return TTSP_ERROR_INVALID_STATE;
+
+	if (NULL == language || NULL == text)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	if (false == __net_is_valid_voice(language, type))
+		return TTSP_ERROR_INVALID_VOICE;
+
+	pthread_mutex_lock(&g_mutex);
+
+	net_request_s* request = __net_new_request(language, type, text, speed, user_data);
+	if (NULL == request) {
+		pthread_mutex_unlock(&g_mutex);
+		return TTSP_ERROR_OUT_OF_MEMORY;
+	}
+
+	if (NULL == g_pending_tail)
+		g_pending_head = request;
+	else
+		g_pending_tail->next = request;
+	g_pending_tail = request;
+
+	pthread_mutex_unlock(&g_mutex);
+
+	__net_wake_up();
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __net_cancel_synthesis(void)
+{
+	if (false == g_is_initialized)
+		return TTSP_ERROR_INVALID_STATE;
+
+	pthread_mutex_lock(&g_mutex);
+	unsigned int cancel_gen = ++g_cancel_gen;
+	pthread_mutex_unlock(&g_mutex);
+
+	__net_wake_up();
+
+	/* called in result callback, requests are canceled after the callback */
+	if (pthread_equal(pthread_self(), g_io_thread))
+		return TTSP_ERROR_NONE;
+
+	pthread_mutex_lock(&g_mutex);
+	while (0 > (int)(g_cancel_done - cancel_gen))
+		pthread_cond_wait(&g_cond, &g_mutex);
+	pthread_mutex_unlock(&g_mutex);
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __net_foreach_engine_settings(ttspe_engine_setting_cb callback, void* user_data)
+{
+	if (NULL == callback)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	char voices[NET_VOICE_MAX * (NET_LANGUAGE_MAX + 4)] = "";
+	char value[32];
+	int i;
+
+	for (i = 0; i < g_voice_count; i++) {
+		snprintf(voices + strlen(voices), sizeof(voices) - strlen(voices), "%s%s:%d",
+			(0 < i) ? "," : "", g_voices[i].language, g_voices[i].type);
+	}
+
+	if (false == callback("url", g_url, user_data) || false == callback("voices", voices, user_data))
+		return TTSP_ERROR_NONE;
+
+	const struct {
+		const char* key;
+		int value;
+	} items[] = {
+		{"sample_rate", g_config.sample_rate},
+		{"max_connections", g_config.max_connections},
+		{"pipeline_depth", g_config.pipeline_depth},
+		{"connect_timeout", g_config.connect_timeout},
+		{"read_timeout", g_config.read_timeout},
+		{"idle_timeout", g_config.idle_timeout},
+	};
+
+	unsigned int j;
+	for (j = 0; j < sizeof(items) / sizeof(items[0]); j++) {
+		snprintf(value, sizeof(value), "%d", items[j].value);
+		if (false == callback(items[j].key, value, user_data))
+			break;
+	}
+
+	return TTSP_ERROR_NONE;
+}
+
+static int __net_set_engine_setting(const char* key, const char* value)
+{
+	if (NULL == key || NULL == value)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	pthread_mutex_lock(&g_mutex);
+	int ret = __net_set_setting(key, value);
+	pthread_mutex_unlock(&g_mutex);
+
+	if (TTSP_ERROR_NONE == ret) {
+		SLOG(LOG_DEBUG, TAG_NET, "[Network] Set setting : %s(%s)", key, value);
+	} else {
+		SLOG(LOG_ERROR, TAG_NET, "[Network ERROR] Invalid setting : %s(%s)", key, value);
+	}
+
+	return ret;
+}
+
+/* Voice is on server, a connection is opened to be reused by first text */
+static int __net_preload_voice(const char* language, ttsp_voice_type_e type)
+{
+	if (false == g_is_initialized)
+		return TTSP_ERROR_INVALID_STATE;
+
+	if (false == __net_is_valid_voice(language, type))
+		return TTSP_ERROR_INVALID_VOICE;
+
+	pthread_mutex_lock(&g_mutex);
+	g_is_preconnect = true;
+	pthread_mutex_unlock(&g_mutex);
+
+	__net_wake_up();
+
+	return TTSP_ERROR_NONE;
+}
+
+static void __net_read_env(const char* name, const char* key)
+{
+	const char* value = getenv(name);
+	if (NULL != value && TTSP_ERROR_NONE != __net_set_setting(key, value))
+		SLOG(LOG_ERROR, TAG_NET, "[Network ERROR] Invalid environment : %s(%s)", name, value);
+}
+
+/*
+* Plugin interface
+*/
+
+int ttsp_get_engine_info(ttsp_engine_info_cb callback, void* user_data)
+{
+	if (NULL == callback)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	callback(NET_ENGINE_UUID, NET_ENGINE_NAME, NULL, true, user_data);
+
+	return TTSP_ERROR_NONE;
+}
+
+int ttsp_load_engine(ttspd_funcs_s* pdfuncs, ttspe_funcs_s* pefuncs)
+{
+	if (NULL == pdfuncs || NULL == pefuncs)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	/* buffers of daemon are used if daemon provides them */
+	g_alloc_buffer = NULL;
+	g_daemon_chunk_size = 0;
+	if (TTSP_VERSION_2 <= pdfuncs->version && TTSPD_FUNCS_V2_SIZE <= pdfuncs->size) {
+		g_alloc_buffer = pdfuncs->alloc_buffer;
+		g_daemon_chunk_size = pdfuncs->chunk_size;
+	}
+
+	__net_set_setting("url", NET_URL_DEFAULT);
+	__net_set_setting("voices", NET_VOICES_DEFAULT);
+
+	__net_read_env("TTS_NETWORK_URL", "url");
+	__net_read_env("TTS_NETWORK_VOICES", "voices");
+	__net_read_env("TTS_NETWORK_SAMPLE_RATE", "sample_rate");
+	__net_read_env("TTS_NETWORK_MAX_CONNECTIONS", "max_connections");
+	__net_read_env("TTS_NETWORK_PIPELINE_DEPTH", "pipeline_depth");
+	__net_read_env("TTS_NETWORK_CONNECT_TIMEOUT", "connect_timeout");
+	__net_read_env("TTS_NETWORK_READ_TIMEOUT", "read_timeout");
+	__net_read_env("TTS_NETWORK_IDLE_TIMEOUT", "idle_timeout");
+
+	memset(pefuncs, 0, sizeof(ttspe_funcs_s));
+	pefuncs->size = sizeof(ttspe_funcs_s);
+	pefuncs->version = TTSP_VERSION_2;
+
+	pefuncs->initialize = __net_initialize;
+	pefuncs->deinitialize = __net_deinitialize;
+	pefuncs->foreach_voices = __net_foreach_voices;
+	pefuncs->is_valid_voice = __net_is_valid_voice;
+	pefuncs->get_audio_format = __net_get_audio_format;
+	pefuncs->start_synth = __net_start_synthesis;
+	pefuncs->cancel_synth = __net_cancel_synthesis;
+	pefuncs->foreach_engine_setting = __net_foreach_engine_settings;
+	pefuncs->set_engine_setting = __net_set_engine_setting;
+
+	pefuncs->capability = TTSP_CAPABILITY_CONCURRENT_SYNTHESIS | TTSP_CAPABILITY_THREAD_SAFE;
+	pefuncs->preload_voice = __net_preload_voice;
+
+	SLOG(LOG_DEBUG, TAG_NET, "[Network] Load engine : url(%s), connections(%d), pipeline(%d)",
+		g_url, g_config.max_connections, g_config.pipeline_depth);
+
+	return TTSP_ERROR_NONE;
+}
+
+void ttsp_unload_engine(void)
+{
+	if (true == g_is_initialized)
+		__net_deinitialize();
+
+	g_alloc_buffer = NULL;
+}
+
+/* Exported so that daemon gives buffers of version 2 in ttsp_load_engine() */
+int ttsp_get_capability(int* capability)
+{
+	if (NULL == capability)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	*capability = TTSP_CAPABILITY_CONCURRENT_SYNTHESIS | TTSP_CAPABILITY_THREAD_SAFE;
+
+	return TTSP_ERROR_NONE;
+}
@@ -31,6 +31,33 @@ Requires:   %{name} = %{version}-%{release}
 Text To Speech header files for TTS development.
 
 
+%package mock-engine
+Summary:    Synthetic TTS engine for load and latency tests
+Group:      libs
+Requires:   %{name} = %{version}-%{release}
+
+%description mock-engine
+Synthetic TTS engine which makes deterministic audio with configurable latency and failures.
+
+
+%package network-engine
+Summary:    TTS engine adapter for network TTS servers
+Group:      libs
+Requires:   %{name} = %{version}-%{release}
+
+%description network-engine
+TTS engine which synthesizes text on a TTS server over HTTP with pooled keep-alive connections.
+
+
+%package tools
+Summary:    Text To Speech engine benchmark tool
+Group:      libs
+Requires:   %{name} = %{version}-%{release}
+
+%description tools
+Conformance and performance benchmark of TTS engine plugins, and a local stand-in of a network TTS server.
+
+
 %prep
 %setup -q -n %{name}-%{version}
 
@@ -66,3 +93,19 @@ rm -rf %{buildroot}
 %{_includedir}/tts.h
 %{_includedir}/tts_setting.h
 %{_includedir}/ttsp.h
+
+
+%files mock-engine
+%defattr(-,root,root,-)
+%{_libdir}/voice/tts/1.0/engine/libttsp-mock.so
+
+
+%files network-engine
+%defattr(-,root,root,-)
+%{_libdir}/voice/tts/1.0/engine/libttsp-network.so
+
+
+%files tools
+%defattr(-,root,root,-)
+%{_bindir}/ttsp-bench
+%{_bindir}/ttsp-net-stub
@@ -0,0 +1,202 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#include <pthread.h>
+
+#include "ttsd_main.h"
+#include "ttsd_config.h"
+#include "ttsd_buffer.h"
+
+#define BUFFER_CHUNK_SIZE_DEFAULT	8192
+#define BUFFER_FREE_MAX			64
+
+typedef struct {
+	unsigned int	capacity;
+	bool		is_taken;	/* owned by sound data, not by engine */
+} buffer_s;
+
+#define BUFFER_DATA(buffer)	((char*)(buffer) + sizeof(buffer_s))
+
+/* engine may allocate in its own thread */
+static pthread_mutex_t g_buffer_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* data of allocated buffers -> buffer_s */
+static GHashTable* g_buffer_table = NULL;
+
+/* free buffers of chunk size */
+static GList* g_free_list = NULL;
+static int g_free_count = 0;
+
+static unsigned int g_chunk_size = 0;
+
+
+unsigned int ttsd_buffer_get_chunk_size()
+{
+	pthread_mutex_lock(&g_buffer_mutex);
+
+	if (0 == g_chunk_size) {
+		int size = ttsd_config_get_int_option(TTSD_CONFIG_AUDIO_CHUNK_SIZE, BUFFER_CHUNK_SIZE_DEFAULT);
+		g_chunk_size = (0 < size) ? (unsigned int)size : BUFFER_CHUNK_SIZE_DEFAULT;
+	}
+
+	unsigned int chunk_size = g_chunk_size;
+
+	pthread_mutex_unlock(&g_buffer_mutex);
+
+	return chunk_size;
+}
+
+void* ttsd_buffer_alloc(unsigned int size)
+{
+	if (0 == size)
+		return NULL;
+
+	unsigned int chunk_size = ttsd_buffer_get_chunk_size();
+	buffer_s* buffer = NULL;
+
+	pthread_mutex_lock(&g_buffer_mutex);
+
+	if (size <= chunk_size && NULL != g_free_list) {
+		buffer = (buffer_s*)g_free_list->data;
+		g_free_list = g_list_delete_link(g_free_list, g_free_list);
+		g_free_count--;
+	}
+
+	pthread_mutex_unlock(&g_buffer_mutex);
+
+	if (NULL == buffer) {
+		unsigned int capacity = (size <= chunk_size) ? chunk_size : size;
+		buffer = (buffer_s*)g_malloc(sizeof(buffer_s) + capacity);
+		if (NULL == buffer)
+			return NULL;
+
+		buffer->capacity = capacity;
+	}
+
+	buffer->is_taken = false;
+
+	pthread_mutex_lock(&g_buffer_mutex);
+
+	if (NULL == g_buffer_table)
+		g_buffer_table = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	g_hash_table_insert(g_buffer_table, BUFFER_DATA(buffer), buffer);
+
+	pthread_mutex_unlock(&g_buffer_mutex);
+
+	return BUFFER_DATA(buffer);
+}
+
+void ttsd_buffer_release(void* data)
+{
+	if (NULL == data)
+		return;
+
+	pthread_mutex_lock(&g_buffer_mutex);
+
+	buffer_s* buffer = NULL;
+	if (NULL != g_buffer_table)
+		buffer = (buffer_s*)g_hash_table_lookup(g_buffer_table, data);
+
+	if (NULL == buffer) {
+		pthread_mutex_unlock(&g_buffer_mutex);
+		SLOG(LOG_WARN, TAG_TTSD, "[Buffer WARNING] Release buffer which is not in pool : %p", data);
+		return;
+	}
+
+	g_hash_table_remove(g_buffer_table, data);
+
+	/* buffer of chunk size is reused */
+	if (buffer->capacity == g_chunk_size && BUFFER_FREE_MAX > g_free_count) {
+		g_free_list = g_list_prepend(g_free_list, buffer);
+		g_free_count++;
+		buffer = NULL;
+	}
+
+	pthread_mutex_unlock(&g_buffer_mutex);
+
+	if (NULL != buffer)
+		g_free(buffer);
+}
+
+bool ttsd_buffer_is_pooled(const void* data)
+{
+	if (NULL == data)
+		return false;
+
+	pthread_mutex_lock(&g_buffer_mutex);
+
+	bool is_pooled = (NULL != g_buffer_table && NULL != g_hash_table_lookup(g_buffer_table, data));
+
+	pthread_mutex_unlock(&g_buffer_mutex);
+
+	return is_pooled;
+}
+
+bool ttsd_buffer_take(const void* data)
+{
+	if (NULL == data)
+		return false;
+
+	pthread_mutex_lock(&g_buffer_mutex);
+
+	buffer_s* buffer = NULL;
+	if (NULL != g_buffer_table)
+		buffer = (buffer_s*)g_hash_table_lookup(g_buffer_table, data);
+
+	/* one buffer becomes one sound data */
+	bool is_taken = false;
+	if (NULL != buffer && false == buffer->is_taken) {
+		buffer->is_taken = true;
+		is_taken = true;
+	}
+
+	pthread_mutex_unlock(&g_buffer_mutex);
+
+	return is_taken;
+}
+
+void ttsd_buffer_return(const void* data)
+{
+	if (NULL == data)
+		return;
+
+	pthread_mutex_lock(&g_buffer_mutex);
+
+	buffer_s* buffer = NULL;
+	if (NULL != g_buffer_table)
+		buffer = (buffer_s*)g_hash_table_lookup(g_buffer_table, data);
+
+	bool is_free = (NULL != buffer && false == buffer->is_taken);
+
+	pthread_mutex_unlock(&g_buffer_mutex);
+
+	if (true == is_free)
+		ttsd_buffer_release((void*)data);
+}
+
+int ttsd_buffer_shrink()
+{
+	pthread_mutex_lock(&g_buffer_mutex);
+
+	GList* free_list = g_free_list;
+	g_free_list = NULL;
+	g_free_count = 0;
+
+	pthread_mutex_unlock(&g_buffer_mutex);
+
+	g_list_free_full(free_list, g_free);
+
+	return 0;
+}
@@ -0,0 +1,56 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#ifndef __TTSD_BUFFER_H_
+#define __TTSD_BUFFER_H_
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+* Audio Buffer Pool Interfaces
+*
+* Engine writes result data into a buffer of the pool and passes it to ttspe_result_cb().
+* The daemon takes the buffer as sound data instead of copying it.
+*/
+
+/** Size of buffers which are reused. Larger buffers are allocated and freed each time. */
+unsigned int ttsd_buffer_get_chunk_size();
+
+/** Allocate buffer, engine can call it in any thread */
+void* ttsd_buffer_alloc(unsigned int size);
+
+/** Give buffer back to the pool */
+void ttsd_buffer_release(void* buffer);
+
+/** Check whether data is a buffer of the pool */
+bool ttsd_buffer_is_pooled(const void* data);
+
+/** Take buffer passed with result, so that it is kept after the result callback. Returns false if data is not a buffer of the pool. */
+bool ttsd_buffer_take(const void* data);
+
+/** Release buffer passed with result, if nobody has taken it in the result callback */
+void ttsd_buffer_return(const void* data);
+
+/** Release free buffers, e.g. when memory is low */
+int ttsd_buffer_shrink();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TTSD_BUFFER_H_ */
@@ -0,0 +1,1019 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <Ecore.h>
+
+#include "ttsd_main.h"
+#include "ttsd_cache.h"
+
+/*
+* Cache file layout
+*
+*  | header | index[entry_count] sorted by key hash | keys and audio data |
+*
+* The file is always written to a temporary file and renamed over the old one,
+* so the daemon maps either the old or the new file, never a partial one.
+* The write runs in a thread. When the file is full, least recently used entries are dropped.
+*/
+
+#define CACHE_FILE_PATH		BASE_DIRECTORY_DOWNLOAD"ttsd_cache.dat"
+#define CACHE_TEMP_FILE_PATH	BASE_DIRECTORY_DOWNLOAD"ttsd_cache.tmp"
+
+#define CACHE_MAGIC		"TTSCACHE"
+#define CACHE_VERSION		2
+#define CACHE_UUID_SIZE		64
+
+#define CACHE_MAX_TEXT_LEN	256			/* Only short prompts are cached */
+#define CACHE_MAX_ENTRY_SIZE	(1024 * 1024)
+#define CACHE_MAX_FILE_SIZE	(16 * 1024 * 1024)
+#define CACHE_FLUSH_DELAY	5.0
+
+typedef struct {
+	char		magic[8];
+	int		version;
+	char		engine_uuid[CACHE_UUID_SIZE];
+	int		engine_version;
+	unsigned int	voice_hash;
+	unsigned int	entry_count;
+	unsigned int	index_offset;
+	unsigned int	data_offset;
+	unsigned int	data_size;
+	unsigned int	checksum;
+} cache_header_s;
+
+typedef struct {
+	unsigned int	key_hash;
+	unsigned int	key_offset;
+	unsigned int	key_size;
+	unsigned int	audio_offset;
+	unsigned int	audio_size;
+	int		audio_type;
+	int		rate;
+	int		channels;
+	unsigned int	serial;		/* order of adding or last use, smallest is evicted first */
+} cache_index_s;
+
+/* A mapped cache file. Retired maps stay alive while sound data still points into them. */
+typedef struct {
+	char*		addr;
+	size_t		size;
+	int		ref_count;
+} cache_map_s;
+
+/* An entry which is not written to the file yet */
+typedef struct {
+	char*		key;
+	unsigned int	key_hash;
+	char*		data;
+	unsigned int	data_size;
+	int		audio_type;
+	int		rate;
+	int		channels;
+	unsigned int	serial;
+} cache_entry_s;
+
+struct _ttsd_cache_record_s {
+	char*		key;
+	char*		data;
+	unsigned int	data_size;
+	int		chunk_count;
+	int		audio_type;
+	int		rate;
+	int		channels;
+	bool		is_valid;
+};
+
+/* An entry to be written by flush */
+typedef struct {
+	unsigned int	key_hash;
+	const char*	key;
+	unsigned int	key_size;
+	const char*	data;
+	unsigned int	data_size;
+	int		audio_type;
+	int		rate;
+	int		channels;
+	unsigned int	serial;
+} cache_write_s;
+
+/* A file write running in thread. Entries point into map and entry_list, which are kept until it is done. */
+typedef struct {
+	cache_header_s	header;		/* engine of cache, other fields are filled by write */
+	cache_write_s*	entries;
+	unsigned int	count;
+	cache_map_s*	map;
+	GList*		entry_list;
+	int		result;
+	bool		is_canceled;	/* cache is cleared while writing, written file is dropped */
+} cache_job_s;
+
+
+static bool g_cache_init = false;
+
+static char* g_engine_uuid = NULL;
+static int g_engine_version;
+static unsigned int g_voice_hash;
+
+/** Current mapped file */
+static cache_map_s* g_cur_map = NULL;
+
+/** Maps which are replaced but still referenced */
+static GList* g_retired_maps = NULL;
+
+/** Entries not written yet */
+static GList* g_pending_list = NULL;
+static unsigned int g_pending_size;
+
+static Ecore_Timer* g_flush_timer = NULL;
+
+/** Write in progress and its thread */
+static cache_job_s* g_write_job = NULL;
+static pthread_t g_write_thread;
+
+/** Serial for next added or used entry */
+static unsigned int g_next_serial = 1;
+
+/** Key hash of mapped entries used since last flush -> serial of last use */
+static GHashTable* g_used_table = NULL;
+
+
+static unsigned int __cache_hash(const void* data, unsigned int size)
+{
+	/* FNV-1a */
+	const unsigned char* p = (const unsigned char*)data;
+	unsigned int hash = 2166136261u;
+	unsigned int i;
+
+	for (i = 0; i < size; i++) {
+		hash ^= p[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+static char* __cache_make_key(const char* text, const char* lang, int vctype, int speed)
+{
+	return g_strdup_printf("%s\x1f%s\x1f%d\x1f%d", lang, text, vctype, speed);
+}
+
+static const cache_header_s* __cache_get_header(const cache_map_s* map)
+{
+	return (const cache_header_s*)map->addr;
+}
+
+static const cache_index_s* __cache_get_index(const cache_map_s* map)
+{
+	return (const cache_index_s*)(map->addr + __cache_get_header(map)->index_offset);
+}
+
+static void __cache_unmap(cache_map_s* map)
+{
+	if (NULL != map->addr)
+		munmap(map->addr, map->size);
+
+	g_free(map);
+}
+
+static void __cache_retire_map(cache_map_s* map)
+{
+	if (NULL == map)
+		return;
+
+	if (0 == map->ref_count) {
+		__cache_unmap(map);
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Cache] Map is still referenced (%d) : retire", map->ref_count);
+		g_retired_maps = g_list_append(g_retired_maps, map);
+	}
+}
+
+static void __cache_unref_map(cache_map_s* map)
+{
+	map->ref_count--;
+
+	if (map != g_cur_map && 0 >= map->ref_count) {
+		g_retired_maps = g_list_remove(g_retired_maps, map);
+		__cache_unmap(map);
+	}
+}
+
+static bool __cache_is_valid_map(const cache_map_s* map)
+{
+	const cache_header_s* header;
+
+	if (map->size < sizeof(cache_header_s))
+		return false;
+
+	header = __cache_get_header(map);
+
+	if (0 != memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) || CACHE_VERSION != header->version) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Cache WARNING] Unknown cache file format");
+		return false;
+	}
+
+	if (0 != strncmp(header->engine_uuid, g_engine_uuid, CACHE_UUID_SIZE) ||
+	    g_engine_version != header->engine_version || g_voice_hash != header->voice_hash) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Cache] Cache is made by other engine(%.*s), version(%d) or voice set",
+			CACHE_UUID_SIZE, header->engine_uuid, header->engine_version);
+		return false;
+	}
+
+	if (header->index_offset < sizeof(cache_header_s) ||
+	    header->entry_count > (map->size - header->index_offset) / sizeof(cache_index_s) ||
+	    header->data_offset > map->size || header->data_size > map->size - header->data_offset) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Cache WARNING] Cache file is truncated");
+		return false;
+	}
+
+	const cache_index_s* index = __cache_get_index(map);
+
+	if (header->checksum != __cache_hash(index, header->entry_count * sizeof(cache_index_s))) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Cache WARNING] Index checksum mismatch");
+		return false;
+	}
+
+	unsigned int data_end = header->data_offset + header->data_size;
+	unsigned int i;
+	for (i = 0; i < header->entry_count; i++) {
+		if (index[i].key_offset < header->data_offset || index[i].key_size > data_end - index[i].key_offset ||
+		    index[i].audio_offset < header->data_offset || index[i].audio_size > data_end - index[i].audio_offset) {
+			SLOG(LOG_WARN, TAG_TTSD, "[Cache WARNING] Entry(%d) is out of range", i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int __cache_map_file()
+{
+	int fd = open(CACHE_FILE_PATH, O_RDONLY);
+	if (fd < 0) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Cache] No cache file");
+		return -1;
+	}
+
+	struct stat st;
+	if (0 != fstat(fd, &st) || st.st_size < (off_t)sizeof(cache_header_s) || st.st_size > CACHE_MAX_FILE_SIZE) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Cache WARNING] Invalid cache file size");
+		close(fd);
+		unlink(CACHE_FILE_PATH);
+		return -1;
+	}
+
+	void* addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (MAP_FAILED == addr) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Cache ERROR] Fail to map cache file : %s", strerror(errno));
+		return -1;
+	}
+
+	cache_map_s* map = (cache_map_s*)g_malloc0(sizeof(cache_map_s));
+	map->addr = (char*)addr;
+	map->size = st.st_size;
+	map->ref_count = 0;
+
+	if (false == __cache_is_valid_map(map)) {
+		__cache_unmap(map);
+		unlink(CACHE_FILE_PATH);
+		return -1;
+	}
+
+	g_cur_map = map;
+
+	const cache_index_s* index = __cache_get_index(map);
+	unsigned int i;
+	for (i = 0; i < __cache_get_header(map)->entry_count; i++) {
+		if (g_next_serial <= index[i].serial)
+			g_next_serial = index[i].serial + 1;
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Cache] Map cache file : entries(%d), size(%d)",
+		__cache_get_header(map)->entry_count, (int)map->size);
+
+	return 0;
+}
+
+static const cache_index_s* __cache_find_mapped(const char* key, unsigned int key_hash)
+{
+	if (NULL == g_cur_map)
+		return NULL;
+
+	const cache_header_s* header = __cache_get_header(g_cur_map);
+	const cache_index_s* index = __cache_get_index(g_cur_map);
+	unsigned int key_size = strlen(key);
+
+	/* lower bound of key hash */
+	unsigned int low = 0;
+	unsigned int high = header->entry_count;
+	while (low < high) {
+		unsigned int mid = low + (high - low) / 2;
+		if (index[mid].key_hash < key_hash)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	for (; low < header->entry_count && index[low].key_hash == key_hash; low++) {
+		if (index[low].key_size == key_size && 0 == memcmp(g_cur_map->addr + index[low].key_offset, key, key_size))
+			return &index[low];
+	}
+
+	return NULL;
+}
+
+static cache_entry_s* __cache_find_in_list(GList* list, const char* key, unsigned int key_hash)
+{
+	GList *iter = NULL;
+	cache_entry_s* entry = NULL;
+
+	iter = g_list_first(list);
+	while (NULL != iter) {
+		entry = iter->data;
+
+		if (entry->key_hash == key_hash && 0 == strcmp(entry->key, key))
+			return entry;
+
+		iter = g_list_next(iter);
+	}
+
+	return NULL;
+}
+
+/* Find entry which is not in the mapped file yet, also while it is being written */
+static cache_entry_s* __cache_find_pending(const char* key, unsigned int key_hash)
+{
+	cache_entry_s* entry = __cache_find_in_list(g_pending_list, key, key_hash);
+
+	if (NULL == entry && NULL != g_write_job && false == g_write_job->is_canceled)
+		entry = __cache_find_in_list(g_write_job->entry_list, key, key_hash);
+
+	return entry;
+}
+
+static void __cache_free_entries(GList* list)
+{
+	GList *iter = NULL;
+	cache_entry_s* entry = NULL;
+
+	iter = g_list_first(list);
+	while (NULL != iter) {
+		entry = iter->data;
+
+		g_free(entry->key);
+		g_free(entry->data);
+		g_free(entry);
+
+		iter = g_list_next(iter);
+	}
+
+	g_list_free(list);
+}
+
+static void __cache_free_pending()
+{
+	__cache_free_entries(g_pending_list);
+
+	g_pending_list = NULL;
+	g_pending_size = 0;
+}
+
+static int __cache_compare_hash(const void* a, const void* b)
+{
+	const cache_write_s* wa = (const cache_write_s*)a;
+	const cache_write_s* wb = (const cache_write_s*)b;
+
+	if (wa->key_hash < wb->key_hash)	return -1;
+	if (wa->key_hash > wb->key_hash)	return 1;
+	return 0;
+}
+
+static int __cache_compare_serial(const void* a, const void* b)
+{
+	const cache_write_s* wa = (const cache_write_s*)a;
+	const cache_write_s* wb = (const cache_write_s*)b;
+
+	if (wa->serial < wb->serial)	return -1;
+	if (wa->serial > wb->serial)	return 1;
+	return 0;
+}
+
+static int __cache_write_all(int fd, const void* buf, size_t size)
+{
+	const char* p = (const char*)buf;
+
+	while (0 < size) {
+		ssize_t written = write(fd, p, size);
+		if (written < 0) {
+			if (EINTR == errno)
+				continue;
+			return -1;
+		}
+		p += written;
+		size -= written;
+	}
+
+	return 0;
+}
+
+/* Write cache file of job. This runs in write thread, so it uses only data of job. */
+static int __cache_write_file(cache_job_s* job)
+{
+	cache_header_s* header = &job->header;
+	cache_write_s* entries = job->entries;
+	unsigned int count = job->count;
+
+	header->entry_count = count;
+	header->index_offset = sizeof(cache_header_s);
+	header->data_offset = header->index_offset + count * sizeof(cache_index_s);
+
+	cache_index_s* index = (cache_index_s*)g_malloc0(sizeof(cache_index_s) * (count > 0 ? count : 1));
+
+	unsigned int offset = header->data_offset;
+	unsigned int i;
+	for (i = 0; i < count; i++) {
+		index[i].key_hash = entries[i].key_hash;
+		index[i].key_offset = offset;
+		index[i].key_size = entries[i].key_size;
+		offset += entries[i].key_size;
+
+		index[i].audio_offset = offset;
+		index[i].audio_size = entries[i].data_size;
+		offset += entries[i].data_size;
+
+		index[i].audio_type = entries[i].audio_type;
+		index[i].rate = entries[i].rate;
+		index[i].channels = entries[i].channels;
+		index[i].serial = entries[i].serial;
+	}
+
+	header->data_size = offset - header->data_offset;
+	header->checksum = __cache_hash(index, count * sizeof(cache_index_s));
+
+	int fd = open(CACHE_TEMP_FILE_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Cache ERROR] Fail to open temp file : %s", strerror(errno));
+		g_free(index);
+		return -1;
+	}
+
+	int ret = __cache_write_all(fd, header, sizeof(cache_header_s));
+	if (0 == ret)
+		ret = __cache_write_all(fd, index, count * sizeof(cache_index_s));
+
+	for (i = 0; i < count && 0 == ret; i++) {
+		ret = __cache_write_all(fd, entries[i].key, entries[i].key_size);
+		if (0 == ret)
+			ret = __cache_write_all(fd, entries[i].data, entries[i].data_size);
+	}
+
+	g_free(index);
+
+	if (0 == ret)
+		ret = fsync(fd);
+
+	close(fd);
+
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Cache ERROR] Fail to write temp file : %s", strerror(errno));
+		unlink(CACHE_TEMP_FILE_PATH);
+		return -1;
+	}
+
+	if (0 != rename(CACHE_TEMP_FILE_PATH, CACHE_FILE_PATH)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Cache ERROR] Fail to rename temp file : %s", strerror(errno));
+		unlink(CACHE_TEMP_FILE_PATH);
+		return -1;
+	}
+
+	/* make the rename durable */
+	int dir_fd = open(BASE_DIRECTORY_DOWNLOAD, O_RDONLY);
+	if (0 <= dir_fd) {
+		fsync(dir_fd);
+		close(dir_fd);
+	}
+
+	return 0;
+}
+
+/* Drop least recently used entries until they fit in the file. Returns count of kept entries. */
+static unsigned int __cache_evict(cache_write_s* entries, unsigned int count)
+{
+	unsigned int size = sizeof(cache_header_s);
+	unsigned int i;
+
+	for (i = 0; i < count; i++)
+		size += sizeof(cache_index_s) + entries[i].key_size + entries[i].data_size;
+
+	if (CACHE_MAX_FILE_SIZE >= size)
+		return count;
+
+	qsort(entries, count, sizeof(cache_write_s), __cache_compare_serial);
+
+	for (i = 0; i < count && CACHE_MAX_FILE_SIZE < size; i++)
+		size -= sizeof(cache_index_s) + entries[i].key_size + entries[i].data_size;
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Cache] Cache is full : evict %d entries", i);
+
+	memmove(entries, entries + i, (count - i) * sizeof(cache_write_s));
+
+	return count - i;
+}
+
+/* Collect mapped and pending entries into a job. Pending entries and the map are owned by job until it is done. */
+static cache_job_s* __cache_new_job()
+{
+	unsigned int mapped_count = 0;
+	if (NULL != g_cur_map)
+		mapped_count = __cache_get_header(g_cur_map)->entry_count;
+
+	cache_job_s* job = (cache_job_s*)g_malloc0(sizeof(cache_job_s));
+
+	memcpy(job->header.magic, CACHE_MAGIC, sizeof(job->header.magic));
+	job->header.version = CACHE_VERSION;
+	strncpy(job->header.engine_uuid, g_engine_uuid, CACHE_UUID_SIZE - 1);
+	job->header.engine_version = g_engine_version;
+	job->header.voice_hash = g_voice_hash;
+
+	job->entries = (cache_write_s*)g_malloc0(sizeof(cache_write_s) * (mapped_count + g_list_length(g_pending_list)));
+
+	/* keep mapped entries, with serial of last use */
+	unsigned int i;
+	if (NULL != g_cur_map) {
+		const cache_index_s* index = __cache_get_index(g_cur_map);
+		for (i = 0; i < mapped_count; i++) {
+			cache_write_s* entry = &job->entries[job->count++];
+
+			entry->key_hash = index[i].key_hash;
+			entry->key = g_cur_map->addr + index[i].key_offset;
+			entry->key_size = index[i].key_size;
+			entry->data = g_cur_map->addr + index[i].audio_offset;
+			entry->data_size = index[i].audio_size;
+			entry->audio_type = index[i].audio_type;
+			entry->rate = index[i].rate;
+			entry->channels = index[i].channels;
+			entry->serial = index[i].serial;
+
+			gpointer used = NULL;
+			if (NULL != g_used_table && NULL != (used = g_hash_table_lookup(g_used_table, GUINT_TO_POINTER(index[i].key_hash))))
+				entry->serial = GPOINTER_TO_UINT(used);
+		}
+
+		g_cur_map->ref_count++;
+		job->map = g_cur_map;
+	}
+
+	if (NULL != g_used_table)
+		g_hash_table_remove_all(g_used_table);
+
+	GList *iter = NULL;
+	cache_entry_s* pending = NULL;
+
+	iter = g_list_first(g_pending_list);
+	while (NULL != iter) {
+		pending = iter->data;
+		cache_write_s* entry = &job->entries[job->count++];
+
+		entry->key_hash = pending->key_hash;
+		entry->key = pending->key;
+		entry->key_size = strlen(pending->key);
+		entry->data = pending->data;
+		entry->data_size = pending->data_size;
+		entry->audio_type = pending->audio_type;
+		entry->rate = pending->rate;
+		entry->channels = pending->channels;
+		entry->serial = pending->serial;
+
+		iter = g_list_next(iter);
+	}
+
+	job->entry_list = g_pending_list;
+	g_pending_list = NULL;
+	g_pending_size = 0;
+
+	job->count = __cache_evict(job->entries, job->count);
+
+	qsort(job->entries, job->count, sizeof(cache_write_s), __cache_compare_hash);
+
+	return job;
+}
+
+static Eina_Bool __cache_flush_timer_cb(void *data);
+
+/* Release job in main loop and map the written file */
+static void __cache_finish_job(cache_job_s* job)
+{
+	if (NULL != job->map)
+		__cache_unref_map(job->map);
+
+	__cache_free_entries(job->entry_list);
+
+	if (true == job->is_canceled) {
+		unlink(CACHE_FILE_PATH);
+	} else if (0 == job->result) {
+		__cache_retire_map(g_cur_map);
+		g_cur_map = NULL;
+
+		__cache_map_file();
+
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Cache SUCCESS] Flush cache : entries(%d)", job->count);
+	}
+
+	/* Pending entries of failed write are dropped not to grow memory */
+
+	g_free(job->entries);
+	g_free(job);
+
+	/* entries added while writing */
+	if (NULL != g_pending_list && NULL == g_flush_timer)
+		g_flush_timer = ecore_timer_add(CACHE_FLUSH_DELAY, __cache_flush_timer_cb, NULL);
+}
+
+/* Wait write thread and finish its job */
+static void __cache_wait_write()
+{
+	if (NULL == g_write_job)
+		return;
+
+	pthread_join(g_write_thread, NULL);
+
+	cache_job_s* job = g_write_job;
+	g_write_job = NULL;
+
+	__cache_finish_job(job);
+}
+
+static void __cache_write_done_cb(void* data)
+{
+	/* job may be finished already by close */
+	__cache_wait_write();
+}
+
+static void* __cache_write_thread(void* data)
+{
+	cache_job_s* job = (cache_job_s*)data;
+
+	job->result = __cache_write_file(job);
+
+	ecore_main_loop_thread_safe_call_async(__cache_write_done_cb, NULL);
+
+	return NULL;
+}
+
+/* Write pending entries. If is_async is true, the file is written in a thread and mapped when it is done. */
+static int __cache_flush(bool is_async)
+{
+	if (NULL == g_pending_list)
+		return 0;
+
+	/* one write at a time */
+	__cache_wait_write();
+
+	cache_job_s* job = __cache_new_job();
+
+	if (true == is_async) {
+		g_write_job = job;
+		if (0 == pthread_create(&g_write_thread, NULL, __cache_write_thread, job))
+			return 0;
+
+		SLOG(LOG_WARN, TAG_TTSD, "[Cache WARNING] Fail to create write thread : write in main loop");
+		g_write_job = NULL;
+	}
+
+	job->result = __cache_write_file(job);
+
+	int ret = (0 == job->result) ? 0 : TTSD_ERROR_OPERATION_FAILED;
+
+	__cache_finish_job(job);
+
+	return ret;
+}
+
+static Eina_Bool __cache_flush_timer_cb(void *data)
+{
+	if (NULL != g_write_job) {
+		/* try again after previous write */
+		return EINA_TRUE;
+	}
+
+	g_flush_timer = NULL;
+
+	__cache_flush(true);
+
+	return EINA_FALSE;
+}
+
+/* Remember use of mapped entry, so that it is evicted later */
+static void __cache_touch(const cache_index_s* index)
+{
+	if (NULL == g_used_table)
+		g_used_table = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	g_hash_table_insert(g_used_table, GUINT_TO_POINTER(index->key_hash), GUINT_TO_POINTER(g_next_serial++));
+}
+
+static int __cache_add(char* key, char* data, unsigned int data_size, int audio_type, int rate, int channels)
+{
+	unsigned int key_hash = __cache_hash(key, strlen(key));
+
+	if (NULL != __cache_find_mapped(key, key_hash) || NULL != __cache_find_pending(key, key_hash)) {
+		g_free(key);
+		g_free(data);
+		return 0;
+	}
+
+	/* Older entries are evicted by flush, only entries in memory are limited here */
+	if (CACHE_MAX_FILE_SIZE < sizeof(cache_header_s) + g_pending_size + data_size + strlen(key) + sizeof(cache_index_s)) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Cache] Too many entries to write");
+		g_free(key);
+		g_free(data);
+		return TTSD_ERROR_OUT_OF_MEMORY;
+	}
+
+	cache_entry_s* entry = (cache_entry_s*)g_malloc0(sizeof(cache_entry_s));
+	entry->key = key;
+	entry->key_hash = key_hash;
+	entry->data = data;
+	entry->data_size = data_size;
+	entry->audio_type = audio_type;
+	entry->rate = rate;
+	entry->channels = channels;
+	entry->serial = g_next_serial++;
+
+	g_pending_list = g_list_append(g_pending_list, entry);
+	g_pending_size += data_size + strlen(key) + sizeof(cache_index_s);
+
+	if (NULL == g_flush_timer)
+		g_flush_timer = ecore_timer_add(CACHE_FLUSH_DELAY, __cache_flush_timer_cb, NULL);
+
+	return 0;
+}
+
+/*
+* TTS Prompt Cache Interfaces
+*/
+
+int ttsd_cache_open(const char* engine_uuid, int engine_version, unsigned int voice_hash)
+{
+	if (NULL == engine_uuid) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Cache ERROR] Input parameter is NULL");
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	if (true == g_cache_init)
+		ttsd_cache_close();
+
+	g_engine_uuid = g_strdup(engine_uuid);
+	g_engine_version = engine_version;
+	g_voice_hash = voice_hash;
+
+	g_cache_init = true;
+
+	__cache_map_file();
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Cache SUCCESS] Open cache : engine(%s), version(%d), voice hash(%x)",
+		engine_uuid, engine_version, voice_hash);
+
+	return 0;
+}
+
+int ttsd_cache_close()
+{
+	if (false == g_cache_init) {
+		return 0;
+	}
+
+	/* Close is called on engine change and exit, the last entries are written before it returns */
+	__cache_wait_write();
+
+	__cache_flush(false);
+
+	if (NULL != g_flush_timer) {
+		ecore_timer_del(g_flush_timer);
+		g_flush_timer = NULL;
+	}
+
+	__cache_retire_map(g_cur_map);
+	g_cur_map = NULL;
+
+	if (NULL != g_used_table) {
+		g_hash_table_destroy(g_used_table);
+		g_used_table = NULL;
+	}
+
+	if (NULL != g_engine_uuid) {
+		g_free(g_engine_uuid);
+		g_engine_uuid = NULL;
+	}
+
+	g_cache_init = false;
+
+	return 0;
+}
+
+int ttsd_cache_clear()
+{
+	if (false == g_cache_init) {
+		return 0;
+	}
+
+	if (NULL != g_flush_timer) {
+		ecore_timer_del(g_flush_timer);
+		g_flush_timer = NULL;
+	}
+
+	__cache_free_pending();
+
+	/* file being written is removed when the write is done */
+	if (NULL != g_write_job)
+		g_write_job->is_canceled = true;
+
+	if (NULL != g_used_table)
+		g_hash_table_remove_all(g_used_table);
+
+	__cache_retire_map(g_cur_map);
+	g_cur_map = NULL;
+
+	unlink(CACHE_FILE_PATH);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Cache] Clear cache");
+
+	return 0;
+}
+
+int ttsd_cache_get(const char* text, const char* lang, int vctype, int speed,
+		   void** data, unsigned int* data_size, ttsp_audio_type_e* audio_type, int* rate, int* channels, bool* is_mapped)
+{
+	if (NULL == text || NULL == lang || NULL == data || NULL == data_size ||
+	    NULL == audio_type || NULL == rate || NULL == channels || NULL == is_mapped) {
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	if (false == g_cache_init || CACHE_MAX_TEXT_LEN < strlen(text)) {
+		return -1;
+	}
+
+	char* key = __cache_make_key(text, lang, vctype, speed);
+	unsigned int key_hash = __cache_hash(key, strlen(key));
+
+	const cache_index_s* index = __cache_find_mapped(key, key_hash);
+	if (NULL != index) {
+		g_free(key);
+
+		*data = g_cur_map->addr + index->audio_offset;
+		*data_size = index->audio_size;
+		*audio_type = (ttsp_audio_type_e)index->audio_type;
+		*rate = index->rate;
+		*channels = index->channels;
+		*is_mapped = true;
+
+		g_cur_map->ref_count++;
+
+		__cache_touch(index);
+
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Cache] Hit : text(%s), size(%d)", text, *data_size);
+		return 0;
+	}
+
+	/* Not written yet. The pending data is freed by flush, so give a copy. */
+	cache_entry_s* entry = __cache_find_pending(key, key_hash);
+	g_free(key);
+
+	if (NULL != entry) {
+		*data = g_malloc0(entry->data_size);
+		memcpy(*data, entry->data, entry->data_size);
+		*data_size = entry->data_size;
+		*audio_type = (ttsp_audio_type_e)entry->audio_type;
+		*rate = entry->rate;
+		*channels = entry->channels;
+		*is_mapped = false;
+
+		entry->serial = g_next_serial++;
+
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Cache] Hit pending entry : text(%s), size(%d)", text, *data_size);
+		return 0;
+	}
+
+	return -1;
+}
+
+int ttsd_cache_release(const void* data)
+{
+	const char* p = (const char*)data;
+
+	if (NULL != g_cur_map && p >= g_cur_map->addr && p < g_cur_map->addr + g_cur_map->size) {
+		g_cur_map->ref_count--;
+		return 0;
+	}
+
+	GList *iter = NULL;
+	cache_map_s* map = NULL;
+
+	iter = g_list_first(g_retired_maps);
+	while (NULL != iter) {
+		map = iter->data;
+
+		if (p >= map->addr && p < map->addr + map->size) {
+			__cache_unref_map(map);
+			return 0;
+		}
+
+		iter = g_list_next(iter);
+	}
+
+	SLOG(LOG_ERROR, TAG_TTSD, "[Cache ERROR] Data(%p) is not in cache", data);
+
+	return TTSD_ERROR_INVALID_PARAMETER;
+}
+
+ttsd_cache_record_h ttsd_cache_record_begin(const char* text, const char* lang, int vctype, int speed)
+{
+	if (false == g_cache_init || NULL == text || NULL == lang) {
+		return NULL;
+	}
+
+	if (CACHE_MAX_TEXT_LEN < strlen(text)) {
+		return NULL;
+	}
+
+	struct _ttsd_cache_record_s* record = (struct _ttsd_cache_record_s*)g_malloc0(sizeof(struct _ttsd_cache_record_s));
+	record->key = __cache_make_key(text, lang, vctype, speed);
+	record->is_valid = true;
+
+	return record;
+}
+
+int ttsd_cache_record_append(ttsd_cache_record_h record, const void* data, unsigned int data_size,
+			     ttsp_audio_type_e audio_type, int rate, int channels)
+{
+	if (NULL == record) {
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	if (false == record->is_valid || 0 == data_size) {
+		return 0;
+	}
+
+	if (0 < record->chunk_count) {
+		/* Only raw PCM can be joined into one entry */
+		if (TTSP_AUDIO_TYPE_RAW != audio_type || record->audio_type != (int)audio_type ||
+		    record->rate != rate || record->channels != channels) {
+			record->is_valid = false;
+			return 0;
+		}
+	}
+
+	if (CACHE_MAX_ENTRY_SIZE < record->data_size + data_size) {
+		record->is_valid = false;
+		return 0;
+	}
+
+	record->data = (char*)g_realloc(record->data, record->data_size + data_size);
+	memcpy(record->data + record->data_size, data, data_size);
+	record->data_size += data_size;
+
+	record->audio_type = audio_type;
+	record->rate = rate;
+	record->channels = channels;
+	record->chunk_count++;
+
+	return 0;
+}
+
+int ttsd_cache_record_end(ttsd_cache_record_h record, bool commit)
+{
+	if (NULL == record) {
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	int ret = 0;
+
+	if (true == commit && true == record->is_valid && 0 < record->data_size && true == g_cache_init) {
+		/* the entry takes key and data */
+		ret = __cache_add(record->key, record->data, record->data_size, record->audio_type, record->rate, record->channels);
+	} else {
+		g_free(record->key);
+		g_free(record->data);
+	}
+
+	g_free(record);
+
+	return ret;
+}
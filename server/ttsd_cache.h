@@ -0,0 +1,62 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#ifndef __TTSD_CACHE_H_
+#define __TTSD_CACHE_H_
+
+#include <stdbool.h>
+#include "ttsp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Handle of an utterance being recorded into the cache */
+typedef struct _ttsd_cache_record_s* ttsd_cache_record_h;
+
+/*
+* TTS Prompt Cache Interfaces
+*/
+
+/** Map the cache file of the current engine. Entries of other engines, versions or voice sets are dropped. */
+int ttsd_cache_open(const char* engine_uuid, int engine_version, unsigned int voice_hash);
+
+/** Write pending entries and unmap the cache file */
+int ttsd_cache_close();
+
+/** Drop all entries, e.g. when engine settings have changed */
+int ttsd_cache_clear();
+
+/** Get cached audio. If is_mapped is true, data points into the mapping and must be given back by ttsd_cache_release() */
+int ttsd_cache_get(const char* text, const char* lang, int vctype, int speed,
+		   void** data, unsigned int* data_size, ttsp_audio_type_e* audio_type, int* rate, int* channels, bool* is_mapped);
+
+/** Release audio data from ttsd_cache_get() */
+int ttsd_cache_release(const void* data);
+
+/** Start recording synthesized audio of text. Returns NULL if the text is not cacheable. */
+ttsd_cache_record_h ttsd_cache_record_begin(const char* text, const char* lang, int vctype, int speed);
+
+/** Append a synthesized chunk to the record */
+int ttsd_cache_record_append(ttsd_cache_record_h record, const void* data, unsigned int data_size,
+			     ttsp_audio_type_e audio_type, int rate, int channels);
+
+/** Finish the record. If commit is true, the audio is added to the cache. */
+int ttsd_cache_record_end(ttsd_cache_record_h record, bool commit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TTSD_CACHE_H_ */
@@ -28,6 +28,47 @@ static char*	g_language;
 static int	g_vc_type;
 static int	g_speed;
 
+typedef struct {
+	char*	key;
+	char*	value;
+} config_option_s;
+
+/* Optional "KEY value" lines after the default settings */
+static GList*	g_option_list;
+
+config_option_s* __ttsd_config_find_option(const char* key)
+{
+	GList *iter = NULL;
+	config_option_s* option = NULL;
+
+	iter = g_list_first(g_option_list);
+	while (NULL != iter) {
+		option = iter->data;
+
+		if (0 == strcmp(option->key, key))
+			return option;
+
+		iter = g_list_next(iter);
+	}
+
+	return NULL;
+}
+
+void __ttsd_config_set_option(const char* key, const char* value)
+{
+	config_option_s* option = __ttsd_config_find_option(key);
+
+	if (NULL == option) {
+		option = (config_option_s*)g_malloc0(sizeof(config_option_s));
+		option->key = strdup(key);
+		g_option_list = g_list_append(g_option_list, option);
+	} else {
+		free(option->value);
+	}
+
+	option->value = strdup(value);
+}
+
 int __ttsd_config_save()
 {
 	FILE* config_fp;
@@ -48,6 +89,17 @@ int __ttsd_config_save()
 	/* Read speed */
 	fprintf(config_fp, "%s %d\n", SPEED, g_speed);
 
+	/* Write options */
+	GList *iter = NULL;
+	config_option_s* option = NULL;
+
+	iter = g_list_first(g_option_list);
+	while (NULL != iter) {
+		option = iter->data;
+		fprintf(config_fp, "%s %s\n", option->key, option->value);
+		iter = g_list_next(iter);
+	}
+
 	fclose(config_fp);
 
 	return 0;
@@ -108,6 +160,14 @@ int __ttsd_config_load()
 		return -1;
 	}
 
+	/* Read options */
+	while (2 == fscanf(config_fp, "%255s %255s", buf_id, buf_param)) {
+		__ttsd_config_set_option(buf_id, buf_param);
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Config] Option : %s(%s)", buf_id, buf_param);
+	}
+
+	fclose(config_fp);
+
 	SLOG(LOG_DEBUG, TAG_TTSD, "[Config] Load config : engine(%s), voice(%s,%d), speed(%d)",
 		g_engine_id, g_language, g_vc_type, g_speed);
 
@@ -129,6 +189,22 @@ int ttsd_config_initialize()
 int ttsd_config_finalize()
 {
 	__ttsd_config_save();
+
+	GList *iter = NULL;
+	config_option_s* option = NULL;
+
+	iter = g_list_first(g_option_list);
+	while (NULL != iter) {
+		option = iter->data;
+
+		free(option->key);
+		free(option->value);
+		g_free(option);
+
+		g_option_list = g_list_remove_link(g_option_list, iter);
+		iter = g_list_first(g_option_list);
+	}
+
 	return 0;
 }
 
@@ -197,3 +273,29 @@ int ttsd_config_set_default_speed(int speed)
 	__ttsd_config_save();
 	return 0;
 }
+
+int ttsd_config_get_option(const char* key, char** value)
+{
+	if (NULL == key || NULL == value)
+		return -1;
+
+	config_option_s* option = __ttsd_config_find_option(key);
+	if (NULL == option)
+		return -1;
+
+	*value = strdup(option->value);
+
+	return 0;
+}
+
+int ttsd_config_get_int_option(const char* key, int default_value)
+{
+	if (NULL == key)
+		return default_value;
+
+	config_option_s* option = __ttsd_config_find_option(key);
+	if (NULL == option)
+		return default_value;
+
+	return atoi(option->value);
+}
@@ -35,6 +35,33 @@ int ttsd_config_get_default_speed(int* speed);
 
 int ttsd_config_set_default_speed(int speed);
 
+/* Optional settings. They are kept in config file as "KEY value" lines. */
+#define TTSD_CONFIG_FRAGMENT_CROSSFADE		"FRAGMENT_CROSSFADE"		/* msec */
+#define TTSD_CONFIG_FRAGMENT_PAUSE		"FRAGMENT_PAUSE"		/* msec */
+#define TTSD_CONFIG_FRAGMENT_SILENCE_LEVEL	"FRAGMENT_SILENCE_LEVEL"	/* amplitude of 16bit sample */
+#define TTSD_CONFIG_LATENCY_TARGET_LOW		"LATENCY_TARGET_LOW"		/* msec, add text to first audio */
+#define TTSD_CONFIG_LATENCY_TARGET_NORMAL	"LATENCY_TARGET_NORMAL"		/* msec */
+#define TTSD_CONFIG_LATENCY_TARGET_HIGH		"LATENCY_TARGET_HIGH"		/* msec */
+#define TTSD_CONFIG_LATENCY_TARGET_CRITICAL	"LATENCY_TARGET_CRITICAL"	/* msec */
+#define TTSD_CONFIG_ENGINE_IDLE_TIMEOUT		"ENGINE_IDLE_TIMEOUT"		/* sec, 0 unloads at once, negative keeps loaded */
+#define TTSD_CONFIG_ENGINE_WARM_UP_TEXT		"ENGINE_WARM_UP_TEXT"		/* text synthesized after load, no space */
+#define TTSD_CONFIG_ENGINE_MAX_LOADED		"ENGINE_MAX_LOADED"		/* engines loaded at once, including current engine */
+#define TTSD_CONFIG_SYNTHESIS_WORKER_MAX	"SYNTHESIS_WORKER_MAX"		/* concurrent synthesis if engine supports it, 0 for count of cores */
+#define TTSD_CONFIG_ENGINE_HOST			"ENGINE_HOST"			/* 1 loads engine in host process */
+#define TTSD_CONFIG_ENGINE_HOST_TIMEOUT		"ENGINE_HOST_TIMEOUT"		/* msec, host process which does not reply is restarted */
+#define TTSD_CONFIG_AUDIO_CHUNK_SIZE		"AUDIO_CHUNK_SIZE"		/* bytes, size of audio buffers reused by engine and daemon */
+#define TTSD_CONFIG_SYNTHESIS_TIMEOUT_MIN	"SYNTHESIS_TIMEOUT_MIN"		/* msec, least time for engine to finish a text, 0 disables watchdog */
+#define TTSD_CONFIG_SYNTHESIS_TIMEOUT_MARGIN	"SYNTHESIS_TIMEOUT_MARGIN"	/* times of estimated synthesis time */
+#define TTSD_CONFIG_HYBRID_FALLBACK_ENGINE	"HYBRID_FALLBACK_ENGINE"	/* uuid of local engine which backs up network engine */
+#define TTSD_CONFIG_HYBRID_HEDGE_DELAY		"HYBRID_HEDGE_DELAY"		/* msec, local engine starts if network engine has no audio, 0 races at once, negative only on failure */
+#define TTSD_CONFIG_LOOKAHEAD_AUDIO		"LOOKAHEAD_AUDIO"		/* msec, estimated audio synthesized ahead of current text, 0 is limited only by workers */
+#define TTSD_CONFIG_QUEUE_AUDIO_MAX		"QUEUE_AUDIO_MAX"		/* msec, estimated audio queued by a client, more text is rejected, 0 for no limit */
+#define TTSD_CONFIG_BATCH_SIZE_MAX		"BATCH_SIZE_MAX"		/* texts of the same voice given to engine at once if it supports batch synthesis, 1 disables */
+
+int ttsd_config_get_option(const char* key, char** value);
+
+int ttsd_config_get_int_option(const char* key, int default_value);
+
 #ifdef __cplusplus
 }
 #endif
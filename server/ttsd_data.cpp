@@ -14,6 +14,8 @@
 
 #include "ttsd_main.h"
 #include "ttsd_data.h"
+#include "ttsd_cache.h"
+#include "ttsd_buffer.h"
 
 using namespace std;
 
@@ -112,8 +114,10 @@ int ttsd_data_new_client(int pid, int uid)
 	app_data_s app;
 	app.pid = pid;
 	app.uid = uid;
-	app.utt_id_stopped = 0;
+	app.generation = 0;
 	app.state = APP_STATE_READY;
+	app.priority = TTSD_PRIORITY_NORMAL;
+	app.is_preempted = false;
 
 	g_app_list.insert( g_app_list.end(), app);
 
@@ -193,6 +197,44 @@ int ttsd_data_get_speak_data_size(int uid)
 	return size;
 }
 
+int ttsd_data_foreach_speak_data(int uid, ttsd_data_speak_data_cb callback, void* user_data)
+{
+	int index = 0;
+	index = ttsd_data_is_client(uid);
+
+	if (index < 0) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[DATA ERROR] ttsd_data_foreach_speak_data() : uid is not valid (%d)\n", uid);	
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	if (NULL == callback) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[DATA ERROR] input data is NULL!!");
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	int vsize = g_app_list[index].m_speak_data.size();
+
+	for (int i=0; i<vsize; i++) {
+		if (false == callback(uid, &g_app_list[index].m_speak_data[i], user_data)) {
+			break;
+		}
+	}
+
+	return TTSD_ERROR_NONE;
+}
+
+bool ttsd_data_is_prior(const speak_data_s* a, const speak_data_s* b)
+{
+	if (a->priority != b->priority)
+		return a->priority > b->priority;
+
+	/* earliest deadline first, text without deadline is the last */
+	if (0 == a->deadline)
+		return false;
+
+	return (0 == b->deadline || a->deadline < b->deadline);
+}
+
 int ttsd_data_add_speak_data(int uid, speak_data_s data)
 {
 	int index = 0;
@@ -203,10 +245,12 @@ int ttsd_data_add_speak_data(int uid, speak_data_s data)
 		return TTSD_ERROR_INVALID_PARAMETER;
 	}
 	
-	g_app_list[index].m_speak_data.insert(g_app_list[index].m_speak_data.end(), data);
+	/* keep order of texts in the same priority and deadline */
+	vector<speak_data_s>::iterator iter = g_app_list[index].m_speak_data.begin();
+	while (iter != g_app_list[index].m_speak_data.end() && false == ttsd_data_is_prior(&data, &(*iter)))
+		iter++;
 
-	if (1 == data.utt_id)
-		g_app_list[index].utt_id_stopped = 0;
+	g_app_list[index].m_speak_data.insert(iter, data);
 
 #ifdef DATA_DEBUG
 	__data_show_text_list(index);
@@ -235,6 +279,12 @@ int ttsd_data_get_speak_data(int uid, speak_data_s* data)
 
 	data->text = g_app_list[index].m_speak_data[0].text;
 	data->utt_id = g_app_list[index].m_speak_data[0].utt_id;
+	data->priority = g_app_list[index].m_speak_data[0].priority;
+	data->enqueue_time = g_app_list[index].m_speak_data[0].enqueue_time;
+	data->deadline = g_app_list[index].m_speak_data[0].deadline;
+	data->expire_time = g_app_list[index].m_speak_data[0].expire_time;
+	data->is_stream = g_app_list[index].m_speak_data[0].is_stream;
+	data->audio_estimate = g_app_list[index].m_speak_data[0].audio_estimate;
 
 	g_app_list[index].m_speak_data.erase(g_app_list[index].m_speak_data.begin());
 
@@ -244,6 +294,28 @@ int ttsd_data_get_speak_data(int uid, speak_data_s* data)
 	return TTSD_ERROR_NONE;
 }
 
+int ttsd_data_requeue_speak_data(int uid, speak_data_s data)
+{
+	int index = 0;
+	index = ttsd_data_is_client(uid);
+
+	if (index < 0) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[DATA ERROR] ttsd_data_requeue_speak_data() : uid is not valid (%d)\n", uid);	
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	vector<speak_data_s>::iterator iter = g_app_list[index].m_speak_data.begin();
+	while (iter != g_app_list[index].m_speak_data.end() && true == ttsd_data_is_prior(&(*iter), &data))
+		iter++;
+
+	g_app_list[index].m_speak_data.insert(iter, data);
+
+#ifdef DATA_DEBUG
+	__data_show_text_list(index);
+#endif 
+	return TTSD_ERROR_NONE;
+}
+
 int ttsd_data_add_sound_data(int uid, sound_data_s data)
 {
 	int index = 0;
@@ -254,7 +326,12 @@ int ttsd_data_add_sound_data(int uid, sound_data_s data)
 		return TTSD_ERROR_INVALID_PARAMETER;
 	}
 
-	g_app_list[index].m_wav_data.insert(g_app_list[index].m_wav_data.end(), data);
+	/* sound of higher priority is played before queued sound of lower priority */
+	vector<sound_data_s>::iterator iter = g_app_list[index].m_wav_data.begin();
+	while (iter != g_app_list[index].m_wav_data.end() && iter->priority >= data.priority)
+		iter++;
+
+	g_app_list[index].m_wav_data.insert(iter, data);
 
 #ifdef DATA_DEBUG
 	__data_show_sound_list(index);
@@ -284,6 +361,8 @@ int ttsd_data_get_sound_data(int uid, sound_data_s* data)
 	data->rate = g_app_list[index].m_wav_data[0].rate;
 	data->channels = g_app_list[index].m_wav_data[0].channels;
 	data->event = g_app_list[index].m_wav_data[0].event;
+	data->is_cached = g_app_list[index].m_wav_data[0].is_cached;
+	data->priority = g_app_list[index].m_wav_data[0].priority;
 
 	g_app_list[index].m_wav_data.erase(g_app_list[index].m_wav_data.begin());
 
@@ -306,6 +385,50 @@ int ttsd_data_get_sound_data_size(int uid)
 	return g_app_list[index].m_wav_data.size();
 }
 
+int ttsd_data_release_sound_data(sound_data_s* data)
+{
+	if (NULL == data || NULL == data->data)
+		return 0;
+
+	if (true == data->is_cached) {
+		ttsd_cache_release(data->data);
+	} else if (true == ttsd_buffer_is_pooled(data->data)) {
+		ttsd_buffer_release(data->data);
+	} else {
+		g_free(data->data);
+	}
+
+	data->data = NULL;
+
+	return TTSD_ERROR_NONE;
+}
+
+int ttsd_data_remove_sound_data(int uid, int utt_id)
+{
+	int index = 0;
+	index = ttsd_data_is_client(uid);
+
+	if (index < 0)	{
+		SLOG(LOG_ERROR, TAG_TTSD, "[DATA ERROR] ttsd_data_remove_sound_data() : uid is not valid (%d)\n", uid);	
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	vector<sound_data_s>::iterator iter = g_app_list[index].m_wav_data.begin();
+	while (iter != g_app_list[index].m_wav_data.end()) {
+		if (utt_id == iter->utt_id) {
+			ttsd_data_release_sound_data(&(*iter));
+			iter = g_app_list[index].m_wav_data.erase(iter);
+		} else {
+			iter++;
+		}
+	}
+
+#ifdef DATA_DEBUG
+	__data_show_sound_list(index);
+#endif 
+	return TTSD_ERROR_NONE;
+}
+
 int ttsd_data_clear_data(int uid)
 {
 	int index = 0;
@@ -316,7 +439,9 @@ int ttsd_data_clear_data(int uid)
 		return TTSD_ERROR_INVALID_PARAMETER;
 	}
 
-	int removed_last_uttid = -1;
+	/* synthesis started before this is stale */
+	g_app_list[index].generation++;
+
 	/* free allocated data */
 	while(1) {
 		speak_data_s temp;
@@ -326,12 +451,6 @@ int ttsd_data_clear_data(int uid)
 
 		if (NULL != temp.text)	free(temp.text);
 		if (NULL != temp.lang)	free(temp.lang);
-
-		removed_last_uttid = temp.utt_id;
-	}
-
-	if (-1 != removed_last_uttid) {
-		g_app_list[index].utt_id_stopped = removed_last_uttid;
 	}
 
 	while(1) {
@@ -340,7 +459,7 @@ int ttsd_data_clear_data(int uid)
 			break;
 		}
 
-		if (NULL != temp.data)	free(temp.data);
+		ttsd_data_release_sound_data(&temp);
 	}
 
 	g_app_list[index].m_speak_data.clear();
@@ -415,6 +534,145 @@ int ttsd_data_get_current_playing()
 	return -1;
 }
 
+int ttsd_data_set_client_priority(int uid, int priority)
+{
+	int index = 0;
+
+	index = ttsd_data_is_client(uid);
+	if (index < 0)	{
+		SLOG(LOG_ERROR, TAG_TTSD, "[DATA ERROR] ttsd_data_set_client_priority() : uid is not valid (%d)\n", uid);	
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	g_app_list[index].priority = priority;
+
+	return TTSD_ERROR_NONE;
+}
+
+int ttsd_data_get_client_priority(int uid, int* priority)
+{
+	int index = 0;
+
+	index = ttsd_data_is_client(uid);
+	if (index < 0)	{
+		SLOG(LOG_ERROR, TAG_TTSD, "[DATA ERROR] ttsd_data_get_client_priority() : uid is not valid (%d)\n", uid);	
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	*priority = g_app_list[index].priority;
+
+	return TTSD_ERROR_NONE;
+}
+
+int __data_get_effective_priority(int index)
+{
+	int priority = g_app_list[index].priority;
+
+	/* queues are sorted by priority, so the first one is the highest */
+	if (0 < g_app_list[index].m_speak_data.size() && g_app_list[index].m_speak_data[0].priority > priority)
+		priority = g_app_list[index].m_speak_data[0].priority;
+
+	if (0 < g_app_list[index].m_wav_data.size() && g_app_list[index].m_wav_data[0].priority > priority)
+		priority = g_app_list[index].m_wav_data[0].priority;
+
+	return priority;
+}
+
+int ttsd_data_get_effective_priority(int uid)
+{
+	int index = 0;
+
+	index = ttsd_data_is_client(uid);
+	if (index < 0)	{
+		SLOG(LOG_ERROR, TAG_TTSD, "[DATA ERROR] ttsd_data_get_effective_priority() : uid is not valid (%d)\n", uid);	
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	return __data_get_effective_priority(index);
+}
+
+long long __data_get_deadline(int index)
+{
+	if (0 == g_app_list[index].m_speak_data.size())
+		return 0;
+
+	if (g_app_list[index].m_speak_data[0].priority != __data_get_effective_priority(index))
+		return 0;
+
+	return g_app_list[index].m_speak_data[0].deadline;
+}
+
+long long ttsd_data_get_deadline(int uid)
+{
+	int index = 0;
+
+	index = ttsd_data_is_client(uid);
+	if (index < 0)	{
+		SLOG(LOG_ERROR, TAG_TTSD, "[DATA ERROR] ttsd_data_get_deadline() : uid is not valid (%d)\n", uid);	
+		return 0;
+	}
+
+	return __data_get_deadline(index);
+}
+
+int ttsd_data_set_preempted(int uid, bool is_preempted)
+{
+	int index = 0;
+
+	index = ttsd_data_is_client(uid);
+	if (index < 0)	{
+		SLOG(LOG_ERROR, TAG_TTSD, "[DATA ERROR] ttsd_data_set_preempted() : uid is not valid (%d)\n", uid);	
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	g_app_list[index].is_preempted = is_preempted;
+
+	return TTSD_ERROR_NONE;
+}
+
+bool ttsd_data_is_preempted(int uid)
+{
+	int index = 0;
+
+	index = ttsd_data_is_client(uid);
+	if (index < 0)	{
+		return false;
+	}
+
+	return g_app_list[index].is_preempted;
+}
+
+int ttsd_data_get_preempted_client()
+{
+	int vsize = g_app_list.size();
+	int uid = -1;
+	bool best_has_data = false;
+	int best_priority = -1;
+	long long best_deadline = 0;
+
+	for (int i=0; i<vsize; i++) {
+		if (true != g_app_list[i].is_preempted)
+			continue;
+
+		bool has_data = (0 < g_app_list[i].m_speak_data.size() || 0 < g_app_list[i].m_wav_data.size());
+		int priority = __data_get_effective_priority(i);
+		long long deadline = __data_get_deadline(i);
+
+		bool is_earlier = (0 != deadline && (0 == best_deadline || deadline < best_deadline));
+
+		if (-1 == uid || (has_data && !best_has_data) ||
+		    (has_data == best_has_data && priority > best_priority) ||
+		    (has_data == best_has_data && priority == best_priority && is_earlier)) {
+			uid = g_app_list[i].uid;
+			best_has_data = has_data;
+			best_priority = priority;
+			best_deadline = deadline;
+		}
+	}
+
+	return uid;
+}
+
 int ttsd_data_foreach_clients(ttsd_data_get_client_cb callback, void* user_data)
 {
 	if (NULL == callback) {
@@ -433,20 +691,19 @@ int ttsd_data_foreach_clients(ttsd_data_get_client_cb callback, void* user_data)
 	return 0;
 }
 
-bool ttsd_data_is_uttid_valid(int uid, int uttid)
+int ttsd_data_get_generation(int uid, unsigned int* generation)
 {
 	int index = 0;
 
 	index = ttsd_data_is_client(uid);
 	if (index < 0)	{
-		SLOG(LOG_ERROR, TAG_TTSD, "[DATA ERROR] ttsd_data_set_client_state() : uid is not valid (%d)\n", uid);	
+		SLOG(LOG_ERROR, TAG_TTSD, "[DATA ERROR] ttsd_data_get_generation() : uid is not valid (%d)\n", uid);	
 		return TTSD_ERROR_INVALID_PARAMETER;
 	}
 
-	if (uttid < g_app_list[index].utt_id_stopped)
-		return false;
+	*generation = g_app_list[index].generation;
 
-	return true;
+	return TTSD_ERROR_NONE;
 }
 
 int ttsd_data_is_current_playing()
@@ -38,6 +38,12 @@ typedef struct
 	char*			lang;
 	ttsp_voice_type_e	vctype;
 	ttsp_speed_e		speed;
+	int			priority;
+	long long		enqueue_time;	/* msec, monotonic */
+	long long		deadline;	/* msec, monotonic. 0 if none */
+	long long		expire_time;	/* msec, monotonic. 0 if text does not expire */
+	bool			is_stream;	/* text is pushed by client while it is synthesized */
+	int			audio_estimate;	/* msec, estimated duration of audio */
 }speak_data_s;
 
 typedef struct 
@@ -50,14 +56,19 @@ typedef struct
 	ttsp_audio_type_e	audio_type;
 	int			rate;
 	int			channels;
+
+	bool			is_cached;	/* data points into the prompt cache */
+	int			priority;
 }sound_data_s;
 
 typedef struct 
 {
 	int		pid;
 	int		uid;
-	int		utt_id_stopped;
+	unsigned int	generation;	/* increased when data of client is cleared */
 	app_state_e	state;
+	int		priority;
+	bool		is_preempted;	/* paused by higher priority client, resumed by daemon */
 	
 	std::vector<speak_data_s> m_speak_data;	
 	std::vector<sound_data_s> m_wav_data;
@@ -77,18 +88,33 @@ int ttsd_data_get_client_count();
 
 int ttsd_data_get_pid(int uid);
 
+/* Check whether text a is synthesized before text b : higher priority, then earlier deadline */
+bool ttsd_data_is_prior(const speak_data_s* a, const speak_data_s* b);
+
 int ttsd_data_add_speak_data(int uid, speak_data_s data);
 
 int ttsd_data_get_speak_data(int uid, speak_data_s* data);
 
+/* Put back the preempted text in front of the texts of the same priority */
+int ttsd_data_requeue_speak_data(int uid, speak_data_s data);
+
 int ttsd_data_get_speak_data_size(int uid);
 
+typedef bool(*ttsd_data_speak_data_cb)(int uid, speak_data_s* data, void* user_data);
+
+/* Callback may change voice of queued text, but not its order */
+int ttsd_data_foreach_speak_data(int uid, ttsd_data_speak_data_cb callback, void* user_data);
+
 int ttsd_data_add_sound_data(int uid, sound_data_s data);
 
 int ttsd_data_get_sound_data(int uid, sound_data_s* data);
 
 int ttsd_data_get_sound_data_size(int uid);
 
+int ttsd_data_release_sound_data(sound_data_s* data);
+
+int ttsd_data_remove_sound_data(int uid, int utt_id);
+
 int ttsd_data_clear_data(int uid);
 
 int ttsd_data_get_client_state(int pid, app_state_e* state);
@@ -97,11 +123,28 @@ int ttsd_data_set_client_state(int pid, app_state_e state);
 
 int ttsd_data_get_current_playing();
 
+int ttsd_data_set_client_priority(int uid, int priority);
+
+int ttsd_data_get_client_priority(int uid, int* priority);
+
+/* Higher one of client priority and priority of queued data */
+int ttsd_data_get_effective_priority(int uid);
+
+/* Deadline of the first text in effective priority. 0 if none */
+long long ttsd_data_get_deadline(int uid);
+
+int ttsd_data_set_preempted(int uid, bool is_preempted);
+
+bool ttsd_data_is_preempted(int uid);
+
+/* Get the preempted client to be resumed first. Clients with queued data come first. */
+int ttsd_data_get_preempted_client();
+
 typedef bool(*ttsd_data_get_client_cb)(int pid, int uid, app_state_e state, void* user_data);
 
 int ttsd_data_foreach_clients(ttsd_data_get_client_cb callback, void* user_data);
 
-bool ttsd_data_is_uttid_valid(int uid, int uttid);
+int ttsd_data_get_generation(int uid, unsigned int* generation);
 
 int ttsd_data_is_current_playing();
 
@@ -25,8 +25,110 @@ static DBusConnection* g_conn;
 
 static int g_waiting_time = 3000;
 
+/* Hello to client which is not answered yet */
+typedef struct {
+	int		pid;
+	int		uid;
+	dbus_uint32_t	serial;
+	DBusPendingCall* pending;
+} hello_s;
+
+static GList* g_hello_list = NULL;
+
+static hello_s* __ttsd_dbus_find_hello(int uid)
+{
+	GList* iter = g_list_first(g_hello_list);
+	while (NULL != iter) {
+		hello_s* hello = (hello_s*)iter->data;
+		if (uid == hello->uid)
+			return hello;
+		iter = g_list_next(iter);
+	}
+
+	return NULL;
+}
+
+static void __ttsd_dbus_free_hello(hello_s* hello)
+{
+	g_hello_list = g_list_remove(g_hello_list, hello);
+	dbus_pending_call_unref(hello->pending);
+	g_free(hello);
+}
+
+/* Reply of hello is handled in main loop, client which is not available is removed */
+static void __ttsd_dbus_handle_hello_reply(hello_s* hello, DBusMessage* result_msg)
+{
+	int pid = hello->pid;
+	int uid = hello->uid;
+	int result = -1;
+
+	__ttsd_dbus_free_hello(hello);
+
+	if (NULL == result_msg || DBUS_MESSAGE_TYPE_ERROR == dbus_message_get_type(result_msg)) {
+		SLOG(LOG_DEBUG, TAG_TTSD, ">>>> [Dbus] Hello is failed. Client is not available : pid(%d)", pid);
+		ttsd_server_remove_process(pid);
+		return;
+	}
+
+	DBusError err;
+	dbus_error_init(&err);
+
+	dbus_message_get_args(result_msg, &err, DBUS_TYPE_INT32, &result, DBUS_TYPE_INVALID);
+	if (dbus_error_is_set(&err)) {
+		SLOG(LOG_ERROR, TAG_TTSD, ">>>> [Dbus] Get arguments error (%s)", err.message);
+		dbus_error_free(&err);
+		result = -1;
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, ">>>> [Dbus] Get hello : uid(%d), result(%d)", uid, result);
+
+	if (0 == result) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Dbus] uid(%d) should be removed.", uid);
+		ttsd_server_finalize(uid);
+	}
+}
+
+static void __ttsd_dbus_hello_reply(DBusPendingCall* pending, void* user_data)
+{
+	DBusMessage* result_msg = dbus_pending_call_steal_reply(pending);
+
+	__ttsd_dbus_handle_hello_reply((hello_s*)user_data, result_msg);
+
+	if (NULL != result_msg)
+		dbus_message_unref(result_msg);
+}
+
+/* Reply which listener pops before it completes pending call */
+static void __ttsd_dbus_popped_reply(DBusMessage* msg)
+{
+	dbus_uint32_t serial = dbus_message_get_reply_serial(msg);
+
+	GList* iter = g_list_first(g_hello_list);
+	while (NULL != iter) {
+		hello_s* hello = (hello_s*)iter->data;
+		if (serial == hello->serial) {
+			dbus_pending_call_cancel(hello->pending);
+			__ttsd_dbus_handle_hello_reply(hello, msg);
+			return;
+		}
+		iter = g_list_next(iter);
+	}
+}
+
 int ttsdc_send_hello(int pid, int uid)
 {
+	/* client which did not answer to previous hello is hung */
+	hello_s* hello = __ttsd_dbus_find_hello(uid);
+	if (NULL != hello) {
+		if (!dbus_pending_call_get_completed(hello->pending)) {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[Dbus] Previous hello is not answered : uid(%d)", uid);
+			dbus_pending_call_cancel(hello->pending);
+			__ttsd_dbus_free_hello(hello);
+			return 0;
+		}
+		return 1;
+	}
+
 	char service_name[64];
 	memset(service_name, 0, 64);
 	snprintf(service_name, 64, "%s%d", TTS_CLIENT_SERVICE_NAME, pid);
@@ -52,31 +154,63 @@ int ttsdc_send_hello(int pid, int uid)
 
 	dbus_message_append_args(msg, DBUS_TYPE_INT32, &uid, DBUS_TYPE_INVALID);
 
-	DBusError err;
-	dbus_error_init(&err);
-
-	DBusMessage* result_msg;
-	int result = -1;
+	/* main loop does not wait for reply, hung client must not block daemon */
+	DBusPendingCall* pending = NULL;
+	if (!dbus_connection_send_with_reply(g_conn, msg, &pending, g_waiting_time) || NULL == pending) {
+		SLOG(LOG_ERROR, TAG_TTSD, "<<<< [Dbus ERROR] Fail to send hello message : uid(%d)", uid);
+		dbus_message_unref(msg);
+		return -1;
+	}
 
-	result_msg = dbus_connection_send_with_reply_and_block(g_conn, msg, g_waiting_time, &err);
+	hello = (hello_s*)g_malloc0(sizeof(hello_s));
+	hello->pid = pid;
+	hello->uid = uid;
+	hello->serial = dbus_message_get_serial(msg);
+	hello->pending = pending;
 	dbus_message_unref(msg);
 
-	if (NULL != result_msg) {
-		dbus_message_get_args(result_msg, &err, DBUS_TYPE_INT32, &result, DBUS_TYPE_INVALID);
+	if (!dbus_pending_call_set_notify(pending, __ttsd_dbus_hello_reply, hello, NULL)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "<<<< [Dbus ERROR] Fail to set reply of hello : uid(%d)", uid);
+		dbus_pending_call_cancel(pending);
+		dbus_pending_call_unref(pending);
+		g_free(hello);
+		return -1;
+	}
 
-		if (dbus_error_is_set(&err)) { 
-			SLOG(LOG_ERROR, TAG_TTSD, ">>>> [Dbus] Get arguments error (%s)", err.message);
-			dbus_error_free(&err); 
-			result = -1;
-		}
+	g_hello_list = g_list_append(g_hello_list, hello);
+	dbus_connection_flush(g_conn);
 
-		dbus_message_unref(result_msg);
-	} else {
-		SLOG(LOG_DEBUG, TAG_TTSD, ">>>> [Dbus] Result message is NULL. Client is not available");
-		result = 0;
+	return 1;
+}
+
+/* Client process is gone from bus when its service name loses owner */
+static void __ttsd_dbus_name_owner_changed(DBusMessage* msg)
+{
+	DBusError err;
+	dbus_error_init(&err);
+
+	const char* name = NULL;
+	const char* old_owner = NULL;
+	const char* new_owner = NULL;
+
+	if (!dbus_message_get_args(msg, &err, DBUS_TYPE_STRING, &name, DBUS_TYPE_STRING, &old_owner,
+				   DBUS_TYPE_STRING, &new_owner, DBUS_TYPE_INVALID)) {
+		if (dbus_error_is_set(&err))
+			dbus_error_free(&err);
+		return;
 	}
 
-	return result;
+	size_t prefix_len = strlen(TTS_CLIENT_SERVICE_NAME);
+	if (NULL == name || NULL == new_owner || '\0' != new_owner[0] || 0 != strncmp(name, TTS_CLIENT_SERVICE_NAME, prefix_len))
+		return;
+
+	char* end = NULL;
+	long pid = strtol(name + prefix_len, &end, 10);
+	if (end == name + prefix_len || '\0' != *end || 0 >= pid)
+		return;
+
+	SLOG(LOG_DEBUG, TAG_TTSD, ">>>> [Dbus] Client is gone from bus : pid(%ld)", pid);
+	ttsd_server_remove_process((int)pid);
 }
 
 int ttsdc_send_message(int pid, int uid, int data, char *method)
@@ -191,7 +325,13 @@ static Eina_Bool listener_event_callback(void* data, Ecore_Fd_Handler *fd_handle
 	}
 	
 	/* client event */
-	if (dbus_message_is_method_call(msg, TTS_SERVER_SERVICE_INTERFACE, TTS_METHOD_HELLO))
+	if (dbus_message_is_signal(msg, DBUS_INTERFACE_DBUS, "NameOwnerChanged"))
+		__ttsd_dbus_name_owner_changed(msg);
+
+	else if (DBUS_MESSAGE_TYPE_METHOD_RETURN == dbus_message_get_type(msg) || DBUS_MESSAGE_TYPE_ERROR == dbus_message_get_type(msg))
+		__ttsd_dbus_popped_reply(msg);
+
+	else if (dbus_message_is_method_call(msg, TTS_SERVER_SERVICE_INTERFACE, TTS_METHOD_HELLO))
 		ttsd_dbus_server_hello(conn, msg);
 
 	else if( dbus_message_is_method_call(msg, TTS_SERVER_SERVICE_INTERFACE, TTS_METHOD_INITIALIZE) )
@@ -218,6 +358,21 @@ static Eina_Bool listener_event_callback(void* data, Ecore_Fd_Handler *fd_handle
 	else if (dbus_message_is_method_call(msg, TTS_SERVER_SERVICE_INTERFACE, TTS_METHOD_PAUSE)) 
 		ttsd_dbus_server_pause(conn, msg);
 
+	else if (dbus_message_is_method_call(msg, TTS_SERVER_SERVICE_INTERFACE, TTS_METHOD_ADD_TEMPLATE)) 
+		ttsd_dbus_server_add_template(conn, msg);
+
+	else if (dbus_message_is_method_call(msg, TTS_SERVER_SERVICE_INTERFACE, TTS_METHOD_SET_PRIORITY)) 
+		ttsd_dbus_server_set_priority(conn, msg);
+
+	else if (dbus_message_is_method_call(msg, TTS_SERVER_SERVICE_INTERFACE, TTS_METHOD_OPEN_STREAM)) 
+		ttsd_dbus_server_open_stream(conn, msg);
+
+	else if (dbus_message_is_method_call(msg, TTS_SERVER_SERVICE_INTERFACE, TTS_METHOD_PUSH_STREAM)) 
+		ttsd_dbus_server_push_stream(conn, msg);
+
+	else if (dbus_message_is_method_call(msg, TTS_SERVER_SERVICE_INTERFACE, TTS_METHOD_CLOSE_STREAM)) 
+		ttsd_dbus_server_close_stream(conn, msg);
+
 	/* setting event */
 	else if (dbus_message_is_method_call(msg, TTS_SERVER_SERVICE_INTERFACE, TTS_SETTING_METHOD_HELLO))
 		ttsd_dbus_server_hello(conn, msg);
@@ -314,6 +469,15 @@ int ttsd_dbus_open_connection()
 		return -1; 
 	}
 
+	/* client which exits without finalize is removed at once */
+	dbus_bus_add_match(g_conn, "type='signal',sender='" DBUS_SERVICE_DBUS "',interface='" DBUS_INTERFACE_DBUS "',member='NameOwnerChanged'", &err);
+	dbus_connection_flush(g_conn);
+
+	if (dbus_error_is_set(&err)) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Dbus WARNING] Fail to watch clients on bus : %s", err.message);
+		dbus_error_free(&err);
+	}
+
 	int fd = 0;
 	dbus_connection_get_unix_fd(g_conn, &fd);
 
@@ -334,6 +498,12 @@ int ttsd_dbus_close_connection()
 	DBusError err;
 	dbus_error_init(&err);
 
+	while (NULL != g_hello_list) {
+		hello_s* hello = (hello_s*)g_hello_list->data;
+		dbus_pending_call_cancel(hello->pending);
+		__ttsd_dbus_free_hello(hello);
+	}
+
 	dbus_bus_release_name (g_conn, TTS_SERVER_SERVICE_NAME, &err);
 
 	if (dbus_error_is_set(&err)) {
@@ -24,6 +24,7 @@ int ttsd_dbus_open_connection();
 int ttsd_dbus_close_connection();
 
 
+/** Send hello without waiting for reply. 0 if previous hello is not answered, client which does not know uid is removed by reply. */
 int ttsdc_send_hello(int pid, int uid);
 
 int ttsdc_send_utt_start_message(int pid, int uid, int uttid);
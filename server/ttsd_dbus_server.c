@@ -296,7 +296,7 @@ int ttsd_dbus_server_add_text(DBusConnection* conn, DBusMessage* msg)
 	DBusError err;
 	dbus_error_init(&err);
 
-	int uid, voicetype, speed, uttid;
+	int uid, voicetype, speed, uttid, priority, deadline, staleness;
 	char *text, *lang;
 	int ret = 0;
 
@@ -307,6 +307,9 @@ int ttsd_dbus_server_add_text(DBusConnection* conn, DBusMessage* msg)
 		DBUS_TYPE_INT32, &voicetype,
 		DBUS_TYPE_INT32, &speed,
 		DBUS_TYPE_INT32, &uttid,
+		DBUS_TYPE_INT32, &priority,
+		DBUS_TYPE_INT32, &deadline,
+		DBUS_TYPE_INT32, &staleness,
 		DBUS_TYPE_INVALID);
 
 	SLOG(LOG_DEBUG, TAG_TTSD, ">>>>> TTS ADD TEXT");
@@ -317,9 +320,9 @@ int ttsd_dbus_server_add_text(DBusConnection* conn, DBusMessage* msg)
 		ret = TTSD_ERROR_OPERATION_FAILED;
 	} else {
 		
-		SLOG(LOG_DEBUG, TAG_TTSD, "[IN] tts add text : uid(%d), text(%s), lang(%s), type(%d), speed(%d), uttid(%d) \n", 
-			uid, text, lang, voicetype, speed, uttid); 
-		ret =  ttsd_server_add_queue(uid, text, lang, voicetype, speed, uttid);
+		SLOG(LOG_DEBUG, TAG_TTSD, "[IN] tts add text : uid(%d), text(%s), lang(%s), type(%d), speed(%d), uttid(%d), priority(%d), deadline(%d), staleness(%d) \n", 
+			uid, text, lang, voicetype, speed, uttid, priority, deadline, staleness); 
+		ret =  ttsd_server_add_queue(uid, text, lang, voicetype, speed, uttid, priority, deadline, staleness);
 	}
 
 	DBusMessage* reply;
@@ -504,6 +507,277 @@ int ttsd_dbus_server_pause(DBusConnection* conn, DBusMessage* msg)
 	return 0;
 }
 
+int ttsd_dbus_server_add_template(DBusConnection* conn, DBusMessage* msg)
+{
+	DBusError err;
+	dbus_error_init(&err);
+
+	int uid;
+	char* text_template;
+	int ret = 0;
+	dbus_message_get_args(msg, &err, 
+		DBUS_TYPE_INT32, &uid, 
+		DBUS_TYPE_STRING, &text_template,
+		DBUS_TYPE_INVALID);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, ">>>>> TTS ADD TEMPLATE");
+
+	if (dbus_error_is_set(&err)) { 
+		SLOG(LOG_ERROR, TAG_TTSD, "[IN ERROR] tts add template : Get arguments error (%s)\n", err.message);
+		dbus_error_free(&err); 
+		ret = TTSD_ERROR_OPERATION_FAILED;
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[IN] tts add template : uid(%d), template(%s)\n", uid, text_template);
+		ret = ttsd_server_add_template(uid, text_template);
+	}
+
+	DBusMessage* reply;
+	reply = dbus_message_new_method_return(msg);
+
+	if (NULL != reply) {
+		dbus_message_append_args(reply, 
+			DBUS_TYPE_INT32, &ret, 
+			DBUS_TYPE_INVALID);
+
+		if (0 == ret) {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[OUT] tts add template : result(%d) \n", ret); 
+		} else {
+			SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts add template : result(%d) \n", ret); 
+		}
+
+		if (!dbus_connection_send(conn, reply, NULL)) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts add template : Out Of Memory!\n");
+		}
+
+		dbus_connection_flush(conn);
+		dbus_message_unref(reply);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts add template : fail to create reply message!!"); 
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "<<<<<");
+	SLOG(LOG_DEBUG, TAG_TTSD, "  ");
+
+	return 0;
+}
+
+int ttsd_dbus_server_set_priority(DBusConnection* conn, DBusMessage* msg)
+{
+	DBusError err;
+	dbus_error_init(&err);
+
+	int uid;
+	int priority;
+	int ret = 0;
+	dbus_message_get_args(msg, &err, 
+		DBUS_TYPE_INT32, &uid, 
+		DBUS_TYPE_INT32, &priority,
+		DBUS_TYPE_INVALID);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, ">>>>> TTS SET PRIORITY");
+
+	if (dbus_error_is_set(&err)) { 
+		SLOG(LOG_ERROR, TAG_TTSD, "[IN ERROR] tts set priority : Get arguments error (%s)\n", err.message);
+		dbus_error_free(&err); 
+		ret = TTSD_ERROR_OPERATION_FAILED;
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[IN] tts set priority : uid(%d), priority(%d)\n", uid, priority);
+		ret = ttsd_server_set_priority(uid, priority);
+	}
+
+	DBusMessage* reply;
+	reply = dbus_message_new_method_return(msg);
+
+	if (NULL != reply) {
+		dbus_message_append_args(reply, 
+			DBUS_TYPE_INT32, &ret, 
+			DBUS_TYPE_INVALID);
+
+		if (0 == ret) {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[OUT] tts set priority : result(%d) \n", ret); 
+		} else {
+			SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts set priority : result(%d) \n", ret); 
+		}
+
+		if (!dbus_connection_send(conn, reply, NULL)) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts set priority : Out Of Memory!\n");
+		}
+
+		dbus_connection_flush(conn);
+		dbus_message_unref(reply);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts set priority : fail to create reply message!!"); 
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "<<<<<");
+	SLOG(LOG_DEBUG, TAG_TTSD, "  ");
+
+	return 0;
+}
+
+int ttsd_dbus_server_open_stream(DBusConnection* conn, DBusMessage* msg)
+{
+	DBusError err;
+	dbus_error_init(&err);
+
+	int uid, voicetype, speed, uttid;
+	char* lang;
+	int ret = 0;
+	dbus_message_get_args(msg, &err, 
+		DBUS_TYPE_INT32, &uid, 
+		DBUS_TYPE_STRING, &lang,
+		DBUS_TYPE_INT32, &voicetype,
+		DBUS_TYPE_INT32, &speed,
+		DBUS_TYPE_INT32, &uttid,
+		DBUS_TYPE_INVALID);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, ">>>>> TTS OPEN STREAM");
+
+	if (dbus_error_is_set(&err)) { 
+		SLOG(LOG_ERROR, TAG_TTSD, "[IN ERROR] tts open stream : Get arguments error (%s)\n", err.message);
+		dbus_error_free(&err); 
+		ret = TTSD_ERROR_OPERATION_FAILED;
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[IN] tts open stream : uid(%d), lang(%s), type(%d), speed(%d), uttid(%d)\n", uid, lang, voicetype, speed, uttid);
+		ret = ttsd_server_open_stream(uid, lang, voicetype, speed, uttid);
+	}
+
+	DBusMessage* reply;
+	reply = dbus_message_new_method_return(msg);
+
+	if (NULL != reply) {
+		dbus_message_append_args(reply, 
+			DBUS_TYPE_INT32, &ret, 
+			DBUS_TYPE_INVALID);
+
+		if (0 == ret) {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[OUT] tts open stream : result(%d) \n", ret); 
+		} else {
+			SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts open stream : result(%d) \n", ret); 
+		}
+
+		if (!dbus_connection_send(conn, reply, NULL)) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts open stream : Out Of Memory!\n");
+		}
+
+		dbus_connection_flush(conn);
+		dbus_message_unref(reply);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts open stream : fail to create reply message!!"); 
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "<<<<<");
+	SLOG(LOG_DEBUG, TAG_TTSD, "  ");
+
+	return 0;
+}
+
+int ttsd_dbus_server_push_stream(DBusConnection* conn, DBusMessage* msg)
+{
+	DBusError err;
+	dbus_error_init(&err);
+
+	int uid;
+	char* text;
+	int ret = 0;
+	dbus_message_get_args(msg, &err, 
+		DBUS_TYPE_INT32, &uid, 
+		DBUS_TYPE_STRING, &text,
+		DBUS_TYPE_INVALID);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, ">>>>> TTS PUSH STREAM");
+
+	if (dbus_error_is_set(&err)) { 
+		SLOG(LOG_ERROR, TAG_TTSD, "[IN ERROR] tts push stream : Get arguments error (%s)\n", err.message);
+		dbus_error_free(&err); 
+		ret = TTSD_ERROR_OPERATION_FAILED;
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[IN] tts push stream : uid(%d), text(%s)\n", uid, text);
+		ret = ttsd_server_push_stream(uid, text);
+	}
+
+	DBusMessage* reply;
+	reply = dbus_message_new_method_return(msg);
+
+	if (NULL != reply) {
+		dbus_message_append_args(reply, 
+			DBUS_TYPE_INT32, &ret, 
+			DBUS_TYPE_INVALID);
+
+		if (0 == ret) {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[OUT] tts push stream : result(%d) \n", ret); 
+		} else {
+			SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts push stream : result(%d) \n", ret); 
+		}
+
+		if (!dbus_connection_send(conn, reply, NULL)) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts push stream : Out Of Memory!\n");
+		}
+
+		dbus_connection_flush(conn);
+		dbus_message_unref(reply);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts push stream : fail to create reply message!!"); 
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "<<<<<");
+	SLOG(LOG_DEBUG, TAG_TTSD, "  ");
+
+	return 0;
+}
+
+int ttsd_dbus_server_close_stream(DBusConnection* conn, DBusMessage* msg)
+{
+	DBusError err;
+	dbus_error_init(&err);
+
+	int uid;
+	int ret = 0;
+	dbus_message_get_args(msg, &err, 
+		DBUS_TYPE_INT32, &uid, 
+		DBUS_TYPE_INVALID);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, ">>>>> TTS CLOSE STREAM");
+
+	if (dbus_error_is_set(&err)) { 
+		SLOG(LOG_ERROR, TAG_TTSD, "[IN ERROR] tts close stream : Get arguments error (%s)\n", err.message);
+		dbus_error_free(&err); 
+		ret = TTSD_ERROR_OPERATION_FAILED;
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[IN] tts close stream : uid(%d)\n", uid);
+		ret = ttsd_server_close_stream(uid);
+	}
+
+	DBusMessage* reply;
+	reply = dbus_message_new_method_return(msg);
+
+	if (NULL != reply) {
+		dbus_message_append_args(reply, 
+			DBUS_TYPE_INT32, &ret, 
+			DBUS_TYPE_INVALID);
+
+		if (0 == ret) {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[OUT] tts close stream : result(%d) \n", ret); 
+		} else {
+			SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts close stream : result(%d) \n", ret); 
+		}
+
+		if (!dbus_connection_send(conn, reply, NULL)) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts close stream : Out Of Memory!\n");
+		}
+
+		dbus_connection_flush(conn);
+		dbus_message_unref(reply);
+	} else {
+		SLOG(LOG_ERROR, TAG_TTSD, "[OUT ERROR] tts close stream : fail to create reply message!!"); 
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "<<<<<");
+	SLOG(LOG_DEBUG, TAG_TTSD, "  ");
+
+	return 0;
+}
+
 
 /*
 * Dbus Setting-Daemon Server
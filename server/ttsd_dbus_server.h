@@ -43,6 +43,16 @@ int ttsd_dbus_server_stop(DBusConnection* conn, DBusMessage* msg);
 
 int ttsd_dbus_server_pause(DBusConnection* conn, DBusMessage* msg);
 
+int ttsd_dbus_server_add_template(DBusConnection* conn, DBusMessage* msg);
+
+int ttsd_dbus_server_set_priority(DBusConnection* conn, DBusMessage* msg);
+
+int ttsd_dbus_server_open_stream(DBusConnection* conn, DBusMessage* msg);
+
+int ttsd_dbus_server_push_stream(DBusConnection* conn, DBusMessage* msg);
+
+int ttsd_dbus_server_close_stream(DBusConnection* conn, DBusMessage* msg);
+
 
 /*
 * Dbus Server functions for Setting
@@ -14,16 +14,51 @@
 
 #include <dlfcn.h>
 #include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <Ecore.h>
 
 #include "ttsd_main.h"
 #include "ttsd_engine_agent.h"
 #include "ttsd_config.h"
+#include "ttsd_cache.h"
+#include "ttsd_stats.h"
+#include "ttsd_engine_host.h"
+#include "ttsd_buffer.h"
+#include "ttsd_resource.h"
+#include "ttsd_result_queue.h"
+#include "ttsd_network.h"
 
 #define	ENGINE_PATH_SIZE	256
 
+#define	VOICE_TYPE_MAX		TTSP_VOICE_TYPE_USER3
+
+#define	ENGINE_MANIFEST_PATH		BASE_DIRECTORY_DOWNLOAD"ttsd_engine_manifest"
+#define	ENGINE_MANIFEST_TEMP_PATH	BASE_DIRECTORY_DOWNLOAD"ttsd_engine_manifest.tmp"
+#define	ENGINE_MANIFEST_VERSION		2
+#define	ENGINE_MANIFEST_LINE_MAX	1024
+
+#define	ENGINE_PROBE_THREAD_MAX		4
+
+#define	ENGINE_MAX_LOADED_DEFAULT	3
+
+#define	HYBRID_HEDGE_DELAY_DEFAULT	300	/* msec */
+
+#define	BATCH_SIZE_MAX_DEFAULT		8
+
 /*
 * Internal data structure
 */
+
+/* Voice types of a language in the voice index */
+typedef struct {
+	char*	language;
+	int	type_count;
+	ttsp_voice_type_e types[VOICE_TYPE_MAX];
+} voice_index_s;
+
 typedef struct {
 	/* base info */
 	char*	engine_uuid;
@@ -44,6 +79,28 @@ typedef struct {
 	ttspe_funcs_s*	pefuncs;
 	ttspd_funcs_s*	pdfuncs;
 
+	/* voice index, built when engine is loaded */
+	GList*		voice_list;		/* voice_index_s in order of engine */
+	GHashTable*	voice_table;		/* language and its prefix before '_' -> voice_index_s */
+
+	/* audio format of engine, queried when engine is loaded */
+	ttsp_audio_type_e audio_type;
+	int		audio_rate;
+	int		audio_channels;
+
+	/* ttsp_capability_e of engine */
+	int		capability;
+
+	/* engine process, NULL if engine is loaded in daemon */
+	ttsd_engine_host_h	host;
+
+	/* initialize() of engine succeeded, engine needs __internal_close_engine() in main loop */
+	bool		is_initialized;
+
+	/* thread which preloads voice of thread-safe engine */
+	pthread_t	preload_thread;
+	bool		is_preloading;
+
 	int (*ttsp_load_engine)(const ttspd_funcs_s* pdfuncs, ttspe_funcs_s* pefuncs);
 	int (*ttsp_unload_engine)();
 } ttsengine_s;
@@ -54,8 +111,19 @@ typedef struct {
 	char*	engine_name;
 	char*	setting_ug_path;
 	bool	use_network;
+	GList*	languages;		/* languages of engine, known after it is loaded once */
+	bool	is_probed;
 } ttsengine_info_s;
 
+/* Probe result of a plugin file, reused while the file is not changed */
+typedef struct {
+	char*	path;
+	ino_t	inode;
+	off_t	size;
+	time_t	mtime;
+	ttsengine_info_s* info;		/* NULL if the file is not a valid engine */
+} engine_manifest_s;
+
 
 /** Init flag */
 static bool g_agent_init;
@@ -63,12 +131,88 @@ static bool g_agent_init;
 /** TTS engine list */
 static GList *g_engine_list;		
 
+/** Manifest of plugin files, path -> engine_manifest_s */
+static GHashTable *g_engine_manifest;
+
 /** Current engine information */
 static ttsengine_s g_cur_engine;
 
 /** Result callback function */
 static synth_result_callback g_result_cb;
 
+/** Engine loaded in background to replace current engine */
+static ttsengine_s* g_next_engine = NULL;
+static pthread_t g_next_thread;
+static bool g_is_next_loading = false;
+static bool g_is_next_canceled = false;
+static long long g_next_start_time = 0;
+static ttsd_engine_prepared_cb g_next_prepared_cb = NULL;
+
+/** Engines loaded for languages which current engine does not support, most recently used first */
+static GList* g_sub_engines = NULL;
+
+/** Engine of the text being synthesized */
+static ttsengine_s* g_synth_engine = NULL;
+
+/** Text stream. Engine without stream functions synthesizes it sentence by sentence. */
+typedef struct {
+	bool		is_open;
+	bool		is_native;		/* engine has stream functions */
+	bool		is_closed;		/* no more text */
+	bool		is_synthesizing;	/* sentence is being synthesized */
+	bool		is_started;		/* START is sent */
+	ttsengine_s*	engine;
+	char*		lang;
+	ttsp_voice_type_e type;
+	ttsp_speed_e	speed;
+	void*		user_data;
+	GString*	text;			/* text which is not synthesized yet */
+	Ecore_Timer*	timer;
+} stream_s;
+
+static stream_s g_stream;
+
+/**
+* Hybrid synthesis. Text for network engine is also given to local fallback engine,
+* first audio wins and the other engine is canceled.
+*/
+typedef enum {
+	HYBRID_PATH_NETWORK = 0,
+	HYBRID_PATH_LOCAL,
+	HYBRID_PATH_COUNT
+} hybrid_path_e;
+
+typedef struct hybrid_race_s hybrid_race_s;
+
+/** Path is given to engine as user data, instead of user data of server */
+typedef struct {
+	hybrid_race_s*	race;
+	ttsengine_s*	engine;		/* NULL if engine is not available */
+	char*		lang;
+	ttsp_voice_type_e type;
+	bool		is_started;	/* engine may send result */
+	bool		is_tried;	/* start_synth() is called once */
+	ttsd_stats_latency_e latency;
+} hybrid_path_s;
+
+struct hybrid_race_s {
+	void*		user_data;	/* user data of server */
+	char*		text;
+	ttsp_speed_e	speed;
+	hybrid_path_s	path[HYBRID_PATH_COUNT];
+	hybrid_path_s*	winner;		/* path whose results are sent to server, NULL until first audio */
+	long long	start_time;
+	Ecore_Timer*	hedge_timer;	/* starts local path if network path is slow */
+	bool		is_done;	/* last event is sent to server */
+	int		ref;		/* race is used in this call stack */
+};
+
+/** Races whose engine may send result */
+static GList* g_races = NULL;
+
+/** Race of current text */
+static hybrid_race_s* g_race = NULL;
+
 
 /** Set current engine */
 int __internal_set_current_engine(const char* engine_uuid);
@@ -82,9 +226,15 @@ int __internal_update_engine_list();
 /** Get engine info */
 int __internal_get_engine_info(const char* filepath, ttsengine_info_s** info);
 
+/** Free engine info */
+void __internal_free_engine_info(ttsengine_info_s* info);
+
 /** Callback function for result */
 bool __result_cb(ttsp_result_event_e event, const void* data, unsigned int data_size, void *user_data);
 
+/** Pass result to server in main thread */
+void __internal_deliver_result(ttsp_result_event_e event, const void* data, unsigned int data_size, void *user_data);
+
 /** Callback function for voice list */
 bool __supported_voice_cb(const char* language, ttsp_voice_type_e type, void* user_data);
 
@@ -95,6 +245,80 @@ void __free_voice_list(GList* voice_list);
 void __engine_info_cb(const char* engine_uuid, const char* engine_name, const char* setting_ug_name, 
 		      bool use_network, void* user_data);
 
+/** Get hash of voice list to detect changes of voice set */
+unsigned int __internal_get_voice_hash();
+
+/** Build voice index of engine */
+int __internal_build_voice_index(ttsengine_s* engine);
+
+/** Release voice index of engine */
+void __internal_free_voice_index(ttsengine_s* engine);
+
+/** Close engine opened by __internal_open_engine(), also after it failed with is_initialized set. Main loop only. */
+void __internal_close_engine(ttsengine_s* engine);
+
+/** Load engine library in daemon and get engine functions */
+int __internal_load_engine_library(ttsengine_s* engine);
+
+/** Unload engine library or stop engine process */
+void __internal_unload_engine_library(ttsengine_s* engine);
+
+/** Let engine prepare voice before synthesis, if engine supports it */
+void __internal_preload_voice(ttsengine_s* engine, const char* lang, int type);
+
+/** Free engine which is not current engine */
+void __internal_free_engine(ttsengine_s* engine);
+
+/** Find voice index entry of language */
+const voice_index_s* __internal_find_voice(ttsengine_s* engine, const char* lang);
+
+/** Get engine for language which current engine does not support */
+ttsengine_s* __internal_route_engine(const char* lang);
+
+/** Record languages of engine to engine list and manifest */
+void __internal_set_engine_languages(ttsengine_s* engine);
+
+/** Close text stream without event */
+void __internal_reset_stream();
+
+/** Convert result of sentence to result of text stream. Returns false if the result is not sent. */
+bool __internal_filter_stream_result(ttsp_result_event_e* event, unsigned int data_size);
+
+/** Check whether current engine is backed up by local engine */
+bool __internal_is_hybrid();
+
+/** Get local fallback engine, loading it if needed */
+ttsengine_s* __internal_get_fallback_engine();
+
+/** Get local fallback engine if it is loaded */
+ttsengine_s* __internal_get_loaded_fallback_engine();
+
+/** Start text on network engine and local fallback engine */
+int __internal_start_race(const char* lang, ttsp_voice_type_e type, const char* text, ttsp_speed_e speed, void* user_param);
+
+/** Cancel race of current text */
+void __internal_cancel_race();
+
+/** Find race path of user data given to engine */
+hybrid_path_s* __internal_find_race_path(void* user_data);
+
+/** Handle result of race path */
+void __internal_deliver_race_result(hybrid_path_s* path, ttsp_result_event_e event, const void* data, unsigned int data_size);
+
+/** Engine is closed, it sends no more result */
+void __internal_detach_race_engine(ttsengine_s* engine);
+
+/** Fail over race of current text when network is out */
+void __internal_network_changed_cb(bool is_connected);
+
+void __internal_unload_sub_engine(ttsengine_s* engine);
+
+void __internal_unload_sub_engine_by_id(const char* engine_uuid);
+
+void __internal_unload_sub_engines();
+
+int __internal_save_engine_manifest();
+
 /** Callback fucntion for engine setting */
 bool __engine_setting_cb(const char* key, const char* value, void* user_data);
 
@@ -115,11 +339,19 @@ int ttsd_engine_agent_init(synth_result_callback result_cb)
 
 	g_cur_engine.is_set = false;
 	g_cur_engine.handle = NULL;
+	g_cur_engine.host = NULL;
 	g_cur_engine.pefuncs = (ttspe_funcs_s*)g_malloc0( sizeof(ttspe_funcs_s) );
 	g_cur_engine.pdfuncs = (ttspd_funcs_s*)g_malloc0( sizeof(ttspd_funcs_s) );
 
 	g_agent_init = true;
 
+	/* results of engine threads are passed to main loop */
+	if (0 != ttsd_result_queue_initialize(__internal_deliver_result)) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Fail to initialize result queue, results are passed in engine thread");
+	}
+
+	ttsd_network_set_changed_cb(__internal_network_changed_cb);
+
 	if (0 != ttsd_config_get_default_voice(&(g_cur_engine.default_lang), &(g_cur_engine.default_vctype))) {
 		SLOG(LOG_WARN, TAG_TTSD, "[Server WARNING] There is No default voice in config\n"); 
 		/* Set default voice */
@@ -148,9 +380,12 @@ int ttsd_engine_agent_release()
 	/* unload current engine */
 	ttsd_engine_agent_unload_current_engine();
 
+	/* engine being loaded in thread is released when it is done */
+	ttsd_engine_agent_cancel_next_engine();
+
 	/* release engine list */
 	GList *iter = NULL;
-	ttsengine_s *data = NULL;
+	ttsengine_info_s *data = NULL;
 
 	if (g_list_length(g_engine_list) > 0) {
 		/* Get a first item */
@@ -159,13 +394,17 @@ int ttsd_engine_agent_release()
 		while (NULL != iter) {
 			/* Get data from item */
 			data = iter->data;
-			dlclose(data->handle); 
+			__internal_free_engine_info(data);
 
-			iter = g_list_remove(iter, data);
+			g_engine_list = g_list_remove_link(g_engine_list, iter);
+			iter = g_list_first(g_engine_list);
 		}
 	}
 
-	g_list_free(iter);
+	if (NULL != g_engine_manifest) {
+		g_hash_table_destroy(g_engine_manifest);
+		g_engine_manifest = NULL;
+	}
 
 	/* release current engine data */
 	if (g_cur_engine.pefuncs != NULL)
@@ -174,6 +413,8 @@ int ttsd_engine_agent_release()
 	if (g_cur_engine.pdfuncs != NULL)
 		g_free(g_cur_engine.pdfuncs);
 
+	ttsd_result_queue_finalize();
+
 	g_result_cb = NULL;
 	g_agent_init = false;
 
@@ -386,6 +627,301 @@ int __internal_get_engine_info(const char* filepath, ttsengine_info_s** info)
 	return 0;
 }
 
+void __internal_free_engine_info(ttsengine_info_s* info)
+{
+	if (NULL == info)
+		return;
+
+	if (NULL != info->engine_uuid)		g_free(info->engine_uuid);
+	if (NULL != info->engine_name)		g_free(info->engine_name);
+	if (NULL != info->engine_path)		g_free(info->engine_path);
+	if (NULL != info->setting_ug_path)	g_free(info->setting_ug_path);
+
+	g_list_free_full(info->languages, g_free);
+
+	g_free(info);
+}
+
+ttsengine_info_s* __internal_copy_engine_info(const ttsengine_info_s* info)
+{
+	ttsengine_info_s* temp = (ttsengine_info_s*)g_malloc0(sizeof(ttsengine_info_s));
+
+	temp->engine_uuid = g_strdup(info->engine_uuid);
+	temp->engine_name = g_strdup(info->engine_name);
+	temp->engine_path = g_strdup(info->engine_path);
+	temp->setting_ug_path = g_strdup(info->setting_ug_path);
+	temp->use_network = info->use_network;
+	temp->is_probed = info->is_probed;
+
+	GList *iter = g_list_first(info->languages);
+	while (NULL != iter) {
+		temp->languages = g_list_append(temp->languages, g_strdup((const char*)iter->data));
+		iter = g_list_next(iter);
+	}
+
+	return temp;
+}
+
+void __manifest_free_entry(gpointer data)
+{
+	engine_manifest_s* entry = (engine_manifest_s*)data;
+
+	if (NULL == entry)
+		return;
+
+	__internal_free_engine_info(entry->info);
+	g_free(entry->path);
+	g_free(entry);
+}
+
+/* Fields are separated by tab, so they should not contain tab or new line */
+static bool __manifest_is_valid_field(const char* field)
+{
+	return (NULL == field || NULL == strpbrk(field, "\t\n"));
+}
+
+int __internal_load_engine_manifest()
+{
+	g_engine_manifest = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, __manifest_free_entry);
+
+	FILE* fp = fopen(ENGINE_MANIFEST_PATH, "r");
+	if (NULL == fp) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] No engine manifest");
+		return 0;
+	}
+
+	char line[ENGINE_MANIFEST_LINE_MAX];
+	int version = 0;
+
+	if (NULL == fgets(line, sizeof(line), fp) || 1 != sscanf(line, "version %d", &version) || ENGINE_MANIFEST_VERSION != version) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Engine manifest is not valid, all engines are probed");
+		fclose(fp);
+		return 0;
+	}
+
+	while (NULL != fgets(line, sizeof(line), fp)) {
+		g_strchomp(line);
+
+		/* path inode size mtime valid uuid name setting_ug network languages */
+		char** fields = g_strsplit(line, "\t", 0);
+		if (10 != g_strv_length(fields)) {
+			g_strfreev(fields);
+			continue;
+		}
+
+		engine_manifest_s* entry = (engine_manifest_s*)g_malloc0(sizeof(engine_manifest_s));
+		entry->path = g_strdup(fields[0]);
+		entry->inode = (ino_t)strtoull(fields[1], NULL, 10);
+		entry->size = (off_t)strtoll(fields[2], NULL, 10);
+		entry->mtime = (time_t)strtoll(fields[3], NULL, 10);
+
+		if (0 == strcmp(fields[4], "1")) {
+			entry->info = (ttsengine_info_s*)g_malloc0(sizeof(ttsengine_info_s));
+			entry->info->engine_path = g_strdup(fields[0]);
+			entry->info->engine_uuid = g_strdup(fields[5]);
+			entry->info->engine_name = g_strdup(fields[6]);
+			entry->info->setting_ug_path = ('\0' != fields[7][0]) ? g_strdup(fields[7]) : NULL;
+			entry->info->use_network = (0 == strcmp(fields[8], "1"));
+
+			/* empty if engine has not been loaded yet */
+			if ('\0' != fields[9][0]) {
+				char** languages = g_strsplit(fields[9], ",", 0);
+				int i;
+				for (i = 0; NULL != languages[i]; i++)
+					entry->info->languages = g_list_append(entry->info->languages, g_strdup(languages[i]));
+				g_strfreev(languages);
+				entry->info->is_probed = true;
+			}
+		}
+
+		g_hash_table_insert(g_engine_manifest, entry->path, entry);
+		g_strfreev(fields);
+	}
+
+	fclose(fp);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Load engine manifest : %d files", g_hash_table_size(g_engine_manifest));
+
+	return 0;
+}
+
+static void __manifest_write_entry(gpointer key, gpointer value, gpointer user_data)
+{
+	engine_manifest_s* entry = (engine_manifest_s*)value;
+	FILE* fp = (FILE*)user_data;
+	ttsengine_info_s* info = entry->info;
+
+	if (false == __manifest_is_valid_field(entry->path))
+		return;
+
+	if (NULL != info && (NULL == info->engine_uuid || NULL == info->engine_name ||
+	    false == __manifest_is_valid_field(info->engine_uuid) || false == __manifest_is_valid_field(info->engine_name) ||
+	    false == __manifest_is_valid_field(info->setting_ug_path))) {
+		/* probed again next time */
+		return;
+	}
+
+	fprintf(fp, "%s\t%llu\t%lld\t%lld\t%d\t%s\t%s\t%s\t%d\t", entry->path,
+		(unsigned long long)entry->inode, (long long)entry->size, (long long)entry->mtime, NULL != info,
+		NULL != info ? info->engine_uuid : "", NULL != info ? info->engine_name : "",
+		(NULL != info && NULL != info->setting_ug_path) ? info->setting_ug_path : "",
+		(NULL != info && info->use_network) ? 1 : 0);
+
+	GList *iter = (NULL != info && true == info->is_probed) ? g_list_first(info->languages) : NULL;
+	while (NULL != iter) {
+		const char* language = (const char*)iter->data;
+		if (NULL == strpbrk(language, "\t\n,"))
+			fprintf(fp, "%s%s", language, NULL != g_list_next(iter) ? "," : "");
+		iter = g_list_next(iter);
+	}
+
+	fprintf(fp, "\n");
+}
+
+int __internal_save_engine_manifest()
+{
+	FILE* fp = fopen(ENGINE_MANIFEST_TEMP_PATH, "w");
+	if (NULL == fp) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Fail to open engine manifest : %s", strerror(errno));
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	fprintf(fp, "version %d\n", ENGINE_MANIFEST_VERSION);
+	g_hash_table_foreach(g_engine_manifest, __manifest_write_entry, fp);
+
+	if (0 != fclose(fp) || 0 != rename(ENGINE_MANIFEST_TEMP_PATH, ENGINE_MANIFEST_PATH)) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Fail to write engine manifest : %s", strerror(errno));
+		unlink(ENGINE_MANIFEST_TEMP_PATH);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	return 0;
+}
+
+/* Plugin files to probe, shared by probe threads */
+typedef struct {
+	engine_manifest_s**	entries;
+	int			count;
+	int			next;
+	pthread_mutex_t		mutex;
+} engine_probe_s;
+
+static void* __engine_probe_thread(void* data)
+{
+	engine_probe_s* probe = (engine_probe_s*)data;
+
+	while (1) {
+		pthread_mutex_lock(&probe->mutex);
+		int index = probe->next++;
+		pthread_mutex_unlock(&probe->mutex);
+
+		if (index >= probe->count)
+			break;
+
+		engine_manifest_s* entry = probe->entries[index];
+		if (0 != __internal_get_engine_info(entry->path, &entry->info))
+			entry->info = NULL;
+	}
+
+	return NULL;
+}
+
+/* Get engine info of changed or new plugin files in parallel */
+void __internal_probe_engines(GList* entries)
+{
+	engine_probe_s probe;
+	probe.count = g_list_length(entries);
+	probe.next = 0;
+
+	if (0 == probe.count)
+		return;
+
+	probe.entries = (engine_manifest_s**)g_malloc0(sizeof(engine_manifest_s*) * probe.count);
+
+	GList *iter = g_list_first(entries);
+	int i = 0;
+	while (NULL != iter) {
+		probe.entries[i++] = iter->data;
+		iter = g_list_next(iter);
+	}
+
+	pthread_mutex_init(&probe.mutex, NULL);
+
+	long cpu = sysconf(_SC_NPROCESSORS_ONLN);
+	int thread_count = (int)((cpu < ENGINE_PROBE_THREAD_MAX) ? cpu : ENGINE_PROBE_THREAD_MAX);
+	if (thread_count > probe.count)
+		thread_count = probe.count;
+
+	pthread_t threads[ENGINE_PROBE_THREAD_MAX];
+	int started = 0;
+
+	/* this thread probes too, so one less thread is created */
+	for (i = 0; i < thread_count - 1; i++) {
+		if (0 != pthread_create(&threads[started], NULL, __engine_probe_thread, &probe)) {
+			SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Fail to create probe thread");
+			break;
+		}
+		started++;
+	}
+
+	__engine_probe_thread(&probe);
+
+	for (i = 0; i < started; i++)
+		pthread_join(threads[i], NULL);
+
+	pthread_mutex_destroy(&probe.mutex);
+	g_free(probe.entries);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Probe %d engine files with %d threads", probe.count, started + 1);
+}
+
+/* Find plugin files in directory. Unchanged files are taken from the old manifest, others are added to probe list. */
+void __internal_scan_engine_directory(const char* directory, GHashTable* manifest, GList** files, GList** probe_list)
+{
+	DIR *dp;
+	struct dirent *dirp;
+	dp = opendir(directory);
+
+	if (NULL == dp)
+		return;
+
+	while ((dirp = readdir(dp)) != NULL) {
+		if (0 == strcmp(dirp->d_name, ".") || 0 == strcmp(dirp->d_name, ".."))
+			continue;
+
+		char* filepath = g_strdup_printf("%s/%s", directory, dirp->d_name);
+		struct stat st;
+
+		if (0 != stat(filepath, &st) || !S_ISREG(st.st_mode)) {
+			g_free(filepath);
+			continue;
+		}
+
+		engine_manifest_s* entry = NULL;
+		if (NULL != g_engine_manifest)
+			entry = (engine_manifest_s*)g_hash_table_lookup(g_engine_manifest, filepath);
+
+		if (NULL != entry && entry->inode == st.st_ino && entry->size == st.st_size && entry->mtime == st.st_mtime) {
+			/* move unchanged entry to new manifest */
+			g_hash_table_steal(g_engine_manifest, filepath);
+			g_free(filepath);
+		} else {
+			entry = (engine_manifest_s*)g_malloc0(sizeof(engine_manifest_s));
+			entry->path = filepath;
+			entry->inode = st.st_ino;
+			entry->size = st.st_size;
+			entry->mtime = st.st_mtime;
+
+			*probe_list = g_list_append(*probe_list, entry);
+		}
+
+		g_hash_table_insert(manifest, entry->path, entry);
+		*files = g_list_append(*files, entry);
+	}
+
+	closedir(dp);
+}
+
 int __internal_update_engine_list()
 {
 	/* relsease engine list */
@@ -398,83 +934,50 @@ int __internal_update_engine_list()
 		while (NULL != iter) {
 			data = iter->data;
 
-			if (data != NULL)
-				g_free(data);
+			__internal_free_engine_info(data);
 
 			g_engine_list = g_list_remove_link(g_engine_list, iter);
 			iter = g_list_first(g_engine_list);
 		}
 	}
 
-	/* get file name from engine directory and get engine information from each filename */
-	DIR *dp;
-	struct dirent *dirp;
-	dp = opendir(ENGINE_DIRECTORY_DEFAULT);
-
-	if (dp != NULL) {
-		while ((dirp = readdir(dp)) != NULL) {
-			ttsengine_info_s* info;
-			char* filepath = NULL;
-			int file_size;
+	if (NULL == g_engine_manifest)
+		__internal_load_engine_manifest();
 
-			file_size = strlen(ENGINE_DIRECTORY_DEFAULT) + strlen(dirp->d_name) + 5;
-			filepath = (char*)g_malloc0( sizeof(char) * file_size);
+	/* get file name from engine directory and probe only changed files */
+	GHashTable* manifest = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, __manifest_free_entry);
+	GList* files = NULL;
+	GList* probe_list = NULL;
 
-			if (NULL != filepath) { 
-				strncpy(filepath, ENGINE_DIRECTORY_DEFAULT, strlen(ENGINE_DIRECTORY_DEFAULT) );
-				strncat(filepath, "/", strlen("/") );
-				strncat(filepath, dirp->d_name, strlen(dirp->d_name) );
-			} else {
-				SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not enough memory!! \n" );
-				continue;	
-			}
-
-			/* get its info and update engine list */
-			if (0 == __internal_get_engine_info(filepath, &info)) {
-				/* add engine info to g_engine_list */
-				g_engine_list = g_list_append(g_engine_list, info);
-			}
-
-			if (NULL != filepath)
-				g_free(filepath);
-		}
-
-		closedir(dp);
-	}
+	__internal_scan_engine_directory(ENGINE_DIRECTORY_DEFAULT, manifest, &files, &probe_list);
+	__internal_scan_engine_directory(ENGINE_DIRECTORY_DOWNLOAD, manifest, &files, &probe_list);
 
-	dp = opendir(ENGINE_DIRECTORY_DOWNLOAD);
+	__internal_probe_engines(probe_list);
 
-	if (dp != NULL) {
-		while ((dirp = readdir(dp)) != NULL) {
-			ttsengine_info_s* info;
-			char* filepath = NULL;
-			int file_size;
+	/* files left in old manifest are removed */
+	bool is_changed = (NULL != probe_list || 0 < g_hash_table_size(g_engine_manifest));
 
-			file_size = strlen(ENGINE_DIRECTORY_DOWNLOAD) + strlen(dirp->d_name) + 5;
-			filepath = (char*)g_malloc0( sizeof(char) * file_size);
+	g_hash_table_destroy(g_engine_manifest);
+	g_engine_manifest = manifest;
 
-			if (NULL != filepath) { 
-				strncpy(filepath, ENGINE_DIRECTORY_DOWNLOAD, strlen(ENGINE_DIRECTORY_DOWNLOAD) );
-				strncat(filepath, "/", strlen("/") );
-				strncat(filepath, dirp->d_name, strlen(dirp->d_name) );
-			} else {
-				SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not enough memory!! \n" );
-				continue;	
-			}
+	if (true == is_changed)
+		__internal_save_engine_manifest();
 
-			/* get its info and update engine list */
-			if (0 == __internal_get_engine_info(filepath, &info)) {
-				/* add engine info to g_engine_list */
-				g_engine_list = g_list_append(g_engine_list, info);
-			}
+	/* update engine list in order of directory */
+	iter = g_list_first(files);
+	while (NULL != iter) {
+		engine_manifest_s* entry = (engine_manifest_s*)iter->data;
 
-			if (NULL != filepath)
-				g_free(filepath);
+		if (NULL != entry->info) {
+			g_engine_list = g_list_append(g_engine_list, __internal_copy_engine_info(entry->info));
 		}
 
-		closedir(dp);
+		iter = g_list_next(iter);
 	}
 
+	g_list_free(files);
+	g_list_free(probe_list);
+
 	if (g_list_length(g_engine_list) <= 0) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] No Engine\n");
 		return TTSD_ERROR_OPERATION_FAILED;	
@@ -539,6 +1042,7 @@ int __internal_set_current_engine(const char* engine_uuid)
 	g_cur_engine.engine_path = g_strdup(data->engine_path);
 
 	g_cur_engine.handle = NULL;
+	g_cur_engine.host = NULL;
 	g_cur_engine.is_loaded = false;
 	g_cur_engine.is_set = true;
 	g_cur_engine.need_network = data->use_network;
@@ -552,88 +1056,278 @@ int __internal_set_current_engine(const char* engine_uuid)
 	return 0;
 }
 
-int ttsd_engine_agent_load_current_engine()
+/* Fill daemon functions of version. Later versions are given only to engines which know them. */
+static void __internal_set_daemon_funcs(ttspd_funcs_s* pdfuncs, int version)
 {
-	if (false == g_agent_init) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not Initialized \n" );
-		return TTSD_ERROR_OPERATION_FAILED;
-	}
-
-	if (false == g_cur_engine.is_set) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] ttsd_engine_agent_load_current_engine : No Current Engine  \n");
-		return TTSD_ERROR_OPERATION_FAILED;
-	}
-
-	/* check whether current engine is loaded or not */
-	if (true == g_cur_engine.is_loaded ) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent] ttsd_engine_agent_load_current_engine : Engine has already been loaded  \n" );
-		return 0;
-	}
-
-	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] current engine path : %s\n", g_cur_engine.engine_path);
+	memset(pdfuncs, 0, sizeof(ttspd_funcs_s));
+
+	if (TTSP_VERSION_1 == version) {
+		pdfuncs->version = TTSP_VERSION_1;
+		pdfuncs->size = TTSPD_FUNCS_V1_SIZE;
+		return;
+	}
+
+	/* result data can be written into buffers of daemon and voice data is shared */
+	pdfuncs->version = TTSP_VERSION_3;
+	pdfuncs->size = sizeof(ttspd_funcs_s);
+	pdfuncs->alloc_buffer = ttsd_buffer_alloc;
+	pdfuncs->release_buffer = ttsd_buffer_release;
+	pdfuncs->chunk_size = ttsd_buffer_get_chunk_size();
+	pdfuncs->map_resource = ttsd_resource_map;
+	pdfuncs->unmap_resource = ttsd_resource_unmap;
+}
 
+int __internal_load_engine_library(ttsengine_s* engine)
+{
 	/* open engine */
 	char *error = NULL;
-	g_cur_engine.handle = dlopen(g_cur_engine.engine_path, RTLD_LAZY); /* RTLD_LAZY RTLD_NOW*/
+	engine->handle = dlopen(engine->engine_path, RTLD_LAZY); /* RTLD_LAZY RTLD_NOW*/
 
-	if ((error = dlerror()) != NULL || !g_cur_engine.handle) {
+	if ((error = dlerror()) != NULL || !engine->handle) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail to get current engine handle : dlopen error \n");
+		engine->handle = NULL;
 		return -2;
 	}
 
-	g_cur_engine.ttsp_unload_engine = (int (*)())dlsym(g_cur_engine.handle, "ttsp_unload_engine");
+	engine->ttsp_unload_engine = (int (*)())dlsym(engine->handle, "ttsp_unload_engine");
 	if ((error = dlerror()) != NULL) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail to link daemon to ttsp_unload_engine() of current engine\n");
+		dlclose(engine->handle);
+		engine->handle = NULL;
 		return -3;
 	}
 
-	g_cur_engine.ttsp_load_engine = (int (*)(const ttspd_funcs_s* , ttspe_funcs_s*) )dlsym(g_cur_engine.handle, "ttsp_load_engine");
+	engine->ttsp_load_engine = (int (*)(const ttspd_funcs_s* , ttspe_funcs_s*) )dlsym(engine->handle, "ttsp_load_engine");
 	if ((error = dlerror()) != NULL) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail to link daemon to ttsp_load_engine() of current engine \n");
+		dlclose(engine->handle);
+		engine->handle = NULL;
 		return -3;
 	}
 
-	/* load engine */
-	g_cur_engine.pdfuncs->version = 1;
-	g_cur_engine.pdfuncs->size = sizeof(ttspd_funcs_s);
+	/* capability is optional, an engine which has it knows daemon functions of later versions */
+	int (*get_capability)(int*) = (int (*)(int*))dlsym(engine->handle, "ttsp_get_capability");
+	if (NULL != dlerror())
+		get_capability = NULL;
+
+	/* engine of version 1 gets the same daemon functions as before version 2 */
+	__internal_set_daemon_funcs(engine->pdfuncs, NULL != get_capability ? TTSP_VERSION_3 : TTSP_VERSION_1);
 
 	int ret = 0;
-	ret = g_cur_engine.ttsp_load_engine(g_cur_engine.pdfuncs, g_cur_engine.pefuncs); 
+	ret = engine->ttsp_load_engine(engine->pdfuncs, engine->pefuncs); 
 	if (0 != ret) {
-		printf("Fail load '%s' engine\n", g_cur_engine.engine_path);
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail to load engine : result(%d) \n");
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail to load engine : result(%d) \n", ret);
+		dlclose(engine->handle);
+		engine->handle = NULL;
 		return TTSD_ERROR_OPERATION_FAILED;
 	}
 
-	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] engine info : version(%d), size(%d)\n",g_cur_engine.pefuncs->version, g_cur_engine.pefuncs->size );
+	/* engine of version 2 or higher can use later daemon functions from initialize() */
+	if (TTSP_VERSION_1 == engine->pdfuncs->version &&
+	    TTSP_VERSION_2 <= engine->pefuncs->version && TTSPE_FUNCS_V2_SIZE <= engine->pefuncs->size) {
+		__internal_set_daemon_funcs(engine->pdfuncs, TTSP_VERSION_3);
+	}
+
+	engine->capability = TTSP_CAPABILITY_NONE;
+	if (NULL == get_capability || 0 != get_capability(&engine->capability)) {
+		engine->capability = TTSP_CAPABILITY_NONE;
+	}
+
+	return 0;
+}
+
+void __internal_unload_engine_library(ttsengine_s* engine)
+{
+	if (NULL != engine->host) {
+		ttsd_engine_host_close(engine->host);
+		engine->host = NULL;
+		return;
+	}
+
+	engine->ttsp_unload_engine();
+	dlclose(engine->handle);
+	engine->handle = NULL;
+}
+
+/*
+* Open engine library and initialize it. This does not touch current engine, so it can run in a thread.
+* If it fails after engine is initialized, engine->is_initialized is kept and caller closes engine in main loop.
+*/
+int __internal_open_engine(ttsengine_s* engine)
+{
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] engine path : %s\n", engine->engine_path);
+
+	int ret = 0;
+
+	if (true == ttsd_engine_host_is_enabled()) {
+		/* engine runs in host process, engine functions call the process */
+		ret = ttsd_engine_host_open(engine->engine_path, engine->pefuncs, &engine->capability, &engine->host);
+		if (0 != ret) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail to start engine process : result(%d) \n", ret);
+			return TTSD_ERROR_OPERATION_FAILED;
+		}
+	} else {
+		ret = __internal_load_engine_library(engine);
+		if (0 != ret) {
+			return ret;
+		}
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] engine info : version(%d), size(%d)\n", engine->pefuncs->version, engine->pefuncs->size);
 
-	/* engine error check */
-	if (g_cur_engine.pefuncs->size != sizeof(ttspe_funcs_s)) {
+	/* engine error check, engine of version 1 has only basic functions */
+	if (TTSP_VERSION_1 > engine->pefuncs->version || TTSPE_FUNCS_V1_SIZE > engine->pefuncs->size) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] ttsd_engine_agent_load_current_engine : current engine is not valid \n");
+		__internal_unload_engine_library(engine);
 		return TTSD_ERROR_OPERATION_FAILED;
 	}
 
+	if (TTSP_VERSION_2 > engine->pefuncs->version || TTSPE_FUNCS_V2_SIZE > engine->pefuncs->size) {
+		memset((char*)engine->pefuncs + TTSPE_FUNCS_V1_SIZE, 0, sizeof(ttspe_funcs_s) - TTSPE_FUNCS_V1_SIZE);
+	} else {
+		if (TTSP_VERSION_3 > engine->pefuncs->version || (int)sizeof(ttspe_funcs_s) > engine->pefuncs->size)
+			memset((char*)engine->pefuncs + TTSPE_FUNCS_V2_SIZE, 0, sizeof(ttspe_funcs_s) - TTSPE_FUNCS_V2_SIZE);
+
+		engine->capability |= engine->pefuncs->capability;
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] engine of version %d : capability(0x%x), chunk size(%u), preload(%s), stream(%s), estimate(%s), batch(%s)",
+			engine->pefuncs->version, engine->pefuncs->capability, engine->pefuncs->chunk_size,
+			NULL != engine->pefuncs->preload_voice ? "yes" : "no",
+			NULL != engine->pefuncs->open_stream ? "yes" : "no",
+			NULL != engine->pefuncs->estimate_cost ? "yes" : "no",
+			NULL != engine->pefuncs->start_batch ? "yes" : "no");
+	}
+
 	/* initalize engine */
-	if (NULL == g_cur_engine.pefuncs->initialize) {
+	if (NULL == engine->pefuncs->initialize) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] init function of engine is NULL!!");
+		__internal_unload_engine_library(engine);
 		return TTSD_ERROR_OPERATION_FAILED;
 	}
 
-	ret = g_cur_engine.pefuncs->initialize(__result_cb);
+	ret = engine->pefuncs->initialize(__result_cb);
 	if (0 != ret) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail to initialize current engine : result(%d)\n", ret);
+		__internal_unload_engine_library(engine);
 		return TTSD_ERROR_OPERATION_FAILED;
 	}
 
-	/* select default voice */
-	bool set_voice = false;
-	if (NULL != g_cur_engine.default_lang) {
-		if (NULL == g_cur_engine.pefuncs->is_valid_voice) {
-			SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] is_valid_voice() of engine is NULL!!");
-			return TTSD_ERROR_OPERATION_FAILED;
-		}
+	engine->is_initialized = true;
 
-		if (true == g_cur_engine.pefuncs->is_valid_voice(g_cur_engine.default_lang, g_cur_engine.default_vctype)) {
+	/* voices and audio format of engine do not change while it is loaded */
+	if (0 != __internal_build_voice_index(engine)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail to build voice index");
+		__internal_free_voice_index(engine);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	if (NULL == engine->pefuncs->get_audio_format || NULL == engine->pefuncs->is_valid_voice) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] get_audio_format() or is_valid_voice() of engine is NULL!!");
+		__internal_free_voice_index(engine);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	ret = engine->pefuncs->get_audio_format(&engine->audio_type, &engine->audio_rate, &engine->audio_channels);
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail to get audio format : result(%d) \n", ret);
+		__internal_free_voice_index(engine);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] audio format : type(%d), rate(%d), channel(%d) \n", 
+		engine->audio_type, engine->audio_rate, engine->audio_channels);
+
+	return 0;
+}
+
+typedef struct {
+	ttspe_preload_voice	preload_voice;
+	char*			lang;
+	int			type;
+} preload_s;
+
+static void* __preload_voice_thread(void* data)
+{
+	preload_s* preload = (preload_s*)data;
+
+	int ret = preload->preload_voice(preload->lang, (ttsp_voice_type_e)preload->type);
+	if (0 != ret) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Fail to preload voice : lang(%s), type(%d), result(%d)", preload->lang, preload->type, ret);
+	}
+
+	g_free(preload->lang);
+	g_free(preload);
+
+	return NULL;
+}
+
+void __internal_preload_voice(ttsengine_s* engine, const char* lang, int type)
+{
+	if (NULL == engine->pefuncs->preload_voice || NULL == lang)
+		return;
+
+	/* previous voice is prepared before next one */
+	if (true == engine->is_preloading) {
+		pthread_join(engine->preload_thread, NULL);
+		engine->is_preloading = false;
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Preload voice : lang(%s), type(%d)", lang, type);
+
+	preload_s* preload = (preload_s*)g_malloc0(sizeof(preload_s));
+	preload->preload_voice = engine->pefuncs->preload_voice;
+	preload->lang = g_strdup(lang);
+	preload->type = type;
+
+	/* thread-safe engine prepares voice while daemon keeps working */
+	if (0 != (engine->capability & TTSP_CAPABILITY_THREAD_SAFE)) {
+		if (0 == pthread_create(&engine->preload_thread, NULL, __preload_voice_thread, preload)) {
+			engine->is_preloading = true;
+			return;
+		}
+	}
+
+	__preload_voice_thread(preload);
+}
+
+/* Deinitialize and close engine library */
+void __internal_close_engine(ttsengine_s* engine)
+{
+	if (true == engine->is_preloading) {
+		pthread_join(engine->preload_thread, NULL);
+		engine->is_preloading = false;
+	}
+
+	/* shutdown engine */
+	if (NULL == engine->pefuncs->deinitialize) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] The deinitialize() of engine is NULL!!");
+	} else {
+		int ret = 0;
+		ret = engine->pefuncs->deinitialize();
+		if (0 != ret) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent] Fail deinitialize() : result(%d)\n", ret);
+		}
+	}
+
+	/* last results of engine thread */
+	ttsd_result_queue_flush();
+
+	__internal_detach_race_engine(engine);
+
+	/* unload engine */
+	__internal_unload_engine_library(engine);
+
+	__internal_free_voice_index(engine);
+
+	engine->is_initialized = false;
+}
+
+/* Select default voice of opened current engine and start to use it */
+int __internal_activate_current_engine()
+{
+	/* select default voice */
+	bool set_voice = false;
+	if (NULL != g_cur_engine.default_lang) {
+		if (true == g_cur_engine.pefuncs->is_valid_voice(g_cur_engine.default_lang, g_cur_engine.default_vctype)) {
 			set_voice = true;
 			SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent SUCCESS] Set origin default voice to current engine : lang(%s), type(%d) \n", 
 				g_cur_engine.default_lang,  g_cur_engine.default_vctype);
@@ -644,53 +1338,81 @@ int ttsd_engine_agent_load_current_engine()
 	}
 
 	if (false == set_voice) {
-		if (NULL == g_cur_engine.pefuncs->foreach_voices) {
-			SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] get_voice_list of engine is NULL!!");
+		/* first voice of engine */
+		GList *iter = g_list_first(g_cur_engine.voice_list);
+		voice_index_s* voice = iter->data;
+
+		if (true != g_cur_engine.pefuncs->is_valid_voice(voice->language, voice->types[0])) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[Engine ERROR] Fail voice is NOT valid");
 			return TTSD_ERROR_OPERATION_FAILED;
 		}
 
-		/* get language list */
-		int ret;
-		GList* voice_list = NULL;
+		ttsd_config_set_default_voice(voice->language, (int)voice->types[0]);
 
-		ret = g_cur_engine.pefuncs->foreach_voices(__supported_voice_cb, &voice_list);
+		if (NULL != g_cur_engine.default_lang)
+			g_free(g_cur_engine.default_lang);
 
-		if (0 == ret && 0 < g_list_length(voice_list)) {
-			GList *iter = NULL;
-			voice_s* voice;
-			
-			iter = g_list_first(voice_list);
+		g_cur_engine.default_lang = g_strdup(voice->language);
+		g_cur_engine.default_vctype = voice->types[0];
 
-			if (NULL != iter) {
-				voice = iter->data;
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent SUCCESS] Select default voice : lang(%s), type(%d) \n", 
+			g_cur_engine.default_lang, g_cur_engine.default_vctype);
+	} 
+ 
+	g_cur_engine.is_loaded = true;
 
-				if (true != g_cur_engine.pefuncs->is_valid_voice(voice->language, voice->type)) {
-					SLOG(LOG_ERROR, TAG_TTSD, "[Engine ERROR] Fail voice is NOT valid");
-					return TTSD_ERROR_OPERATION_FAILED;
-				}
+	__internal_set_engine_languages(&g_cur_engine);
 
-				ttsd_config_set_default_voice(voice->language, (int)voice->type);
-				
-				g_cur_engine.default_lang = g_strdup(voice->language);
-				g_cur_engine.default_vctype = voice->type;
+	__internal_preload_voice(&g_cur_engine, g_cur_engine.default_lang, g_cur_engine.default_vctype);
 
-				SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent SUCCESS] Select default voice : lang(%s), type(%d) \n", 
-					voice->language,  voice->type);
+	/* audio of a different engine, version or voice set must not be replayed */
+	ttsd_cache_open(g_cur_engine.engine_uuid, g_cur_engine.pefuncs->version, __internal_get_voice_hash());
 
-				
-			} else {
-				SLOG(LOG_ERROR, TAG_TTSD, "[Engine ERROR] Fail to get language list : result(%d)\n", ret);
-				return TTSD_ERROR_OPERATION_FAILED;
-			}
+	return 0;
+}
 
-			__free_voice_list(voice_list);
-		} else {
-			SLOG(LOG_ERROR, TAG_TTSD, "[Engine ERROR] Fail to get language list : result(%d)\n", ret);
-			return TTSD_ERROR_OPERATION_FAILED;
-		}
-	} 
- 
-	g_cur_engine.is_loaded = true;
+int ttsd_engine_agent_load_current_engine()
+{
+	if (false == g_agent_init) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not Initialized \n" );
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	if (false == g_cur_engine.is_set) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] ttsd_engine_agent_load_current_engine : No Current Engine  \n");
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	/* check whether current engine is loaded or not */
+	if (true == g_cur_engine.is_loaded ) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent] ttsd_engine_agent_load_current_engine : Engine has already been loaded  \n" );
+		return 0;
+	}
+
+	/* engine may be loaded already for other language */
+	__internal_unload_sub_engine_by_id(g_cur_engine.engine_uuid);
+
+	long long start_time = ttsd_stats_get_time();
+
+	int ret = __internal_open_engine(&g_cur_engine);
+	if (0 != ret) {
+		if (true == g_cur_engine.is_initialized)
+			__internal_close_engine(&g_cur_engine);
+
+		printf("Fail load '%s' engine\n", g_cur_engine.engine_path);
+		return ret;
+	}
+
+	if (0 != __internal_activate_current_engine()) {
+		__internal_close_engine(&g_cur_engine);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	ttsd_stats_add_latency(TTSD_STATS_ENGINE_LOAD, ttsd_stats_get_time() - start_time);
+
+	/* local engine is ready before network is out */
+	if (true == __internal_is_hybrid())
+		__internal_get_fallback_engine();
 
 	return 0;
 }
@@ -712,198 +1434,1366 @@ int ttsd_engine_agent_unload_current_engine()
 		return 0;
 	}
 
-	/* shutdown engine */
-	if (NULL == g_cur_engine.pefuncs->deinitialize) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] The deinitialize() of engine is NULL!!");
+	__internal_unload_sub_engines();
+	g_synth_engine = NULL;
+
+	long long start_time = ttsd_stats_get_time();
+
+	ttsd_cache_close();
+
+	__internal_close_engine(&g_cur_engine);
+
+	/* reset current engine data */
+	g_cur_engine.is_loaded = false;
+
+	ttsd_stats_add_latency(TTSD_STATS_ENGINE_UNLOAD, ttsd_stats_get_time() - start_time);
+
+	return 0;
+}
+
+int ttsd_engine_agent_restart_engine()
+{
+	if (false == g_agent_init) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not Initialized \n" );
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	ttsengine_s* engine = g_synth_engine;
+
+	__internal_reset_stream();
+	ttsd_stats_increase(TTSD_STATS_ENGINE_RESTART);
+
+	/* engine for other language is loaded again by next text of the language */
+	if (NULL != engine && &g_cur_engine != engine) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Restart engine : %s", engine->engine_uuid);
+		__internal_unload_sub_engine(engine);
+		return 0;
+	}
+
+	SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Restart current engine : %s", g_cur_engine.engine_uuid);
+
+	if (0 != ttsd_engine_agent_unload_current_engine())
+		return TTSD_ERROR_OPERATION_FAILED;
+
+	return ttsd_engine_agent_load_current_engine();
+}
+
+bool ttsd_engine_agent_is_loaded()
+{
+	return (true == g_agent_init && true == g_cur_engine.is_loaded);
+}
+
+/*
+* Engine switch. Next engine is loaded in a thread while current engine keeps working.
+*/
+
+static void __engine_prepared_cb(void* data)
+{
+	pthread_join(g_next_thread, NULL);
+	g_is_next_loading = false;
+
+	bool is_loaded = (NULL != data);
+
+	if (true == g_is_next_canceled || false == is_loaded) {
+		/* engine which failed after initialize() is closed here, not in loading thread */
+		if (true == g_next_engine->is_initialized)
+			__internal_close_engine(g_next_engine);
+
+		__internal_free_engine(g_next_engine);
+		g_next_engine = NULL;
+
+		if (true == g_is_next_canceled) {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Loaded next engine is canceled");
+			return;
+		}
 	} else {
-		int ret = 0;
-		ret = g_cur_engine.pefuncs->deinitialize();
-		if (0 != ret) {
-			SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent] Fail deinitialize() : result(%d)\n", ret);
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent SUCCESS] Next engine is ready : %s", g_next_engine->engine_uuid);
+		ttsd_stats_add_latency(TTSD_STATS_ENGINE_LOAD, ttsd_stats_get_time() - g_next_start_time);
+	}
+
+	if (NULL != g_next_prepared_cb)
+		g_next_prepared_cb(is_loaded);
+}
+
+static void* __engine_prepare_thread(void* data)
+{
+	ttsengine_s* engine = (ttsengine_s*)data;
+
+	bool is_loaded = (0 == __internal_open_engine(engine));
+
+	/* result is handled in main loop */
+	ecore_main_loop_thread_safe_call_async(__engine_prepared_cb, true == is_loaded ? engine : NULL);
+
+	return NULL;
+}
+
+void __internal_free_engine(ttsengine_s* engine)
+{
+	if (NULL == engine)
+		return;
+
+	if (NULL != engine->engine_uuid)	g_free(engine->engine_uuid);
+	if (NULL != engine->engine_name)	g_free(engine->engine_name);
+	if (NULL != engine->engine_path)	g_free(engine->engine_path);
+	if (NULL != engine->default_lang)	g_free(engine->default_lang);
+	if (NULL != engine->pefuncs)		g_free(engine->pefuncs);
+	if (NULL != engine->pdfuncs)		g_free(engine->pdfuncs);
+
+	g_free(engine);
+}
+
+int ttsd_engine_agent_prepare_engine(const char* engine_id, ttsd_engine_prepared_cb callback)
+{
+	if (false == g_agent_init) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not Initialized \n" );
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	if (NULL == engine_id) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Invalid parameter \n" );
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	if (true == g_is_next_loading) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Other engine is being loaded \n" );
+		return TTSD_ERROR_INVALID_STATE;
+	}
+
+	/* next engine which is not switched yet is replaced */
+	ttsd_engine_agent_cancel_next_engine();
+
+	GList *iter = g_list_first(g_engine_list);
+	ttsengine_info_s *data = NULL;
+
+	while (NULL != iter) {
+		data = iter->data;
+
+		if (0 == strcmp(data->engine_uuid, engine_id))
+			break;
+
+		iter = g_list_next(iter);
+	}
+
+	if (NULL == iter || NULL == data->engine_name || NULL == data->engine_path) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Cannot find engine id : %s", engine_id);
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	/* engine may be loaded already for other language */
+	__internal_unload_sub_engine_by_id(engine_id);
+
+	ttsengine_s* engine = (ttsengine_s*)g_malloc0(sizeof(ttsengine_s));
+	engine->engine_uuid = g_strdup(data->engine_uuid);
+	engine->engine_name = g_strdup(data->engine_name);
+	engine->engine_path = g_strdup(data->engine_path);
+	engine->is_set = true;
+	engine->need_network = data->use_network;
+	engine->default_lang = g_strdup(g_cur_engine.default_lang);
+	engine->default_vctype = g_cur_engine.default_vctype;
+	engine->default_speed = g_cur_engine.default_speed;
+	engine->pefuncs = (ttspe_funcs_s*)g_malloc0(sizeof(ttspe_funcs_s));
+	engine->pdfuncs = (ttspd_funcs_s*)g_malloc0(sizeof(ttspd_funcs_s));
+
+	g_next_engine = engine;
+	g_next_prepared_cb = callback;
+	g_next_start_time = ttsd_stats_get_time();
+	g_is_next_canceled = false;
+	g_is_next_loading = true;
+
+	if (0 != pthread_create(&g_next_thread, NULL, __engine_prepare_thread, engine)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Fail to create thread to load engine");
+		g_is_next_loading = false;
+		__internal_free_engine(engine);
+		g_next_engine = NULL;
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Load next engine in background : %s", engine_id);
+
+	return 0;
+}
+
+int ttsd_engine_agent_cancel_next_engine()
+{
+	if (NULL == g_next_engine)
+		return 0;
+
+	if (true == g_is_next_loading) {
+		/* released when loading is done */
+		g_is_next_canceled = true;
+		return 0;
+	}
+
+	__internal_close_engine(g_next_engine);
+	__internal_free_engine(g_next_engine);
+	g_next_engine = NULL;
+
+	return 0;
+}
+
+int ttsd_engine_agent_switch_engine()
+{
+	if (NULL == g_next_engine || true == g_is_next_loading) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Next engine is not ready \n" );
+		return TTSD_ERROR_INVALID_STATE;
+	}
+
+	char* old_uuid = g_strdup(g_cur_engine.engine_uuid);
+
+	/* break after make */
+	ttsd_engine_agent_unload_current_engine();
+
+	ttsengine_s* engine = g_next_engine;
+	g_next_engine = NULL;
+
+	if (NULL != g_cur_engine.engine_uuid)	g_free(g_cur_engine.engine_uuid);
+	if (NULL != g_cur_engine.engine_name)	g_free(g_cur_engine.engine_name);
+	if (NULL != g_cur_engine.engine_path)	g_free(g_cur_engine.engine_path);
+	if (NULL != g_cur_engine.default_lang)	g_free(g_cur_engine.default_lang);
+	if (NULL != g_cur_engine.pefuncs)	g_free(g_cur_engine.pefuncs);
+	if (NULL != g_cur_engine.pdfuncs)	g_free(g_cur_engine.pdfuncs);
+
+	g_cur_engine = *engine;
+	g_free(engine);
+
+	if (0 != __internal_activate_current_engine()) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Fail to switch engine, roll back to old engine");
+		__internal_close_engine(&g_cur_engine);
+
+		if (NULL != old_uuid) {
+			__internal_set_current_engine(old_uuid);
+			ttsd_engine_agent_load_current_engine();
+			g_free(old_uuid);
+		}
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	/* save engine id to config */
+	if (0 != ttsd_config_set_default_engine(g_cur_engine.engine_uuid)) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Fail to save engine id to config \n"); 
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent SUCCESS] Switch engine : %s -> %s", old_uuid, g_cur_engine.engine_uuid);
+
+	if (NULL != old_uuid)
+		g_free(old_uuid);
+
+	return 0;
+}
+
+bool ttsd_engine_agent_need_network()
+{
+	if (false == g_agent_init) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not Initialized \n" );
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	if (false == g_cur_engine.is_loaded) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not loaded engine \n");
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	/* local engine speaks while network is out */
+	return (true == g_cur_engine.need_network && false == __internal_is_hybrid());
+}
+
+/* Select voice of engine. Default language and type are of current engine. */
+bool __internal_select_voice(ttsengine_s* engine, const char* lang, int type, const char** out_lang, ttsp_voice_type_e* out_type)
+{
+	bool is_default_lang = (0 == strncmp(lang, "default", strlen("default")));
+	const voice_index_s* voice = NULL;
+	int preferred_type;
+	int i;
+
+	if (NULL == engine->default_lang) {
+		/* engine loaded for other languages does not have default voice */
+		if (true == is_default_lang)
+			return false;
+	} else if ((true == is_default_lang && (0 == type || type == engine->default_vctype)) ||
+	    (0 == type && 0 == strncmp(lang, engine->default_lang, strlen(engine->default_lang)))) {
+		/* default voice */
+		voice = __internal_find_voice(engine, engine->default_lang);
+		*out_lang = (NULL != voice) ? voice->language : engine->default_lang;
+		*out_type = (ttsp_voice_type_e)engine->default_vctype;
+		return true;
+	}
+
+	voice = __internal_find_voice(engine, true == is_default_lang ? engine->default_lang : lang);
+	if (NULL == voice) {
+		return false;
+	}
+
+	/* Only type is default, type of default voice is preferred */
+	preferred_type = (0 == type) ? engine->default_vctype : type;
+
+	for (i = 0; i < voice->type_count; i++) {
+		if (voice->types[i] == preferred_type) {
+			*out_lang = voice->language;
+			*out_type = voice->types[i];
+			return true;
+		}
+	}
+
+	/* Type is given with language, it should be supported */
+	if (false == is_default_lang && 0 != type) {
+		return false;
+	}
+
+	*out_lang = voice->language;
+	*out_type = voice->types[0];
+	return true;
+}
+
+/* Select engine and its voice. Text in language which current engine does not support is routed to other engine. */
+ttsengine_s* __internal_select_engine(const char* lang, int type, const char** out_lang, ttsp_voice_type_e* out_type)
+{
+	if (true == __internal_select_voice(&g_cur_engine, lang, type, out_lang, out_type))
+		return &g_cur_engine;
+
+	if (0 == strncmp(lang, "default", strlen("default")))
+		return NULL;
+
+	ttsengine_s* engine = __internal_route_engine(lang);
+	if (NULL != engine && true == __internal_select_voice(engine, lang, type, out_lang, out_type))
+		return engine;
+
+	return NULL;
+}
+
+bool ttsd_engine_select_valid_voice(const char* lang, int type, const char** out_lang, ttsp_voice_type_e* out_type)
+{
+	if (NULL == lang || NULL == out_lang || NULL == out_type) {
+		return false;
+	}
+
+	if (false == g_cur_engine.is_loaded || NULL == g_cur_engine.default_lang) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not loaded engine \n");
+		return false;
+	}
+
+	if (NULL == __internal_select_engine(lang, type, out_lang, out_type)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Voice is not supported : lang(%s), type(%d)", lang, type);
+		return false;
+	}
+
+	return true;
+}
+
+/*
+* Engines for other languages. They are loaded on demand and evicted in LRU order.
+*/
+
+static bool __internal_has_language(GList* languages, const char* lang)
+{
+	GList *iter = g_list_first(languages);
+	size_t len = strlen(lang);
+
+	while (NULL != iter) {
+		const char* language = (const char*)iter->data;
+
+		/* "en" matches "en_US" */
+		if (0 == strcmp(language, lang) || (NULL == strchr(lang, '_') && 0 == strncmp(language, lang, len) && '_' == language[len]))
+			return true;
+
+		iter = g_list_next(iter);
+	}
+
+	return false;
+}
+
+ttsengine_info_s* __internal_find_engine_info(const char* engine_uuid)
+{
+	GList *iter = g_list_first(g_engine_list);
+
+	while (NULL != iter) {
+		ttsengine_info_s* info = iter->data;
+
+		if (NULL != info->engine_uuid && 0 == strcmp(info->engine_uuid, engine_uuid))
+			return info;
+
+		iter = g_list_next(iter);
+	}
+
+	return NULL;
+}
+
+static void __manifest_find_info(gpointer key, gpointer value, gpointer user_data)
+{
+	engine_manifest_s* entry = (engine_manifest_s*)value;
+	ttsengine_info_s** info = (ttsengine_info_s**)user_data;
+
+	if (NULL != entry->info && NULL != entry->info->engine_uuid && 0 == strcmp(entry->info->engine_uuid, (*info)->engine_uuid))
+		*info = entry->info;
+}
+
+static void __internal_copy_languages(ttsengine_info_s* info, GList* voice_list)
+{
+	g_list_free_full(info->languages, g_free);
+	info->languages = NULL;
+
+	GList *iter = g_list_first(voice_list);
+	while (NULL != iter) {
+		voice_index_s* voice = iter->data;
+		info->languages = g_list_append(info->languages, g_strdup(voice->language));
+		iter = g_list_next(iter);
+	}
+
+	info->is_probed = true;
+}
+
+/* Remember languages of loaded engine, so that it is loaded only for these languages */
+void __internal_set_engine_languages(ttsengine_s* engine)
+{
+	ttsengine_info_s* info = __internal_find_engine_info(engine->engine_uuid);
+	if (NULL == info || true == info->is_probed)
+		return;
+
+	__internal_copy_languages(info, engine->voice_list);
+
+	if (NULL != g_engine_manifest) {
+		ttsengine_info_s* entry_info = info;
+		g_hash_table_foreach(g_engine_manifest, __manifest_find_info, &entry_info);
+
+		if (entry_info != info) {
+			__internal_copy_languages(entry_info, engine->voice_list);
+			__internal_save_engine_manifest();
+		}
+	}
+}
+
+ttsengine_s* __internal_new_engine(const ttsengine_info_s* info)
+{
+	ttsengine_s* engine = (ttsengine_s*)g_malloc0(sizeof(ttsengine_s));
+	engine->engine_uuid = g_strdup(info->engine_uuid);
+	engine->engine_name = g_strdup(info->engine_name);
+	engine->engine_path = g_strdup(info->engine_path);
+	engine->is_set = true;
+	engine->need_network = info->use_network;
+	engine->default_vctype = g_cur_engine.default_vctype;
+	engine->default_speed = g_cur_engine.default_speed;
+	engine->pefuncs = (ttspe_funcs_s*)g_malloc0(sizeof(ttspe_funcs_s));
+	engine->pdfuncs = (ttspd_funcs_s*)g_malloc0(sizeof(ttspd_funcs_s));
+
+	return engine;
+}
+
+void __internal_unload_sub_engine(ttsengine_s* engine)
+{
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Unload engine : %s", engine->engine_uuid);
+
+	long long start_time = ttsd_stats_get_time();
+
+	g_sub_engines = g_list_remove(g_sub_engines, engine);
+	if (g_synth_engine == engine)
+		g_synth_engine = NULL;
+
+	__internal_close_engine(engine);
+	__internal_free_engine(engine);
+
+	ttsd_stats_add_latency(TTSD_STATS_ENGINE_UNLOAD, ttsd_stats_get_time() - start_time);
+}
+
+/* Unload engine of uuid, which is going to be current engine */
+void __internal_unload_sub_engine_by_id(const char* engine_uuid)
+{
+	GList *iter = g_list_first(g_sub_engines);
+
+	while (NULL != iter) {
+		ttsengine_s* engine = iter->data;
+		iter = g_list_next(iter);
+
+		if (0 == strcmp(engine->engine_uuid, engine_uuid))
+			__internal_unload_sub_engine(engine);
+	}
+}
+
+/* Keep loaded engines in budget. Engine which is synthesizing is not evicted. */
+void __internal_evict_sub_engines()
+{
+	/* engine which has just been loaded for the text is kept */
+	int max = ttsd_config_get_int_option(TTSD_CONFIG_ENGINE_MAX_LOADED, ENGINE_MAX_LOADED_DEFAULT) - 1;
+	if (max < 1)
+		max = 1;
+
+	GList *iter = g_list_last(g_sub_engines);
+
+	while (NULL != iter && (int)g_list_length(g_sub_engines) > max) {
+		ttsengine_s* engine = iter->data;
+		iter = g_list_previous(iter);
+
+		if (engine != g_synth_engine && engine != __internal_get_loaded_fallback_engine())
+			__internal_unload_sub_engine(engine);
+	}
+}
+
+ttsengine_s* __internal_load_sub_engine(const ttsengine_info_s* info)
+{
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Load engine for other language : %s", info->engine_uuid);
+
+	long long start_time = ttsd_stats_get_time();
+
+	ttsengine_s* engine = __internal_new_engine(info);
+
+	if (0 != __internal_open_engine(engine)) {
+		if (true == engine->is_initialized)
+			__internal_close_engine(engine);
+
+		__internal_free_engine(engine);
+		return NULL;
+	}
+
+	ttsd_stats_add_latency(TTSD_STATS_ENGINE_LOAD, ttsd_stats_get_time() - start_time);
+
+	g_sub_engines = g_list_prepend(g_sub_engines, engine);
+	__internal_set_engine_languages(engine);
+
+	return engine;
+}
+
+/* Find engine other than current engine for language, loading it if needed */
+ttsengine_s* __internal_route_engine(const char* lang)
+{
+	GList *iter = NULL;
+
+	if (ttsd_config_get_int_option(TTSD_CONFIG_ENGINE_MAX_LOADED, ENGINE_MAX_LOADED_DEFAULT) < 2) {
+		/* only current engine is allowed */
+		return NULL;
+	}
+
+	/* loaded engine, most recently used first */
+	iter = g_list_first(g_sub_engines);
+	while (NULL != iter) {
+		ttsengine_s* engine = iter->data;
+
+		if (NULL != __internal_find_voice(engine, lang)) {
+			g_sub_engines = g_list_remove_link(g_sub_engines, iter);
+			g_sub_engines = g_list_concat(iter, g_sub_engines);
+			return engine;
+		}
+
+		iter = g_list_next(iter);
+	}
+
+	/* installed engine which is known to have the language, then unknown engines */
+	int pass;
+	for (pass = 0; pass < 2; pass++) {
+		iter = g_list_first(g_engine_list);
+		while (NULL != iter) {
+			ttsengine_info_s* info = iter->data;
+			iter = g_list_next(iter);
+
+			if (NULL == info->engine_uuid || 0 == strcmp(info->engine_uuid, g_cur_engine.engine_uuid))
+				continue;
+
+			/* engine being loaded to replace current engine */
+			if (NULL != g_next_engine && 0 == strcmp(info->engine_uuid, g_next_engine->engine_uuid))
+				continue;
+
+			if (0 == pass && (false == info->is_probed || false == __internal_has_language(info->languages, lang)))
+				continue;
+
+			if (1 == pass && true == info->is_probed)
+				continue;
+
+			bool is_loaded = false;
+			GList *sub = g_list_first(g_sub_engines);
+			while (NULL != sub) {
+				if (0 == strcmp(((ttsengine_s*)sub->data)->engine_uuid, info->engine_uuid))
+					is_loaded = true;
+				sub = g_list_next(sub);
+			}
+			if (true == is_loaded)
+				continue;
+
+			ttsengine_s* engine = __internal_load_sub_engine(info);
+			if (NULL == engine)
+				continue;
+
+			if (NULL != __internal_find_voice(engine, lang)) {
+				__internal_evict_sub_engines();
+				return engine;
+			}
+
+			/* probed engine does not have the language */
+			__internal_unload_sub_engine(engine);
+		}
+	}
+
+	return NULL;
+}
+
+/* Unload all engines except current engine */
+void __internal_unload_sub_engines()
+{
+	while (NULL != g_sub_engines) {
+		__internal_unload_sub_engine((ttsengine_s*)g_sub_engines->data);
+	}
+}
+
+int ttsd_engine_get_concurrency(const char* lang, int type)
+{
+	if (false == g_cur_engine.is_loaded || NULL == lang)
+		return 1;
+
+	if (0 == (g_cur_engine.capability & TTSP_CAPABILITY_CONCURRENT_SYNTHESIS))
+		return 1;
+
+	/* loser of race is canceled by cancel_synth(), which cancels all texts of engine */
+	if (true == __internal_is_hybrid())
+		return 1;
+
+	/* text routed to other engine is synthesized alone */
+	const char* temp_lang = NULL;
+	ttsp_voice_type_e temp_type;
+	if (false == __internal_select_voice(&g_cur_engine, lang, type, &temp_lang, &temp_type))
+		return 1;
+
+	int count = ttsd_config_get_int_option(TTSD_CONFIG_SYNTHESIS_WORKER_MAX, 0);
+	if (0 >= count) {
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		count = (0 < cores) ? (int)cores : 1;
+	}
+
+	return count;
+}
+
+int ttsd_engine_get_batch_size(const char* lang, int type)
+{
+	if (false == g_agent_init || false == g_cur_engine.is_loaded || NULL == lang)
+		return 1;
+
+	/* loser of race is canceled by cancel_synth(), which cancels the whole batch */
+	if (true == __internal_is_hybrid())
+		return 1;
+
+	const char* temp_lang = NULL;
+	ttsp_voice_type_e temp_type;
+	ttsengine_s* engine = __internal_select_engine(lang, type, &temp_lang, &temp_type);
+	if (NULL == engine || NULL == engine->pefuncs->start_batch)
+		return 1;
+
+	int count = ttsd_config_get_int_option(TTSD_CONFIG_BATCH_SIZE_MAX, BATCH_SIZE_MAX_DEFAULT);
+	return (1 < count) ? count : 1;
+}
+
+bool ttsd_engine_agent_is_same_engine(const char* engine_id)
+{
+	if (false == g_agent_init) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not Initialized \n" );
+		return false;
+	}
+
+	if (false == g_cur_engine.is_loaded) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not loaded engine \n");
+		return false;
+	}
+
+	/* compare current engine and engine id.*/
+	if (0 == strncmp(g_cur_engine.engine_uuid, engine_id, strlen(engine_id))) {
+		return true;
+	}
+
+	return false;
+}
+
+/******************************************************************************************
+* TTS Engine Interfaces for client
+*******************************************************************************************/
+
+int ttsd_engine_start_synthesis(const char* lang, const ttsp_voice_type_e vctype, const char* text, const int speed, void* user_param)
+{
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] start ttsd_engine_start_synthesis() \n");
+
+	if (false == g_agent_init) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not Initialized \n" );
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	if (false == g_cur_engine.is_loaded) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not loaded engine \n");
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	/* select engine and voice for default */
+	const char* temp_lang = NULL;
+	ttsp_voice_type_e temp_type;
+	ttsengine_s* engine = NULL;
+	if (NULL != lang)
+		engine = __internal_select_engine(lang, vctype, &temp_lang, &temp_type);
+
+	if (NULL == engine) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Fail to select default voice \n");
+		return TTSD_ERROR_INVALID_VOICE;
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Start synthesis : language(%s), type(%d), speed(%d), text(%s) \n", 
+			temp_lang, temp_type, speed, text);
+	}
+
+	if (NULL == engine->pefuncs->start_synth) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] start_synth() of engine is NULL!!");
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	ttsp_speed_e temp_speed;
+
+	if (0 == speed) {
+		temp_speed = engine->default_speed;
+	} else {
+		temp_speed = speed;
+	}
+
+	/* text for network engine is raced with local engine */
+	if (&g_cur_engine == engine && true == __internal_is_hybrid())
+		return __internal_start_race(temp_lang, temp_type, text, temp_speed, user_param);
+
+	/* synthesize text */
+	int ret = 0;
+	g_synth_engine = engine;
+	ret = engine->pefuncs->start_synth(temp_lang, temp_type, text, temp_speed, user_param);
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] ***************************************", ret);
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] * synthesize error : result(%6d) *", ret);
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] ***************************************", ret);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	return 0;
+}
+
+
+int ttsd_engine_start_batch(const char* lang, const ttsp_voice_type_e vctype, const int speed, const char** texts, void** user_params, int count)
+{
+	if (false == g_agent_init || false == g_cur_engine.is_loaded) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not loaded engine");
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	if (NULL == lang || NULL == texts || NULL == user_params || 0 >= count)
+		return TTSD_ERROR_INVALID_PARAMETER;
+
+	const char* temp_lang = NULL;
+	ttsp_voice_type_e temp_type;
+	ttsengine_s* engine = __internal_select_engine(lang, vctype, &temp_lang, &temp_type);
+	if (NULL == engine) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Fail to select default voice");
+		return TTSD_ERROR_INVALID_VOICE;
+	}
+
+	if (NULL == engine->pefuncs->start_batch) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Engine does not support batch synthesis");
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	ttsp_speed_e temp_speed = (0 == speed) ? engine->default_speed : (ttsp_speed_e)speed;
+
+	ttsp_batch_item_s* items = (ttsp_batch_item_s*)calloc(count, sizeof(ttsp_batch_item_s));
+	if (NULL == items) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Out of memory");
+		return TTSD_ERROR_OUT_OF_MEMORY;
+	}
+
+	int i;
+	for (i = 0; i < count; i++) {
+		items[i].language = temp_lang;
+		items[i].type = temp_type;
+		items[i].text = texts[i];
+		items[i].speed = temp_speed;
+		items[i].user_data = user_params[i];
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Start batch : language(%s), type(%d), speed(%d), count(%d)",
+		temp_lang, temp_type, temp_speed, count);
+
+	g_synth_engine = engine;
+	int ret = engine->pefuncs->start_batch(items, count);
+	free(items);
+
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Fail to start batch : result(%d)", ret);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	return 0;
+}
+
+int ttsd_engine_estimate_cost(const char* lang, int vctype, const char* text, int speed, int* synth_msec, int* audio_msec)
+{
+	if (false == g_agent_init || false == g_cur_engine.is_loaded || NULL == lang || NULL == text)
+		return TTSD_ERROR_OPERATION_FAILED;
+
+	const char* temp_lang = NULL;
+	ttsp_voice_type_e temp_type;
+	ttsengine_s* engine = __internal_select_engine(lang, vctype, &temp_lang, &temp_type);
+	if (NULL == engine)
+		return TTSD_ERROR_INVALID_VOICE;
+
+	/* optional, daemon estimates by itself */
+	if (NULL == engine->pefuncs->estimate_cost)
+		return TTSD_ERROR_OPERATION_FAILED;
+
+	ttsp_speed_e temp_speed = (0 == speed) ? engine->default_speed : (ttsp_speed_e)speed;
+
+	int ret = engine->pefuncs->estimate_cost(temp_lang, temp_type, text, temp_speed, synth_msec, audio_msec);
+	if (0 != ret || 0 > *synth_msec || 0 > *audio_msec) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Fail to estimate text : result(%d)", ret);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	return 0;
+}
+
+int ttsd_engine_cancel_synthesis()
+{
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] start ttsd_engine_cancel_synthesis() \n");
+	
+	if (false == g_agent_init) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not Initialized \n" );
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	if (false == g_cur_engine.is_loaded) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not loaded engine \n");
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+	
+	if (NULL != g_race) {
+		__internal_cancel_race();
+		return 0;
+	}
+
+	ttsengine_s* engine = (NULL != g_synth_engine) ? g_synth_engine : &g_cur_engine;
+
+	if (NULL == engine->pefuncs->cancel_synth) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] cancel_synth() of engine is NULL!!");
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	/* stream waiting for text has no synthesis to cancel */
+	if (true == g_stream.is_open && false == g_stream.is_native && false == g_stream.is_synthesizing) {
+		void* user_data = g_stream.user_data;
+		__internal_reset_stream();
+		g_result_cb(TTSP_RESULT_EVENT_CANCEL, NULL, 0, user_data);
+		return 0;
+	}
+
+	__internal_reset_stream();
+
+	/* stop synthesis */
+	int ret = 0;
+	ret = engine->pefuncs->cancel_synth();
+
+	/* results which engine thread sent before cancel are passed before cancel is done, as engine calling back in main thread */
+	ttsd_result_queue_flush();
+
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail cancel synthesis : result(%d) \n", ret);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	return 0;
+}
+
+/*
+* Hybrid synthesis
+*/
+
+static char* __internal_get_fallback_id()
+{
+	char* engine_id = NULL;
+	if (0 != ttsd_config_get_option(TTSD_CONFIG_HYBRID_FALLBACK_ENGINE, &engine_id))
+		return NULL;
+
+	if ('\0' == engine_id[0]) {
+		free(engine_id);
+		return NULL;
+	}
+
+	return engine_id;
+}
+
+bool __internal_is_hybrid()
+{
+	if (false == g_cur_engine.is_loaded || false == g_cur_engine.need_network)
+		return false;
+
+	char* engine_id = __internal_get_fallback_id();
+	if (NULL == engine_id)
+		return false;
+
+	bool is_hybrid = (0 != strcmp(engine_id, g_cur_engine.engine_uuid) && NULL != __internal_find_engine_info(engine_id));
+	free(engine_id);
+
+	return is_hybrid;
+}
+
+ttsengine_s* __internal_get_loaded_fallback_engine()
+{
+	char* engine_id = __internal_get_fallback_id();
+	if (NULL == engine_id)
+		return NULL;
+
+	ttsengine_s* engine = NULL;
+	GList *iter = g_list_first(g_sub_engines);
+	while (NULL != iter) {
+		if (0 == strcmp(((ttsengine_s*)iter->data)->engine_uuid, engine_id)) {
+			engine = iter->data;
+			break;
+		}
+		iter = g_list_next(iter);
+	}
+
+	free(engine_id);
+
+	return engine;
+}
+
+ttsengine_s* __internal_get_fallback_engine()
+{
+	ttsengine_s* engine = __internal_get_loaded_fallback_engine();
+	if (NULL != engine)
+		return engine;
+
+	char* engine_id = __internal_get_fallback_id();
+	if (NULL == engine_id)
+		return NULL;
+
+	const ttsengine_info_s* info = __internal_find_engine_info(engine_id);
+	if (NULL != info && 0 != strcmp(engine_id, g_cur_engine.engine_uuid)) {
+		engine = __internal_load_sub_engine(info);
+		if (NULL != engine)
+			__internal_evict_sub_engines();
+	}
+
+	if (NULL == engine)
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Fail to load local fallback engine : %s", engine_id);
+
+	free(engine_id);
+
+	return engine;
+}
+
+void __internal_free_race(hybrid_race_s* race)
+{
+	int i;
+
+	if (NULL != race->hedge_timer)
+		ecore_timer_del(race->hedge_timer);
+
+	for (i = 0; i < HYBRID_PATH_COUNT; i++)
+		g_free(race->path[i].lang);
+
+	g_free(race->text);
+	g_free(race);
+}
+
+/* Race is freed when it is not used and its engines send no more result */
+void __internal_release_race(hybrid_race_s* race)
+{
+	if (0 < race->ref || true == race->path[HYBRID_PATH_NETWORK].is_started || true == race->path[HYBRID_PATH_LOCAL].is_started)
+		return;
+
+	if (g_race == race)
+		g_race = NULL;
+
+	g_races = g_list_remove(g_races, race);
+
+	/* engine is closed before last event */
+	if (false == race->is_done && NULL != g_result_cb)
+		g_result_cb(TTSP_RESULT_EVENT_FAIL, NULL, 0, race->user_data);
+
+	__internal_free_race(race);
+}
+
+int __internal_start_path(hybrid_path_s* path)
+{
+	if (NULL == path->engine || NULL == path->lang || NULL == path->engine->pefuncs->start_synth)
+		return TTSD_ERROR_OPERATION_FAILED;
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Start hybrid path : engine(%s), language(%s), type(%d)", 
+		path->engine->engine_uuid, path->lang, path->type);
+
+	/* engine may send result in start_synth() */
+	path->is_tried = true;
+	path->is_started = true;
+
+	int ret = path->engine->pefuncs->start_synth(path->lang, path->type, path->race->text, path->race->speed, (void*)path);
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Fail to start hybrid path : engine(%s), result(%d)", path->engine->engine_uuid, ret);
+		path->is_started = false;
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	return 0;
+}
+
+static Eina_Bool __hybrid_hedge_cb(void* data)
+{
+	hybrid_race_s* race = (hybrid_race_s*)data;
+	race->hedge_timer = NULL;
+
+	if (race == g_race && NULL == race->winner && false == race->path[HYBRID_PATH_LOCAL].is_tried) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Network engine has no audio yet, local engine starts");
+
+		race->ref++;
+		__internal_start_path(&race->path[HYBRID_PATH_LOCAL]);
+		race->ref--;
+		__internal_release_race(race);
+	}
+
+	return EINA_FALSE;
+}
+
+int __internal_start_race(const char* lang, ttsp_voice_type_e type, const char* text, ttsp_speed_e speed, void* user_param)
+{
+	hybrid_race_s* race = (hybrid_race_s*)g_malloc0(sizeof(hybrid_race_s));
+	race->user_data = user_param;
+	race->text = g_strdup(text);
+	race->speed = speed;
+	race->start_time = ttsd_stats_get_time();
+
+	hybrid_path_s* network = &race->path[HYBRID_PATH_NETWORK];
+	hybrid_path_s* local = &race->path[HYBRID_PATH_LOCAL];
+
+	network->race = race;
+	network->engine = &g_cur_engine;
+	network->lang = g_strdup(lang);
+	network->type = type;
+	network->latency = TTSD_STATS_HYBRID_NETWORK;
+
+	local->race = race;
+	local->engine = __internal_get_fallback_engine();
+	local->latency = TTSD_STATS_HYBRID_LOCAL;
+
+	/* voice of local engine in the same language */
+	const char* local_lang = NULL;
+	if (NULL != local->engine && (true == __internal_select_voice(local->engine, lang, type, &local_lang, &local->type) ||
+	    true == __internal_select_voice(local->engine, lang, 0, &local_lang, &local->type)))
+		local->lang = g_strdup(local_lang);
+
+	g_races = g_list_prepend(g_races, race);
+	g_race = race;
+	race->ref++;
+
+	int ret = TTSD_ERROR_OUT_OF_NETWORK;
+	if (true == ttsd_network_is_connected()) {
+		g_synth_engine = network->engine;
+		ret = __internal_start_path(network);
+	}
+
+	if (0 == ret) {
+		int delay = ttsd_config_get_int_option(TTSD_CONFIG_HYBRID_HEDGE_DELAY, HYBRID_HEDGE_DELAY_DEFAULT);
+
+		if (0 == delay && race == g_race && NULL == race->winner)
+			__internal_start_path(local);
+		else if (0 < delay && NULL != local->lang)
+			race->hedge_timer = ecore_timer_add((double)delay / 1000, __hybrid_hedge_cb, race);
+	} else {
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Network engine is not available, text goes to local engine");
+
+		g_synth_engine = local->engine;
+		if (0 == __internal_start_path(local)) {
+			ttsd_stats_increase(TTSD_STATS_HYBRID_FAILOVER);
+			ret = 0;
+		} else {
+			/* server gets error of start instead of result */
+			race->is_done = true;
+		}
+	}
+
+	race->ref--;
+	__internal_release_race(race);
+
+	return ret;
+}
+
+void __internal_set_race_winner(hybrid_race_s* race, hybrid_path_s* path)
+{
+	hybrid_path_s* other = (path == &race->path[HYBRID_PATH_NETWORK]) ? &race->path[HYBRID_PATH_LOCAL] : &race->path[HYBRID_PATH_NETWORK];
+
+	race->winner = path;
+	g_synth_engine = path->engine;
+
+	if (NULL != race->hedge_timer) {
+		ecore_timer_del(race->hedge_timer);
+		race->hedge_timer = NULL;
+	}
+
+	ttsd_stats_add_latency(path->latency, ttsd_stats_get_time() - race->start_time);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] First audio of hybrid path : engine(%s)", path->engine->engine_uuid);
+
+	/* results of loser are dropped */
+	if (true == other->is_started && NULL != other->engine->pefuncs->cancel_synth) {
+		other->engine->pefuncs->cancel_synth();
+		ttsd_result_queue_flush();
+	}
+}
+
+void __internal_cancel_race()
+{
+	hybrid_race_s* race = g_race;
+	g_race = NULL;
+
+	if (NULL != race->hedge_timer) {
+		ecore_timer_del(race->hedge_timer);
+		race->hedge_timer = NULL;
+	}
+
+	/* cancel event of one path is sent to server */
+	if (NULL == race->winner) {
+		race->winner = (true == race->path[HYBRID_PATH_NETWORK].is_started) ? 
+			&race->path[HYBRID_PATH_NETWORK] : &race->path[HYBRID_PATH_LOCAL];
+	}
+
+	/* race may be released in cancel_synth() */
+	ttsengine_s* engines[HYBRID_PATH_COUNT];
+	int i;
+	for (i = 0; i < HYBRID_PATH_COUNT; i++)
+		engines[i] = (true == race->path[i].is_started) ? race->path[i].engine : NULL;
+
+	for (i = 0; i < HYBRID_PATH_COUNT; i++) {
+		if (NULL != engines[i] && NULL != engines[i]->pefuncs->cancel_synth)
+			engines[i]->pefuncs->cancel_synth();
+	}
+
+	ttsd_result_queue_flush();
+}
+
+hybrid_path_s* __internal_find_race_path(void* user_data)
+{
+	GList* iter = g_list_first(g_races);
+	while (NULL != iter) {
+		hybrid_race_s* race = iter->data;
+		int i;
+
+		for (i = 0; i < HYBRID_PATH_COUNT; i++) {
+			if (user_data == (void*)&race->path[i])
+				return &race->path[i];
+		}
+
+		iter = g_list_next(iter);
+	}
+
+	return NULL;
+}
+
+void __internal_deliver_race_result(hybrid_path_s* path, ttsp_result_event_e event, const void* data, unsigned int data_size)
+{
+	hybrid_race_s* race = path->race;
+	hybrid_path_s* other = (path == &race->path[HYBRID_PATH_NETWORK]) ? &race->path[HYBRID_PATH_LOCAL] : &race->path[HYBRID_PATH_NETWORK];
+	bool is_terminal = (TTSP_RESULT_EVENT_FINISH == event || TTSP_RESULT_EVENT_CANCEL == event || TTSP_RESULT_EVENT_FAIL == event);
+	bool is_forwarded = false;
+
+	race->ref++;
+
+	if (true == is_terminal)
+		path->is_started = false;
+
+	if (NULL == path->engine) {
+		/* engine is closed */
+	} else if (NULL != race->winner) {
+		is_forwarded = (race->winner == path);
+	} else if (TTSP_RESULT_EVENT_START == event || TTSP_RESULT_EVENT_CONTINUE == event || TTSP_RESULT_EVENT_FINISH == event) {
+		/* first audio wins */
+		__internal_set_race_winner(race, path);
+		is_forwarded = true;
+	} else if (true == other->is_started) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Hybrid path fails, the other goes on : engine(%s), event(%d)", 
+			path->engine->engine_uuid, event);
+	} else if (&race->path[HYBRID_PATH_NETWORK] == path && race == g_race && false == other->is_tried && 0 == __internal_start_path(other)) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Network engine fails, text goes to local engine : event(%d)", event);
+		ttsd_stats_increase(TTSD_STATS_HYBRID_FAILOVER);
+		g_synth_engine = other->engine;
+	} else {
+		is_forwarded = true;
+	}
+
+	if (true == is_forwarded && false == race->is_done) {
+		if (true == is_terminal) {
+			race->is_done = true;
+			if (g_race == race)
+				g_race = NULL;
+		}
+
+		g_result_cb(event, data, data_size, race->user_data);
+	}
+
+	race->ref--;
+	__internal_release_race(race);
+}
+
+void __internal_detach_race_engine(ttsengine_s* engine)
+{
+	GList* iter = g_list_first(g_races);
+	while (NULL != iter) {
+		hybrid_race_s* race = iter->data;
+		iter = g_list_next(iter);
+
+		int i;
+		for (i = 0; i < HYBRID_PATH_COUNT; i++) {
+			if (engine == race->path[i].engine) {
+				race->path[i].engine = NULL;
+				race->path[i].is_started = false;
+			}
 		}
+
+		__internal_release_race(race);
 	}
+}
 
-	/* unload engine */
-	g_cur_engine.ttsp_unload_engine();
-	
-	dlclose(g_cur_engine.handle);
+void __internal_network_changed_cb(bool is_connected)
+{
+	hybrid_race_s* race = g_race;
+	if (true == is_connected || NULL == race || NULL != race->winner)
+		return;
 
-	/* reset current engine data */
-	g_cur_engine.handle = NULL;
-	g_cur_engine.is_loaded = false;
+	hybrid_path_s* network = &race->path[HYBRID_PATH_NETWORK];
+	hybrid_path_s* local = &race->path[HYBRID_PATH_LOCAL];
+	if (false == network->is_started)
+		return;
 
-	return 0;
-}
+	SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Network is out, text goes to local engine");
 
-bool ttsd_engine_agent_need_network()
-{
-	if (false == g_agent_init) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not Initialized \n" );
-		return TTSD_ERROR_OPERATION_FAILED;
+	race->ref++;
+
+	if (NULL != race->hedge_timer) {
+		ecore_timer_del(race->hedge_timer);
+		race->hedge_timer = NULL;
 	}
 
-	if (false == g_cur_engine.is_loaded) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not loaded engine \n");
-		return TTSD_ERROR_OPERATION_FAILED;
+	if (false == local->is_tried && 0 == __internal_start_path(local))
+		ttsd_stats_increase(TTSD_STATS_HYBRID_FAILOVER);
+
+	/* network engine may wait for its own timeout */
+	if (NULL == race->winner && true == local->is_started && true == network->is_started && NULL != network->engine->pefuncs->cancel_synth) {
+		network->engine->pefuncs->cancel_synth();
+		ttsd_result_queue_flush();
 	}
 
-	return g_cur_engine.need_network;
+	race->ref--;
+	__internal_release_race(race);
 }
 
-bool ttsd_engine_select_valid_voice(const char* lang, int type, char** out_lang, ttsp_voice_type_e* out_type)
+/*
+* Text stream
+*/
+
+void __internal_reset_stream()
 {
-	if (NULL == lang || NULL == out_lang || NULL == out_type) {
-		return false;
-	}
+	if (NULL != g_stream.timer)
+		ecore_timer_del(g_stream.timer);
 
-	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Select voice : input lang(%s) , input type(%d), default lang(%s), default type(%d)", 
-		lang, type, g_cur_engine.default_lang, g_cur_engine.default_vctype);
+	if (NULL != g_stream.lang)
+		g_free(g_stream.lang);
 
-	
-	/* case 1 : Both are default */
-	if (0 == strncmp(lang, "default", strlen("default")) && 0 == type) {
-		*out_lang = strdup(g_cur_engine.default_lang);
-		*out_type = g_cur_engine.default_vctype;
-		return true;	
+	if (NULL != g_stream.text)
+		g_string_free(g_stream.text, TRUE);
 
-	} 
-	
-	/* Get voice list */
-	if (NULL == g_cur_engine.pefuncs->foreach_voices) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] foreach_voices of engine is NULL!!");
-		return TTSD_ERROR_OPERATION_FAILED;
-	}
+	memset(&g_stream, 0, sizeof(stream_s));
+}
 
-	GList* voice_list = NULL;
-	int ret = 0;
+/* Synthesize complete sentences of stream, or all text if stream is closed */
+int __internal_synthesize_stream()
+{
+	if (true == g_stream.is_synthesizing || NULL == g_stream.text)
+		return 0;
 
-	ret = g_cur_engine.pefuncs->foreach_voices(__supported_voice_cb, &voice_list);
-	if (0 != ret || 0 >= g_list_length(voice_list)) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail to get voice list : result(%d) \n", ret);
-		return false;
+	gsize len = 0;
+	if (true == g_stream.is_closed) {
+		len = g_stream.text->len;
+	} else {
+		gsize i;
+		for (i = 0; i < g_stream.text->len; i++) {
+			if (NULL != strchr(".!?;\n", g_stream.text->str[i]))
+				len = i + 1;
+		}
 	}
 
-	bool result;
-	result = false;
+	if (0 == len)
+		return 0;
 
-	GList *iter = NULL;
-	voice_s* voice;
+	char* sentence = g_strndup(g_stream.text->str, len);
+	g_string_erase(g_stream.text, 0, len);
 
-	/* lang and type are not default type */
-	if (0 != strncmp(lang, "default", strlen("default")) && 0 != type) {
-		iter = g_list_first(voice_list);
+	/* sentence of spaces is skipped */
+	if ('\0' == g_strstrip(sentence)[0]) {
+		g_free(sentence);
+		return 0;
+	}
 
-		while (NULL != iter) {
-			/* Get handle data from list */
-			voice = iter->data;
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Synthesize sentence of stream : %s", sentence);
 
-			if (0 == strncmp(voice->language, lang, strlen(lang)) &&  voice->type == type) {
-				*out_lang = strdup(voice->language);
-				*out_type = voice->type;
-				result = true;
-				break;
-			}
+	g_synth_engine = g_stream.engine;
+	g_stream.is_synthesizing = true;
 
-			iter = g_list_next(iter);
-		}
+	int ret = g_stream.engine->pefuncs->start_synth(g_stream.lang, g_stream.type, sentence, g_stream.speed, g_stream.user_data);
+	g_free(sentence);
 
-	} else if (0 != strncmp(lang, "default", strlen("default")) && 0 == type) {
-		/* Only type is default */
-		if (0 == strncmp(lang, g_cur_engine.default_lang, strlen(g_cur_engine.default_lang))) {
-			*out_lang = strdup(g_cur_engine.default_lang);
-			*out_type = g_cur_engine.default_vctype;
-			result = true;
-		} else {
-			voice_s* voice_selected = NULL;
-			iter = g_list_first(voice_list);
-			while (NULL != iter) {
-				/* Get handle data from list */
-				voice = iter->data;
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Fail to synthesize sentence of stream : result(%d)", ret);
+		g_stream.is_synthesizing = false;
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
 
-				if (0 == strncmp(voice->language, lang, strlen(lang))) {
-					voice_selected = voice;
-					if (voice->type == g_cur_engine.default_vctype) {
-						voice_selected = voice;
-						break;
-					}
-				}
-				iter = g_list_next(iter);
-			}
+	return 0;
+}
 
-			if (NULL != voice_selected) {
-				*out_lang = strdup(voice_selected->language);
-				*out_type = voice_selected->type;
-				result = true;
-			}
-		}
-	} else if (0 == strncmp(lang, "default", strlen("default")) && 0 != type) {
-		/* Only lang is default */
-		if (type == g_cur_engine.default_vctype) {
-			*out_lang = strdup(g_cur_engine.default_lang);
-			*out_type = g_cur_engine.default_vctype;
-			result = true;
-		} else {
-			voice_s* voice_selected = NULL;
-			iter = g_list_first(voice_list);
-			while (NULL != iter) {
-				/* Get handle data from list */
-				voice = iter->data;
+/* Go on with next sentence, or finish closed stream. Engine may not accept new request in its callback. */
+static Eina_Bool __stream_next_cb(void* data)
+{
+	g_stream.timer = NULL;
 
-				if (0 == strncmp(voice->language, g_cur_engine.default_lang, strlen(g_cur_engine.default_lang)) ) {
-					voice_selected = voice;
-					if (voice->type == type) {
-						voice_selected = voice;
-						break;
-					}
-				}
-				iter = g_list_next(iter);
-			}
+	if (false == g_stream.is_open)
+		return EINA_FALSE;
 
-			if (NULL != voice_selected) {
-				*out_lang = strdup(voice->language);
-				*out_type = voice_selected->type;
-				result = true;
-			}
-		}
-	}
+	void* user_data = g_stream.user_data;
+	ttsp_result_event_e event;
 
-	if (true == result) {
-		SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Selected voice : lang(%s), type(%d) \n", *out_lang, *out_type);
+	if (0 != __internal_synthesize_stream()) {
+		event = TTSP_RESULT_EVENT_FAIL;
+	} else if (false == g_stream.is_synthesizing && true == g_stream.is_closed) {
+		event = TTSP_RESULT_EVENT_FINISH;
+	} else {
+		return EINA_FALSE;
 	}
 
-	__free_voice_list(voice_list);
+	__internal_reset_stream();
+	g_result_cb(event, NULL, 0, user_data);
 
-	return result;
+	return EINA_FALSE;
 }
 
-bool ttsd_engine_agent_is_same_engine(const char* engine_id)
+bool __internal_filter_stream_result(ttsp_result_event_e* event, unsigned int data_size)
 {
-	if (false == g_agent_init) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not Initialized \n" );
-		return false;
-	}
+	if (true == g_stream.is_native)
+		return true;
 
-	if (false == g_cur_engine.is_loaded) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not loaded engine \n");
-		return false;
+	if (TTSP_RESULT_EVENT_START == *event) {
+		if (true == g_stream.is_started)
+			*event = TTSP_RESULT_EVENT_CONTINUE;
+		g_stream.is_started = true;
+		return true;
 	}
 
-	/* compare current engine and engine id.*/
-	if (0 == strncmp(g_cur_engine.engine_uuid, engine_id, strlen(engine_id))) {
-		return true;
+	if (TTSP_RESULT_EVENT_FINISH == *event) {
+		g_stream.is_synthesizing = false;
+
+		if (true == g_stream.is_closed && (NULL == g_stream.text || 0 == g_stream.text->len))
+			return true;
+
+		/* sentence is done, but stream is not */
+		*event = TTSP_RESULT_EVENT_CONTINUE;
+		if (NULL == g_stream.timer)
+			g_stream.timer = ecore_timer_add(0, __stream_next_cb, NULL);
+
+		return (0 < data_size);
 	}
 
-	return false;
+	return true;
 }
 
-/******************************************************************************************
-* TTS Engine Interfaces for client
-*******************************************************************************************/
-
-int ttsd_engine_start_synthesis(const char* lang, const ttsp_voice_type_e vctype, const char* text, const int speed, void* user_param)
+int ttsd_engine_open_stream(const char* lang, const ttsp_voice_type_e vctype, const int speed, void* user_param)
 {
-	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] start ttsd_engine_start_synthesis() \n");
-
 	if (false == g_agent_init) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not Initialized \n" );
 		return TTSD_ERROR_OPERATION_FAILED;
@@ -914,74 +2804,119 @@ int ttsd_engine_start_synthesis(const char* lang, const ttsp_voice_type_e vctype
 		return TTSD_ERROR_OPERATION_FAILED;
 	}
 
-	/* select voice for default */
-	char* temp_lang = NULL;
+	if (true == g_stream.is_open) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Stream is already opened");
+		return TTSD_ERROR_INVALID_STATE;
+	}
+
+	const char* temp_lang = NULL;
 	ttsp_voice_type_e temp_type;
-	if (true != ttsd_engine_select_valid_voice(lang, vctype, &temp_lang, &temp_type)) {
+	ttsengine_s* engine = NULL;
+	if (NULL != lang)
+		engine = __internal_select_engine(lang, vctype, &temp_lang, &temp_type);
+
+	if (NULL == engine) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Fail to select default voice \n");
 		return TTSD_ERROR_INVALID_VOICE;
-	} else {
-		SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Start synthesis : language(%s), type(%d), speed(%d), text(%s) \n", 
-			temp_lang, temp_type, speed, text);
 	}
 
-	if (NULL == g_cur_engine.pefuncs->start_synth) {
+	ttsp_speed_e temp_speed = (0 == speed) ? (ttsp_speed_e)engine->default_speed : (ttsp_speed_e)speed;
+
+	/* stream is not raced, it goes to local engine while network is out */
+	if (&g_cur_engine == engine && true == __internal_is_hybrid() && false == ttsd_network_is_connected()) {
+		ttsengine_s* local = __internal_get_fallback_engine();
+		const char* local_lang = NULL;
+		ttsp_voice_type_e local_type;
+
+		if (NULL != local && (true == __internal_select_voice(local, temp_lang, temp_type, &local_lang, &local_type) ||
+		    true == __internal_select_voice(local, temp_lang, 0, &local_lang, &local_type))) {
+			engine = local;
+			temp_lang = local_lang;
+			temp_type = local_type;
+			ttsd_stats_increase(TTSD_STATS_HYBRID_FAILOVER);
+		}
+	}
+
+	g_stream.is_native = (NULL != engine->pefuncs->open_stream && NULL != engine->pefuncs->push_stream && NULL != engine->pefuncs->close_stream);
+
+	if (false == g_stream.is_native && NULL == engine->pefuncs->start_synth) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] start_synth() of engine is NULL!!");
 		return TTSD_ERROR_OPERATION_FAILED;
 	}
 
-	ttsp_speed_e temp_speed;
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Open stream : language(%s), type(%d), speed(%d), native(%d)",
+		temp_lang, temp_type, temp_speed, g_stream.is_native);
 
-	if (0 == speed) {
-		temp_speed = g_cur_engine.default_speed;
-	} else {
-		temp_speed = speed;
-	}
+	g_synth_engine = engine;
 
-	/* synthesize text */
-	int ret = 0;
-	ret = g_cur_engine.pefuncs->start_synth(temp_lang, temp_type, text, temp_speed, user_param);
-	if (0 != ret) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] ***************************************", ret);
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] * synthesize error : result(%6d) *", ret);
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] ***************************************", ret);
-		return TTSD_ERROR_OPERATION_FAILED;
+	if (true == g_stream.is_native) {
+		int ret = engine->pefuncs->open_stream(temp_lang, temp_type, temp_speed, user_param);
+		if (0 != ret) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Fail to open stream : result(%d)", ret);
+			return TTSD_ERROR_OPERATION_FAILED;
+		}
+	} else {
+		g_stream.text = g_string_new(NULL);
 	}
 
-	if (NULL == temp_lang)
-		free(temp_lang);
+	g_stream.is_open = true;
+	g_stream.engine = engine;
+	g_stream.lang = g_strdup(temp_lang);
+	g_stream.type = temp_type;
+	g_stream.speed = temp_speed;
+	g_stream.user_data = user_param;
 
 	return 0;
 }
 
-
-int ttsd_engine_cancel_synthesis()
+int ttsd_engine_push_stream(const char* text)
 {
-	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] start ttsd_engine_cancel_synthesis() \n");
-	
-	if (false == g_agent_init) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not Initialized \n" );
-		return TTSD_ERROR_OPERATION_FAILED;
+	if (NULL == text) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Invalid parameter");
+		return TTSD_ERROR_INVALID_PARAMETER;
 	}
 
-	if (false == g_cur_engine.is_loaded) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Not loaded engine \n");
-		return TTSD_ERROR_OPERATION_FAILED;
+	if (false == g_stream.is_open || true == g_stream.is_closed) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Stream is not opened");
+		return TTSD_ERROR_INVALID_STATE;
 	}
-	
-	if (NULL == g_cur_engine.pefuncs->cancel_synth) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] cancel_synth() of engine is NULL!!");
-		return TTSD_ERROR_OPERATION_FAILED;
+
+	if (true == g_stream.is_native) {
+		int ret = g_stream.engine->pefuncs->push_stream(text);
+		if (0 != ret) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Fail to push text to stream : result(%d)", ret);
+			return TTSD_ERROR_OPERATION_FAILED;
+		}
+		return 0;
 	}
 
-	/* stop synthesis */
-	int ret = 0;
-	ret = g_cur_engine.pefuncs->cancel_synth();
-	if (0 != ret) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail cancel synthesis : result(%d) \n", ret);
-		return TTSD_ERROR_OPERATION_FAILED;
+	g_string_append(g_stream.text, text);
+
+	return __internal_synthesize_stream();
+}
+
+int ttsd_engine_close_stream()
+{
+	if (false == g_stream.is_open || true == g_stream.is_closed) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Stream is not opened");
+		return TTSD_ERROR_INVALID_STATE;
+	}
+
+	g_stream.is_closed = true;
+
+	if (true == g_stream.is_native) {
+		int ret = g_stream.engine->pefuncs->close_stream();
+		if (0 != ret) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Fail to close stream : result(%d)", ret);
+			return TTSD_ERROR_OPERATION_FAILED;
+		}
+		return 0;
 	}
 
+	/* rest of text, or FINISH if nothing is left */
+	if (false == g_stream.is_synthesizing && NULL == g_stream.timer)
+		g_stream.timer = ecore_timer_add(0, __stream_next_cb, NULL);
+
 	return 0;
 }
 
@@ -997,18 +2932,11 @@ int ttsd_engine_get_audio_format( ttsp_audio_type_e* type, int* rate, int* chann
 		return TTSD_ERROR_OPERATION_FAILED;
 	}
 
-	if (NULL == g_cur_engine.pefuncs->get_audio_format) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] get_audio_format() of engine is NULL!!");
-		return TTSD_ERROR_OPERATION_FAILED;
-	}
-
-	int ret = 0;
-	ret = g_cur_engine.pefuncs->get_audio_format(type, rate, channels);
-	if (0 != ret) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail to get audio format : result(%d) \n", ret);
-		return TTSD_ERROR_OPERATION_FAILED;
-	} else
-		SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] get audio format : type(%d), rate(%d), channel(%d) \n", *type, *rate, *channels);
+	/* queried when engine is loaded, engines for other languages may have other format */
+	const ttsengine_s* engine = (NULL != g_synth_engine) ? g_synth_engine : &g_cur_engine;
+	*type = engine->audio_type;
+	*rate = engine->audio_rate;
+	*channels = engine->audio_channels;
 	
 	return 0;
 }
@@ -1355,6 +3283,8 @@ int ttsd_engine_setting_set_default_voice(const char* language, ttsp_voice_type_
 	g_cur_engine.default_lang = strdup(language);
 	g_cur_engine.default_vctype = vctype;
 
+	__internal_preload_voice(&g_cur_engine, g_cur_engine.default_lang, g_cur_engine.default_vctype);
+
 	ret = ttsd_config_set_default_voice(language, (int)vctype);
 	if (0 == ret) {
 		SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent SUCCESS] Set default voice : lang(%s), type(%d) \n",
@@ -1487,6 +3417,9 @@ int ttsd_engine_setting_set_engine_setting(const char* key, const char* value)
 		return TTSD_ERROR_OPERATION_FAILED;
 	} 
 
+	/* cached audio may not match new setting */
+	ttsd_cache_clear();
+
 	return 0;
 }
 
@@ -1515,16 +3448,177 @@ void __free_voice_list(GList* voice_list)
 	}
 }
 
+unsigned int __internal_get_voice_hash()
+{
+	unsigned int hash = 2166136261u;
+
+	GList *iter = NULL;
+	voice_index_s* voice = NULL;
+	int i;
+
+	iter = g_list_first(g_cur_engine.voice_list);
+	while (NULL != iter) {
+		voice = iter->data;
+
+		for (i = 0; i < voice->type_count; i++) {
+			const char* p = voice->language;
+			while ('\0' != *p) {
+				hash ^= (unsigned char)*p++;
+				hash *= 16777619u;
+			}
+			hash ^= (unsigned int)voice->types[i];
+			hash *= 16777619u;
+		}
+
+		iter = g_list_next(iter);
+	}
+
+	return hash;
+}
+
+bool __voice_index_cb(const char* language, ttsp_voice_type_e type, void* user_data)
+{
+	ttsengine_s* engine = (ttsengine_s*)user_data;
+
+	if (NULL == language) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Input parameter is NULL in voice list callback!!!!");
+		return false;
+	}
+
+	if (type < TTSP_VOICE_TYPE_MALE || type > VOICE_TYPE_MAX) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Engine Agent WARNING] Invalid voice type : lang(%s), type(%d)", language, type);
+		return true;
+	}
+
+	voice_index_s* voice = g_hash_table_lookup(engine->voice_table, language);
+	if (NULL == voice || 0 != strcmp(voice->language, language)) {
+		voice = g_malloc0(sizeof(voice_index_s));
+		voice->language = g_strdup(language);
+
+		engine->voice_list = g_list_append(engine->voice_list, voice);
+		g_hash_table_insert(engine->voice_table, g_strdup(language), voice);
+
+		/* "en" finds the first voice of "en_US", "en_GB" ... */
+		const char* delim = strchr(language, '_');
+		if (NULL != delim) {
+			char* prefix = g_strndup(language, delim - language);
+			if (NULL == g_hash_table_lookup(engine->voice_table, prefix))
+				g_hash_table_insert(engine->voice_table, prefix, voice);
+			else
+				g_free(prefix);
+		}
+	}
+
+	int i;
+	for (i = 0; i < voice->type_count; i++) {
+		if (voice->types[i] == type)
+			return true;
+	}
+	voice->types[voice->type_count++] = type;
+
+	return true;
+}
+
+int __internal_build_voice_index(ttsengine_s* engine)
+{
+	__internal_free_voice_index(engine);
+
+	if (NULL == engine->pefuncs->foreach_voices) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] foreach_voices of engine is NULL!!");
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	engine->voice_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	int ret = engine->pefuncs->foreach_voices(__voice_index_cb, engine);
+	if (0 != ret || NULL == engine->voice_list) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] fail to get voice list : result(%d) \n", ret);
+		__internal_free_voice_index(engine);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Agent] Voice index : %d languages", g_list_length(engine->voice_list));
+
+	return 0;
+}
+
+void __internal_free_voice_index(ttsengine_s* engine)
+{
+	if (NULL != engine->voice_table) {
+		g_hash_table_destroy(engine->voice_table);
+		engine->voice_table = NULL;
+	}
+
+	GList *iter = g_list_first(engine->voice_list);
+	while (NULL != iter) {
+		voice_index_s* voice = iter->data;
+		g_free(voice->language);
+		g_free(voice);
+
+		iter = g_list_next(iter);
+	}
+
+	g_list_free(engine->voice_list);
+	engine->voice_list = NULL;
+}
+
+const voice_index_s* __internal_find_voice(ttsengine_s* engine, const char* lang)
+{
+	if (NULL == engine->voice_table || NULL == lang)
+		return NULL;
+
+	return g_hash_table_lookup(engine->voice_table, lang);
+}
+
 /*
 * TTS Engine Callback Functions											`				  *
 */
 bool __result_cb(ttsp_result_event_e event, const void* data, unsigned int data_size, void *user_data)
 {
-	g_result_cb(event, data, data_size, user_data);
+	/* data of server is not thread-safe, result of engine thread is handled in main loop */
+	if (false == ttsd_result_queue_is_main_thread()) {
+		if (0 != ttsd_result_queue_push(event, data, data_size, user_data)) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[Engine Agent ERROR] Fail to queue result, data is dropped : event(%d)", event);
+			ttsd_result_queue_push(event, NULL, 0, user_data);
+		}
+		return true;
+	}
+
+	/* results queued before come first */
+	ttsd_result_queue_flush();
+
+	__internal_deliver_result(event, data, data_size, user_data);
+
+	/* buffer of daemon which is not kept as sound data */
+	ttsd_buffer_return(data);
 
 	return true;
 }
 
+void __internal_deliver_result(ttsp_result_event_e event, const void* data, unsigned int data_size, void *user_data)
+{
+	if (NULL == g_result_cb)
+		return;
+
+	hybrid_path_s* path = __internal_find_race_path(user_data);
+	if (NULL != path) {
+		__internal_deliver_race_result(path, event, data, data_size);
+		return;
+	}
+
+	bool is_stream = (true == g_stream.is_open && user_data == g_stream.user_data);
+	bool is_forwarded = true;
+
+	if (true == is_stream)
+		is_forwarded = __internal_filter_stream_result(&event, data_size);
+
+	if (true == is_forwarded)
+		g_result_cb(event, data, data_size, user_data);
+
+	if (true == is_stream && (TTSP_RESULT_EVENT_FINISH == event || TTSP_RESULT_EVENT_CANCEL == event || TTSP_RESULT_EVENT_FAIL == event))
+		__internal_reset_stream();
+}
+
 /* function for debugging */
 int ttsd_print_enginelist()
 {
@@ -24,6 +24,8 @@ extern "C" {
 
 typedef int (*synth_result_callback)(ttsp_result_event_e event, const void* data, unsigned int data_size, void *user_data);
 
+typedef void (*ttsd_engine_prepared_cb)(bool is_loaded);
+
 /*
 * tts Engine Agent Interfaces
 */
@@ -43,13 +45,35 @@ int ttsd_engine_agent_load_current_engine();
 /** Unload current engine */
 int ttsd_engine_agent_unload_current_engine();
 
+/** Unload and load engine of current synthesis, which does not respond */
+int ttsd_engine_agent_restart_engine();
+
+/** Check whether current engine is loaded */
+bool ttsd_engine_agent_is_loaded();
+
+/** Load engine in background while current engine works. Callback is called in main loop. */
+int ttsd_engine_agent_prepare_engine(const char* engine_id, ttsd_engine_prepared_cb callback);
+
+/** Release engine which is prepared but not switched */
+int ttsd_engine_agent_cancel_next_engine();
+
+/** Replace current engine with prepared engine. Synthesis of current engine should be done. */
+int ttsd_engine_agent_switch_engine();
+
 /** test for language list */
 int ttsd_print_enginelist();
 
 /** Get state of current engine to need network */
 bool ttsd_engine_agent_need_network();
 
-bool ttsd_engine_select_valid_voice(const char* lang, int type, char** out_lang, ttsp_voice_type_e* out_type);
+/** Select voice for default language or type. The out_lang is valid until engine is unloaded. */
+bool ttsd_engine_select_valid_voice(const char* lang, int type, const char** out_lang, ttsp_voice_type_e* out_type);
+
+/** Get count of texts which can be synthesized at once with the voice. 1 if engine does not support concurrent synthesis. */
+int ttsd_engine_get_concurrency(const char* lang, int type);
+
+/** Get count of texts which can be given to engine at once with the voice. 1 if engine does not support batch synthesis. */
+int ttsd_engine_get_batch_size(const char* lang, int type);
 
 bool ttsd_engine_agent_is_same_engine(const char* engine_id);
 
@@ -58,8 +82,22 @@ bool ttsd_engine_agent_is_same_engine(const char* engine_id);
 */
 int ttsd_engine_start_synthesis(const char* lang, const ttsp_voice_type_e vctype, const char* text, const int speed, void* user_param);
 
+/** Start synthesis of texts of the same voice and speed at once. Results of each text are sent with its user_param. */
+int ttsd_engine_start_batch(const char* lang, const ttsp_voice_type_e vctype, const int speed, const char** texts, void** user_params, int count);
+
+/** Estimate text by engine. It fails if engine cannot estimate. */
+int ttsd_engine_estimate_cost(const char* lang, int vctype, const char* text, int speed, int* synth_msec, int* audio_msec);
+
 int ttsd_engine_cancel_synthesis();
 
+/** Start synthesis of text which is pushed later. Engine without text stream gets the text sentence by sentence. */
+int ttsd_engine_open_stream(const char* lang, const ttsp_voice_type_e vctype, const int speed, void* user_param);
+
+int ttsd_engine_push_stream(const char* text);
+
+/** No more text. FINISH is sent after audio of all pushed text. */
+int ttsd_engine_close_stream();
+
 int ttsd_engine_get_voice_list(GList** voice_list);
 
 int ttsd_engine_get_default_voice(char** lang, ttsp_voice_type_e* vctype );
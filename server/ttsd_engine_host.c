@@ -0,0 +1,1390 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE		/* memfd_create() */
+#endif
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <Ecore.h>
+
+#include "ttsd_main.h"
+#include "ttsd_config.h"
+#include "ttsd_stats.h"
+#include "ttsd_engine_host.h"
+#include "ttsd_resource.h"
+
+/*
+* Engine host process. It is the daemon binary executed with HOST_ARGUMENT, so that it does not inherit
+* locks of daemon threads. Daemon sends requests on control socket and waits for reply, except start and cancel
+* of synthesis which are not answered. Host process sends synthesis results on event socket, and its audio is
+* written to ring in shared memory.
+*/
+
+#define HOST_MAX			4		/* engines in host process at once */
+#define HOST_RING_SIZE			(1024 * 1024)
+#define HOST_TIMEOUT_DEFAULT		5000		/* msec */
+#define HOST_RESTART_MAX		3		/* restarts in HOST_RESTART_PERIOD, then host is given up */
+#define HOST_RESTART_PERIOD		60000		/* msec */
+#define HOST_STOP_TIMEOUT		1000		/* msec, host process which does not exit after unload is killed */
+#define HOST_REAP_INTERVAL		0.1		/* sec */
+#define HOST_ARGUMENT			"--engine-host"
+
+typedef enum {
+	HOST_MSG_HELLO = 0,		/* engine is loaded in host process */
+	HOST_MSG_INITIALIZE,
+	HOST_MSG_DEINITIALIZE,
+	HOST_MSG_FOREACH_VOICES,
+	HOST_MSG_IS_VALID_VOICE,
+	HOST_MSG_GET_AUDIO_FORMAT,
+	HOST_MSG_START_SYNTH,
+	HOST_MSG_CANCEL_SYNTH,
+	HOST_MSG_FOREACH_SETTINGS,
+	HOST_MSG_SET_SETTING,
+	HOST_MSG_UNLOAD,
+	HOST_MSG_ITEM,			/* voice or setting of foreach request */
+	HOST_MSG_REPLY,
+	HOST_MSG_RESULT,		/* synthesis result, audio is in ring */
+	HOST_MSG_EXIT			/* host process is gone, made by daemon */
+} host_msg_e;
+
+/* Message header. Two strings of payload follow it. */
+typedef struct {
+	int			type;
+	int			ret;
+	int			arg[3];
+	unsigned int		funcs;		/* engine functions which are not NULL, bit of host_msg_e */
+	unsigned long long	user_data;
+	unsigned int		start;		/* position of audio in ring, free running */
+	unsigned int		size;
+	unsigned int		payload_size;
+} host_msg_s;
+
+/* Audio ring shared with host process. Only host writes audio, only daemon consumes it. */
+typedef struct {
+	unsigned int	head;
+	unsigned int	tail;
+	char		data[HOST_RING_SIZE];
+} host_ring_s;
+
+struct _ttsd_engine_host_s {
+	int		slot;
+	char*		engine_path;
+	host_ring_s*	ring;
+	int		ring_fd;	/* shared memory of ring, given to each host process */
+
+	/* host process */
+	pid_t		pid;
+	int		control_fd;
+	int		event_fd;
+	pthread_t	reader;
+	bool		is_reading;
+	unsigned int	generation;
+
+	/* engine in host process */
+	int		version;
+	int		capability;
+	unsigned int	funcs;
+	ttspe_result_cb	result_cb;	/* set while engine is initialized */
+	GList*		requests;	/* user data of synthesis which is not finished */
+
+	long long	restart_time;
+	int		restart_count;
+};
+
+/* Event from reader thread, handled in main loop */
+typedef struct {
+	int		slot;
+	unsigned int	generation;
+	host_msg_s	msg;
+} host_event_s;
+
+typedef struct {
+	ttsd_engine_host_h	host;
+	int			fd;
+	unsigned int		generation;
+} host_reader_s;
+
+/* Stopped host process which is not reaped yet */
+typedef struct {
+	pid_t		pid;
+	long long	kill_time;	/* killed if it is alive at this time */
+	bool		is_killed;
+} host_dying_s;
+
+typedef void (*host_item_cb)(const host_msg_s* msg, const char* s1, const char* s2, void* user_data);
+
+static ttsd_engine_host_h g_hosts[HOST_MAX];
+
+static pthread_mutex_t g_host_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned int g_generation = 0;
+
+/* host_dying_s, used in main loop */
+static GList* g_dying_list = NULL;
+static Ecore_Timer* g_reap_timer = NULL;
+
+/* Engine in host process */
+static ttspe_funcs_s g_child_pefuncs;
+static ttspd_funcs_s g_child_pdfuncs;
+static host_ring_s* g_child_ring = NULL;
+static int g_child_control_fd = -1;
+static int g_child_event_fd = -1;
+static pthread_mutex_t g_child_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Synthesis of host process. Engine may block in start_synth(), so it is called by worker and cancel is always read. */
+typedef struct {
+	char*	language;
+	char*	text;
+	int	type;
+	int	speed;
+	void*	user_data;
+} child_synth_s;
+
+static GList* g_child_synth_list = NULL;	/* child_synth_s*, not started yet */
+static bool g_child_is_synthesizing = false;	/* worker is in start_synth() */
+static bool g_child_is_exit = false;
+static pthread_t g_child_worker;
+static pthread_mutex_t g_child_synth_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_child_synth_cond = PTHREAD_COND_INITIALIZER;
+
+
+static void __host_restart(ttsd_engine_host_h host, bool is_crash);
+
+/*
+* Message I/O
+*/
+
+static int __host_write(int fd, const void* buf, size_t size)
+{
+	const char* p = (const char*)buf;
+
+	while (0 < size) {
+		ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+		if (0 > n) {
+			if (EINTR == errno)
+				continue;
+			return -1;
+		}
+		p += n;
+		size -= n;
+	}
+
+	return 0;
+}
+
+/* Negative timeout waits forever */
+static int __host_read(int fd, void* buf, size_t size, int timeout)
+{
+	char* p = (char*)buf;
+
+	while (0 < size) {
+		if (0 <= timeout) {
+			struct pollfd pfd = {fd, POLLIN, 0};
+			int ret = poll(&pfd, 1, timeout);
+			if (0 > ret && EINTR == errno)
+				continue;
+			if (0 >= ret)
+				return -1;
+		}
+
+		ssize_t n = read(fd, p, size);
+		if (0 > n) {
+			if (EINTR == errno)
+				continue;
+			return -1;
+		}
+		if (0 == n)
+			return -1;
+
+		p += n;
+		size -= n;
+	}
+
+	return 0;
+}
+
+static int __host_send(int fd, host_msg_s* msg, const char* s1, const char* s2)
+{
+	/* empty string for NULL, so that second string is found after first one */
+	size_t len1 = (NULL != s1) ? strlen(s1) + 1 : 1;
+	size_t len2 = (NULL != s2) ? strlen(s2) + 1 : 1;
+
+	msg->payload_size = (NULL != s1 || NULL != s2) ? (unsigned int)(len1 + len2) : 0;
+
+	char* buf = (char*)g_malloc0(sizeof(host_msg_s) + msg->payload_size);
+	memcpy(buf, msg, sizeof(host_msg_s));
+
+	if (0 < msg->payload_size) {
+		char* p = buf + sizeof(host_msg_s);
+		if (NULL != s1)
+			memcpy(p, s1, len1);
+		if (NULL != s2)
+			memcpy(p + len1, s2, len2);
+	}
+
+	int ret = __host_write(fd, buf, sizeof(host_msg_s) + msg->payload_size);
+	g_free(buf);
+
+	return ret;
+}
+
+/* Payload should be released by g_free() */
+static int __host_recv(int fd, host_msg_s* msg, char** payload, int timeout)
+{
+	*payload = NULL;
+
+	if (0 != __host_read(fd, msg, sizeof(host_msg_s), timeout))
+		return -1;
+
+	if (0 == msg->payload_size)
+		return 0;
+
+	*payload = (char*)g_malloc0(msg->payload_size + 1);
+	if (0 != __host_read(fd, *payload, msg->payload_size, timeout)) {
+		g_free(*payload);
+		*payload = NULL;
+		return -1;
+	}
+
+	return 0;
+}
+
+static void __host_get_strings(const host_msg_s* msg, const char* payload, const char** s1, const char** s2)
+{
+	*s1 = NULL;
+	*s2 = NULL;
+
+	if (NULL == payload)
+		return;
+
+	*s1 = payload;
+	if (strlen(payload) + 1 < msg->payload_size)
+		*s2 = payload + strlen(payload) + 1;
+}
+
+/*
+* Host process
+*/
+
+static int __child_send_event(host_msg_s* msg)
+{
+	return __host_send(g_child_event_fd, msg, NULL, NULL);
+}
+
+/* Engine may call it in its thread. Large audio is split, so that it fits in ring. */
+static bool __child_result_cb(ttsp_result_event_e event, const void* data, unsigned int data_size, void* user_data)
+{
+	const unsigned int max = HOST_RING_SIZE / 2;
+	unsigned int done = 0;
+
+	if (NULL == data)
+		data_size = 0;
+
+	pthread_mutex_lock(&g_child_mutex);
+
+	do {
+		unsigned int size = data_size - done;
+		if (size > max)
+			size = max;
+
+		bool is_last = (done + size >= data_size);
+		ttsp_result_event_e piece = event;
+
+		if (TTSP_RESULT_EVENT_START == event && 0 != done)
+			piece = TTSP_RESULT_EVENT_CONTINUE;
+		else if (TTSP_RESULT_EVENT_FINISH == event && false == is_last)
+			piece = TTSP_RESULT_EVENT_CONTINUE;
+
+		unsigned int start = g_child_ring->head;
+
+		if (0 < size) {
+			/* audio is not wrapped, so that daemon reads it in place */
+			unsigned int pos = start % HOST_RING_SIZE;
+			if (pos + size > HOST_RING_SIZE)
+				start += HOST_RING_SIZE - pos;
+
+			/* wait until daemon consumes old audio */
+			while (start + size - __atomic_load_n(&g_child_ring->tail, __ATOMIC_ACQUIRE) > HOST_RING_SIZE)
+				usleep(1000);
+
+			memcpy(g_child_ring->data + start % HOST_RING_SIZE, (const char*)data + done, size);
+			__atomic_store_n(&g_child_ring->head, start + size, __ATOMIC_RELEASE);
+		}
+
+		host_msg_s msg;
+		memset(&msg, 0, sizeof(host_msg_s));
+		msg.type = HOST_MSG_RESULT;
+		msg.arg[0] = (int)piece;
+		msg.user_data = (unsigned long long)(uintptr_t)user_data;
+		msg.start = start;
+		msg.size = size;
+
+		if (0 != __child_send_event(&msg))
+			break;
+
+		done += size;
+	} while (done < data_size);
+
+	pthread_mutex_unlock(&g_child_mutex);
+
+	return true;
+}
+
+static void __child_free_synth(child_synth_s* synth)
+{
+	g_free(synth->language);
+	g_free(synth->text);
+	g_free(synth);
+}
+
+static void* __child_synth_worker(void* arg)
+{
+	pthread_mutex_lock(&g_child_synth_mutex);
+
+	while (false == g_child_is_exit) {
+		if (NULL == g_child_synth_list) {
+			pthread_cond_wait(&g_child_synth_cond, &g_child_synth_mutex);
+			continue;
+		}
+
+		child_synth_s* synth = (child_synth_s*)g_child_synth_list->data;
+		g_child_synth_list = g_list_delete_link(g_child_synth_list, g_child_synth_list);
+		g_child_is_synthesizing = true;
+		pthread_mutex_unlock(&g_child_synth_mutex);
+
+		int ret = g_child_pefuncs.start_synth(synth->language, (ttsp_voice_type_e)synth->type, synth->text,
+						      (ttsp_speed_e)synth->speed, synth->user_data);
+		if (0 != ret)
+			__child_result_cb(TTSP_RESULT_EVENT_FAIL, NULL, 0, synth->user_data);
+
+		__child_free_synth(synth);
+
+		pthread_mutex_lock(&g_child_synth_mutex);
+		g_child_is_synthesizing = false;
+		pthread_cond_broadcast(&g_child_synth_cond);
+	}
+
+	pthread_mutex_unlock(&g_child_synth_mutex);
+
+	return NULL;
+}
+
+/* Texts which are not started are canceled before engine */
+static void __child_cancel_synth_list()
+{
+	pthread_mutex_lock(&g_child_synth_mutex);
+	GList* list = g_child_synth_list;
+	g_child_synth_list = NULL;
+	pthread_mutex_unlock(&g_child_synth_mutex);
+
+	GList* iter = g_list_first(list);
+	while (NULL != iter) {
+		child_synth_s* synth = (child_synth_s*)iter->data;
+		__child_result_cb(TTSP_RESULT_EVENT_CANCEL, NULL, 0, synth->user_data);
+		__child_free_synth(synth);
+		iter = g_list_next(iter);
+	}
+	g_list_free(list);
+}
+
+/* Engine is not deinitialized while worker uses it */
+static void __child_wait_synth()
+{
+	pthread_mutex_lock(&g_child_synth_mutex);
+	while (NULL != g_child_synth_list || true == g_child_is_synthesizing)
+		pthread_cond_wait(&g_child_synth_cond, &g_child_synth_mutex);
+	pthread_mutex_unlock(&g_child_synth_mutex);
+}
+
+static void __child_stop_worker()
+{
+	pthread_mutex_lock(&g_child_synth_mutex);
+	g_child_is_exit = true;
+	pthread_cond_broadcast(&g_child_synth_cond);
+	pthread_mutex_unlock(&g_child_synth_mutex);
+
+	pthread_join(g_child_worker, NULL);
+}
+
+static bool __child_voice_cb(const char* language, ttsp_voice_type_e type, void* user_data)
+{
+	host_msg_s msg;
+	memset(&msg, 0, sizeof(host_msg_s));
+	msg.type = HOST_MSG_ITEM;
+	msg.arg[0] = (int)type;
+
+	return (0 == __host_send(g_child_control_fd, &msg, language, NULL));
+}
+
+static bool __child_setting_cb(const char* key, const char* value, void* user_data)
+{
+	host_msg_s msg;
+	memset(&msg, 0, sizeof(host_msg_s));
+	msg.type = HOST_MSG_ITEM;
+
+	return (0 == __host_send(g_child_control_fd, &msg, key, value));
+}
+
+static unsigned int __child_get_funcs()
+{
+	unsigned int funcs = 0;
+
+	if (NULL != g_child_pefuncs.initialize)			funcs |= 1 << HOST_MSG_INITIALIZE;
+	if (NULL != g_child_pefuncs.deinitialize)		funcs |= 1 << HOST_MSG_DEINITIALIZE;
+	if (NULL != g_child_pefuncs.foreach_voices)		funcs |= 1 << HOST_MSG_FOREACH_VOICES;
+	if (NULL != g_child_pefuncs.is_valid_voice)		funcs |= 1 << HOST_MSG_IS_VALID_VOICE;
+	if (NULL != g_child_pefuncs.get_audio_format)		funcs |= 1 << HOST_MSG_GET_AUDIO_FORMAT;
+	if (NULL != g_child_pefuncs.start_synth)		funcs |= 1 << HOST_MSG_START_SYNTH;
+	if (NULL != g_child_pefuncs.cancel_synth)		funcs |= 1 << HOST_MSG_CANCEL_SYNTH;
+	if (NULL != g_child_pefuncs.foreach_engine_setting)	funcs |= 1 << HOST_MSG_FOREACH_SETTINGS;
+	if (NULL != g_child_pefuncs.set_engine_setting)		funcs |= 1 << HOST_MSG_SET_SETTING;
+
+	return funcs;
+}
+
+static void __child_set_daemon_funcs(int version)
+{
+	memset(&g_child_pdfuncs, 0, sizeof(ttspd_funcs_s));
+
+	if (TTSP_VERSION_1 == version) {
+		g_child_pdfuncs.version = TTSP_VERSION_1;
+		g_child_pdfuncs.size = TTSPD_FUNCS_V1_SIZE;
+		return;
+	}
+
+	/* audio is passed by ring, daemon buffer is not provided. Mapped files share page cache with other processes. */
+	g_child_pdfuncs.version = TTSP_VERSION_3;
+	g_child_pdfuncs.size = sizeof(ttspd_funcs_s);
+	g_child_pdfuncs.map_resource = ttsd_resource_map;
+	g_child_pdfuncs.unmap_resource = ttsd_resource_unmap;
+}
+
+static void __child_main(const char* engine_path, int control_fd, int event_fd, host_ring_s* ring)
+{
+	g_child_control_fd = control_fd;
+	g_child_event_fd = event_fd;
+	g_child_ring = ring;
+
+	host_msg_s hello;
+	memset(&hello, 0, sizeof(host_msg_s));
+	hello.type = HOST_MSG_HELLO;
+	hello.ret = TTSP_ERROR_OPERATION_FAILED;
+
+	int (*load_engine)(const ttspd_funcs_s*, ttspe_funcs_s*) = NULL;
+	void (*unload_engine)() = NULL;
+	int (*get_capability)(int*) = NULL;
+
+	void* handle = dlopen(engine_path, RTLD_LAZY);
+	if (NULL != handle) {
+		load_engine = (int (*)(const ttspd_funcs_s*, ttspe_funcs_s*))dlsym(handle, "ttsp_load_engine");
+		unload_engine = (void (*)())dlsym(handle, "ttsp_unload_engine");
+		get_capability = (int (*)(int*))dlsym(handle, "ttsp_get_capability");
+	}
+
+	if (NULL != load_engine && NULL != unload_engine) {
+		/* engine of version 1 gets the same daemon functions as before version 2 */
+		__child_set_daemon_funcs(NULL != get_capability ? TTSP_VERSION_3 : TTSP_VERSION_1);
+
+		hello.ret = load_engine(&g_child_pdfuncs, &g_child_pefuncs);
+
+		if (0 == hello.ret && TTSP_VERSION_1 == g_child_pdfuncs.version &&
+		    TTSP_VERSION_2 <= g_child_pefuncs.version && TTSPE_FUNCS_V2_SIZE <= g_child_pefuncs.size)
+			__child_set_daemon_funcs(TTSP_VERSION_3);
+	}
+
+	if (0 == hello.ret) {
+		int capability = TTSP_CAPABILITY_NONE;
+		if (NULL != get_capability && 0 == get_capability(&capability))
+			hello.arg[2] = capability;
+
+		if (TTSP_VERSION_2 <= g_child_pefuncs.version && TTSPE_FUNCS_V2_SIZE <= g_child_pefuncs.size)
+			hello.arg[2] |= g_child_pefuncs.capability;
+
+		hello.arg[0] = g_child_pefuncs.version;
+		hello.arg[1] = g_child_pefuncs.size;
+		hello.funcs = __child_get_funcs();
+
+		if (0 != pthread_create(&g_child_worker, NULL, __child_synth_worker, NULL))
+			hello.ret = TTSP_ERROR_OPERATION_FAILED;
+	}
+
+	if (0 != __host_send(control_fd, &hello, NULL, NULL) || 0 != hello.ret)
+		_exit(1);
+
+	bool is_running = true;
+	while (true == is_running) {
+		host_msg_s msg;
+		char* payload = NULL;
+		const char* s1 = NULL;
+		const char* s2 = NULL;
+
+		if (0 != __host_recv(control_fd, &msg, &payload, -1))
+			break;
+
+		__host_get_strings(&msg, payload, &s1, &s2);
+
+		host_msg_s reply;
+		memset(&reply, 0, sizeof(host_msg_s));
+		reply.type = HOST_MSG_REPLY;
+		reply.ret = TTSP_ERROR_OPERATION_FAILED;
+
+		/* daemon does not wait for start and cancel of synthesis */
+		bool need_reply = true;
+
+		void* user_data = (void*)(uintptr_t)msg.user_data;
+
+		switch (msg.type) {
+		case HOST_MSG_INITIALIZE:
+			if (NULL != g_child_pefuncs.initialize)
+				reply.ret = g_child_pefuncs.initialize(__child_result_cb);
+			break;
+
+		case HOST_MSG_DEINITIALIZE:
+			__child_wait_synth();
+			if (NULL != g_child_pefuncs.deinitialize)
+				reply.ret = g_child_pefuncs.deinitialize();
+			break;
+
+		case HOST_MSG_FOREACH_VOICES:
+			if (NULL != g_child_pefuncs.foreach_voices)
+				reply.ret = g_child_pefuncs.foreach_voices(__child_voice_cb, NULL);
+			break;
+
+		case HOST_MSG_IS_VALID_VOICE:
+			if (NULL != g_child_pefuncs.is_valid_voice && NULL != s1)
+				reply.ret = g_child_pefuncs.is_valid_voice(s1, (ttsp_voice_type_e)msg.arg[0]) ? 1 : 0;
+			break;
+
+		case HOST_MSG_GET_AUDIO_FORMAT:
+			if (NULL != g_child_pefuncs.get_audio_format) {
+				ttsp_audio_type_e audio_type;
+				int rate;
+				int channels;
+
+				reply.ret = g_child_pefuncs.get_audio_format(&audio_type, &rate, &channels);
+				reply.arg[0] = (int)audio_type;
+				reply.arg[1] = rate;
+				reply.arg[2] = channels;
+			}
+			break;
+
+		case HOST_MSG_START_SYNTH:
+			need_reply = false;
+			if (NULL == g_child_pefuncs.start_synth || NULL == s1 || NULL == s2) {
+				__child_result_cb(TTSP_RESULT_EVENT_FAIL, NULL, 0, user_data);
+			} else {
+				/* failure of engine is sent as result */
+				child_synth_s* synth = (child_synth_s*)g_malloc0(sizeof(child_synth_s));
+				synth->language = g_strdup(s1);
+				synth->text = g_strdup(s2);
+				synth->type = msg.arg[0];
+				synth->speed = msg.arg[1];
+				synth->user_data = user_data;
+
+				pthread_mutex_lock(&g_child_synth_mutex);
+				g_child_synth_list = g_list_append(g_child_synth_list, synth);
+				pthread_cond_broadcast(&g_child_synth_cond);
+				pthread_mutex_unlock(&g_child_synth_mutex);
+			}
+			break;
+
+		case HOST_MSG_CANCEL_SYNTH:
+			need_reply = false;
+			__child_cancel_synth_list();
+			if (NULL != g_child_pefuncs.cancel_synth)
+				g_child_pefuncs.cancel_synth();
+			break;
+
+		case HOST_MSG_FOREACH_SETTINGS:
+			if (NULL != g_child_pefuncs.foreach_engine_setting)
+				reply.ret = g_child_pefuncs.foreach_engine_setting(__child_setting_cb, NULL);
+			break;
+
+		case HOST_MSG_SET_SETTING:
+			if (NULL != g_child_pefuncs.set_engine_setting && NULL != s1 && NULL != s2)
+				reply.ret = g_child_pefuncs.set_engine_setting(s1, s2);
+			break;
+
+		case HOST_MSG_UNLOAD:
+			__child_wait_synth();
+			is_running = false;
+			reply.ret = 0;
+			break;
+		}
+
+		g_free(payload);
+
+		if (true == need_reply && 0 != __host_send(control_fd, &reply, NULL, NULL))
+			break;
+	}
+
+	__child_stop_worker();
+	unload_engine();
+	_exit(0);
+}
+
+/*
+* Daemon side
+*/
+
+static int __host_get_timeout()
+{
+	return ttsd_config_get_int_option(TTSD_CONFIG_ENGINE_HOST_TIMEOUT, HOST_TIMEOUT_DEFAULT);
+}
+
+static void __host_event_cb(void* data)
+{
+	host_event_s* event = (host_event_s*)data;
+	ttsd_engine_host_h host = g_hosts[event->slot];
+
+	/* event of old host process */
+	if (NULL == host || host->generation != event->generation) {
+		g_free(event);
+		return;
+	}
+
+	if (HOST_MSG_EXIT == event->msg.type) {
+		/* host process is stopped on purpose */
+		if (0 >= host->pid) {
+			g_free(event);
+			return;
+		}
+
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Engine process is gone : pid(%d)", host->pid);
+		__host_restart(host, true);
+	} else if (HOST_MSG_RESULT == event->msg.type) {
+		ttsp_result_event_e result = (ttsp_result_event_e)event->msg.arg[0];
+		void* user_data = (void*)(uintptr_t)event->msg.user_data;
+		const void* audio = NULL;
+
+		/* audio is read in place */
+		if (0 < event->msg.size)
+			audio = host->ring->data + event->msg.start % HOST_RING_SIZE;
+
+		if (TTSP_RESULT_EVENT_FINISH == result || TTSP_RESULT_EVENT_CANCEL == result || TTSP_RESULT_EVENT_FAIL == result)
+			host->requests = g_list_remove(host->requests, user_data);
+
+		if (NULL != host->result_cb)
+			host->result_cb(result, audio, event->msg.size, user_data);
+
+		/* host may be closed in the callback */
+		if (0 < event->msg.size && host == g_hosts[event->slot] && host->generation == event->generation)
+			__atomic_store_n(&host->ring->tail, event->msg.start + event->msg.size, __ATOMIC_RELEASE);
+	}
+
+	g_free(event);
+}
+
+static void* __host_reader_thread(void* data)
+{
+	host_reader_s* reader = (host_reader_s*)data;
+
+	while (true) {
+		host_event_s* event = (host_event_s*)g_malloc0(sizeof(host_event_s));
+		char* payload = NULL;
+
+		if (0 != __host_recv(reader->fd, &event->msg, &payload, -1))
+			event->msg.type = HOST_MSG_EXIT;
+
+		g_free(payload);
+
+		event->slot = reader->host->slot;
+		event->generation = reader->generation;
+
+		int type = event->msg.type;
+		ecore_main_loop_thread_safe_call_async(__host_event_cb, event);
+
+		if (HOST_MSG_EXIT == type)
+			break;
+	}
+
+	g_free(reader);
+
+	return NULL;
+}
+
+static Eina_Bool __host_reap_timer_cb(void* data)
+{
+	long long now = ttsd_stats_get_time();
+
+	GList* iter = g_list_first(g_dying_list);
+	while (NULL != iter) {
+		host_dying_s* dying = (host_dying_s*)iter->data;
+		GList* next = g_list_next(iter);
+
+		pid_t ret = waitpid(dying->pid, NULL, WNOHANG);
+		if (0 != ret) {
+			/* reaped, or it is not a child any more */
+			g_dying_list = g_list_delete_link(g_dying_list, iter);
+			g_free(dying);
+		} else if (false == dying->is_killed && now >= dying->kill_time) {
+			SLOG(LOG_WARN, TAG_TTSD, "[Engine Host WARNING] Engine process does not exit : pid(%d)", dying->pid);
+			kill(dying->pid, SIGKILL);
+			dying->is_killed = true;
+		}
+
+		iter = next;
+	}
+
+	if (NULL != g_dying_list)
+		return EINA_TRUE;
+
+	g_reap_timer = NULL;
+	return EINA_FALSE;
+}
+
+static void __host_add_dying_cb(void* data)
+{
+	g_dying_list = g_list_append(g_dying_list, data);
+
+	if (NULL == g_reap_timer)
+		g_reap_timer = ecore_timer_add(HOST_REAP_INTERVAL, __host_reap_timer_cb, NULL);
+}
+
+/* Host process is reaped in main loop, stop does not wait for it */
+static void __host_stop(ttsd_engine_host_h host, bool is_graceful)
+{
+	if (0 >= host->pid)
+		return;
+
+	host_dying_s* dying = (host_dying_s*)g_malloc0(sizeof(host_dying_s));
+	dying->pid = host->pid;
+	dying->kill_time = ttsd_stats_get_time();
+
+	if (true == is_graceful) {
+		host_msg_s msg;
+		memset(&msg, 0, sizeof(host_msg_s));
+		msg.type = HOST_MSG_UNLOAD;
+
+		/* host process exits after unloading engine */
+		if (0 == __host_send(host->control_fd, &msg, NULL, NULL))
+			dying->kill_time += HOST_STOP_TIMEOUT;
+	}
+
+	if (dying->kill_time <= ttsd_stats_get_time()) {
+		kill(host->pid, SIGKILL);
+		dying->is_killed = true;
+	}
+
+	/* stop may be called in loading thread */
+	ecore_main_loop_thread_safe_call_async(__host_add_dying_cb, dying);
+
+	/* reader thread gets end of stream */
+	shutdown(host->control_fd, SHUT_RDWR);
+	shutdown(host->event_fd, SHUT_RDWR);
+
+	if (true == host->is_reading) {
+		pthread_join(host->reader, NULL);
+		host->is_reading = false;
+	}
+
+	close(host->control_fd);
+	close(host->event_fd);
+
+	host->pid = -1;
+	host->control_fd = -1;
+	host->event_fd = -1;
+}
+
+static int __host_spawn(ttsd_engine_host_h host)
+{
+	int control[2];
+	int event[2];
+
+	host->generation = __sync_add_and_fetch(&g_generation, 1);
+
+	/* only fds given in arguments are left open in host process */
+	if (0 != socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, control)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Fail to make socket : %s", strerror(errno));
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	if (0 != socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, event)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Fail to make socket : %s", strerror(errno));
+		close(control[0]);
+		close(control[1]);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	host->ring->head = 0;
+	host->ring->tail = 0;
+
+	/* arguments are made before fork, child of threaded daemon only calls async-signal-safe functions until exec */
+	char* control_arg = g_strdup_printf("%d", control[1]);
+	char* event_arg = g_strdup_printf("%d", event[1]);
+	char* ring_arg = g_strdup_printf("%d", host->ring_fd);
+	char* argv[] = {(char*)"tts-daemon", (char*)HOST_ARGUMENT, host->engine_path, control_arg, event_arg, ring_arg, NULL};
+
+	/* parent death signal is sent when forking thread exits, so it is used only from main thread */
+	bool is_main_thread = (getpid() == (pid_t)syscall(SYS_gettid));
+
+	pid_t pid = fork();
+	if (0 == pid) {
+		if (true == is_main_thread)
+			prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+		fcntl(control[1], F_SETFD, 0);
+		fcntl(event[1], F_SETFD, 0);
+		fcntl(host->ring_fd, F_SETFD, 0);
+
+		execv("/proc/self/exe", argv);
+		_exit(127);
+	}
+
+	g_free(control_arg);
+	g_free(event_arg);
+	g_free(ring_arg);
+
+	close(control[1]);
+	close(event[1]);
+
+	if (0 > pid) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Fail to fork : %s", strerror(errno));
+		close(control[0]);
+		close(event[0]);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	host->pid = pid;
+	host->control_fd = control[0];
+	host->event_fd = event[0];
+
+	host_msg_s hello;
+	char* payload = NULL;
+	if (0 != __host_recv(host->control_fd, &hello, &payload, __host_get_timeout()) || HOST_MSG_HELLO != hello.type || 0 != hello.ret) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Fail to load engine in host process : %s", host->engine_path);
+		g_free(payload);
+		__host_stop(host, false);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+	g_free(payload);
+
+	host->version = hello.arg[0];
+	host->capability = hello.arg[2];
+	host->funcs = hello.funcs;
+
+	host_reader_s* reader = (host_reader_s*)g_malloc0(sizeof(host_reader_s));
+	reader->host = host;
+	reader->fd = host->event_fd;
+	reader->generation = host->generation;
+
+	if (0 != pthread_create(&host->reader, NULL, __host_reader_thread, reader)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Fail to create reader thread");
+		g_free(reader);
+		__host_stop(host, false);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+	host->is_reading = true;
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Host] Engine process is started : pid(%d), engine(%s), version(%d)", host->pid, host->engine_path, host->version);
+
+	return 0;
+}
+
+/* Call engine in host process. Host process which does not reply in time is restarted. */
+static int __host_call(ttsd_engine_host_h host, host_msg_s* msg, const char* s1, const char* s2,
+		       host_item_cb item_cb, void* user_data, host_msg_s* reply, bool can_restart)
+{
+	if (0 >= host->pid)
+		return TTSP_ERROR_INVALID_STATE;
+
+	if (0 == __host_send(host->control_fd, msg, s1, s2)) {
+		while (true) {
+			char* payload = NULL;
+			if (0 != __host_recv(host->control_fd, reply, &payload, __host_get_timeout()))
+				break;
+
+			if (HOST_MSG_ITEM == reply->type) {
+				const char* item1 = NULL;
+				const char* item2 = NULL;
+				__host_get_strings(reply, payload, &item1, &item2);
+
+				if (NULL != item_cb)
+					item_cb(reply, item1, item2, user_data);
+
+				g_free(payload);
+				continue;
+			}
+
+			g_free(payload);
+			return 0;
+		}
+	}
+
+	SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Engine process does not respond : pid(%d), request(%d)", host->pid, msg->type);
+
+	if (true == can_restart)
+		__host_restart(host, true);
+	else
+		__host_stop(host, false);
+
+	return TTSP_ERROR_OPERATION_FAILED;
+}
+
+/* Send request which is not answered. Its result comes by event socket and is delivered by reader thread. */
+static int __host_post(ttsd_engine_host_h host, host_msg_s* msg, const char* s1, const char* s2)
+{
+	if (0 >= host->pid)
+		return TTSP_ERROR_INVALID_STATE;
+
+	if (0 != __host_send(host->control_fd, msg, s1, s2)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Fail to send request to engine process : pid(%d), request(%d)", host->pid, msg->type);
+		__host_restart(host, true);
+		return TTSP_ERROR_OPERATION_FAILED;
+	}
+
+	return 0;
+}
+
+/* Synthesis of crashed process is failed, and engine is loaded again in new process */
+static void __host_restart(ttsd_engine_host_h host, bool is_crash)
+{
+	__host_stop(host, false);
+
+	ttsd_stats_increase(TTSD_STATS_ENGINE_RESTART);
+
+	long long now = ttsd_stats_get_time();
+	if (now - host->restart_time > HOST_RESTART_PERIOD) {
+		host->restart_time = now;
+		host->restart_count = 0;
+	}
+
+	if (true == is_crash && HOST_RESTART_MAX <= host->restart_count++) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Engine process crashes repeatedly, it is not restarted");
+	} else if (0 != __host_spawn(host)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Fail to restart engine process");
+	} else if (NULL != host->result_cb) {
+		host_msg_s msg;
+		host_msg_s reply;
+		memset(&msg, 0, sizeof(host_msg_s));
+		msg.type = HOST_MSG_INITIALIZE;
+
+		if (0 != __host_call(host, &msg, NULL, NULL, NULL, NULL, &reply, false) || 0 != reply.ret) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Fail to initialize restarted engine");
+			__host_stop(host, false);
+		} else {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Host] Engine process is restarted : pid(%d)", host->pid);
+		}
+	}
+
+	/* results are delivered in main loop, not in the call which finds the crash */
+	GList* iter = g_list_first(host->requests);
+	while (NULL != iter) {
+		host_event_s* event = (host_event_s*)g_malloc0(sizeof(host_event_s));
+		event->slot = host->slot;
+		event->generation = host->generation;
+		event->msg.type = HOST_MSG_RESULT;
+		event->msg.arg[0] = TTSP_RESULT_EVENT_FAIL;
+		event->msg.user_data = (unsigned long long)(uintptr_t)iter->data;
+
+		ecore_main_loop_thread_safe_call_async(__host_event_cb, event);
+		iter = g_list_next(iter);
+	}
+
+	g_list_free(host->requests);
+	host->requests = NULL;
+}
+
+/*
+* Engine functions of host. Each slot has its own functions, because engine functions have no handle.
+*/
+
+static int __host_initialize(int slot, ttspe_result_cb callback)
+{
+	ttsd_engine_host_h host = g_hosts[slot];
+	if (NULL == host)
+		return TTSP_ERROR_INVALID_STATE;
+
+	host_msg_s msg;
+	host_msg_s reply;
+	memset(&msg, 0, sizeof(host_msg_s));
+	msg.type = HOST_MSG_INITIALIZE;
+
+	int ret = __host_call(host, &msg, NULL, NULL, NULL, NULL, &reply, true);
+	if (0 != ret)
+		return ret;
+
+	if (0 == reply.ret)
+		host->result_cb = callback;
+
+	return reply.ret;
+}
+
+static int __host_deinitialize(int slot)
+{
+	ttsd_engine_host_h host = g_hosts[slot];
+	if (NULL == host)
+		return TTSP_ERROR_INVALID_STATE;
+
+	host_msg_s msg;
+	host_msg_s reply;
+	memset(&msg, 0, sizeof(host_msg_s));
+	msg.type = HOST_MSG_DEINITIALIZE;
+
+	host->result_cb = NULL;
+
+	int ret = __host_call(host, &msg, NULL, NULL, NULL, NULL, &reply, false);
+	if (0 != ret)
+		return ret;
+
+	return reply.ret;
+}
+
+typedef struct {
+	ttspe_supported_voice_cb	voice_cb;
+	ttspe_engine_setting_cb		setting_cb;
+	void*				user_data;
+	bool				is_stopped;
+} host_foreach_s;
+
+static void __host_voice_item_cb(const host_msg_s* msg, const char* s1, const char* s2, void* user_data)
+{
+	host_foreach_s* foreach = (host_foreach_s*)user_data;
+
+	if (false == foreach->is_stopped && NULL != s1)
+		foreach->is_stopped = !foreach->voice_cb(s1, (ttsp_voice_type_e)msg->arg[0], foreach->user_data);
+}
+
+static void __host_setting_item_cb(const host_msg_s* msg, const char* s1, const char* s2, void* user_data)
+{
+	host_foreach_s* foreach = (host_foreach_s*)user_data;
+
+	if (false == foreach->is_stopped && NULL != s1 && NULL != s2)
+		foreach->is_stopped = !foreach->setting_cb(s1, s2, foreach->user_data);
+}
+
+static int __host_foreach_voices(int slot, ttspe_supported_voice_cb callback, void* user_data)
+{
+	ttsd_engine_host_h host = g_hosts[slot];
+	if (NULL == host)
+		return TTSP_ERROR_INVALID_STATE;
+
+	host_foreach_s foreach = {callback, NULL, user_data, false};
+	host_msg_s msg;
+	host_msg_s reply;
+	memset(&msg, 0, sizeof(host_msg_s));
+	msg.type = HOST_MSG_FOREACH_VOICES;
+
+	int ret = __host_call(host, &msg, NULL, NULL, __host_voice_item_cb, &foreach, &reply, true);
+	if (0 != ret)
+		return ret;
+
+	return reply.ret;
+}
+
+static bool __host_is_valid_voice(int slot, const char* language, ttsp_voice_type_e type)
+{
+	ttsd_engine_host_h host = g_hosts[slot];
+	if (NULL == host || NULL == language)
+		return false;
+
+	host_msg_s msg;
+	host_msg_s reply;
+	memset(&msg, 0, sizeof(host_msg_s));
+	msg.type = HOST_MSG_IS_VALID_VOICE;
+	msg.arg[0] = (int)type;
+
+	if (0 != __host_call(host, &msg, language, NULL, NULL, NULL, &reply, true))
+		return false;
+
+	return (1 == reply.ret);
+}
+
+static int __host_get_audio_format(int slot, ttsp_audio_type_e* audio_type, int* rate, int* channel)
+{
+	ttsd_engine_host_h host = g_hosts[slot];
+	if (NULL == host)
+		return TTSP_ERROR_INVALID_STATE;
+
+	host_msg_s msg;
+	host_msg_s reply;
+	memset(&msg, 0, sizeof(host_msg_s));
+	msg.type = HOST_MSG_GET_AUDIO_FORMAT;
+
+	int ret = __host_call(host, &msg, NULL, NULL, NULL, NULL, &reply, true);
+	if (0 != ret)
+		return ret;
+
+	*audio_type = (ttsp_audio_type_e)reply.arg[0];
+	*rate = reply.arg[1];
+	*channel = reply.arg[2];
+
+	return reply.ret;
+}
+
+static int __host_start_synth(int slot, const char* language, ttsp_voice_type_e type, const char* text, ttsp_speed_e speed, void* user_data)
+{
+	ttsd_engine_host_h host = g_hosts[slot];
+	if (NULL == host || NULL == language || NULL == text)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	host_msg_s msg;
+	memset(&msg, 0, sizeof(host_msg_s));
+	msg.type = HOST_MSG_START_SYNTH;
+	msg.arg[0] = (int)type;
+	msg.arg[1] = (int)speed;
+	msg.user_data = (unsigned long long)(uintptr_t)user_data;
+
+	/* failure of engine comes as result */
+	int ret = __host_post(host, &msg, language, text);
+	if (0 != ret)
+		return ret;
+
+	host->requests = g_list_append(host->requests, user_data);
+
+	return 0;
+}
+
+static int __host_cancel_synth(int slot)
+{
+	ttsd_engine_host_h host = g_hosts[slot];
+	if (NULL == host)
+		return TTSP_ERROR_INVALID_STATE;
+
+	host_msg_s msg;
+	memset(&msg, 0, sizeof(host_msg_s));
+	msg.type = HOST_MSG_CANCEL_SYNTH;
+
+	/* cancel applies to all requests, late results of them are still delivered */
+	g_list_free(host->requests);
+	host->requests = NULL;
+
+	return __host_post(host, &msg, NULL, NULL);
+}
+
+static int __host_foreach_engine_setting(int slot, ttspe_engine_setting_cb callback, void* user_data)
+{
+	ttsd_engine_host_h host = g_hosts[slot];
+	if (NULL == host)
+		return TTSP_ERROR_INVALID_STATE;
+
+	host_foreach_s foreach = {NULL, callback, user_data, false};
+	host_msg_s msg;
+	host_msg_s reply;
+	memset(&msg, 0, sizeof(host_msg_s));
+	msg.type = HOST_MSG_FOREACH_SETTINGS;
+
+	int ret = __host_call(host, &msg, NULL, NULL, __host_setting_item_cb, &foreach, &reply, true);
+	if (0 != ret)
+		return ret;
+
+	return reply.ret;
+}
+
+static int __host_set_engine_setting(int slot, const char* key, const char* value)
+{
+	ttsd_engine_host_h host = g_hosts[slot];
+	if (NULL == host || NULL == key || NULL == value)
+		return TTSP_ERROR_INVALID_PARAMETER;
+
+	host_msg_s msg;
+	host_msg_s reply;
+	memset(&msg, 0, sizeof(host_msg_s));
+	msg.type = HOST_MSG_SET_SETTING;
+
+	int ret = __host_call(host, &msg, key, value, NULL, NULL, &reply, true);
+	if (0 != ret)
+		return ret;
+
+	return reply.ret;
+}
+
+#define HOST_FUNCS(n) \
+static int __host_initialize_##n(ttspe_result_cb callback) { return __host_initialize(n, callback); } \
+static int __host_deinitialize_##n(void) { return __host_deinitialize(n); } \
+static int __host_foreach_voices_##n(ttspe_supported_voice_cb callback, void* user_data) { return __host_foreach_voices(n, callback, user_data); } \
+static bool __host_is_valid_voice_##n(const char* language, ttsp_voice_type_e type) { return __host_is_valid_voice(n, language, type); } \
+static int __host_get_audio_format_##n(ttsp_audio_type_e* audio_type, int* rate, int* channel) { return __host_get_audio_format(n, audio_type, rate, channel); } \
+static int __host_start_synth_##n(const char* language, ttsp_voice_type_e type, const char* text, ttsp_speed_e speed, void* user_data) \
+	{ return __host_start_synth(n, language, type, text, speed, user_data); } \
+static int __host_cancel_synth_##n(void) { return __host_cancel_synth(n); } \
+static int __host_foreach_engine_setting_##n(ttspe_engine_setting_cb callback, void* user_data) { return __host_foreach_engine_setting(n, callback, user_data); } \
+static int __host_set_engine_setting_##n(const char* key, const char* value) { return __host_set_engine_setting(n, key, value); }
+
+/* engine in host process is used by functions of version 1 */
+#define HOST_FUNCS_TABLE(n) { TTSPE_FUNCS_V1_SIZE, TTSP_VERSION_1, __host_initialize_##n, __host_deinitialize_##n, \
+	__host_foreach_voices_##n, __host_is_valid_voice_##n, __host_get_audio_format_##n, \
+	__host_start_synth_##n, __host_cancel_synth_##n, __host_foreach_engine_setting_##n, __host_set_engine_setting_##n }
+
+HOST_FUNCS(0)
+HOST_FUNCS(1)
+HOST_FUNCS(2)
+HOST_FUNCS(3)
+
+static const ttspe_funcs_s g_host_funcs[HOST_MAX] = {
+	HOST_FUNCS_TABLE(0),
+	HOST_FUNCS_TABLE(1),
+	HOST_FUNCS_TABLE(2),
+	HOST_FUNCS_TABLE(3),
+};
+
+/*
+* Engine host interfaces
+*/
+
+bool ttsd_engine_host_is_enabled()
+{
+	return (0 != ttsd_config_get_int_option(TTSD_CONFIG_ENGINE_HOST, 0));
+}
+
+int ttsd_engine_host_open(const char* engine_path, ttspe_funcs_s* pefuncs, int* capability, ttsd_engine_host_h* host)
+{
+	if (NULL == engine_path || NULL == pefuncs || NULL == capability || NULL == host) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Invalid parameter");
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	/* engine may be loaded in thread */
+	pthread_mutex_lock(&g_host_mutex);
+
+	int slot;
+	for (slot = 0; slot < HOST_MAX; slot++) {
+		if (NULL == g_hosts[slot])
+			break;
+	}
+
+	if (HOST_MAX <= slot) {
+		pthread_mutex_unlock(&g_host_mutex);
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Too many engine processes");
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	ttsd_engine_host_h temp = (ttsd_engine_host_h)g_malloc0(sizeof(struct _ttsd_engine_host_s));
+	temp->slot = slot;
+	temp->pid = -1;
+	temp->control_fd = -1;
+	temp->event_fd = -1;
+	temp->ring_fd = -1;
+	g_hosts[slot] = temp;
+
+	pthread_mutex_unlock(&g_host_mutex);
+
+	temp->engine_path = g_strdup(engine_path);
+
+	/* ring is mapped again by host process after exec */
+	temp->ring = (host_ring_s*)MAP_FAILED;
+	temp->ring_fd = memfd_create("ttsd-engine-ring", MFD_CLOEXEC);
+	if (0 <= temp->ring_fd && 0 == ftruncate(temp->ring_fd, sizeof(host_ring_s)))
+		temp->ring = (host_ring_s*)mmap(NULL, sizeof(host_ring_s), PROT_READ | PROT_WRITE, MAP_SHARED, temp->ring_fd, 0);
+
+	if (MAP_FAILED == temp->ring || 0 != __host_spawn(temp)) {
+		if (MAP_FAILED == temp->ring)
+			SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Fail to make ring : %s", strerror(errno));
+		else
+			munmap(temp->ring, sizeof(host_ring_s));
+
+		if (0 <= temp->ring_fd)
+			close(temp->ring_fd);
+
+		g_free(temp->engine_path);
+		g_free(temp);
+
+		pthread_mutex_lock(&g_host_mutex);
+		g_hosts[slot] = NULL;
+		pthread_mutex_unlock(&g_host_mutex);
+
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	*pefuncs = g_host_funcs[slot];
+
+	/* functions which engine does not have */
+	if (0 == (temp->funcs & (1 << HOST_MSG_INITIALIZE)))		pefuncs->initialize = NULL;
+	if (0 == (temp->funcs & (1 << HOST_MSG_DEINITIALIZE)))		pefuncs->deinitialize = NULL;
+	if (0 == (temp->funcs & (1 << HOST_MSG_FOREACH_VOICES)))	pefuncs->foreach_voices = NULL;
+	if (0 == (temp->funcs & (1 << HOST_MSG_IS_VALID_VOICE)))	pefuncs->is_valid_voice = NULL;
+	if (0 == (temp->funcs & (1 << HOST_MSG_GET_AUDIO_FORMAT)))	pefuncs->get_audio_format = NULL;
+	if (0 == (temp->funcs & (1 << HOST_MSG_START_SYNTH)))		pefuncs->start_synth = NULL;
+	if (0 == (temp->funcs & (1 << HOST_MSG_CANCEL_SYNTH)))		pefuncs->cancel_synth = NULL;
+	if (0 == (temp->funcs & (1 << HOST_MSG_FOREACH_SETTINGS)))	pefuncs->foreach_engine_setting = NULL;
+	if (0 == (temp->funcs & (1 << HOST_MSG_SET_SETTING)))		pefuncs->set_engine_setting = NULL;
+
+	*capability = temp->capability;
+	*host = temp;
+
+	return 0;
+}
+
+int ttsd_engine_host_close(ttsd_engine_host_h host)
+{
+	if (NULL == host) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Invalid parameter");
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Engine Host] Stop engine process : pid(%d)", host->pid);
+
+	__host_stop(host, true);
+
+	pthread_mutex_lock(&g_host_mutex);
+	g_hosts[host->slot] = NULL;
+	pthread_mutex_unlock(&g_host_mutex);
+
+	/* events which are not handled yet are dropped, ring is not read any more */
+	munmap(host->ring, sizeof(host_ring_s));
+	close(host->ring_fd);
+	g_list_free(host->requests);
+	g_free(host->engine_path);
+	g_free(host);
+
+	return 0;
+}
+
+bool ttsd_engine_host_is_host_process(int argc, char** argv)
+{
+	return (6 == argc && 0 == strcmp(argv[1], HOST_ARGUMENT));
+}
+
+int ttsd_engine_host_main(int argc, char** argv)
+{
+	if (false == ttsd_engine_host_is_host_process(argc, argv))
+		return EXIT_FAILURE;
+
+	const char* engine_path = argv[2];
+	int control_fd = atoi(argv[3]);
+	int event_fd = atoi(argv[4]);
+	int ring_fd = atoi(argv[5]);
+
+	/* engine does not touch sockets and files of daemon */
+	long fd_max = sysconf(_SC_OPEN_MAX);
+	int fd;
+	for (fd = 3; fd < fd_max; fd++) {
+		if (fd != control_fd && fd != event_fd && fd != ring_fd)
+			close(fd);
+	}
+
+	host_ring_s* ring = (host_ring_s*)mmap(NULL, sizeof(host_ring_s), PROT_READ | PROT_WRITE, MAP_SHARED, ring_fd, 0);
+	close(ring_fd);
+
+	if (MAP_FAILED == ring) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Engine Host ERROR] Fail to map ring : %s", strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	__child_main(engine_path, control_fd, event_fd, ring);
+
+	return 0;
+}
@@ -0,0 +1,50 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#ifndef __TTSD_ENGINE_HOST_H_
+#define __TTSD_ENGINE_HOST_H_
+
+#include <stdbool.h>
+#include "ttsp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Handle of engine running in host process */
+typedef struct _ttsd_engine_host_s* ttsd_engine_host_h;
+
+/** Check whether engines are loaded in host process instead of daemon */
+bool ttsd_engine_host_is_enabled();
+
+/**
+* Start host process which loads engine, and fill engine functions which call the host process.
+* Result callback of engine is called in main loop. Crashed host process is started again.
+*/
+int ttsd_engine_host_open(const char* engine_path, ttspe_funcs_s* pefuncs, int* capability, ttsd_engine_host_h* host);
+
+/** Unload engine and stop host process */
+int ttsd_engine_host_close(ttsd_engine_host_h host);
+
+/** Check whether the daemon binary is executed as host process */
+bool ttsd_engine_host_is_host_process(int argc, char** argv);
+
+/** Main of host process, it loads engine and serves requests of daemon */
+int ttsd_engine_host_main(int argc, char** argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TTSD_ENGINE_HOST_H_ */
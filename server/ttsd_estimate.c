@@ -0,0 +1,122 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#include "ttsd_main.h"
+#include "ttsd_engine_agent.h"
+#include "ttsd_estimate.h"
+
+#define ESTIMATE_MSEC_PER_CHAR_DEFAULT	100.0	/* rough audio length of a character */
+#define ESTIMATE_RTF_DEFAULT		1.0
+#define ESTIMATE_WEIGHT			0.2	/* weight of last text in learned values */
+
+typedef struct {
+	char*	lang;
+	int	vctype;
+	int	speed;
+	double	msec_per_char;	/* msec of audio for a character */
+	double	rtf;		/* synthesis time per audio duration */
+	int	count;		/* texts learned */
+} estimate_s;
+
+/* values of each voice and speed */
+static GList* g_estimate_list = NULL;
+
+/* values of all voices, used for voice which is not learned yet */
+static estimate_s g_total = {NULL, 0, 0, ESTIMATE_MSEC_PER_CHAR_DEFAULT, ESTIMATE_RTF_DEFAULT, 0};
+
+
+static estimate_s* __estimate_find(const char* lang, int vctype, int speed)
+{
+	GList* iter = NULL;
+	for (iter = g_list_first(g_estimate_list); NULL != iter; iter = g_list_next(iter)) {
+		estimate_s* estimate = (estimate_s*)iter->data;
+		if (estimate->vctype == vctype && estimate->speed == speed && 0 == strcmp(estimate->lang, lang))
+			return estimate;
+	}
+
+	return NULL;
+}
+
+static void __estimate_learn(estimate_s* estimate, double msec_per_char, double rtf)
+{
+	/* first text replaces default values */
+	double weight = (0 == estimate->count) ? 1.0 : ESTIMATE_WEIGHT;
+
+	estimate->msec_per_char = estimate->msec_per_char * (1 - weight) + msec_per_char * weight;
+	estimate->rtf = estimate->rtf * (1 - weight) + rtf * weight;
+	estimate->count++;
+}
+
+int ttsd_estimate_cost(const char* lang, int vctype, int speed, const char* text, int* synth_msec, int* audio_msec)
+{
+	if (NULL == lang || NULL == text || NULL == synth_msec || NULL == audio_msec)
+		return TTSD_ERROR_INVALID_PARAMETER;
+
+	if (0 == ttsd_engine_estimate_cost(lang, vctype, text, speed, synth_msec, audio_msec))
+		return 0;
+
+	const estimate_s* estimate = __estimate_find(lang, vctype, speed);
+	if (NULL == estimate)
+		estimate = &g_total;
+
+	double audio = (double)g_utf8_strlen(text, -1) * estimate->msec_per_char;
+
+	*audio_msec = (int)audio;
+	*synth_msec = (int)(audio * estimate->rtf);
+
+	return 0;
+}
+
+int ttsd_estimate_update(const char* lang, int vctype, int speed, const char* text, long long synth_msec, long long audio_msec)
+{
+	if (NULL == lang || NULL == text || 0 > synth_msec || 0 >= audio_msec)
+		return TTSD_ERROR_INVALID_PARAMETER;
+
+	long chars = g_utf8_strlen(text, -1);
+	if (0 >= chars)
+		return TTSD_ERROR_INVALID_PARAMETER;
+
+	double msec_per_char = (double)audio_msec / chars;
+	double rtf = (double)synth_msec / audio_msec;
+
+	estimate_s* estimate = __estimate_find(lang, vctype, speed);
+	if (NULL == estimate) {
+		estimate = (estimate_s*)g_malloc0(sizeof(estimate_s));
+		estimate->lang = g_strdup(lang);
+		estimate->vctype = vctype;
+		estimate->speed = speed;
+		g_estimate_list = g_list_append(g_estimate_list, estimate);
+	}
+
+	__estimate_learn(estimate, msec_per_char, rtf);
+	__estimate_learn(&g_total, msec_per_char, rtf);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Estimate] %s(%d) speed(%d) : text(%.1f msec/char, rtf %.3f), average(%.1f msec/char, rtf %.3f)",
+		lang, vctype, speed, msec_per_char, rtf, estimate->msec_per_char, estimate->rtf);
+
+	return 0;
+}
+
+void ttsd_estimate_finalize()
+{
+	GList* iter = NULL;
+	for (iter = g_list_first(g_estimate_list); NULL != iter; iter = g_list_next(iter)) {
+		estimate_s* estimate = (estimate_s*)iter->data;
+		g_free(estimate->lang);
+		g_free(estimate);
+	}
+
+	g_list_free(g_estimate_list);
+	g_estimate_list = NULL;
+}
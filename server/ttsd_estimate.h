@@ -0,0 +1,42 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#ifndef __TTSD_ESTIMATE_H_
+#define __TTSD_ESTIMATE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+* Cost Estimation Interfaces
+*
+* Time to synthesize a text and duration of its audio are estimated by engine if it can.
+* Otherwise they are estimated by audio per character and real time factor learned from previous texts of the voice.
+*/
+
+/** Estimate synthesis time and audio duration of text in msec */
+int ttsd_estimate_cost(const char* lang, int vctype, int speed, const char* text, int* synth_msec, int* audio_msec);
+
+/** Learn from a text whose synthesis is finished */
+int ttsd_estimate_update(const char* lang, int vctype, int speed, const char* text, long long synth_msec, long long audio_msec);
+
+/** Release learned values */
+void ttsd_estimate_finalize();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TTSD_ESTIMATE_H_ */
@@ -0,0 +1,507 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#include "ttsd_main.h"
+#include "ttsd_config.h"
+#include "ttsd_fragment.h"
+
+#define FRAGMENT_PLACEHOLDER		"%s"
+#define FRAGMENT_MAX_TEMPLATE		32	/* per client */
+
+#define FRAGMENT_DEFAULT_CROSSFADE	10	/* msec */
+#define FRAGMENT_DEFAULT_PAUSE		40	/* msec of silence kept at each side of a boundary */
+#define FRAGMENT_DEFAULT_SILENCE_LEVEL	256
+
+typedef struct {
+	int	uid;
+	char*	text_template;
+
+	/* fixed texts around placeholders. The number of placeholders is literal_count - 1. */
+	char**	literals;
+	int	literal_count;
+} template_s;
+
+typedef struct {
+	char*	text;
+	bool	is_stable;
+} fragment_s;
+
+struct _ttsd_fragment_job_s {
+	GList*		fragments;
+	GList*		current;
+
+	/* spliced audio */
+	char*		audio;
+	unsigned int	audio_size;
+
+	/* audio of current fragment */
+	char*		frag_audio;
+	unsigned int	frag_size;
+
+	int		rate;
+	int		channels;
+	bool		is_valid;
+
+	int		crossfade;
+	int		pause;
+	int		silence_level;
+};
+
+/** Template list of all clients */
+static GList* g_template_list = NULL;
+
+
+static void __fragment_free_template(template_s* temp)
+{
+	g_free(temp->text_template);
+	g_strfreev(temp->literals);
+	g_free(temp);
+}
+
+static bool __fragment_is_blank(const char* text)
+{
+	while ('\0' != *text) {
+		if (!g_ascii_isspace(*text))
+			return false;
+		text++;
+	}
+	return true;
+}
+
+static void __fragment_add(ttsd_fragment_job_h job, const char* text, int size, bool is_stable)
+{
+	char* temp = g_strndup(text, size);
+	g_strstrip(temp);
+
+	if ('\0' == temp[0]) {
+		g_free(temp);
+		return;
+	}
+
+	fragment_s* fragment = (fragment_s*)g_malloc0(sizeof(fragment_s));
+	fragment->text = temp;
+	fragment->is_stable = is_stable;
+
+	job->fragments = g_list_append(job->fragments, fragment);
+}
+
+/* Match text with template and make fragments. Each variable part should not be empty. */
+static bool __fragment_match(const template_s* temp, const char* text, ttsd_fragment_job_h job)
+{
+	int last = temp->literal_count - 1;
+	const char* pos = text;
+	int i;
+
+	if (0 != strncmp(pos, temp->literals[0], strlen(temp->literals[0])))
+		return false;
+
+	pos += strlen(temp->literals[0]);
+
+	/* check the suffix first to fail fast */
+	int text_len = strlen(text);
+	int suffix_len = strlen(temp->literals[last]);
+	if (text_len - (pos - text) <= suffix_len || 0 != strcmp(text + text_len - suffix_len, temp->literals[last]))
+		return false;
+
+	const char* end = text + text_len - suffix_len;
+
+	__fragment_add(job, temp->literals[0], strlen(temp->literals[0]), true);
+
+	for (i = 1; i < last; i++) {
+		/* variable part takes at least one character */
+		const char* found = NULL;
+		if (pos + 1 < end)
+			found = strstr(pos + 1, temp->literals[i]);
+
+		if (NULL == found || found + strlen(temp->literals[i]) >= end)
+			return false;
+
+		__fragment_add(job, pos, found - pos, false);
+		__fragment_add(job, found, strlen(temp->literals[i]), true);
+
+		pos = found + strlen(temp->literals[i]);
+	}
+
+	__fragment_add(job, pos, end - pos, false);
+	__fragment_add(job, end, suffix_len, true);
+
+	return true;
+}
+
+static void __fragment_clear(ttsd_fragment_job_h job)
+{
+	GList *iter = NULL;
+	fragment_s* fragment = NULL;
+
+	iter = g_list_first(job->fragments);
+	while (NULL != iter) {
+		fragment = iter->data;
+
+		g_free(fragment->text);
+		g_free(fragment);
+
+		job->fragments = g_list_remove_link(job->fragments, iter);
+		iter = g_list_first(job->fragments);
+	}
+
+	job->fragments = NULL;
+	job->current = NULL;
+}
+
+/*
+* TTS Template Interfaces
+*/
+
+int ttsd_fragment_add_template(int uid, const char* text_template)
+{
+	if (NULL == text_template) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Fragment ERROR] Input parameter is NULL");
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	char** literals = g_strsplit(text_template, FRAGMENT_PLACEHOLDER, -1);
+	int count = g_strv_length(literals);
+
+	/* Template needs a variable part and a fixed text */
+	bool has_fixed_text = false;
+	int i;
+	for (i = 0; i < count; i++) {
+		if (false == __fragment_is_blank(literals[i]))
+			has_fixed_text = true;
+	}
+
+	if (count < 2 || false == has_fixed_text) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Fragment ERROR] Invalid template : %s", text_template);
+		g_strfreev(literals);
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	/* two placeholders without text between them can not be split */
+	for (i = 1; i < count - 1; i++) {
+		if ('\0' == literals[i][0]) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[Fragment ERROR] Placeholders should be separated : %s", text_template);
+			g_strfreev(literals);
+			return TTSD_ERROR_INVALID_PARAMETER;
+		}
+	}
+
+	GList *iter = NULL;
+	template_s* temp = NULL;
+	int client_count = 0;
+
+	iter = g_list_first(g_template_list);
+	while (NULL != iter) {
+		temp = iter->data;
+
+		if (uid == temp->uid) {
+			if (0 == strcmp(temp->text_template, text_template)) {
+				SLOG(LOG_DEBUG, TAG_TTSD, "[Fragment] Template is already added");
+				g_strfreev(literals);
+				return 0;
+			}
+			client_count++;
+		}
+
+		iter = g_list_next(iter);
+	}
+
+	if (FRAGMENT_MAX_TEMPLATE <= client_count) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Fragment ERROR] Too many templates : uid(%d)", uid);
+		g_strfreev(literals);
+		return TTSD_ERROR_OUT_OF_MEMORY;
+	}
+
+	temp = (template_s*)g_malloc0(sizeof(template_s));
+	temp->uid = uid;
+	temp->text_template = g_strdup(text_template);
+	temp->literals = literals;
+	temp->literal_count = count;
+
+	g_template_list = g_list_append(g_template_list, temp);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Fragment] Add template : uid(%d), template(%s)", uid, text_template);
+
+	return 0;
+}
+
+int ttsd_fragment_remove_templates(int uid)
+{
+	GList *iter = NULL;
+	GList *next = NULL;
+	template_s* temp = NULL;
+
+	iter = g_list_first(g_template_list);
+	while (NULL != iter) {
+		next = g_list_next(iter);
+		temp = iter->data;
+
+		if (uid == temp->uid) {
+			__fragment_free_template(temp);
+			g_template_list = g_list_delete_link(g_template_list, iter);
+		}
+
+		iter = next;
+	}
+
+	return 0;
+}
+
+bool ttsd_fragment_has_template(int uid)
+{
+	GList *iter = NULL;
+	template_s* temp = NULL;
+
+	iter = g_list_first(g_template_list);
+	while (NULL != iter) {
+		temp = iter->data;
+
+		if (uid == temp->uid)
+			return true;
+
+		iter = g_list_next(iter);
+	}
+
+	return false;
+}
+
+/*
+* TTS Fragment Job Interfaces
+*/
+
+ttsd_fragment_job_h ttsd_fragment_job_create(int uid, const char* text)
+{
+	if (NULL == text)
+		return NULL;
+
+	struct _ttsd_fragment_job_s* job = (struct _ttsd_fragment_job_s*)g_malloc0(sizeof(struct _ttsd_fragment_job_s));
+
+	GList *iter = NULL;
+	template_s* temp = NULL;
+
+	iter = g_list_first(g_template_list);
+	while (NULL != iter) {
+		temp = iter->data;
+
+		if (uid == temp->uid) {
+			if (true == __fragment_match(temp, text, job))
+				break;
+
+			__fragment_clear(job);
+		}
+
+		iter = g_list_next(iter);
+	}
+
+	if (NULL == job->fragments) {
+		g_free(job);
+		return NULL;
+	}
+
+	job->is_valid = true;
+	job->crossfade = ttsd_config_get_int_option(TTSD_CONFIG_FRAGMENT_CROSSFADE, FRAGMENT_DEFAULT_CROSSFADE);
+	job->pause = ttsd_config_get_int_option(TTSD_CONFIG_FRAGMENT_PAUSE, FRAGMENT_DEFAULT_PAUSE);
+	job->silence_level = ttsd_config_get_int_option(TTSD_CONFIG_FRAGMENT_SILENCE_LEVEL, FRAGMENT_DEFAULT_SILENCE_LEVEL);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Fragment] Text is matched with template(%s) : %d fragments",
+		temp->text_template, g_list_length(job->fragments));
+
+	return job;
+}
+
+bool ttsd_fragment_job_next(ttsd_fragment_job_h job, const char** text, bool* is_stable)
+{
+	if (NULL == job || NULL == text || NULL == is_stable)
+		return false;
+
+	if (NULL == job->current)
+		job->current = g_list_first(job->fragments);
+	else
+		job->current = g_list_next(job->current);
+
+	if (NULL == job->current)
+		return false;
+
+	fragment_s* fragment = job->current->data;
+	*text = fragment->text;
+	*is_stable = fragment->is_stable;
+
+	return true;
+}
+
+int ttsd_fragment_job_append(ttsd_fragment_job_h job, const void* data, unsigned int data_size,
+			     ttsp_audio_type_e audio_type, int rate, int channels)
+{
+	if (NULL == job) {
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	if (0 == data_size || NULL == data) {
+		return 0;
+	}
+
+	if (TTSP_AUDIO_TYPE_RAW != audio_type || 0 >= channels ||
+	    (0 != job->rate && (job->rate != rate || job->channels != channels))) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Fragment ERROR] Audio can not be spliced : type(%d), rate(%d), channels(%d)",
+			audio_type, rate, channels);
+		job->is_valid = false;
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	job->rate = rate;
+	job->channels = channels;
+
+	job->frag_audio = (char*)g_realloc(job->frag_audio, job->frag_size + data_size);
+	memcpy(job->frag_audio + job->frag_size, data, data_size);
+	job->frag_size += data_size;
+
+	return 0;
+}
+
+static unsigned int __fragment_leading_silence(const short* samples, unsigned int frames, int channels, int level)
+{
+	unsigned int i;
+	int c;
+
+	for (i = 0; i < frames; i++) {
+		for (c = 0; c < channels; c++) {
+			if (abs(samples[i * channels + c]) > level)
+				return i;
+		}
+	}
+
+	return frames;
+}
+
+static unsigned int __fragment_trailing_silence(const short* samples, unsigned int frames, int channels, int level)
+{
+	unsigned int i;
+	int c;
+
+	for (i = frames; i > 0; i--) {
+		for (c = 0; c < channels; c++) {
+			if (abs(samples[(i - 1) * channels + c]) > level)
+				return frames - i;
+		}
+	}
+
+	return frames;
+}
+
+int ttsd_fragment_job_splice(ttsd_fragment_job_h job)
+{
+	if (NULL == job) {
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	if (false == job->is_valid) {
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	if (0 == job->frag_size) {
+		return 0;
+	}
+
+	if (NULL == job->audio) {
+		job->audio = job->frag_audio;
+		job->audio_size = job->frag_size;
+		job->frag_audio = NULL;
+		job->frag_size = 0;
+		return 0;
+	}
+
+	unsigned int frame_size = sizeof(short) * job->channels;
+	unsigned int out_frames = job->audio_size / frame_size;
+	unsigned int in_frames = job->frag_size / frame_size;
+	short* out = (short*)job->audio;
+	short* in = (short*)job->frag_audio;
+
+	/* cut silence at the boundary down to the pause */
+	unsigned int keep = job->rate * job->pause / 1000;
+
+	unsigned int trail = __fragment_trailing_silence(out, out_frames, job->channels, job->silence_level);
+	if (trail > keep)
+		out_frames -= trail - keep;
+
+	unsigned int lead = __fragment_leading_silence(in, in_frames, job->channels, job->silence_level);
+	if (lead > keep) {
+		in += (lead - keep) * job->channels;
+		in_frames -= lead - keep;
+	}
+
+	/* linear crossfade */
+	unsigned int overlap = job->rate * job->crossfade / 1000;
+	if (overlap > out_frames)	overlap = out_frames;
+	if (overlap > in_frames)	overlap = in_frames;
+
+	unsigned int i;
+	int c;
+	for (i = 0; i < overlap; i++) {
+		float weight = (float)(i + 1) / (float)(overlap + 1);
+		short* dst = out + (out_frames - overlap + i) * job->channels;
+
+		for (c = 0; c < job->channels; c++) {
+			dst[c] = (short)(dst[c] * (1.0f - weight) + in[i * job->channels + c] * weight);
+		}
+	}
+
+	unsigned int remain_size = (in_frames - overlap) * frame_size;
+	unsigned int out_size = out_frames * frame_size;
+
+	job->audio = (char*)g_realloc(job->audio, out_size + remain_size);
+	memcpy(job->audio + out_size, in + overlap * job->channels, remain_size);
+	job->audio_size = out_size + remain_size;
+
+	g_free(job->frag_audio);
+	job->frag_audio = NULL;
+	job->frag_size = 0;
+
+	return 0;
+}
+
+int ttsd_fragment_job_get_audio(ttsd_fragment_job_h job, void** data, unsigned int* data_size, int* rate, int* channels)
+{
+	if (NULL == job || NULL == data || NULL == data_size || NULL == rate || NULL == channels) {
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	if (false == job->is_valid || NULL == job->audio) {
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	*data = job->audio;
+	*data_size = job->audio_size;
+	*rate = job->rate;
+	*channels = job->channels;
+
+	job->audio = NULL;
+	job->audio_size = 0;
+
+	return 0;
+}
+
+void ttsd_fragment_job_destroy(ttsd_fragment_job_h job)
+{
+	if (NULL == job)
+		return;
+
+	__fragment_clear(job);
+
+	if (NULL != job->audio)
+		g_free(job->audio);
+
+	if (NULL != job->frag_audio)
+		g_free(job->frag_audio);
+
+	g_free(job);
+}
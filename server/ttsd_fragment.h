@@ -0,0 +1,67 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#ifndef __TTSD_FRAGMENT_H_
+#define __TTSD_FRAGMENT_H_
+
+#include <stdbool.h>
+#include "ttsp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Handle of a text synthesized by fragments of a template */
+typedef struct _ttsd_fragment_job_s* ttsd_fragment_job_h;
+
+/*
+* TTS Template Interfaces
+*/
+
+/** Add a template of client. "%s" in template marks a variable part. */
+int ttsd_fragment_add_template(int uid, const char* text_template);
+
+/** Remove all templates of client */
+int ttsd_fragment_remove_templates(int uid);
+
+/** Check whether client has templates */
+bool ttsd_fragment_has_template(int uid);
+
+/*
+* TTS Fragment Job Interfaces
+*/
+
+/** Split text by the templates of client. Returns NULL if no template matches. */
+ttsd_fragment_job_h ttsd_fragment_job_create(int uid, const char* text);
+
+/** Move to next fragment. Stable fragments are the fixed text of template and can be cached. */
+bool ttsd_fragment_job_next(ttsd_fragment_job_h job, const char** text, bool* is_stable);
+
+/** Append audio of current fragment. Only 16bit raw PCM can be spliced. */
+int ttsd_fragment_job_append(ttsd_fragment_job_h job, const void* data, unsigned int data_size,
+			     ttsp_audio_type_e audio_type, int rate, int channels);
+
+/** Splice audio of current fragment to the result at silence boundary */
+int ttsd_fragment_job_splice(ttsd_fragment_job_h job);
+
+/** Take the spliced audio. The data should be released by g_free(). */
+int ttsd_fragment_job_get_audio(ttsd_fragment_job_h job, void** data, unsigned int* data_size, int* rate, int* channels);
+
+void ttsd_fragment_job_destroy(ttsd_fragment_job_h job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TTSD_FRAGMENT_H_ */
@@ -16,14 +16,21 @@
 #include "ttsd_server.h"
 #include "ttsd_dbus.h"
 #include "ttsd_network.h"
+#include "ttsd_stats.h"
+#include "ttsd_estimate.h"
+#include "ttsd_engine_host.h"
 
 #include <Ecore.h>
 
 #define CLIENT_CLEAN_UP_TIME 500
 
 /* Main of TTS Daemon */
-int main()
+int main(int argc, char** argv)
 {
+	/* engine host process runs the same binary */
+	if (true == ttsd_engine_host_is_host_process(argc, argv))
+		return ttsd_engine_host_main(argc, argv);
+
 	SLOG(LOG_DEBUG, TAG_TTSD, "  ");
 	SLOG(LOG_DEBUG, TAG_TTSD, "  ");
 	SLOG(LOG_DEBUG, TAG_TTSD, "===== TTS DAEMON INITIALIZE");
@@ -59,6 +66,10 @@ int main()
 	printf("TTS-Daemon Start...\n");
 	
 	ecore_main_loop_begin();
+
+	ttsd_stats_finalize();
+
+	ttsd_estimate_finalize();
 	
 	ecore_shutdown();
 
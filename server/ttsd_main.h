@@ -56,6 +56,9 @@ typedef enum {
 	TTSD_ERROR_ENGINE_NOT_FOUND	= -0x0100023,	/**< No available TTS-engine  */
 	TTSD_ERROR_TIMED_OUT		= -0x0100024,	/**< No answer from TTS daemon */
 	TTSD_ERROR_OPERATION_FAILED	= -0x0100025,	/**< TTS daemon failed  */
+	TTSD_ERROR_UTTERANCE_EXPIRED	= -0x0100026,	/**< Text is dropped without synthesis, because it is stale */
+	TTSD_ERROR_SYNTHESIS_TIMED_OUT	= -0x0100027,	/**< Engine does not finish synthesis in time */
+	TTSD_ERROR_QUEUE_FULL		= -0x0100028,	/**< Estimated audio of queued texts is too long */
 }ttsd_error_e;
 
 
@@ -64,6 +67,13 @@ typedef enum {
 	TTSD_INTERRUPTED_STOPPED	/**< Current state change 'Ready' */
 }ttsd_interrupted_code_e;
 
+typedef enum {
+	TTSD_PRIORITY_LOW = 0,		/**< Background reading */
+	TTSD_PRIORITY_NORMAL,		/**< Default priority */
+	TTSD_PRIORITY_HIGH,		/**< Notification */
+	TTSD_PRIORITY_CRITICAL		/**< Alert, preempts all others */
+}ttsd_priority_e;
+
 
 typedef struct {
 	char* engine_id;
@@ -19,11 +19,19 @@
 
 bool g_is_connected;
 
+static ttsd_network_changed_cb g_changed_cb = NULL;
+
 bool ttsd_network_is_connected()
 {
 	return g_is_connected;
 }
 
+int ttsd_network_set_changed_cb(ttsd_network_changed_cb callback)
+{
+	g_changed_cb = callback;
+	return 0;
+}
+
 void __net_config_change_cb(keynode_t* node, void *data) 
 {
 	int network_configuration = 0;
@@ -36,10 +44,12 @@ void __net_config_change_cb(keynode_t* node, void *data)
 	} else {
 		SLOG(LOG_DEBUG, TAG_TTSD, "[Network] Notification : Network connection is ON ");
 		g_is_connected = true;
-
-		/* need to notify changing net to engine. */
 	}
 
+	/* engine agent fails over to local engine */
+	if (NULL != g_changed_cb)
+		g_changed_cb(g_is_connected);
+
 	return;
 }
 
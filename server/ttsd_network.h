@@ -19,12 +19,17 @@
 extern "C" {
 #endif
 
+/** Called when network connection is changed */
+typedef void (*ttsd_network_changed_cb)(bool is_connected);
+
 int ttsd_network_initialize();
 
 int ttsd_network_finalize();
 
 bool ttsd_network_is_connected();
 
+int ttsd_network_set_changed_cb(ttsd_network_changed_cb callback);
+
 
 #ifdef __cplusplus
 }
@@ -373,6 +373,10 @@ int ttsd_player_next_play(int uid)
 	if (0 == ttsd_data_get_sound_data_size(uid)) {
 		SLOG(LOG_WARN, TAG_TTSD, "[Player WARNING] A sound queue of current player(%d) is empty", uid); 
 		g_playing_info = NULL;
+
+		/* daemon may give player to other client */
+		if (NULL != g_result_callback)
+			g_result_callback(PLAYER_EMPTY_SOUND_QUEUE, uid, -1);
 		return -1;
 	}
 
@@ -993,7 +997,7 @@ int __set_and_start(player_s* player)
 	}
 
 	if( NULL != sound_file )	g_free(sound_file);
-	if( NULL != wdata.data )	g_free(wdata.data);
+	ttsd_data_release_sound_data(&wdata);
 
 	return 0;
 }
@@ -0,0 +1,174 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ttsd_main.h"
+#include "ttsd_resource.h"
+
+typedef struct {
+	char*		path;
+	dev_t		dev;
+	ino_t		ino;
+	time_t		mtime;		/* file replaced by update is mapped again */
+	void*		data;
+	unsigned int	size;
+	int		ref_count;
+} resource_s;
+
+/* engine may map in its own thread */
+static pthread_mutex_t g_resource_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static GList* g_resource_list = NULL;
+
+
+static resource_s* __find_resource(const struct stat* st)
+{
+	GList* iter = NULL;
+	for (iter = g_list_first(g_resource_list); NULL != iter; iter = g_list_next(iter)) {
+		resource_s* resource = (resource_s*)iter->data;
+		if (resource->dev == st->st_dev && resource->ino == st->st_ino 
+			&& resource->mtime == st->st_mtime && resource->size == (unsigned int)st->st_size)
+			return resource;
+	}
+
+	return NULL;
+}
+
+int ttsd_resource_map(const char* path, const void** data, unsigned int* size)
+{
+	if (NULL == path || NULL == data || NULL == size) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Resource ERROR] Invalid parameter");
+		return TTSP_ERROR_INVALID_PARAMETER;
+	}
+
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (0 > fd) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Resource ERROR] Fail to open %s : %s", path, strerror(errno));
+		return TTSP_ERROR_OPERATION_FAILED;
+	}
+
+	struct stat st;
+	if (0 != fstat(fd, &st) || !S_ISREG(st.st_mode) || 0 >= st.st_size || UINT_MAX < (unsigned long long)st.st_size) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Resource ERROR] Invalid resource file : %s", path);
+		close(fd);
+		return TTSP_ERROR_OPERATION_FAILED;
+	}
+
+	pthread_mutex_lock(&g_resource_mutex);
+
+	resource_s* resource = __find_resource(&st);
+	if (NULL != resource) {
+		resource->ref_count++;
+		*data = resource->data;
+		*size = resource->size;
+
+		pthread_mutex_unlock(&g_resource_mutex);
+		close(fd);
+
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Resource] Share %s : ref(%d)", path, resource->ref_count);
+		return TTSP_ERROR_NONE;
+	}
+
+	/* pages of the file are shared with page cache, nothing is read until engine touches them */
+	void* mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (MAP_FAILED == mapped) {
+		pthread_mutex_unlock(&g_resource_mutex);
+		SLOG(LOG_ERROR, TAG_TTSD, "[Resource ERROR] Fail to map %s : %s", path, strerror(errno));
+		return TTSP_ERROR_OPERATION_FAILED;
+	}
+
+	resource = (resource_s*)g_malloc0(sizeof(resource_s));
+	resource->path = g_strdup(path);
+	resource->dev = st.st_dev;
+	resource->ino = st.st_ino;
+	resource->mtime = st.st_mtime;
+	resource->data = mapped;
+	resource->size = (unsigned int)st.st_size;
+	resource->ref_count = 1;
+
+	g_resource_list = g_list_append(g_resource_list, resource);
+
+	*data = resource->data;
+	*size = resource->size;
+
+	pthread_mutex_unlock(&g_resource_mutex);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Resource] Map %s : size(%u)", path, resource->size);
+
+	return TTSP_ERROR_NONE;
+}
+
+void ttsd_resource_unmap(const void* data)
+{
+	if (NULL == data)
+		return;
+
+	pthread_mutex_lock(&g_resource_mutex);
+
+	GList* iter = NULL;
+	for (iter = g_list_first(g_resource_list); NULL != iter; iter = g_list_next(iter)) {
+		resource_s* resource = (resource_s*)iter->data;
+		if (resource->data != data)
+			continue;
+
+		resource->ref_count--;
+		if (0 < resource->ref_count) {
+			pthread_mutex_unlock(&g_resource_mutex);
+			return;
+		}
+
+		g_resource_list = g_list_delete_link(g_resource_list, iter);
+		pthread_mutex_unlock(&g_resource_mutex);
+
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Resource] Unmap %s", resource->path);
+
+		munmap(resource->data, resource->size);
+		g_free(resource->path);
+		g_free(resource);
+		return;
+	}
+
+	pthread_mutex_unlock(&g_resource_mutex);
+
+	SLOG(LOG_WARN, TAG_TTSD, "[Resource WARNING] Unknown resource is unmapped");
+}
+
+void ttsd_resource_get_usage(int* count, unsigned long long* size)
+{
+	int resource_count = 0;
+	unsigned long long total = 0;
+
+	pthread_mutex_lock(&g_resource_mutex);
+
+	GList* iter = NULL;
+	for (iter = g_list_first(g_resource_list); NULL != iter; iter = g_list_next(iter)) {
+		resource_s* resource = (resource_s*)iter->data;
+		resource_count++;
+		total += resource->size;
+	}
+
+	pthread_mutex_unlock(&g_resource_mutex);
+
+	if (NULL != count)	*count = resource_count;
+	if (NULL != size)	*size = total;
+}
@@ -0,0 +1,42 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#ifndef __TTSD_RESOURCE_H_
+#define __TTSD_RESOURCE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+* Shared Resource Interfaces
+*
+* Voice data files of engines are mapped read-only once and the same view is given to every engine,
+* so that engine instances and reloads share page cache instead of reading the data into private memory.
+*/
+
+/** Map file read-only or get the view which is already mapped, engine can call it in any thread */
+int ttsd_resource_map(const char* path, const void** data, unsigned int* size);
+
+/** Release a view, the file is unmapped when nobody uses it */
+void ttsd_resource_unmap(const void* data);
+
+/** Get count and total size of mapped files */
+void ttsd_resource_get_usage(int* count, unsigned long long* size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TTSD_RESOURCE_H_ */
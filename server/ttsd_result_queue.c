@@ -0,0 +1,192 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <Ecore.h>
+
+#include "ttsd_main.h"
+#include "ttsd_buffer.h"
+#include "ttsd_result_queue.h"
+
+/*
+* Single producer, single consumer list. Producer appends after head, and consumer moves tail.
+* The node at tail is already consumed, so producer and consumer never touch the same node.
+*/
+typedef struct _result_node_s {
+	struct _result_node_s*	next;
+	ttsp_result_event_e	event;
+	void*			data;		/* buffer of pool, or NULL */
+	unsigned int		data_size;
+	void*			user_data;
+} result_node_s;
+
+static result_node_s* g_head = NULL;		/* written only by producer */
+static result_node_s* g_tail = NULL;		/* written only by consumer */
+
+/* engine can call back from more than one thread, so producers take turns */
+static pthread_mutex_t g_producer_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int g_event_fd = -1;
+static Ecore_Fd_Handler* g_fd_handler = NULL;
+
+static pthread_t g_main_thread;
+
+static ttsd_result_queue_cb g_callback = NULL;
+
+
+/* Deliver all results which are queued. It runs in main thread. */
+static void __result_queue_deliver(bool is_dropped)
+{
+	while (1) {
+		result_node_s* next = __atomic_load_n(&g_tail->next, __ATOMIC_ACQUIRE);
+		if (NULL == next)
+			break;
+
+		/* previous tail is not used by producer any more */
+		g_free(g_tail);
+		g_tail = next;
+
+		/* node can be freed by flush in callback, so it is not used after callback */
+		void* data = next->data;
+		next->data = NULL;
+
+		if (false == is_dropped && NULL != g_callback)
+			g_callback(next->event, data, next->data_size, next->user_data);
+
+		/* buffer is released unless it is taken as sound data */
+		ttsd_buffer_return(data);
+	}
+}
+
+static Eina_Bool __result_queue_event_cb(void* data, Ecore_Fd_Handler* fd_handler)
+{
+	uint64_t count;
+	if (0 > read(g_event_fd, &count, sizeof(count))) {
+		if (EAGAIN != errno)
+			SLOG(LOG_WARN, TAG_TTSD, "[Result Queue WARNING] Fail to read event : %s", strerror(errno));
+	}
+
+	__result_queue_deliver(false);
+
+	return ECORE_CALLBACK_RENEW;
+}
+
+int ttsd_result_queue_initialize(ttsd_result_queue_cb callback)
+{
+	if (NULL == callback) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Result Queue ERROR] Invalid parameter");
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	if (NULL != g_fd_handler) {
+		g_callback = callback;
+		return 0;
+	}
+
+	g_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (0 > g_event_fd) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Result Queue ERROR] Fail to create eventfd : %s", strerror(errno));
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	g_fd_handler = ecore_main_fd_handler_add(g_event_fd, ECORE_FD_READ, (Ecore_Fd_Cb)__result_queue_event_cb, NULL, NULL, NULL);
+	if (NULL == g_fd_handler) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Result Queue ERROR] Fail to add fd handler");
+		close(g_event_fd);
+		g_event_fd = -1;
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	g_head = g_tail = (result_node_s*)g_malloc0(sizeof(result_node_s));
+	g_main_thread = pthread_self();
+	g_callback = callback;
+
+	return 0;
+}
+
+int ttsd_result_queue_finalize()
+{
+	if (NULL == g_fd_handler)
+		return 0;
+
+	ecore_main_fd_handler_del(g_fd_handler);
+	g_fd_handler = NULL;
+
+	__result_queue_deliver(true);
+
+	g_free(g_tail);
+	g_head = g_tail = NULL;
+
+	close(g_event_fd);
+	g_event_fd = -1;
+	g_callback = NULL;
+
+	return 0;
+}
+
+bool ttsd_result_queue_is_main_thread()
+{
+	if (NULL == g_fd_handler)
+		return true;
+
+	return pthread_equal(pthread_self(), g_main_thread);
+}
+
+int ttsd_result_queue_push(ttsp_result_event_e event, const void* data, unsigned int data_size, void* user_data)
+{
+	if (NULL == g_fd_handler)
+		return TTSD_ERROR_INVALID_STATE;
+
+	result_node_s* node = (result_node_s*)g_malloc0(sizeof(result_node_s));
+	node->event = event;
+	node->data_size = (NULL != data) ? data_size : 0;
+	node->user_data = user_data;
+
+	/* data of engine is valid only in callback, buffer of pool is handed over */
+	if (0 < node->data_size) {
+		if (true == ttsd_buffer_is_pooled(data)) {
+			node->data = (void*)data;
+		} else {
+			node->data = ttsd_buffer_alloc(data_size);
+			if (NULL == node->data) {
+				SLOG(LOG_ERROR, TAG_TTSD, "[Result Queue ERROR] Fail to allocate buffer");
+				g_free(node);
+				return TTSD_ERROR_OUT_OF_MEMORY;
+			}
+			memcpy(node->data, data, data_size);
+		}
+	}
+
+	pthread_mutex_lock(&g_producer_mutex);
+	__atomic_store_n(&g_head->next, node, __ATOMIC_RELEASE);
+	g_head = node;
+	pthread_mutex_unlock(&g_producer_mutex);
+
+	uint64_t count = 1;
+	if (0 > write(g_event_fd, &count, sizeof(count))) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Result Queue WARNING] Fail to signal main loop : %s", strerror(errno));
+	}
+
+	return 0;
+}
+
+void ttsd_result_queue_flush()
+{
+	if (NULL == g_fd_handler || false == ttsd_result_queue_is_main_thread())
+		return;
+
+	__result_queue_deliver(false);
+}
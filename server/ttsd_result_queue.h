@@ -0,0 +1,53 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#ifndef __TTSD_RESULT_QUEUE_H_
+#define __TTSD_RESULT_QUEUE_H_
+
+#include <stdbool.h>
+#include "ttsp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+* Result Queue Interfaces
+*
+* Engine can call result callback in its own thread. Results of other threads are queued without lock
+* for the main loop, and they are delivered in the main loop in the order of the engine.
+*/
+
+typedef void (*ttsd_result_queue_cb)(ttsp_result_event_e event, const void* data, unsigned int data_size, void* user_data);
+
+/** Initialize in main thread. Callback is called in main loop. */
+int ttsd_result_queue_initialize(ttsd_result_queue_cb callback);
+
+/** Release queue. Results which are not delivered are dropped. */
+int ttsd_result_queue_finalize();
+
+/** Check whether current thread is main thread */
+bool ttsd_result_queue_is_main_thread();
+
+/** Queue result of other thread. Data is kept in a buffer of pool until it is delivered. */
+int ttsd_result_queue_push(ttsp_result_event_e event, const void* data, unsigned int data_size, void* user_data);
+
+/** Deliver queued results now, in main thread. e.g. before cancel of synthesis is finished */
+void ttsd_result_queue_flush();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TTSD_RESULT_QUEUE_H_ */
@@ -12,6 +12,8 @@
 */
 
 #include <Ecore.h>
+#include <vconf.h>
+#include <signal.h>
 #include "ttsd_main.h"
 #include "ttsd_player.h"
 #include "ttsd_data.h"
@@ -22,79 +24,1210 @@
 #include "ttsd_dbus.h"
 #include "ttsd_config.h"
 #include "ttsd_network.h"
+#include "ttsd_cache.h"
+#include "ttsd_fragment.h"
+#include "ttsd_stats.h"
+#include "ttsd_buffer.h"
+#include "ttsd_estimate.h"
 
 
 typedef struct {
 	int uid;
 	int uttid;
+	ttsd_cache_record_h record;
+
+	/* text is kept to be requeued when synthesis is preempted */
+	speak_data_s sdata;
+	bool is_started;	/* first audio is added to sound queue */
+
+	unsigned int generation;	/* generation of client when synthesis starts */
+	long long cancel_time;		/* msec, when synthesis is canceled */
+
+	long long synth_time;		/* msec, when engine starts the text */
+	long long watchdog_time;	/* msec, engine is regarded as hung after it, 0 if not watched */
+	unsigned int audio_size;	/* bytes of audio from engine */
+
+	/* text synthesized by fragments of template */
+	ttsd_fragment_job_h job;
+	char* lang;
+	int vctype;
+	int speed;
+
+	/* result of text synthesized ahead, added to sound queue when texts before it are done */
+	GList* pending;		/* sound_data_s* */
+	bool is_done;
+	bool is_alone;		/* texts after it are not synthesized ahead */
+	bool is_batched;	/* started in batch after other texts, its own synthesis time is unknown */
 } utterance_t;
 
-/* If current engine exist */
-static bool	g_is_engine;
+/* If current engine exist */
+static bool	g_is_engine;
+
+/* If engine is running */
+static bool	g_is_synthesizing;
+
+/* If the daemon get the result */
+Ecore_Timer*	g_timer;
+static bool	g_is_next_synthesis;
+
+/* Utterance which engine is synthesizing. Results of other utterances are stale. */
+static utterance_t*	g_synth_utt = NULL;
+
+/* Utterances synthesized ahead of g_synth_utt by engine supporting concurrent synthesis, in order of text */
+static GList*	g_ahead_list = NULL;
+
+/* Idle engine is unloaded after timeout */
+#define ENGINE_IDLE_TIMEOUT_DEFAULT	60	/* sec */
+
+static Ecore_Timer*	g_idle_timer = NULL;
+
+/* Marker of warm-up synthesis, its result is dropped */
+static utterance_t	g_warm_up_utt;
+static bool		g_is_warming_up = false;
+static long long	g_warm_up_time = 0;
+
+/* New engine is loaded and waits for utterance boundary */
+static bool		g_is_engine_switching = false;
+
+/* Text stream of client, synthesized while client is still adding text */
+typedef struct {
+	int		uid;
+	int		utt_id;
+	GString*	text;		/* all text of stream, given again to engine after preemption */
+	gsize		pushed_len;	/* length of text given to engine */
+	bool		is_closed;	/* client adds no more text */
+	bool		is_engine_closed;
+	utterance_t*	utt;		/* utterance synthesizing the stream, NULL while it waits in queue */
+} stream_t;
+
+static GList*	g_stream_list = NULL;
+
+/* Watchdog of synthesis. Engine which does not finish a text before its deadline is restarted. */
+#define SYNTHESIS_TIMEOUT_MIN_DEFAULT		10000	/* msec */
+#define SYNTHESIS_TIMEOUT_MARGIN_DEFAULT	4
+#define WATCHDOG_INTERVAL			1.0	/* sec */
+
+static Ecore_Timer*	g_watchdog_timer = NULL;
+
+/* Utterances canceled or given up by watchdog, kept until engine releases them */
+static GList*		g_stuck_list = NULL;
+
+/* Timed-out utterance whose cancel is given one watchdog period before engine is restarted */
+static utterance_t*	g_recovering_utt = NULL;
+
+/* Function definitions */
+int __server_next_synthesis(int uid);
+
+int __server_schedule();
+
+void __server_cancel_stale_synthesis();
+
+void __server_cancel_ahead(bool is_preempted);
+
+void __server_remove_streams(int uid);
+
+void __server_detach_stream(utterance_t* utt);
+
+int __server_start_stream(utterance_t* utt);
+
+int __server_enqueue(int uid, app_state_e state, const speak_data_s* sdata);
+
+void __server_arm_watchdog(utterance_t* utt, const char* text);
+
+void __server_start_watchdog();
+
+void __server_update_estimate(utterance_t* utt, ttsp_audio_type_e audio_type, int rate, int channels);
+
+int __server_start_batch(utterance_t* head);
+
+
+int __server_set_is_synthesizing(bool flag)
+{
+	g_is_synthesizing = flag;
+	return 0;
+}
+
+bool __server_get_current_synthesis()
+{
+	return g_is_synthesizing;
+}
+
+int __server_send_error(int uid, int utt_id, int error_code)
+{
+	int pid = ttsd_data_get_pid(uid);
+
+	/* send error */
+	if ( 0 != ttsdc_send_error_message(pid, uid, utt_id, error_code)) {
+		__server_remove_streams(uid);
+		ttsd_fragment_remove_templates(uid);
+		ttsd_data_delete_client(uid);			
+		__server_cancel_stale_synthesis();
+	} 
+	
+	return 0;
+}
+
+/* Resolve default voice and speed, so that cache keys do not depend on how client asks */
+bool __server_resolve_voice(const speak_data_s* sdata, char** lang, int* vctype, int* speed)
+{
+	const char* temp_lang = NULL;
+	ttsp_voice_type_e temp_type;
+	if (true != ttsd_engine_select_valid_voice(sdata->lang, sdata->vctype, &temp_lang, &temp_type)) {
+		return false;
+	}
+	*lang = strdup(temp_lang);
+	*vctype = (int)temp_type;
+
+	*speed = (int)sdata->speed;
+	if (0 == *speed) {
+		ttsp_speed_e default_speed;
+		if (0 != ttsd_engine_setting_get_default_speed(&default_speed)) {
+			free(*lang);
+			*lang = NULL;
+			return false;
+		}
+		*speed = (int)default_speed;
+	}
+
+	return true;
+}
+
+void __server_free_utterance(utterance_t* utt)
+{
+	if (NULL == utt)
+		return;
+
+	if (g_synth_utt == utt)
+		g_synth_utt = NULL;
+
+	g_ahead_list = g_list_remove(g_ahead_list, utt);
+	g_stuck_list = g_list_remove(g_stuck_list, utt);
+
+	if (g_recovering_utt == utt)
+		g_recovering_utt = NULL;
+
+	__server_detach_stream(utt);
+
+	GList* iter = g_list_first(utt->pending);
+	while (NULL != iter) {
+		ttsd_data_release_sound_data((sound_data_s*)iter->data);
+		g_free(iter->data);
+		iter = g_list_next(iter);
+	}
+	g_list_free(utt->pending);
+
+	ttsd_cache_record_end(utt->record, false);
+	ttsd_fragment_job_destroy(utt->job);
+
+	if (NULL != utt->lang)
+		free(utt->lang);
+
+	if (NULL != utt->sdata.text)
+		free(utt->sdata.text);
+
+	if (NULL != utt->sdata.lang)
+		g_free(utt->sdata.lang);
+
+	g_free(utt);
+}
+
+/* Take text of speak data. Text and language are released with utterance. */
+utterance_t* __server_new_utterance(int uid, speak_data_s* sdata, ttsd_cache_record_h record)
+{
+	utterance_t* utt = (utterance_t*)g_malloc0(sizeof(utterance_t));
+	if (NULL == utt) {
+		return NULL;
+	}
+
+	utt->uid = uid;
+	utt->uttid = sdata->utt_id;
+	utt->record = record;
+	utt->sdata = *sdata;
+
+	if (0 != ttsd_data_get_generation(uid, &utt->generation)) {
+		g_free(utt);
+		return NULL;
+	}
+
+	sdata->text = NULL;
+	sdata->lang = NULL;
+
+	return utt;
+}
+
+void __server_add_first_audio_latency(const speak_data_s* sdata)
+{
+	int priority = sdata->priority;
+	if (TTSD_PRIORITY_LOW > priority)
+		priority = TTSD_PRIORITY_LOW;
+	else if (TTSD_PRIORITY_CRITICAL < priority)
+		priority = TTSD_PRIORITY_CRITICAL;
+
+	long long now = ttsd_stats_get_time();
+
+	ttsd_stats_add_latency((ttsd_stats_latency_e)(TTSD_STATS_FIRST_AUDIO_LOW + priority), now - sdata->enqueue_time);
+
+	if (0 != sdata->deadline && now > sdata->deadline) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Server WARNING] Deadline is missed : uttid(%d), %lld msec late", sdata->utt_id, now - sdata->deadline);
+		ttsd_stats_increase(TTSD_STATS_DEADLINE_MISS);
+	}
+}
+
+/* Get next text. Stale texts are dropped without synthesis. */
+int __server_get_speak_data(int uid, speak_data_s* sdata)
+{
+	while (0 == ttsd_data_get_speak_data(uid, sdata)) {
+		if (0 == sdata->expire_time || ttsd_stats_get_time() <= sdata->expire_time) {
+			return 0;
+		}
+
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Text is expired : uid(%d), uttid(%d)", uid, sdata->utt_id);
+
+		ttsd_stats_increase(TTSD_STATS_EXPIRED);
+		__server_send_error(uid, sdata->utt_id, TTSD_ERROR_UTTERANCE_EXPIRED);
+
+		if (NULL != sdata->text)
+			free(sdata->text);
+		if (NULL != sdata->lang)
+			g_free(sdata->lang);
+
+		sdata->text = NULL;
+		sdata->lang = NULL;
+	}
+
+	return -1;
+}
+
+/* Find sound of text in prompt cache. If it is not cached, start to record the synthesized sound. */
+bool __server_find_cached_sound(const speak_data_s* sdata, sound_data_s* sound, ttsd_cache_record_h* record)
+{
+	*record = NULL;
+
+	if (true == sdata->is_stream)
+		return false;
+
+	/* make key with the voice and speed really used by engine */
+	char* lang = NULL;
+	int vctype;
+	int speed;
+	if (true != __server_resolve_voice(sdata, &lang, &vctype, &speed)) {
+		return false;
+	}
+
+	void* data = NULL;
+	bool is_mapped = false;
+
+	if (0 != ttsd_cache_get(sdata->text, lang, vctype, speed, &data, &sound->data_size, 
+		&sound->audio_type, &sound->rate, &sound->channels, &is_mapped)) {
+		*record = ttsd_cache_record_begin(sdata->text, lang, vctype, speed);
+		free(lang);
+		return false;
+	}
+
+	free(lang);
+
+	sound->data = data;
+	sound->utt_id = sdata->utt_id;
+	sound->event = TTSP_RESULT_EVENT_FINISH;
+	sound->is_cached = is_mapped;
+	sound->priority = sdata->priority;
+
+	return true;
+}
+
+/* Get sound of text from prompt cache, and add it to sound queue */
+bool __server_get_cached_sound(int uid, const speak_data_s* sdata, ttsd_cache_record_h* record)
+{
+	sound_data_s temp_data;
+	if (false == __server_find_cached_sound(sdata, &temp_data, record)) {
+		return false;
+	}
+
+	if (0 != ttsd_data_add_sound_data(uid, temp_data)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[SERVER ERROR] Fail to add cached sound data : uid(%d)", uid);
+		ttsd_data_release_sound_data(&temp_data);
+		return false;
+	}
+
+	__server_add_first_audio_latency(sdata);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Play cached sound : uid(%d), uttid(%d)", uid, sdata->utt_id);
+
+	return true;
+}
+
+/* 
+* Synthesize next fragment. Cached fragments are spliced without engine.
+* Returns 0 if engine starts, 1 if all fragments are done, otherwise error.
+*/
+int __server_next_fragment(utterance_t* utt)
+{
+	const char* text = NULL;
+	bool is_stable = false;
+
+	while (true == ttsd_fragment_job_next(utt->job, &text, &is_stable)) {
+		if (true == is_stable) {
+			void* data = NULL;
+			unsigned int data_size;
+			ttsp_audio_type_e audio_type;
+			int rate;
+			int channels;
+			bool is_mapped = false;
+
+			if (0 == ttsd_cache_get(text, utt->lang, utt->vctype, utt->speed, &data, &data_size, 
+				&audio_type, &rate, &channels, &is_mapped)) {
+				int ret = ttsd_fragment_job_append(utt->job, data, data_size, audio_type, rate, channels);
+
+				if (true == is_mapped)
+					ttsd_cache_release(data);
+				else
+					g_free(data);
+
+				if (0 != ret || 0 != ttsd_fragment_job_splice(utt->job))
+					return TTSD_ERROR_OPERATION_FAILED;
+
+				continue;
+			}
+
+			/* stable fragment is recorded to be reused by other texts */
+			utt->record = ttsd_cache_record_begin(text, utt->lang, utt->vctype, utt->speed);
+		}
+
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Synthesize fragment : text(%s), stable(%d)", text, is_stable);
+
+		return ttsd_engine_start_synthesis(utt->lang, (ttsp_voice_type_e)utt->vctype, text, utt->speed, (void*)utt);
+	}
+
+	/* all fragments are spliced */
+	sound_data_s temp_data;
+	void* data = NULL;
+
+	if (0 != ttsd_fragment_job_get_audio(utt->job, &data, &temp_data.data_size, &temp_data.rate, &temp_data.channels)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to get spliced audio");
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	temp_data.data = data;
+	temp_data.utt_id = utt->uttid;
+	temp_data.event = TTSP_RESULT_EVENT_FINISH;
+	temp_data.audio_type = TTSP_AUDIO_TYPE_RAW;
+	temp_data.is_cached = false;
+	temp_data.priority = utt->sdata.priority;
+
+	if (0 != ttsd_data_add_sound_data(utt->uid, temp_data)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[SERVER ERROR] Fail to add sound data : uid(%d)", utt->uid);
+		ttsd_data_release_sound_data(&temp_data);
+	} else {
+		__server_add_first_audio_latency(&utt->sdata);
+	}
+
+	return 1;
+}
+
+/* Finish the utterance made of fragments, and go to next text */
+void __server_finish_fragments(utterance_t* utt, int result)
+{
+	if (0 > result) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to synthesize fragments : result(%d)", result);
+		__server_send_error(utt->uid, utt->uttid, TTSD_ERROR_OPERATION_FAILED);
+	}
+
+	__server_free_utterance(utt);
+
+	__server_set_is_synthesizing(false);
+	g_is_next_synthesis = true;
+}
+
+Eina_Bool __server_continue_fragment(void *data)
+{
+	utterance_t* utt = (utterance_t*)data;
+
+	/* the client may be stopped, preempted or removed before this timer */
+	if (utt != g_synth_utt) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Fragments are canceled : uid(%d), uttid(%d)", utt->uid, utt->uttid);
+		__server_free_utterance(utt);
+		return EINA_FALSE;
+	}
+
+	int ret = __server_next_fragment(utt);
+	if (0 != ret) {
+		__server_finish_fragments(utt, ret);
+	}
+
+	return EINA_FALSE;
+}
+
+/* Start synthesis of the text. A text matched with a template of client is synthesized by fragments. */
+int __server_start_utterance(utterance_t* utt)
+{
+	const speak_data_s* sdata = &utt->sdata;
+	ttsp_audio_type_e audio_type;
+	int rate;
+	int channels;
+
+	if (true == sdata->is_stream)
+		return __server_start_stream(utt);
+
+	__server_arm_watchdog(utt, sdata->text);
+
+	/* only raw PCM can be spliced */
+	if (true == ttsd_fragment_has_template(utt->uid) &&
+	    0 == ttsd_engine_get_audio_format(&audio_type, &rate, &channels) && TTSP_AUDIO_TYPE_RAW == audio_type &&
+	    true == __server_resolve_voice(sdata, &utt->lang, &utt->vctype, &utt->speed)) {
+		utt->job = ttsd_fragment_job_create(utt->uid, sdata->text);
+
+		if (NULL != utt->job) {
+			/* whole text is not cached, variable parts make it rarely reused */
+			ttsd_cache_record_end(utt->record, false);
+			utt->record = NULL;
+
+			int ret = __server_next_fragment(utt);
+			if (1 == ret) {
+				__server_finish_fragments(utt, 0);
+				return 0;
+			}
+			return ret;
+		}
+	}
+
+	return __server_start_batch(utt);
+}
+
+/*
+* Text stream. Text is given to engine as soon as it is added, while the stream is at the head of queue.
+*/
+
+stream_t* __server_find_stream(int uid, int utt_id)
+{
+	GList* iter = g_list_first(g_stream_list);
+	while (NULL != iter) {
+		stream_t* stream = (stream_t*)iter->data;
+		if (uid == stream->uid && utt_id == stream->utt_id)
+			return stream;
+		iter = g_list_next(iter);
+	}
+
+	return NULL;
+}
+
+/* Stream which client is adding text to */
+stream_t* __server_find_open_stream(int uid)
+{
+	GList* iter = g_list_first(g_stream_list);
+	while (NULL != iter) {
+		stream_t* stream = (stream_t*)iter->data;
+		if (uid == stream->uid && false == stream->is_closed)
+			return stream;
+		iter = g_list_next(iter);
+	}
+
+	return NULL;
+}
+
+void __server_free_stream(stream_t* stream)
+{
+	g_stream_list = g_list_remove(g_stream_list, stream);
+	g_string_free(stream->text, TRUE);
+	g_free(stream);
+}
+
+void __server_remove_streams(int uid)
+{
+	GList* iter = g_list_first(g_stream_list);
+	while (NULL != iter) {
+		stream_t* stream = (stream_t*)iter->data;
+		iter = g_list_next(iter);
+
+		if (uid == stream->uid)
+			__server_free_stream(stream);
+	}
+}
+
+void __server_detach_stream(utterance_t* utt)
+{
+	GList* iter = g_list_first(g_stream_list);
+	while (NULL != iter) {
+		stream_t* stream = (stream_t*)iter->data;
+		if (utt == stream->utt)
+			stream->utt = NULL;
+		iter = g_list_next(iter);
+	}
+}
+
+/* Give text which engine does not have yet */
+int __server_feed_stream(stream_t* stream)
+{
+	if (NULL == stream->utt || stream->utt != g_synth_utt)
+		return 0;
+
+	if (stream->pushed_len < stream->text->len) {
+		if (0 != ttsd_engine_push_stream(stream->text->str + stream->pushed_len))
+			return TTSD_ERROR_OPERATION_FAILED;
+		stream->pushed_len = stream->text->len;
+	}
+
+	if (true == stream->is_closed && false == stream->is_engine_closed) {
+		if (0 != ttsd_engine_close_stream())
+			return TTSD_ERROR_OPERATION_FAILED;
+		stream->is_engine_closed = true;
+	}
+
+	return 0;
+}
+
+int __server_start_stream(utterance_t* utt)
+{
+	stream_t* stream = __server_find_stream(utt->uid, utt->uttid);
+	if (NULL == stream) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Stream is not found : uid(%d), uttid(%d)", utt->uid, utt->uttid);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	/* texts after stream wait until it is closed and synthesized */
+	utt->is_alone = true;
+
+	int ret = ttsd_engine_open_stream(utt->sdata.lang, utt->sdata.vctype, utt->sdata.speed, (void*)utt);
+	if (0 != ret)
+		return ret;
+
+	/* preempted stream is synthesized again from the beginning */
+	stream->utt = utt;
+	stream->pushed_len = 0;
+	stream->is_engine_closed = false;
+
+	__server_arm_watchdog(utt, stream->text->str);
+
+	return __server_feed_stream(stream);
+}
+
+/* 
+* Cancel synthesis of the client. Result of canceled utterance is ignored.
+* Preempted text is put back to queue and synthesized again from the beginning.
+*/
+void __server_cancel_synthesis(int uid, bool is_preempted)
+{
+	utterance_t* utt = g_synth_utt;
+	if (NULL == utt || uid != utt->uid) {
+		return;
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Cancel synthesis : uid(%d), uttid(%d), preempted(%d)", uid, utt->uttid, is_preempted);
+
+	utt->cancel_time = ttsd_stats_get_time();
+	g_synth_utt = NULL;
+	g_stuck_list = g_list_append(g_stuck_list, utt);
+
+	/* texts after current text are put back first, so that current text goes before them */
+	__server_cancel_ahead(is_preempted);
+
+	if (true == is_preempted) {
+		/* partial sound of the text is dropped */
+		ttsd_data_remove_sound_data(uid, utt->uttid);
+
+		if (0 == ttsd_data_requeue_speak_data(uid, utt->sdata)) {
+			utt->sdata.text = NULL;
+			utt->sdata.lang = NULL;
+		}
+
+		ttsd_stats_increase(TTSD_STATS_PREEMPTION);
+	}
+
+	__server_set_is_synthesizing(false);
+
+	/* utterance is released by the result callback, it may be called in cancel */
+	int ret = ttsd_engine_cancel_synthesis();
+	if (0 != ret)
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to cancel synthesis : ret(%d)", ret);
+}
+
+/*
+* Concurrent synthesis. Texts after current text are synthesized by other workers of engine,
+* and their results are added to sound queue in order of text.
+*/
+
+/* Get sound data of result. Buffer of daemon which engine wrote is used without copy. */
+void* __server_take_sound(const void* data, unsigned int data_size)
+{
+	if (true == ttsd_buffer_take(data))
+		return (void*)data;
+
+	void* temp = g_malloc0(sizeof(char) * data_size);
+	memcpy(temp, data, data_size);
+
+	return temp;
+}
+
+/* Keep result of text synthesized ahead until texts before it are done */
+void __server_keep_sound(utterance_t* utt, const sound_data_s* sound)
+{
+	sound_data_s* temp = (sound_data_s*)g_malloc0(sizeof(sound_data_s));
+	*temp = *sound;
+	utt->pending = g_list_append(utt->pending, temp);
+}
+
+/* Add kept result of utterance to sound queue */
+void __server_flush_sound(utterance_t* utt)
+{
+	GList* iter = g_list_first(utt->pending);
+	while (NULL != iter) {
+		sound_data_s* sound = (sound_data_s*)iter->data;
+
+		if (0 != ttsd_data_add_sound_data(utt->uid, *sound)) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[SERVER ERROR] Fail to add sound data : uid(%d)", utt->uid);
+			ttsd_data_release_sound_data(sound);
+		} else if (false == utt->is_started) {
+			utt->is_started = true;
+			__server_add_first_audio_latency(&utt->sdata);
+		}
+
+		g_free(sound);
+		iter = g_list_next(iter);
+	}
+
+	g_list_free(utt->pending);
+	utt->pending = NULL;
+}
+
+/* Next text synthesized ahead becomes current text, after current text is done */
+void __server_promote_ahead()
+{
+	while (NULL != g_ahead_list) {
+		utterance_t* utt = (utterance_t*)g_ahead_list->data;
+		g_ahead_list = g_list_delete_link(g_ahead_list, g_ahead_list);
+
+		__server_flush_sound(utt);
+
+		if (false == utt->is_done) {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Text synthesized ahead is current : uid(%d), uttid(%d)", utt->uid, utt->uttid);
+			g_synth_utt = utt;
+			__server_set_is_synthesizing(true);
+			g_is_next_synthesis = false;
+			return;
+		}
+
+		__server_free_utterance(utt);
+	}
+}
+
+/* Cancel texts synthesized ahead. Preempted texts are put back to queue. */
+void __server_cancel_ahead(bool is_preempted)
+{
+	GList* iter = g_list_last(g_ahead_list);
+	while (NULL != iter) {
+		utterance_t* utt = (utterance_t*)iter->data;
+		iter = g_list_previous(iter);
+
+		g_ahead_list = g_list_remove(g_ahead_list, utt);
+
+		if (true == is_preempted && 0 == ttsd_data_requeue_speak_data(utt->uid, utt->sdata)) {
+			utt->sdata.text = NULL;
+			utt->sdata.lang = NULL;
+		}
+
+		if (true == utt->is_done) {
+			__server_free_utterance(utt);
+		} else {
+			/* released by the result callback */
+			utt->cancel_time = ttsd_stats_get_time();
+			g_stuck_list = g_list_append(g_stuck_list, utt);
+		}
+	}
+}
+
+/* Estimated audio of texts synthesized ahead */
+int __server_get_ahead_audio()
+{
+	int audio_msec = 0;
+
+	GList* iter = NULL;
+	for (iter = g_list_first(g_ahead_list); NULL != iter; iter = g_list_next(iter))
+		audio_msec += ((utterance_t*)iter->data)->sdata.audio_estimate;
+
+	return audio_msec;
+}
+
+/* Start texts after current text on other workers, if engine can synthesize them at once */
+void __server_dispatch_ahead()
+{
+	utterance_t* head = g_synth_utt;
+	if (NULL == head || true == head->is_alone || NULL != head->job || true == ttsd_fragment_has_template(head->uid))
+		return;
+
+	int uid = head->uid;
+	int workers = ttsd_engine_get_concurrency(head->sdata.lang, head->sdata.vctype);
+	if (1 >= workers) {
+		head->is_alone = true;
+		return;
+	}
+
+	/* texts far ahead are likely to be canceled before they are played */
+	int lookahead = ttsd_config_get_int_option(TTSD_CONFIG_LOOKAHEAD_AUDIO, 0);
+
+	while ((int)g_list_length(g_ahead_list) + 1 < workers) {
+		if (0 < lookahead && lookahead <= __server_get_ahead_audio())
+			return;
+
+		speak_data_s sdata;
+		memset(&sdata, 0, sizeof(speak_data_s));
+
+		if (0 != __server_get_speak_data(uid, &sdata))
+			return;
+
+		/* expired text may remove the client */
+		if (head != g_synth_utt || true == sdata.is_stream || 1 >= ttsd_engine_get_concurrency(sdata.lang, sdata.vctype)) {
+			/* text for other engine waits for current text */
+			if (0 != ttsd_data_requeue_speak_data(uid, sdata)) {
+				free(sdata.text);
+				g_free(sdata.lang);
+			}
+			if (head == g_synth_utt)
+				head->is_alone = true;
+			return;
+		}
+
+		sound_data_s sound;
+		ttsd_cache_record_h record = NULL;
+		bool is_cached = __server_find_cached_sound(&sdata, &sound, &record);
+
+		utterance_t* utt = __server_new_utterance(uid, &sdata, record);
+		if (NULL == utt) {
+			ttsd_cache_record_end(record, false);
+			if (true == is_cached)
+				ttsd_data_release_sound_data(&sound);
+			if (0 != ttsd_data_requeue_speak_data(uid, sdata)) {
+				free(sdata.text);
+				g_free(sdata.lang);
+			}
+			return;
+		}
+
+		g_ahead_list = g_list_append(g_ahead_list, utt);
+
+		if (true == is_cached) {
+			__server_keep_sound(utt, &sound);
+			utt->is_done = true;
+			continue;
+		}
+
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Synthesize ahead : uid(%d), uttid(%d), workers(%d)", uid, utt->uttid, workers);
+
+		__server_arm_watchdog(utt, utt->sdata.text);
+
+		if (0 != ttsd_engine_start_synthesis(utt->sdata.lang, utt->sdata.vctype, utt->sdata.text, utt->sdata.speed, (void*)utt)) {
+			SLOG(LOG_WARN, TAG_TTSD, "[Server WARNING] Fail to synthesize ahead, text waits for current text");
+
+			g_ahead_list = g_list_remove(g_ahead_list, utt);
+			if (0 == ttsd_data_requeue_speak_data(uid, utt->sdata)) {
+				utt->sdata.text = NULL;
+				utt->sdata.lang = NULL;
+			}
+			__server_free_utterance(utt);
+
+			head->is_alone = true;
+			return;
+		}
+	}
+}
+
+/* Start current text with queued texts of the same voice and speed in one engine call, if engine supports it */
+int __server_start_batch(utterance_t* head)
+{
+	speak_data_s* hdata = &head->sdata;
+	int size = ttsd_engine_get_batch_size(hdata->lang, hdata->vctype);
+
+	/* texts of client with template may be spliced by fragments */
+	if (1 >= size || NULL != g_ahead_list || head != g_synth_utt || true == ttsd_fragment_has_template(head->uid))
+		return ttsd_engine_start_synthesis(hdata->lang, hdata->vctype, hdata->text, hdata->speed, (void*)head);
+
+	int uid = head->uid;
+	int lookahead = ttsd_config_get_int_option(TTSD_CONFIG_LOOKAHEAD_AUDIO, 0);
+	long long start = ttsd_stats_get_time();
+	long long deadline = head->watchdog_time;
+
+	const char** texts = (const char**)g_malloc0(sizeof(char*) * size);
+	void** params = (void**)g_malloc0(sizeof(void*) * size);
+	texts[0] = hdata->text;
+	params[0] = (void*)head;
+	int count = 1;
+
+	while (count < size) {
+		if (0 < lookahead && lookahead <= __server_get_ahead_audio())
+			break;
+
+		speak_data_s sdata;
+		memset(&sdata, 0, sizeof(speak_data_s));
+
+		if (0 != __server_get_speak_data(uid, &sdata))
+			break;
+
+		/* expired text may remove the client, text of other voice starts next batch */
+		if (head != g_synth_utt || true == sdata.is_stream || sdata.vctype != hdata->vctype || sdata.speed != hdata->speed ||
+		    (NULL == sdata.lang) != (NULL == hdata->lang) || (NULL != sdata.lang && 0 != strcmp(sdata.lang, hdata->lang))) {
+			if (0 != ttsd_data_requeue_speak_data(uid, sdata)) {
+				free(sdata.text);
+				g_free(sdata.lang);
+			}
+			break;
+		}
+
+		sound_data_s sound;
+		ttsd_cache_record_h record = NULL;
+		bool is_cached = __server_find_cached_sound(&sdata, &sound, &record);
+
+		utterance_t* utt = __server_new_utterance(uid, &sdata, record);
+		if (NULL == utt) {
+			ttsd_cache_record_end(record, false);
+			if (true == is_cached)
+				ttsd_data_release_sound_data(&sound);
+			if (0 != ttsd_data_requeue_speak_data(uid, sdata)) {
+				free(sdata.text);
+				g_free(sdata.lang);
+			}
+			break;
+		}
+
+		g_ahead_list = g_list_append(g_ahead_list, utt);
+
+		if (true == is_cached) {
+			__server_keep_sound(utt, &sound);
+			utt->is_done = true;
+			continue;
+		}
+
+		/* engine synthesizes items in order, deadline of each includes items before it */
+		utt->is_batched = true;
+		__server_arm_watchdog(utt, utt->sdata.text);
+		if (0 != deadline && 0 != utt->watchdog_time)
+			utt->watchdog_time += deadline - start;
+		deadline = utt->watchdog_time;
+
+		texts[count] = utt->sdata.text;
+		params[count] = (void*)utt;
+		count++;
+	}
+
+	int ret;
+	if (head != g_synth_utt) {
+		/* client is removed by expired text, texts taken for batch are never started */
+		int i;
+		for (i = 1; i < count; i++)
+			__server_free_utterance((utterance_t*)params[i]);
+		ret = TTSD_ERROR_OPERATION_FAILED;
+	} else if (1 == count) {
+		ret = ttsd_engine_start_synthesis(hdata->lang, hdata->vctype, hdata->text, hdata->speed, (void*)head);
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Synthesize batch : uid(%d), uttid(%d), count(%d)", uid, head->uttid, count);
+
+		ret = ttsd_engine_start_batch(hdata->lang, hdata->vctype, hdata->speed, texts, params, count);
+		if (0 != ret) {
+			SLOG(LOG_WARN, TAG_TTSD, "[Server WARNING] Fail to start batch, texts are synthesized one by one");
+
+			/* no item is started, texts after current text wait in queue again */
+			GList* iter = g_list_last(g_ahead_list);
+			while (NULL != iter) {
+				utterance_t* utt = (utterance_t*)iter->data;
+				iter = g_list_previous(iter);
+
+				if (0 == ttsd_data_requeue_speak_data(uid, utt->sdata)) {
+					utt->sdata.text = NULL;
+					utt->sdata.lang = NULL;
+				}
+				__server_free_utterance(utt);
+			}
+
+			head->is_alone = true;
+			ret = ttsd_engine_start_synthesis(hdata->lang, hdata->vctype, hdata->text, hdata->speed, (void*)head);
+		}
+	}
+
+	/* batch is the lookahead of current text */
+	if (1 < count)
+		head->is_alone = true;
+
+	g_free(texts);
+	g_free(params);
+
+	return ret;
+}
+
+/* Cancel synthesis started before the client is stopped or removed */
+void __server_cancel_stale_synthesis()
+{
+	if (NULL == g_synth_utt)
+		return;
+
+	unsigned int generation;
+	if (0 == ttsd_data_get_generation(g_synth_utt->uid, &generation) && generation == g_synth_utt->generation)
+		return;
+
+	__server_cancel_synthesis(g_synth_utt->uid, false);
+}
+
+/*
+* Engine keep-alive
+*/
+
+static bool __server_is_low_memory()
+{
+	int status = VCONFKEY_SYSMAN_LOW_MEMORY_NORMAL;
+	if (0 != vconf_get_int(VCONFKEY_SYSMAN_LOW_MEMORY, &status))
+		return false;
+
+	return (VCONFKEY_SYSMAN_LOW_MEMORY_SOFT_WARNING == status || VCONFKEY_SYSMAN_LOW_MEMORY_HARD_WARNING == status);
+}
+
+/* Stop warm-up, so that text of client is synthesized without waiting */
+void __server_cancel_warm_up()
+{
+	if (false == g_is_warming_up)
+		return;
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Cancel warm-up synthesis");
+
+	g_is_warming_up = false;
+	__server_set_is_synthesizing(false);
+	ttsd_engine_cancel_synthesis();
+}
+
+/* Synthesize a short text once, so that engine loads its voice data before first request */
+void __server_warm_up_engine()
+{
+	char* text = NULL;
+	if (0 != ttsd_config_get_option(TTSD_CONFIG_ENGINE_WARM_UP_TEXT, &text))
+		return;
+
+	if (true == __server_get_current_synthesis() || '\0' == text[0]) {
+		free(text);
+		return;
+	}
+
+	g_warm_up_utt.uid = -1;
+	g_warm_up_utt.uttid = -1;
+
+	__server_set_is_synthesizing(true);
+	g_is_warming_up = true;
+	g_warm_up_time = ttsd_stats_get_time();
+	__server_start_watchdog();
+
+	if (0 != ttsd_engine_start_synthesis("default", (ttsp_voice_type_e)0, text, 0, &g_warm_up_utt)) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Server WARNING] Fail to start warm-up synthesis");
+		g_is_warming_up = false;
+		__server_set_is_synthesizing(false);
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Start warm-up synthesis");
+	}
+
+	free(text);
+}
+
+void __server_unload_engine()
+{
+	if (NULL != g_idle_timer) {
+		ecore_timer_del(g_idle_timer);
+		g_idle_timer = NULL;
+	}
+
+	__server_cancel_warm_up();
+
+	if (0 != ttsd_engine_agent_unload_current_engine()) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] fail to unload current engine ");
+	} else {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Server SUCCESS] unload current engine ");
+	}
+}
+
+Eina_Bool __server_idle_timer_cb(void *data)
+{
+	g_idle_timer = NULL;
+
+	if (0 == ttsd_data_get_client_count()) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Engine is idle, unload it");
+		__server_unload_engine();
+	}
+
+	return EINA_FALSE;
+}
+
+void __server_low_memory_cb(keynode_t* key, void* data)
+{
+	if (true == __server_is_low_memory())
+		ttsd_buffer_shrink();
+
+	if (0 == ttsd_data_get_client_count() && true == ttsd_engine_agent_is_loaded() && true == __server_is_low_memory()) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Low memory, unload idle engine");
+		__server_unload_engine();
+	}
+}
+
+/* Load engine for first client. Engine which is kept alive is reused. */
+int __server_load_engine()
+{
+	if (NULL != g_idle_timer) {
+		ecore_timer_del(g_idle_timer);
+		g_idle_timer = NULL;
+	}
 
-/* If engine is running */
-static bool	g_is_synthesizing;
+	if (true == ttsd_engine_agent_is_loaded()) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Reuse loaded engine");
+		ttsd_stats_increase(TTSD_STATS_ENGINE_REUSE);
+		return 0;
+	}
 
-/* If the daemon get the result */
-Ecore_Timer*	g_timer;
-static bool	g_is_next_synthesis;
+	if (0 != ttsd_engine_agent_load_current_engine()) {
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
 
-/* Function definitions */
-int __server_next_synthesis(int uid);
+	__server_warm_up_engine();
 
+	return 0;
+}
 
-int __server_set_is_synthesizing(bool flag)
+/* Unload engine after idle timeout, when last client is removed */
+void __server_release_engine()
 {
-	g_is_synthesizing = flag;
-	return 0;
+	int timeout = ttsd_config_get_int_option(TTSD_CONFIG_ENGINE_IDLE_TIMEOUT, ENGINE_IDLE_TIMEOUT_DEFAULT);
+
+	if (0 == timeout || true == __server_is_low_memory()) {
+		__server_unload_engine();
+		return;
+	}
+
+	/* negative timeout keeps engine loaded */
+	if (0 > timeout)
+		return;
+
+	if (NULL != g_idle_timer)
+		ecore_timer_del(g_idle_timer);
+
+	g_idle_timer = ecore_timer_add((double)timeout, __server_idle_timer_cb, NULL);
 }
 
-bool __server_get_current_synthesis()
+/*
+* Engine switch
+*/
+
+/* Keep language of queued text if new engine supports it, voice type may fall back to default */
+bool __server_retarget_speak_data(int uid, speak_data_s* data, void* user_data)
 {
-	return g_is_synthesizing;
+	const char* lang = NULL;
+	ttsp_voice_type_e type;
+
+	if (true == ttsd_engine_select_valid_voice(data->lang, data->vctype, &lang, &type))
+		return true;
+
+	if (0 != data->vctype && true == ttsd_engine_select_valid_voice(data->lang, 0, &lang, &type)) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Retarget text : uid(%d), uttid(%d), lang(%s), type(%d -> default)", 
+			uid, data->utt_id, data->lang, data->vctype);
+		data->vctype = (ttsp_voice_type_e)0;
+	} else {
+		SLOG(LOG_WARN, TAG_TTSD, "[Server WARNING] New engine does not support voice : uid(%d), uttid(%d), lang(%s)", 
+			uid, data->utt_id, data->lang);
+	}
+
+	return true;
 }
 
-int __server_send_error(int uid, int utt_id, int error_code)
+bool __server_retarget_client(int pid, int uid, app_state_e state, void* user_data)
 {
-	int pid = ttsd_data_get_pid(uid);
+	ttsd_data_foreach_speak_data(uid, __server_retarget_speak_data, NULL);
+	return true;
+}
 
-	/* send error */
-	if ( 0 != ttsdc_send_error_message(pid, uid, utt_id, error_code)) {
-		ttsd_data_delete_client(uid);			
-	} 
-	
-	return 0;
+/* Switch to prepared engine at utterance boundary */
+void __server_try_switch_engine()
+{
+	if (false == g_is_engine_switching)
+		return;
+
+	/* in-flight utterance is finished by current engine */
+	if (NULL != g_synth_utt || (true == __server_get_current_synthesis() && false == g_is_warming_up))
+		return;
+
+	g_is_engine_switching = false;
+
+	__server_cancel_warm_up();
+
+	if (0 != ttsd_engine_agent_switch_engine()) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to switch engine");
+		return;
+	}
+
+	/* voice of queued text is selected again by new engine */
+	ttsd_data_foreach_clients(__server_retarget_client, NULL);
+
+	if (0 > ttsd_data_is_current_playing())
+		__server_warm_up_engine();
+
+	/* new engine is kept alive as current engine was */
+	if (0 == ttsd_data_get_client_count())
+		__server_release_engine();
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Server SUCCESS] Engine is switched");
+}
+
+Eina_Bool __server_switch_engine_cb(void *data)
+{
+	__server_try_switch_engine();
+	return EINA_FALSE;
+}
+
+void __server_engine_prepared_cb(bool is_loaded)
+{
+	if (false == is_loaded) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to load new engine, current engine is kept");
+		return;
+	}
+
+	g_is_engine_switching = true;
+	__server_try_switch_engine();
 }
 
 int __server_start_synthesis(int uid, int mode)
 {
 	int result = 0;
 
+	__server_cancel_warm_up();
+
 	/* check if tts-engine is running */
 	if (true == __server_get_current_synthesis()) {
 		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] TTS-engine is running ");
 	} else {
 		speak_data_s sdata;
-		if (0 == ttsd_data_get_speak_data(uid, &sdata)) {
-			utterance_t* utt = (utterance_t*)g_malloc0(sizeof(utterance_t));
+		ttsd_cache_record_h record = NULL;
+		sdata.text = NULL;
+		if (0 == __server_get_speak_data(uid, &sdata) && true == __server_get_cached_sound(uid, &sdata, &record)) {
+			/* No need to synthesize. Go to next text. */
+			g_is_next_synthesis = true;
+
+			if(sdata.text != NULL)	
+				g_free(sdata.text);
+
+			if(sdata.lang != NULL)	
+				g_free(sdata.lang);
+
+		} else if (NULL != sdata.text) {
+			utterance_t* utt = __server_new_utterance(uid, &sdata, record);
 
 			if (NULL == utt) {
 				SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Out of memory : utterance ");
+				ttsd_cache_record_end(record, false);
+				g_free(sdata.text);
+				g_free(sdata.lang);
 				return TTSD_ERROR_OUT_OF_MEMORY;
 			}
-
-			utt->uid = uid;
-			utt->uttid = sdata.utt_id;
 			
 			SLOG(LOG_DEBUG, TAG_TTSD, "-----------------------------------------------------------");
-			SLOG(LOG_DEBUG, TAG_TTSD, "ID : uid (%d), uttid(%d) ", utt->uid, utt->uttid );
-			SLOG(LOG_DEBUG, TAG_TTSD, "Voice : langauge(%s), type(%d), speed(%d)", sdata.lang, sdata.vctype, sdata.speed);
-			SLOG(LOG_DEBUG, TAG_TTSD, "Text : %s", sdata.text);
+			SLOG(LOG_DEBUG, TAG_TTSD, "ID : uid (%d), uttid(%d), priority(%d) ", utt->uid, utt->uttid, utt->sdata.priority);
+			SLOG(LOG_DEBUG, TAG_TTSD, "Voice : langauge(%s), type(%d), speed(%d)", utt->sdata.lang, utt->sdata.vctype, utt->sdata.speed);
+			SLOG(LOG_DEBUG, TAG_TTSD, "Text : %s", utt->sdata.text);
 			SLOG(LOG_DEBUG, TAG_TTSD, "-----------------------------------------------------------");
 
 			__server_set_is_synthesizing(true);
+			g_synth_utt = utt;
+
+			int utt_id = utt->uttid;
 			int ret = 0;
-			ret = ttsd_engine_start_synthesis(sdata.lang, sdata.vctype, sdata.text, sdata.speed, (void*)utt);
+			ret = __server_start_utterance(utt);
 			if (0 != ret) {
 				SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] * FAIL to start SYNTHESIS !!!! * ");
 
@@ -102,10 +1235,10 @@ int __server_start_synthesis(int uid, int mode)
 
 				result = TTSD_ERROR_OPERATION_FAILED;
 
-				g_free(utt);
+				__server_free_utterance(utt);
 
 				if (2 == mode) {
-					__server_send_error(uid, sdata.utt_id, TTSD_ERROR_OPERATION_FAILED);
+					__server_send_error(uid, utt_id, TTSD_ERROR_OPERATION_FAILED);
 					ttsd_server_stop(uid);
 
 					int pid = ttsd_data_get_pid(uid);
@@ -115,9 +1248,6 @@ int __server_start_synthesis(int uid, int mode)
 				SLOG(LOG_DEBUG, TAG_TTSD, "[Server] SUCCESS to start synthesis");
 			}
 
-			if(sdata.text != NULL)	
-				g_free(sdata.text);
-
 		} else {
 			SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Text List is EMPTY!! ");
 		}
@@ -181,47 +1311,58 @@ int __server_next_synthesis(int uid)
 
 	/* synthesize next text */
 	speak_data_s sdata;
-	if (0 == ttsd_data_get_speak_data(current_uid, &sdata)) {
+	ttsd_cache_record_h record = NULL;
+	sdata.text = NULL;
+	if (0 == __server_get_speak_data(current_uid, &sdata) && true == __server_get_cached_sound(current_uid, &sdata, &record)) {
+		/* No need to synthesize. Go to next text. */
+		g_is_next_synthesis = true;
+
+		if(sdata.text != NULL)	
+			g_free(sdata.text);
 
-		utterance_t* utt = (utterance_t*)g_malloc0(sizeof(utterance_t));
+		if(sdata.lang != NULL)	
+			g_free(sdata.lang);
+
+	} else if (NULL != sdata.text) {
+
+		utterance_t* utt = __server_new_utterance(current_uid, &sdata, record);
 
 		if (NULL == utt) {
 			SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] fail to allocate memory : utterance ");
 
+			ttsd_cache_record_end(record, false);
 			__server_send_error(current_uid, sdata.utt_id, TTSD_ERROR_OUT_OF_MEMORY);
+			g_free(sdata.text);
+			g_free(sdata.lang);
 			return TTSD_ERROR_OUT_OF_MEMORY;
 		}
 
-		utt->uid = current_uid;
-		utt->uttid = sdata.utt_id;
-
 		SLOG(LOG_DEBUG, TAG_TTSD, "-----------------------------------------------------------");
-		SLOG(LOG_DEBUG, TAG_TTSD, "ID : uid (%d), uttid(%d) ", utt->uid, utt->uttid );
-		SLOG(LOG_DEBUG, TAG_TTSD, "Voice : langauge(%s), type(%d), speed(%d)", sdata.lang, sdata.vctype, sdata.speed);
-		SLOG(LOG_DEBUG, TAG_TTSD, "Text : %s", sdata.text);
+		SLOG(LOG_DEBUG, TAG_TTSD, "ID : uid (%d), uttid(%d), priority(%d) ", utt->uid, utt->uttid, utt->sdata.priority);
+		SLOG(LOG_DEBUG, TAG_TTSD, "Voice : langauge(%s), type(%d), speed(%d)", utt->sdata.lang, utt->sdata.vctype, utt->sdata.speed);
+		SLOG(LOG_DEBUG, TAG_TTSD, "Text : %s", utt->sdata.text);
 		SLOG(LOG_DEBUG, TAG_TTSD, "-----------------------------------------------------------");
 
 		__server_set_is_synthesizing(true);
+		g_synth_utt = utt;
 
+		int utt_id = utt->uttid;
 		int ret = 0;
-		ret = ttsd_engine_start_synthesis(sdata.lang, sdata.vctype, sdata.text, sdata.speed, (void*)utt);
+		ret = __server_start_utterance(utt);
 		if (0 != ret) {
 			SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] * FAIL to start SYNTHESIS !!!! * ");
 
 			__server_set_is_synthesizing(false);
 
-			__server_send_error(current_uid, sdata.utt_id, TTSD_ERROR_OPERATION_FAILED);
+			__server_send_error(current_uid, utt_id, TTSD_ERROR_OPERATION_FAILED);
 
-			g_free(utt);
+			__server_free_utterance(utt);
 
 			ttsd_server_stop(current_uid);
 
 			int pid = ttsd_data_get_pid(current_uid);
 			ttsdc_send_set_state_message(pid, current_uid, APP_STATE_READY);
 		}
-
-		if(sdata.text != NULL)	
-			g_free(sdata.text);
 	}
 
 	if (0 != ttsd_player_play(current_uid)) {
@@ -250,6 +1391,9 @@ int __player_result_callback(player_event_e event, int uid, int utt_id)
 			/* check text queue is empty */
 			if (0 == ttsd_data_get_speak_data_size(uid) && 0 == ttsd_data_get_sound_data_size(uid)) {
 				SLOG(LOG_DEBUG, TAG_TTSD, "[SERVER Callback] all play completed ");
+
+				/* resume client waiting for this client */
+				__server_schedule();
 			}
 		} 
 		break;
@@ -269,21 +1413,29 @@ int __player_result_callback(player_event_e event, int uid, int utt_id)
 
 Eina_Bool __start_next_synthesis(void *data)
 {
+	__server_try_switch_engine();
+
 	/* get current play */
 	int uid = ttsd_data_is_current_playing();
 
-	if (uid < 0)
+	if (uid < 0) {
+		g_timer = NULL;
 		return EINA_FALSE;
+	}
 
 	if (true == g_is_next_synthesis) {
+		/* reset first, cached sound sets it again in __server_next_synthesis() */
+		g_is_next_synthesis = false;
+
 		SLOG(LOG_DEBUG, TAG_TTSD, "===== NEXT SYNTHESIS START");
 		__server_next_synthesis(uid);
 		SLOG(LOG_DEBUG, TAG_TTSD, "===== ");
 		SLOG(LOG_DEBUG, TAG_TTSD, " ");
-
-		g_is_next_synthesis = false;
 	}
 
+	/* engine may not accept new request in its callback, so workers are filled here */
+	__server_dispatch_ahead();
+
 	return EINA_TRUE;	
 }
 
@@ -294,9 +1446,6 @@ int __synthesis_result_callback(ttsp_result_event_e event, const void* data, uns
 	utterance_t* utt_get_param;
 	utt_get_param = (utterance_t*)user_data;
 
-	int uid = utt_get_param->uid;
-	int uttid = utt_get_param->uttid;
-
 	if (NULL == utt_get_param) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[SERVER ERROR] User data is NULL " );
 		SLOG(LOG_DEBUG, TAG_TTSD, "=====");
@@ -304,6 +1453,99 @@ int __synthesis_result_callback(ttsp_result_event_e event, const void* data, uns
 		return -1;
 	}
 
+	if (&g_warm_up_utt == utt_get_param) {
+		if (TTSP_RESULT_EVENT_FINISH == event || TTSP_RESULT_EVENT_CANCEL == event || TTSP_RESULT_EVENT_FAIL == event) {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[SERVER] Warm-up synthesis is done : event(%d)", event);
+
+			/* canceled warm-up is already reset */
+			if (true == g_is_warming_up) {
+				ttsd_stats_add_latency(TTSD_STATS_ENGINE_WARM_UP, ttsd_stats_get_time() - g_warm_up_time);
+				g_is_warming_up = false;
+				__server_set_is_synthesizing(false);
+				g_is_next_synthesis = true;
+			}
+
+			/* engine is not unloaded in its own callback */
+			if (true == g_is_engine_switching)
+				ecore_timer_add(0, __server_switch_engine_cb, NULL);
+		}
+
+		SLOG(LOG_DEBUG, TAG_TTSD, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSD, "  ");
+		return 0;
+	}
+
+	int uid = utt_get_param->uid;
+	int uttid = utt_get_param->uttid;
+
+	/* stale result of stopped or preempted utterance, other synthesis may be running now */
+	if (utt_get_param != g_synth_utt && NULL == g_list_find(g_ahead_list, utt_get_param)) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[SERVER] Result of canceled utterance : uid(%d), uttid(%d), event(%d)", uid, uttid, event);
+
+		if (TTSP_RESULT_EVENT_FINISH == event || TTSP_RESULT_EVENT_CANCEL == event || TTSP_RESULT_EVENT_FAIL == event) {
+			/* engine releases the canceled utterance */
+			if (0 != utt_get_param->cancel_time)
+				ttsd_stats_add_latency(TTSD_STATS_CANCEL, ttsd_stats_get_time() - utt_get_param->cancel_time);
+
+			__server_free_utterance(utt_get_param);
+		}
+
+		SLOG(LOG_DEBUG, TAG_TTSD, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSD, "  ");
+		return 0;
+	}
+
+	if (utt_get_param != g_synth_utt) {
+		/* text synthesized ahead, its result waits for texts before it */
+		ttsp_audio_type_e audio_type;
+		int rate;
+		int channels;
+
+		if ((TTSP_RESULT_EVENT_START == event || TTSP_RESULT_EVENT_CONTINUE == event || TTSP_RESULT_EVENT_FINISH == event) &&
+		    0 == ttsd_engine_get_audio_format(&audio_type, &rate, &channels)) {
+			if (NULL != utt_get_param->record) {
+				ttsd_cache_record_append(utt_get_param->record, data, data_size, audio_type, rate, channels);
+			}
+
+			utt_get_param->audio_size += data_size;
+			if (TTSP_RESULT_EVENT_FINISH == event)
+				__server_update_estimate(utt_get_param, audio_type, rate, channels);
+
+			sound_data_s temp_data;
+			temp_data.data = __server_take_sound(data, data_size);
+
+			temp_data.data_size = data_size;
+			temp_data.utt_id = utt_get_param->uttid;
+			temp_data.event = event;
+			temp_data.is_cached = false;
+			temp_data.audio_type = audio_type;
+			temp_data.rate = rate;
+			temp_data.channels = channels;
+			temp_data.priority = utt_get_param->sdata.priority;
+
+			__server_keep_sound(utt_get_param, &temp_data);
+		}
+
+		if (TTSP_RESULT_EVENT_FINISH == event || TTSP_RESULT_EVENT_CANCEL == event || TTSP_RESULT_EVENT_FAIL == event) {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[SERVER] Text synthesized ahead is done : uid(%d), uttid(%d), event(%d)", uid, uttid, event);
+
+			ttsd_cache_record_end(utt_get_param->record, TTSP_RESULT_EVENT_FINISH == event);
+			utt_get_param->record = NULL;
+			utt_get_param->is_done = true;
+		}
+
+		SLOG(LOG_DEBUG, TAG_TTSD, "=====");
+		SLOG(LOG_DEBUG, TAG_TTSD, "  ");
+		return 0;
+	}
+
+	/* stream is done, client may open next one */
+	if (true == utt_get_param->sdata.is_stream && (TTSP_RESULT_EVENT_FINISH == event || TTSP_RESULT_EVENT_FAIL == event)) {
+		stream_t* stream = __server_find_stream(uid, uttid);
+		if (NULL != stream)
+			__server_free_stream(stream);
+	}
+
 	/* Synthesis is success */
 	if (TTSP_RESULT_EVENT_START == event || TTSP_RESULT_EVENT_CONTINUE == event || TTSP_RESULT_EVENT_FINISH == event) {
 		
@@ -311,27 +1553,9 @@ int __synthesis_result_callback(ttsp_result_event_e event, const void* data, uns
 		if (TTSP_RESULT_EVENT_CONTINUE == event)	SLOG(LOG_DEBUG, TAG_TTSD, "[SERVER] Event : TTSP_RESULT_EVENT_CONTINUE");
 		if (TTSP_RESULT_EVENT_FINISH == event)		SLOG(LOG_DEBUG, TAG_TTSD, "[SERVER] Event : TTSP_RESULT_EVENT_FINISH");
 
-		if (false == ttsd_data_is_uttid_valid(uid, uttid)) {
-			SLOG(LOG_ERROR, TAG_TTSD, "[SERVER ERROR] uttid is NOT valid !!!! " );
-			SLOG(LOG_DEBUG, TAG_TTSD, "=====");
-			SLOG(LOG_DEBUG, TAG_TTSD, "  ");
-
-			return 0;
-		}
-
-
 		SLOG(LOG_DEBUG, TAG_TTSD, "[SERVER] Result Info : uid(%d), utt(%d), data(%p), data size(%d) ", 
 			uid, uttid, data, data_size);
 
-		/* add wav data */
-		sound_data_s temp_data;
-		temp_data.data = (char*)g_malloc0( sizeof(char) * data_size );
-		memcpy(temp_data.data, data, data_size);
-
-		temp_data.data_size = data_size;
-		temp_data.utt_id = utt_get_param->uttid;
-		temp_data.event = event;
-
 		ttsp_audio_type_e audio_type;
 		int rate;
 		int channels;
@@ -342,46 +1566,276 @@ int __synthesis_result_callback(ttsp_result_event_e event, const void* data, uns
 			SLOG(LOG_DEBUG, TAG_TTSD, "  ");
 			return -1;
 		}
-		
+
+		if (NULL != utt_get_param->record) {
+			ttsd_cache_record_append(utt_get_param->record, data, data_size, audio_type, rate, channels);
+		}
+
+		utt_get_param->audio_size += data_size;
+
+		if (NULL != utt_get_param->job) {
+			/* audio of fragments is added to sound queue after splicing */
+			ttsd_fragment_job_append(utt_get_param->job, data, data_size, audio_type, rate, channels);
+
+			if (TTSP_RESULT_EVENT_FINISH == event) {
+				ttsd_cache_record_end(utt_get_param->record, true);
+				utt_get_param->record = NULL;
+
+				ttsd_fragment_job_splice(utt_get_param->job);
+
+				/* engine may not accept new request in its callback */
+				ecore_timer_add(0, __server_continue_fragment, utt_get_param);
+			}
+
+			SLOG(LOG_DEBUG, TAG_TTSD, "===== SYNTHESIS RESULT CALLBACK END");
+			SLOG(LOG_DEBUG, TAG_TTSD, "  ");
+			return 0;
+		}
+
+		/* add wav data */
+		sound_data_s temp_data;
+		temp_data.data = __server_take_sound(data, data_size);
+
+		temp_data.data_size = data_size;
+		temp_data.utt_id = utt_get_param->uttid;
+		temp_data.event = event;
+		temp_data.is_cached = false;
 		temp_data.audio_type = audio_type;
 		temp_data.rate = rate;
 		temp_data.channels = channels;
+		temp_data.priority = utt_get_param->sdata.priority;
 		
 		if (0 != ttsd_data_add_sound_data(uid, temp_data)) {
 			SLOG(LOG_ERROR, TAG_TTSD, "[SERVER ERROR] Fail to add sound data : uid(%d)", utt_get_param->uid);
+			ttsd_data_release_sound_data(&temp_data);
+		} else if (false == utt_get_param->is_started) {
+			utt_get_param->is_started = true;
+			__server_add_first_audio_latency(&utt_get_param->sdata);
+		}
+
+		if (event == TTSP_RESULT_EVENT_FINISH) {
+			__server_update_estimate(utt_get_param, audio_type, rate, channels);
+			__server_set_is_synthesizing(false);
+
+			g_is_next_synthesis = true;
+		}
+	} 
+	
+	else if (event == TTSP_RESULT_EVENT_CANCEL) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[SERVER] Event : TTSP_RESULT_EVENT_CANCEL");
+		__server_set_is_synthesizing(false);
+
+		g_is_next_synthesis = true;
+	} 
+	
+	else {
+		SLOG(LOG_DEBUG, TAG_TTSD, "[SERVER] Event : etc");
+		
+		__server_set_is_synthesizing(false);
+		
+		g_is_next_synthesis = true;
+	} 
+
+	if (TTSP_RESULT_EVENT_FINISH == event || TTSP_RESULT_EVENT_CANCEL == event || TTSP_RESULT_EVENT_FAIL == event) {
+		if (NULL != utt_get_param) {
+			/* only complete utterance is cached */
+			ttsd_cache_record_end(utt_get_param->record, TTSP_RESULT_EVENT_FINISH == event);
+			utt_get_param->record = NULL;
+			__server_free_utterance(utt_get_param);
+		}
+
+		/* results of next texts are reassembled in order */
+		__server_promote_ahead();
+
+		/* engine is not unloaded in its own callback */
+		if (true == g_is_engine_switching)
+			ecore_timer_add(0, __server_switch_engine_cb, NULL);
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "===== SYNTHESIS RESULT CALLBACK END");
+	SLOG(LOG_DEBUG, TAG_TTSD, "  ");
+
+	return 0;
+}
+
+/*
+* Synthesis watchdog. Deadline of text is estimated synthesis time of the text.
+*/
+
+void __server_arm_watchdog(utterance_t* utt, const char* text)
+{
+	long long now = ttsd_stats_get_time();
+	if (0 == utt->synth_time)
+		utt->synth_time = now;
+
+	int timeout = ttsd_config_get_int_option(TTSD_CONFIG_SYNTHESIS_TIMEOUT_MIN, SYNTHESIS_TIMEOUT_MIN_DEFAULT);
+	if (0 >= timeout) {
+		utt->watchdog_time = 0;
+		return;
+	}
+
+	int margin = ttsd_config_get_int_option(TTSD_CONFIG_SYNTHESIS_TIMEOUT_MARGIN, SYNTHESIS_TIMEOUT_MARGIN_DEFAULT);
+	if (1 > margin)
+		margin = 1;
+
+	int synth_msec = 0;
+	int audio_msec = 0;
+	ttsd_estimate_cost(utt->sdata.lang, utt->sdata.vctype, utt->sdata.speed, text, &synth_msec, &audio_msec);
+
+	utt->watchdog_time = now + timeout + (long long)synth_msec * margin;
+
+	__server_start_watchdog();
+}
+
+/* Estimation is learned from raw audio of whole text, stream waits for text of client */
+void __server_update_estimate(utterance_t* utt, ttsp_audio_type_e audio_type, int rate, int channels)
+{
+	if (true == utt->sdata.is_stream || true == utt->is_batched || TTSP_AUDIO_TYPE_RAW != audio_type || 0 >= rate || 0 >= channels || 0 == utt->audio_size)
+		return;
+
+	long long audio_msec = (long long)utt->audio_size * 1000 / ((long long)rate * channels * 2);
+
+	ttsd_estimate_update(utt->sdata.lang, utt->sdata.vctype, utt->sdata.speed, utt->sdata.text,
+			     ttsd_stats_get_time() - utt->synth_time, audio_msec);
+}
+
+/* Restart hung engine. Old engine is gone with its results, so nothing releases stuck utterances any more. */
+void __server_restart_engine()
+{
+	if (0 != ttsd_engine_agent_restart_engine()) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to restart engine");
+		return;
+	}
+
+	while (NULL != g_stuck_list)
+		__server_free_utterance((utterance_t*)g_stuck_list->data);
+}
+
+/* Engine does not finish the text in time. Its synthesis is canceled or engine is restarted, and the text is failed. */
+void __server_recover_synthesis(utterance_t* utt)
+{
+	int uid = utt->uid;
+	int uttid = utt->uttid;
+	long long now = ttsd_stats_get_time();
+
+	SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Synthesis is timed out : uid(%d), uttid(%d), elapsed(%lld msec)", 
+		uid, uttid, now - utt->synth_time);
+
+	ttsd_stats_increase(TTSD_STATS_SYNTHESIS_TIMEOUT);
+
+	/* result of it is ignored as canceled utterance */
+	utt->cancel_time = now;
+	g_stuck_list = g_list_append(g_stuck_list, utt);
+
+	stream_t* stream = __server_find_stream(uid, uttid);
+	if (NULL != stream)
+		__server_free_stream(stream);
+
+	int ret;
+	if (utt == g_synth_utt) {
+		g_synth_utt = NULL;
+
+		/* texts after it are not at fault, they are synthesized again */
+		__server_cancel_ahead(true);
+		ttsd_data_remove_sound_data(uid, uttid);
+
+		__server_set_is_synthesizing(false);
+		ret = ttsd_engine_cancel_synthesis();
+	} else {
+		g_ahead_list = g_list_remove(g_ahead_list, utt);
+
+		if (NULL != g_synth_utt) {
+			/* engine is canceled as a whole, current text is synthesized again */
+			__server_cancel_synthesis(g_synth_utt->uid, true);
+			ret = 0;
+		} else {
+			__server_set_is_synthesizing(false);
+			ret = ttsd_engine_cancel_synthesis();
 		}
+	}
+
+	/* engine which answers to cancel releases the utterance, maybe later in its thread */
+	if (0 != ret)
+		__server_restart_engine();
+	else if (NULL != g_list_find(g_stuck_list, utt))
+		g_recovering_utt = utt;
+
+	__server_send_error(uid, uttid, TTSD_ERROR_SYNTHESIS_TIMED_OUT);
+
+	if (true == g_is_engine_switching)
+		ecore_timer_add(0, __server_switch_engine_cb, NULL);
 
-		if (event == TTSP_RESULT_EVENT_FINISH) {
-			__server_set_is_synthesizing(false);
+	g_is_next_synthesis = true;
+	if (NULL == g_timer)
+		g_timer = ecore_timer_add(0, __start_next_synthesis, NULL);
+}
+
+bool __server_is_overdue(const utterance_t* utt, long long now)
+{
+	return (false == utt->is_done && 0 != utt->watchdog_time && now > utt->watchdog_time);
+}
+
+Eina_Bool __server_watchdog_cb(void *data)
+{
+	long long now = ttsd_stats_get_time();
+
+	if (true == g_is_warming_up) {
+		int timeout = ttsd_config_get_int_option(TTSD_CONFIG_SYNTHESIS_TIMEOUT_MIN, SYNTHESIS_TIMEOUT_MIN_DEFAULT);
+
+		if (0 < timeout && now - g_warm_up_time > timeout) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Warm-up synthesis is timed out");
+			ttsd_stats_increase(TTSD_STATS_SYNTHESIS_TIMEOUT);
+
+			__server_cancel_warm_up();
+			__server_restart_engine();
 
 			g_is_next_synthesis = true;
 		}
-	} 
-	
-	else if (event == TTSP_RESULT_EVENT_CANCEL) {
-		SLOG(LOG_DEBUG, TAG_TTSD, "[SERVER] Event : TTSP_RESULT_EVENT_CANCEL");
-		__server_set_is_synthesizing(false);
+		return EINA_TRUE;
+	}
+
+	/* cancel of timed-out text did not take effect, texts started after it are synthesized again after restart */
+	if (NULL != g_recovering_utt) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Engine does not release canceled text : uid(%d), uttid(%d)",
+			g_recovering_utt->uid, g_recovering_utt->uttid);
+		g_recovering_utt = NULL;
+
+		if (NULL != g_synth_utt)
+			__server_cancel_synthesis(g_synth_utt->uid, true);
+		__server_restart_engine();
 
 		g_is_next_synthesis = true;
-	} 
-	
-	else {
-		SLOG(LOG_DEBUG, TAG_TTSD, "[SERVER] Event : etc");
-		
-		__server_set_is_synthesizing(false);
-		
-		g_is_next_synthesis = true;
-	} 
+		if (NULL == g_timer)
+			g_timer = ecore_timer_add(0, __start_next_synthesis, NULL);
+	}
 
-	if (TTSP_RESULT_EVENT_FINISH == event || TTSP_RESULT_EVENT_CANCEL == event || TTSP_RESULT_EVENT_FAIL == event) {
-		if (NULL != utt_get_param)		
-			free(utt_get_param);
+	utterance_t* stuck = NULL;
+	if (NULL != g_synth_utt && true == __server_is_overdue(g_synth_utt, now))
+		stuck = g_synth_utt;
+
+	GList* iter = g_list_first(g_ahead_list);
+	while (NULL == stuck && NULL != iter) {
+		if (true == __server_is_overdue((utterance_t*)iter->data, now))
+			stuck = (utterance_t*)iter->data;
+		iter = g_list_next(iter);
 	}
 
-	SLOG(LOG_DEBUG, TAG_TTSD, "===== SYNTHESIS RESULT CALLBACK END");
-	SLOG(LOG_DEBUG, TAG_TTSD, "  ");
+	if (NULL != stuck)
+		__server_recover_synthesis(stuck);
 
-	return 0;
+	/* timer is stopped while engine is idle */
+	if (NULL == g_synth_utt && NULL == g_ahead_list && NULL == g_recovering_utt && false == g_is_warming_up) {
+		g_watchdog_timer = NULL;
+		return EINA_FALSE;
+	}
+
+	return EINA_TRUE;
+}
+
+void __server_start_watchdog()
+{
+	if (NULL == g_watchdog_timer)
+		g_watchdog_timer = ecore_timer_add(WATCHDOG_INTERVAL, __server_watchdog_cb, NULL);
 }
 
 /*
@@ -394,6 +1848,12 @@ int ttsd_initialize()
 		SLOG(LOG_ERROR, TAG_TTSD, "[Server WARNING] Fail to initialize config.");
 	}
 
+	ttsd_stats_initialize();
+	ttsd_stats_set_target(TTSD_STATS_FIRST_AUDIO_LOW, ttsd_config_get_int_option(TTSD_CONFIG_LATENCY_TARGET_LOW, 3000));
+	ttsd_stats_set_target(TTSD_STATS_FIRST_AUDIO_NORMAL, ttsd_config_get_int_option(TTSD_CONFIG_LATENCY_TARGET_NORMAL, 1000));
+	ttsd_stats_set_target(TTSD_STATS_FIRST_AUDIO_HIGH, ttsd_config_get_int_option(TTSD_CONFIG_LATENCY_TARGET_HIGH, 300));
+	ttsd_stats_set_target(TTSD_STATS_FIRST_AUDIO_CRITICAL, ttsd_config_get_int_option(TTSD_CONFIG_LATENCY_TARGET_CRITICAL, 100));
+
 	/* player init */
 	if (ttsd_player_init(__player_result_callback)) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to initialize player init.");
@@ -415,31 +1875,82 @@ int ttsd_initialize()
 
 	g_timer = NULL;
 
+	/* idle engine is unloaded when memory is low */
+	if (0 != vconf_notify_key_changed(VCONFKEY_SYSMAN_LOW_MEMORY, __server_low_memory_cb, NULL))
+		SLOG(LOG_WARN, TAG_TTSD, "[Server WARNING] Fail to watch low memory status");
+
 	return TTSD_ERROR_NONE;
 }
 
 
+/* Client list is not changed while foreach, clients are removed after it */
+typedef struct {
+	int pid;
+	int uid;
+} client_id_s;
+
 bool __get_client_for_clean_up(int pid, int uid, app_state_e state, void* user_data)
 {
-	int result = 1;
-
-	result = ttsdc_send_hello(pid, uid);
+	GList** clients = (GList**)user_data;
 
-	if (0 == result) {
-		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] uid(%d) should be removed.", uid); 
-		ttsd_server_finalize(uid);
-	} else if (-1 == result) {
-		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Hello result has error"); 
-	}
+	client_id_s* client = (client_id_s*)g_malloc0(sizeof(client_id_s));
+	client->pid = pid;
+	client->uid = uid;
+	*clients = g_list_append(*clients, client);
 
 	return true;
 }
 
+int ttsd_server_remove_process(int pid)
+{
+	GList* clients = NULL;
+	ttsd_data_foreach_clients(__get_client_for_clean_up, &clients);
+
+	GList* iter = g_list_first(clients);
+	while (NULL != iter) {
+		client_id_s* client = (client_id_s*)iter->data;
+		if (pid == client->pid) {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Client of dead process is removed : pid(%d), uid(%d)", pid, client->uid);
+			ttsd_server_finalize(client->uid);
+		}
+		g_free(client);
+		iter = g_list_next(iter);
+	}
+	g_list_free(clients);
+
+	return TTSD_ERROR_NONE;
+}
 
 Eina_Bool ttsd_cleanup_client(void *data)
 {
 	SLOG(LOG_DEBUG, TAG_TTSD, "===== CLEAN UP CLIENT START");
-	ttsd_data_foreach_clients(__get_client_for_clean_up, NULL);
+
+	GList* clients = NULL;
+	ttsd_data_foreach_clients(__get_client_for_clean_up, &clients);
+
+	/* dead process is found without bus, alive one is asked asynchronously */
+	GList* iter = g_list_first(clients);
+	while (NULL != iter) {
+		client_id_s* client = (client_id_s*)iter->data;
+
+		if (0 != kill(client->pid, 0) && ESRCH == errno) {
+			SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Process of uid(%d) is gone.", client->uid);
+			ttsd_server_finalize(client->uid);
+		} else {
+			int result = ttsdc_send_hello(client->pid, client->uid);
+			if (0 == result) {
+				SLOG(LOG_DEBUG, TAG_TTSD, "[Server] uid(%d) should be removed.", client->uid);
+				ttsd_server_finalize(client->uid);
+			} else if (-1 == result) {
+				SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Hello result has error");
+			}
+		}
+
+		g_free(client);
+		iter = g_list_next(iter);
+	}
+	g_list_free(clients);
+
 	SLOG(LOG_DEBUG, TAG_TTSD, "=====");
 	SLOG(LOG_DEBUG, TAG_TTSD, "  ");
 
@@ -469,7 +1980,7 @@ int ttsd_server_initialize(int pid, int uid)
 	}
 
 	if (0 == ttsd_data_get_client_count()) {
-		if (0 != ttsd_engine_agent_load_current_engine()) {
+		if (0 != __server_load_engine()) {
 			SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to load current engine ");
 			return TTSD_ERROR_OPERATION_FAILED;
 		}
@@ -501,21 +2012,25 @@ int ttsd_server_finalize(int uid)
 	
 	ttsd_player_destroy_instance(uid);
 
+	ttsd_fragment_remove_templates(uid);
 	ttsd_data_delete_client(uid);
 
-	/* unload engine, if ref count of client is 0 */
+	/* release engine, if ref count of client is 0 */
 	if (0 == ttsd_data_get_client_count()) {
-		if (0 != ttsd_engine_agent_unload_current_engine()) {
-			SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] fail to unload current engine ");
-		} else {
-			SLOG(LOG_DEBUG, TAG_TTSD, "[Server SUCCESS] unload current engine ");
-		}
+		__server_release_engine();
 	}
 
 	return TTSD_ERROR_NONE;
 }
 
-int ttsd_server_add_queue(int uid, const char* text, const char* lang, int voice_type, int speed, int utt_id)
+bool __server_add_queued_audio(int uid, speak_data_s* data, void* user_data)
+{
+	*(long long*)user_data += data->audio_estimate;
+	return true;
+}
+
+int ttsd_server_add_queue(int uid, const char* text, const char* lang, int voice_type, int speed, int utt_id, int priority,
+			  int deadline, int max_staleness)
 {
 	app_state_e state;
 	if (0 > ttsd_data_get_client_state(uid, &state)) {
@@ -523,17 +2038,42 @@ int ttsd_server_add_queue(int uid, const char* text, const char* lang, int voice
 		return TTSD_ERROR_INVALID_PARAMETER;
 	}
 
+	if (TTS_PRIORITY_CLIENT_DEFAULT == priority) {
+		ttsd_data_get_client_priority(uid, &priority);
+	} else if (TTSD_PRIORITY_LOW > priority || TTSD_PRIORITY_CRITICAL < priority) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] ttsd_server_add_queue : priority(%d) is not valid  ", priority);
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	if (0 > deadline || 0 > max_staleness) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] ttsd_server_add_queue : deadline(%d) or staleness(%d) is not valid  ", deadline, max_staleness);
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
 	/* check valid voice */
-	char* temp_lang = NULL;
+	const char* temp_lang = NULL;
 	ttsp_voice_type_e temp_type;
 	if (true != ttsd_engine_select_valid_voice((const char*)lang, (const ttsp_voice_type_e)voice_type, &temp_lang, &temp_type)) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to select valid voice ");
 		return TTSD_ERROR_INVALID_VOICE;
-	} else {		
-		if (NULL == temp_lang)
-			free(temp_lang);
 	}
 	
+	/* queue of client is limited by time to speak it, critical text is always accepted */
+	int synth_msec = 0;
+	int audio_msec = 0;
+	ttsd_estimate_cost(lang, voice_type, speed, text, &synth_msec, &audio_msec);
+
+	int queue_max = ttsd_config_get_int_option(TTSD_CONFIG_QUEUE_AUDIO_MAX, 0);
+	if (0 < queue_max && TTSD_PRIORITY_CRITICAL > priority) {
+		long long queued = 0;
+		ttsd_data_foreach_speak_data(uid, __server_add_queued_audio, &queued);
+
+		if (0 < queued && queued + audio_msec > queue_max) {
+			SLOG(LOG_WARN, TAG_TTSD, "[Server WARNING] Queue is full : uid(%d), queued(%lld msec), text(%d msec)", uid, queued, audio_msec);
+			return TTSD_ERROR_QUEUE_FULL;
+		}
+	}
+
 	speak_data_s data;
 
 	data.lang = strdup(lang);
@@ -541,8 +2081,24 @@ int ttsd_server_add_queue(int uid, const char* text, const char* lang, int voice
 
 	data.speed = (ttsp_speed_e)speed;
 	data.utt_id = utt_id;
+	data.priority = priority;
+	data.audio_estimate = audio_msec;
+	data.enqueue_time = ttsd_stats_get_time();
+
+	/* client sends relative time, because clock of client may be different */
+	data.deadline = (0 < deadline) ? data.enqueue_time + deadline : 0;
+	data.expire_time = (0 < max_staleness) ? data.enqueue_time + max_staleness : 0;
 		
 	data.text = strdup(text);
+	data.is_stream = false;
+
+	return __server_enqueue(uid, state, &data);
+}
+
+/* Add text to queue of client, and start synthesis if client is playing */
+int __server_enqueue(int uid, app_state_e state, const speak_data_s* sdata)
+{
+	speak_data_s data = *sdata;
 
 	/* if state is APP_STATE_READY , APP_STATE_PAUSED , only need to add speak data to queue*/
 	if (0 != ttsd_data_add_speak_data(uid, data)) {
@@ -559,13 +2115,145 @@ int ttsd_server_add_queue(int uid, const char* text, const char* lang, int voice
 			}
 		}
 
+		/* text of higher priority or earlier deadline does not wait for synthesis of other text */
+		if (NULL != g_synth_utt && uid == g_synth_utt->uid && true == ttsd_data_is_prior(&data, &g_synth_utt->sdata)) {
+			__server_cancel_synthesis(uid, true);
+		}
+
 		/* mode 2 for add text */
 		if (0 != __server_start_synthesis(uid, 2)) {
 			SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] fail to schedule synthesis : uid(%d)", uid);
 			return TTSD_ERROR_OPERATION_FAILED;
 		}
+	} else if (true == ttsd_data_is_preempted(uid)) {
+		/* the waiting client may be higher than current one now */
+		__server_schedule();
+	}
+
+	return TTSD_ERROR_NONE;
+}
+
+int ttsd_server_open_stream(int uid, const char* lang, int voice_type, int speed, int utt_id)
+{
+	app_state_e state;
+	if (0 > ttsd_data_get_client_state(uid, &state)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] ttsd_server_open_stream : uid is not valid  ");
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	if (NULL != __server_find_open_stream(uid)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Stream of client is already opened : uid(%d)", uid);
+		return TTSD_ERROR_INVALID_STATE;
+	}
+
+	const char* temp_lang = NULL;
+	ttsp_voice_type_e temp_type;
+	if (true != ttsd_engine_select_valid_voice(lang, voice_type, &temp_lang, &temp_type)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to select valid voice ");
+		return TTSD_ERROR_INVALID_VOICE;
+	}
+
+	stream_t* stream = (stream_t*)g_malloc0(sizeof(stream_t));
+	stream->uid = uid;
+	stream->utt_id = utt_id;
+	stream->text = g_string_new(NULL);
+	g_stream_list = g_list_append(g_stream_list, stream);
+
+	/* stream waits in queue like other text, and its text is given to engine when it is synthesized */
+	speak_data_s data;
+	data.lang = strdup(lang);
+	data.vctype = (ttsp_voice_type_e)voice_type;
+	data.speed = (ttsp_speed_e)speed;
+	data.utt_id = utt_id;
+	ttsd_data_get_client_priority(uid, &data.priority);
+	data.enqueue_time = ttsd_stats_get_time();
+	data.deadline = 0;
+	data.expire_time = 0;
+	data.text = strdup("");
+	data.is_stream = true;
+	data.audio_estimate = 0;
+
+	int ret = __server_enqueue(uid, state, &data);
+	if (0 != ret) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to add stream : uid(%d), result(%d)", uid, ret);
+		stream = __server_find_stream(uid, utt_id);
+		if (NULL != stream)
+			__server_free_stream(stream);
+	}
+
+	return ret;
+}
+
+int ttsd_server_push_stream(int uid, const char* text)
+{
+	stream_t* stream = __server_find_open_stream(uid);
+	if (NULL == stream) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Stream of client is not opened : uid(%d)", uid);
+		return TTSD_ERROR_INVALID_STATE;
+	}
+
+	g_string_append(stream->text, text);
+
+	/* engine gets more time for new text */
+	if (NULL != stream->utt)
+		__server_arm_watchdog(stream->utt, stream->text->str);
+
+	if (0 != __server_feed_stream(stream)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to push text to engine : uid(%d)", uid);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	return TTSD_ERROR_NONE;
+}
+
+int ttsd_server_close_stream(int uid)
+{
+	stream_t* stream = __server_find_open_stream(uid);
+	if (NULL == stream) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Stream of client is not opened : uid(%d)", uid);
+		return TTSD_ERROR_INVALID_STATE;
+	}
+
+	stream->is_closed = true;
+
+	if (0 != __server_feed_stream(stream)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to close stream of engine : uid(%d)", uid);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	return TTSD_ERROR_NONE;
+}
+
+int ttsd_server_add_template(int uid, const char* text_template)
+{
+	app_state_e state;
+	if (0 > ttsd_data_get_client_state(uid, &state)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] ttsd_server_add_template : uid is not valid  ");
+		return TTSD_ERROR_INVALID_PARAMETER;
 	}
 
+	return ttsd_fragment_add_template(uid, text_template);
+}
+
+int ttsd_server_set_priority(int uid, int priority)
+{
+	app_state_e state;
+	if (0 > ttsd_data_get_client_state(uid, &state)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] ttsd_server_set_priority : uid is not valid  ");
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	if (TTSD_PRIORITY_LOW > priority || TTSD_PRIORITY_CRITICAL < priority) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] ttsd_server_set_priority : priority(%d) is not valid  ", priority);
+		return TTSD_ERROR_INVALID_PARAMETER;
+	}
+
+	ttsd_data_set_client_priority(uid, priority);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Set priority : uid(%d), priority(%d)", uid, priority);
+
+	__server_schedule();
+
 	return TTSD_ERROR_NONE;
 }
 
@@ -582,6 +2270,148 @@ Eina_Bool __send_interrupt_client(void *data)
 	return EINA_FALSE;
 }
 
+Eina_Bool __send_resume_client(void *data)
+{
+	int* uid = (int*)data;
+	
+	if (NULL != uid) {
+		int pid = ttsd_data_get_pid(*uid);
+		/* send message to client about changing state */
+		ttsdc_send_set_state_message (pid, *uid, APP_STATE_PLAYING);
+		free(uid);
+	}
+	return EINA_FALSE;
+}
+
+/* Priority of client including text being synthesized */
+int __server_get_priority(int uid)
+{
+	int priority = ttsd_data_get_effective_priority(uid);
+
+	if (NULL != g_synth_utt && uid == g_synth_utt->uid && g_synth_utt->sdata.priority > priority)
+		priority = g_synth_utt->sdata.priority;
+
+	return priority;
+}
+
+/* Deadline of client including text being synthesized. 0 if none */
+long long __server_get_deadline(int uid)
+{
+	long long deadline = ttsd_data_get_deadline(uid);
+
+	if (NULL != g_synth_utt && uid == g_synth_utt->uid && 0 != g_synth_utt->sdata.deadline &&
+	    g_synth_utt->sdata.priority == __server_get_priority(uid) && (0 == deadline || g_synth_utt->sdata.deadline < deadline))
+		deadline = g_synth_utt->sdata.deadline;
+
+	return deadline;
+}
+
+/* Check whether client a goes before client b : higher priority, then earlier deadline */
+bool __server_is_prior_client(int a, int b)
+{
+	int priority_a = __server_get_priority(a);
+	int priority_b = __server_get_priority(b);
+
+	if (priority_a != priority_b)
+		return priority_a > priority_b;
+
+	long long deadline_a = __server_get_deadline(a);
+	long long deadline_b = __server_get_deadline(b);
+
+	if (0 == deadline_a)
+		return false;
+
+	return (0 == deadline_b || deadline_a < deadline_b);
+}
+
+/* Check whether client has something to synthesize or play */
+bool __server_is_busy(int uid)
+{
+	if (0 < ttsd_data_get_speak_data_size(uid) || 0 < ttsd_data_get_sound_data_size(uid))
+		return true;
+
+	if (NULL != g_synth_utt && uid == g_synth_utt->uid)
+		return true;
+
+	if (uid == ttsd_player_get_current_client())
+		return true;
+
+	return false;
+}
+
+/* Pause the playing client for higher priority. It is resumed by daemon later. */
+void __server_preempt_client(int uid)
+{
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Server] uid(%d) is preempted ", uid);
+
+	if (0 != ttsd_player_pause(uid)) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Server WARNING] fail to ttsd_player_pause() : uid (%d)", uid);
+	}
+
+	__server_cancel_synthesis(uid, true);
+
+	ttsd_data_set_client_state(uid, APP_STATE_PAUSED);
+	ttsd_data_set_preempted(uid, true);
+
+	int* temp_uid = (int*)malloc(sizeof(int));
+	*temp_uid = uid;
+	ecore_timer_add(0, __send_interrupt_client, temp_uid);
+}
+
+int __server_resume_client(int uid)
+{
+	SLOG(LOG_DEBUG, TAG_TTSD, "[Server] uid(%d) is resumed ", uid);
+
+	ttsd_data_set_preempted(uid, false);
+
+	if (0 != ttsd_data_set_client_state(uid, APP_STATE_PLAYING)) {
+		SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to set state : uid(%d)", uid);
+		return TTSD_ERROR_OPERATION_FAILED;
+	}
+
+	int* temp_uid = (int*)malloc(sizeof(int));
+	*temp_uid = uid;
+	ecore_timer_add(0, __send_resume_client, temp_uid);
+
+	if (0 != __server_play_internal(uid, APP_STATE_PAUSED)) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Server WARNING] Fail to start synthesis : uid(%d)", uid);
+	}
+
+	/* play sound queued before preemption */
+	ttsd_player_play(uid);
+
+	if (NULL == g_timer)
+		g_timer = ecore_timer_add(0, __start_next_synthesis, NULL);
+
+	return TTSD_ERROR_NONE;
+}
+
+/* Give player to the preempted client, if current client is idle or lower priority */
+int __server_schedule()
+{
+	int uid = ttsd_data_get_preempted_client();
+	if (0 > uid) {
+		return 0;
+	}
+
+	int current_uid = ttsd_data_get_current_playing();
+
+	if (-1 != current_uid) {
+		if (true == __server_is_busy(current_uid)) {
+			if (false == __server_is_prior_client(uid, current_uid))
+				return 0;
+		} else {
+			/* idle client does not give player to another idle client */
+			if (false == __server_is_busy(uid))
+				return 0;
+		}
+
+		__server_preempt_client(current_uid);
+	}
+
+	return __server_resume_client(uid);
+}
+
 int ttsd_server_play(int uid)
 {
 	app_state_e state;
@@ -603,23 +2433,40 @@ int ttsd_server_play(int uid)
 		}
 	}
 
+	/* play is requested again by client which is waiting */
+	ttsd_data_set_preempted(uid, false);
+
 	int current_uid = ttsd_data_get_current_playing();
 
 	if (uid != current_uid && -1 != current_uid) {
-		/* Send interrupt message */
-		SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Old uid(%d) will be interrupted into 'Pause' state ", current_uid);
+		if (true == __server_is_prior_client(current_uid, uid) && true == __server_is_busy(current_uid)) {
+			/* client looks playing, and starts after higher priority or earlier deadline client */
+			SLOG(LOG_DEBUG, TAG_TTSD, "[Server] uid(%d) waits for higher priority uid(%d) ", uid, current_uid);
 
-		/* pause player */
-		if (0 != ttsd_player_pause(current_uid)) {
-			SLOG(LOG_WARN, TAG_TTSD, "[Server ERROR] fail to ttsd_player_pause() : uid (%d)", current_uid);
-		} 
+			ttsd_data_set_client_state(uid, APP_STATE_PAUSED);
+			ttsd_data_set_preempted(uid, true);
+			return TTSD_ERROR_NONE;
+		}
+
+		if (true == __server_is_prior_client(uid, current_uid)) {
+			/* old client is resumed after this client */
+			__server_preempt_client(current_uid);
+		} else {
+			/* Send interrupt message */
+			SLOG(LOG_DEBUG, TAG_TTSD, "[Server] Old uid(%d) will be interrupted into 'Pause' state ", current_uid);
 
-		/* change state */
-		ttsd_data_set_client_state(current_uid, APP_STATE_PAUSED);
+			/* pause player */
+			if (0 != ttsd_player_pause(current_uid)) {
+				SLOG(LOG_WARN, TAG_TTSD, "[Server ERROR] fail to ttsd_player_pause() : uid (%d)", current_uid);
+			} 
 
-		int* temp_uid = (int*)malloc(sizeof(int));
-		*temp_uid = current_uid;
-		ecore_timer_add(0, __send_interrupt_client, temp_uid);
+			/* change state */
+			ttsd_data_set_client_state(current_uid, APP_STATE_PAUSED);
+
+			int* temp_uid = (int*)malloc(sizeof(int));
+			*temp_uid = current_uid;
+			ecore_timer_add(0, __send_interrupt_client, temp_uid);
+		}
 	}
 	
 	/* Change current play */
@@ -634,7 +2481,7 @@ int ttsd_server_play(int uid)
 	}
 
 	if (NULL == g_timer)
-		ecore_timer_add(0, __start_next_synthesis, NULL);
+		g_timer = ecore_timer_add(0, __start_next_synthesis, NULL);
 
 	return TTSD_ERROR_NONE;
 }
@@ -648,8 +2495,14 @@ int ttsd_server_stop(int uid)
 		return TTSD_ERROR_INVALID_PARAMETER;
 	}
 
-	/* Reset all data */
+	long long start_time = ttsd_stats_get_time();
+	bool is_synthesizing = (NULL != g_synth_utt && uid == g_synth_utt->uid);
+
+	/* Reset all data. Synthesis of the client becomes stale. */
 	ttsd_data_clear_data(uid);
+	__server_remove_streams(uid);
+	ttsd_data_set_preempted(uid, false);
+	__server_cancel_stale_synthesis();
 
 	if (APP_STATE_PLAYING == state || APP_STATE_PAUSED == state) {
 		ttsd_data_set_client_state(uid, APP_STATE_READY);
@@ -657,16 +2510,12 @@ int ttsd_server_stop(int uid)
 		if (0 != ttsd_player_stop(uid)) 
 			SLOG(LOG_WARN, TAG_TTSD, "[Server] Fail to ttsd_player_stop()");
 
-		if (true == __server_get_current_synthesis()) {
-			SLOG(LOG_DEBUG, TAG_TTSD, "[Server] TTS-engine is running ");
-
-			int ret = 0;
-			ret = ttsd_engine_cancel_synthesis();
-			if (0 != ret)
-				SLOG(LOG_ERROR, TAG_TTSD, "[Server ERROR] Fail to cancel synthesis : ret(%d)", ret);
+		/* latency of canceled synthesis is recorded when engine releases it */
+		if (false == is_synthesizing)
+			ttsd_stats_add_latency(TTSD_STATS_CANCEL, ttsd_stats_get_time() - start_time);
 
-			__server_set_is_synthesizing(false);
-		} 
+		if (APP_STATE_PLAYING == state)
+			__server_schedule();
 	} else {
 		SLOG(LOG_WARN, TAG_TTSD, "[Server WARNING] Current state is 'ready' ");
 	}
@@ -682,6 +2531,12 @@ int ttsd_server_pause(int uid, int* utt_id)
 		return TTSD_ERROR_INVALID_PARAMETER;
 	}
 
+	if (APP_STATE_PAUSED == state && true == ttsd_data_is_preempted(uid)) {
+		/* client looks playing while waiting, it is not resumed by daemon any more */
+		ttsd_data_set_preempted(uid, false);
+		return TTSD_ERROR_NONE;
+	}
+
 	if (APP_STATE_PLAYING != state)	{
 		SLOG(LOG_WARN, TAG_TTSD, "[Server WARNING] Current state is not 'play' ");
 		return TTSD_ERROR_INVALID_STATE;
@@ -696,6 +2551,9 @@ int ttsd_server_pause(int uid, int* utt_id)
 
 	ttsd_data_set_client_state(uid, APP_STATE_PAUSED);
 
+	/* client waiting for this client can play */
+	__server_schedule();
+
 	return TTSD_ERROR_NONE;
 }
 
@@ -761,7 +2619,7 @@ int ttsd_server_setting_initialize(int uid)
 	}
 
 	if (0 == ttsd_data_get_client_count()) {
-		if( 0 != ttsd_engine_agent_load_current_engine() ) {
+		if( 0 != __server_load_engine() ) {
 			SLOG(LOG_ERROR, TAG_TTSD, "[Server Setting ERROR] Fail to load current engine ");
 			return TTSD_ERROR_OPERATION_FAILED;
 		}
@@ -785,13 +2643,10 @@ int ttsd_server_setting_finalize(int uid)
 
 	ttsd_setting_data_delete(uid);
 
-	/* unload engine, if ref count of client is 0 */
+	/* release engine, if ref count of client is 0 */
 	if (0 == ttsd_data_get_client_count())
 	{
-		if (0 != ttsd_engine_agent_unload_current_engine()) 
-			SLOG(LOG_ERROR, TAG_TTSD, "[Server Setting ERROR] fail to unload current engine ");
-		else
-			SLOG(LOG_DEBUG, TAG_TTSD, "[Server Setting SUCCESS] unload current engine ");
+		__server_release_engine();
 	}
 
 	return TTSD_ERROR_NONE;
@@ -836,12 +2691,16 @@ bool __get_client_cb(int pid, int uid, app_state_e state, void* user_data)
 {
 	/* clear client data */
 	ttsd_data_clear_data(uid);			
+	__server_remove_streams(uid);
 	ttsd_data_set_client_state(uid, APP_STATE_READY);
+	__server_cancel_stale_synthesis();
 
 	/* send message */
 	if ( 0 != ttsdc_send_set_state_message(pid, uid, APP_STATE_READY)) {
 		/* remove client */
+		ttsd_fragment_remove_templates(uid);
 		ttsd_data_delete_client(uid);
+		__server_cancel_stale_synthesis();
 	} 
 
 	return true;
@@ -860,14 +2719,32 @@ int ttsd_server_setting_set_current_engine(int uid, const char* engine_id)
 		return TTSD_ERROR_NONE;
 	}
 
+	int ret = 0;
+
+	/* load new engine in background, clients keep working with current engine */
+	if (true == ttsd_engine_agent_is_loaded()) {
+		ret = ttsd_engine_agent_prepare_engine(engine_id, __server_engine_prepared_cb);
+		if (0 == ret) {
+			return TTSD_ERROR_NONE;
+		} else if (TTSD_ERROR_OPERATION_FAILED != ret) {
+			SLOG(LOG_ERROR, TAG_TTSD, "[Server Setting ERROR] fail to set current engine : result(%d) ", ret);
+			return ret;
+		}
+
+		SLOG(LOG_WARN, TAG_TTSD, "[Server Setting WARNING] Fail to load engine in background, stop all clients");
+	}
+
 	/* stop all player */ 
 	ttsd_player_all_stop();
 
 	/* send interrupt message to  all clients */
 	ttsd_data_foreach_clients(__get_client_cb, NULL);
 
+	__server_cancel_warm_up();
+	g_is_engine_switching = false;
+	ttsd_engine_agent_cancel_next_engine();
+
 	/* set engine */
-	int ret = 0;
 	ret = ttsd_engine_setting_set_engine(engine_id);
 	if (0 != ret) {
 		SLOG(LOG_ERROR, TAG_TTSD, "[Server Setting ERROR] fail to set current engine : result(%d) ", ret);
@@ -39,11 +39,25 @@ int ttsd_server_initialize(int pid, int uid);
 
 int ttsd_server_finalize(int uid);
 
+/** Remove all clients of process which is gone */
+int ttsd_server_remove_process(int pid);
+
 int ttsd_server_get_support_voices(int uid, GList** voice_list);
 
 int ttsd_server_get_current_voice(int uid, char** language, int* voice_type);
 
-int ttsd_server_add_queue(int uid, const char* text, const char* lang, int voice_type, int speed, int utt_id);
+int ttsd_server_add_queue(int uid, const char* text, const char* lang, int voice_type, int speed, int utt_id, int priority,
+			  int deadline, int max_staleness);
+
+int ttsd_server_add_template(int uid, const char* text_template);
+
+int ttsd_server_open_stream(int uid, const char* lang, int voice_type, int speed, int utt_id);
+
+int ttsd_server_push_stream(int uid, const char* text);
+
+int ttsd_server_close_stream(int uid);
+
+int ttsd_server_set_priority(int uid, int priority);
 
 int ttsd_server_play(int uid);
 
@@ -0,0 +1,243 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#include <time.h>
+#include <Ecore.h>
+
+#include "ttsd_main.h"
+#include "ttsd_stats.h"
+#include "ttsd_resource.h"
+
+#define STATS_FILE_PATH		BASE_DIRECTORY_DOWNLOAD"ttsd_stats.txt"
+#define STATS_DUMP_INTERVAL	60.0
+
+/* Upper bound of histogram buckets in msec. The last bucket has no bound. */
+static const int g_bucket_bound[] = {10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+
+#define STATS_BUCKET_COUNT	(int)(sizeof(g_bucket_bound) / sizeof(g_bucket_bound[0]) + 1)
+
+typedef struct {
+	const char*	name;
+	int		target;
+	long long	count;
+	long long	sum;
+	long long	max;
+	long long	over_target;
+	long long	bucket[STATS_BUCKET_COUNT];
+} stats_latency_s;
+
+static stats_latency_s g_latency[TTSD_STATS_LATENCY_COUNT] = {
+	{"first_audio_low", 0, },
+	{"first_audio_normal", 0, },
+	{"first_audio_high", 0, },
+	{"first_audio_critical", 0, },
+	{"cancel", 0, },
+	{"engine_load", 0, },
+	{"engine_unload", 0, },
+	{"engine_warm_up", 0, },
+	{"hybrid_network", 0, },
+	{"hybrid_local", 0, },
+};
+
+static const char* g_counter_name[TTSD_STATS_COUNTER_COUNT] = {
+	"preemption",
+	"expired",
+	"deadline_miss",
+	"engine_reuse",
+	"engine_restart",
+	"synthesis_timeout",
+	"hybrid_failover",
+};
+
+static long long g_counter[TTSD_STATS_COUNTER_COUNT];
+
+static bool g_is_dirty = false;
+
+static Ecore_Timer* g_dump_timer = NULL;
+
+
+static Eina_Bool __stats_dump_timer_cb(void *data)
+{
+	if (true == g_is_dirty) {
+		ttsd_stats_dump();
+	}
+
+	return EINA_TRUE;
+}
+
+/* Percentile is estimated by the upper bound of bucket */
+static long long __stats_get_percentile(const stats_latency_s* latency, int percent)
+{
+	if (0 == latency->count)
+		return 0;
+
+	long long rank = (latency->count * percent + 99) / 100;
+	long long acc = 0;
+	int i;
+
+	for (i = 0; i < STATS_BUCKET_COUNT - 1; i++) {
+		acc += latency->bucket[i];
+		if (acc >= rank)
+			return (g_bucket_bound[i] < latency->max) ? g_bucket_bound[i] : latency->max;
+	}
+
+	return latency->max;
+}
+
+int ttsd_stats_initialize()
+{
+	int i;
+	for (i = 0; i < TTSD_STATS_LATENCY_COUNT; i++) {
+		stats_latency_s* latency = &g_latency[i];
+		latency->count = 0;
+		latency->sum = 0;
+		latency->max = 0;
+		latency->over_target = 0;
+		memset(latency->bucket, 0, sizeof(latency->bucket));
+	}
+
+	memset(g_counter, 0, sizeof(g_counter));
+	g_is_dirty = false;
+
+	if (NULL == g_dump_timer)
+		g_dump_timer = ecore_timer_add(STATS_DUMP_INTERVAL, __stats_dump_timer_cb, NULL);
+
+	return 0;
+}
+
+int ttsd_stats_finalize()
+{
+	if (NULL != g_dump_timer) {
+		ecore_timer_del(g_dump_timer);
+		g_dump_timer = NULL;
+	}
+
+	if (true == g_is_dirty)
+		ttsd_stats_dump();
+
+	return 0;
+}
+
+long long ttsd_stats_get_time()
+{
+	struct timespec now;
+	if (0 != clock_gettime(CLOCK_MONOTONIC, &now))
+		return 0;
+
+	return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+int ttsd_stats_set_target(ttsd_stats_latency_e type, int msec)
+{
+	if (type < 0 || type >= TTSD_STATS_LATENCY_COUNT || msec < 0)
+		return TTSD_ERROR_INVALID_PARAMETER;
+
+	g_latency[type].target = msec;
+
+	return 0;
+}
+
+int ttsd_stats_add_latency(ttsd_stats_latency_e type, long long msec)
+{
+	if (type < 0 || type >= TTSD_STATS_LATENCY_COUNT)
+		return TTSD_ERROR_INVALID_PARAMETER;
+
+	if (msec < 0)
+		msec = 0;
+
+	stats_latency_s* latency = &g_latency[type];
+
+	int i;
+	for (i = 0; i < STATS_BUCKET_COUNT - 1; i++) {
+		if (msec <= g_bucket_bound[i])
+			break;
+	}
+	latency->bucket[i]++;
+
+	latency->count++;
+	latency->sum += msec;
+	if (msec > latency->max)
+		latency->max = msec;
+
+	if (0 < latency->target && msec > latency->target) {
+		latency->over_target++;
+		SLOG(LOG_WARN, TAG_TTSD, "[Stats] %s : %lld msec is over target(%d msec)", latency->name, msec, latency->target);
+	}
+
+	g_is_dirty = true;
+
+	return 0;
+}
+
+int ttsd_stats_increase(ttsd_stats_counter_e counter)
+{
+	if (counter < 0 || counter >= TTSD_STATS_COUNTER_COUNT)
+		return TTSD_ERROR_INVALID_PARAMETER;
+
+	g_counter[counter]++;
+	g_is_dirty = true;
+
+	return 0;
+}
+
+int ttsd_stats_dump()
+{
+	FILE* fp = fopen(STATS_FILE_PATH, "w");
+	if (NULL == fp) {
+		SLOG(LOG_WARN, TAG_TTSD, "[Stats WARNING] Fail to open stats file");
+	}
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "----- Stats -----");
+
+	int i;
+	for (i = 0; i < TTSD_STATS_LATENCY_COUNT; i++) {
+		const stats_latency_s* latency = &g_latency[i];
+		long long avg = (0 < latency->count) ? latency->sum / latency->count : 0;
+		long long p50 = __stats_get_percentile(latency, 50);
+		long long p95 = __stats_get_percentile(latency, 95);
+
+		SLOG(LOG_DEBUG, TAG_TTSD, "%s : count(%lld) avg(%lld) p50(%lld) p95(%lld) max(%lld) target(%d) over(%lld)",
+			latency->name, latency->count, avg, p50, p95, latency->max, latency->target, latency->over_target);
+
+		if (NULL != fp) {
+			fprintf(fp, "%s count=%lld avg=%lld p50=%lld p95=%lld max=%lld target=%d over_target=%lld\n",
+				latency->name, latency->count, avg, p50, p95, latency->max, latency->target, latency->over_target);
+		}
+	}
+
+	for (i = 0; i < TTSD_STATS_COUNTER_COUNT; i++) {
+		SLOG(LOG_DEBUG, TAG_TTSD, "%s : %lld", g_counter_name[i], g_counter[i]);
+
+		if (NULL != fp)
+			fprintf(fp, "%s=%lld\n", g_counter_name[i], g_counter[i]);
+	}
+
+	int resource_count = 0;
+	unsigned long long resource_size = 0;
+	ttsd_resource_get_usage(&resource_count, &resource_size);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "resource : count(%d) size(%llu)", resource_count, resource_size);
+
+	if (NULL != fp)
+		fprintf(fp, "resource_count=%d\nresource_size=%llu\n", resource_count, resource_size);
+
+	SLOG(LOG_DEBUG, TAG_TTSD, "-----------------");
+
+	if (NULL != fp)
+		fclose(fp);
+
+	g_is_dirty = false;
+
+	return 0;
+}
@@ -0,0 +1,70 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+
+#ifndef __TTSD_STATS_H_
+#define __TTSD_STATS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Latency which is measured by daemon */
+typedef enum {
+	TTSD_STATS_FIRST_AUDIO_LOW = 0,		/**< From add text to first audio, low priority */
+	TTSD_STATS_FIRST_AUDIO_NORMAL,		/**< From add text to first audio, normal priority */
+	TTSD_STATS_FIRST_AUDIO_HIGH,		/**< From add text to first audio, high priority */
+	TTSD_STATS_FIRST_AUDIO_CRITICAL,	/**< From add text to first audio, critical priority */
+	TTSD_STATS_CANCEL,			/**< From stop or preemption to release of engine */
+	TTSD_STATS_ENGINE_LOAD,			/**< Load and initialize engine */
+	TTSD_STATS_ENGINE_UNLOAD,		/**< Deinitialize and unload engine */
+	TTSD_STATS_ENGINE_WARM_UP,		/**< Warm-up synthesis after load */
+	TTSD_STATS_HYBRID_NETWORK,		/**< From start of synthesis to first audio, network engine wins */
+	TTSD_STATS_HYBRID_LOCAL,		/**< From start of synthesis to first audio, local engine wins */
+	TTSD_STATS_LATENCY_COUNT
+} ttsd_stats_latency_e;
+
+/* Events which are counted by daemon */
+typedef enum {
+	TTSD_STATS_PREEMPTION = 0,		/**< Synthesis or playback is preempted by higher priority */
+	TTSD_STATS_EXPIRED,			/**< Stale text is dropped before synthesis */
+	TTSD_STATS_DEADLINE_MISS,		/**< First audio of text is later than its deadline */
+	TTSD_STATS_ENGINE_REUSE,		/**< First client uses engine kept alive */
+	TTSD_STATS_ENGINE_RESTART,		/**< Crashed or hung engine process is restarted */
+	TTSD_STATS_SYNTHESIS_TIMEOUT,		/**< Synthesis does not finish before its watchdog deadline */
+	TTSD_STATS_HYBRID_FAILOVER,		/**< Text goes to local engine, because network engine is out or fails */
+	TTSD_STATS_COUNTER_COUNT
+} ttsd_stats_counter_e;
+
+int ttsd_stats_initialize();
+
+int ttsd_stats_finalize();
+
+/** Get monotonic time in msec */
+long long ttsd_stats_get_time();
+
+/** Set latency target. Samples over the target are counted separately. */
+int ttsd_stats_set_target(ttsd_stats_latency_e type, int msec);
+
+int ttsd_stats_add_latency(ttsd_stats_latency_e type, long long msec);
+
+int ttsd_stats_increase(ttsd_stats_counter_e counter);
+
+/** Write statistics to log and stats file */
+int ttsd_stats_dump();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TTSD_STATS_H_ */
@@ -17,6 +17,7 @@
 
 #include <errno.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
 * @addtogroup TTS_ENGINE_MODULE
@@ -41,6 +42,18 @@ typedef enum {
 	TTSP_ERROR_OPERATION_FAILED	= -0x0100025	/**< Operation failed */
 }ttsp_error_e;
 
+/**
+* @brief Definitions of plugin interface version.
+*
+* @remarks The daemon sets the version which it supports to ttspd_funcs_s. \n
+* An engine sets the version which it implements to ttspe_funcs_s, which should not be higher than the version of the daemon. \n
+* Fields of a higher version are valid only when both version and size of the structure include them. \n
+* An engine of version 1 gets ttspd_funcs_s of version 1 and #TTSPD_FUNCS_V1_SIZE, as before version 2.
+*/
+#define TTSP_VERSION_1		1	/**< Basic functions */
+#define TTSP_VERSION_2		2	/**< Capability, preferred chunk size, preload and text stream in ttspe_funcs_s, buffer allocator in ttspd_funcs_s */
+#define TTSP_VERSION_3		3	/**< Cost estimation and batch synthesis in ttspe_funcs_s, shared resource mapping in ttspd_funcs_s */
+
 /**
 * @brief Enumerations of speaking speed.
 */
@@ -95,6 +108,9 @@ typedef enum {
 *
 * @return @c true to continue with the next iteration of synthesis \n @c false to stop
 *
+* @remarks The engine may call it from any thread. The daemon delivers results to its main loop in order of the calls, \n
+* so synthesis is stopped by ttspe_cancel_synthesis(), not by the return value.
+*
 * @pre ttspe_start_synthesis() will invoke this callback.
 *
 * @see ttspe_start_synthesis()
@@ -273,6 +289,123 @@ typedef int (* ttspe_foreach_engine_settings)(ttspe_engine_setting_cb callback,
 */
 typedef int (* ttspe_set_engine_setting)(const char* key, const char* value);
 
+/**
+* @brief Prepares resources of the voice, so that the first synthesis with it is not delayed. (Version 2)
+*
+* @param[in] language A language
+* @param[in] type A voice type
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTSP_ERROR_NONE Successful
+* @retval #TTSP_ERROR_INVALID_STATE Not initialized
+* @retval #TTSP_ERROR_INVALID_VOICE Invalid voice
+* @retval #TTSP_ERROR_OPERATION_FAILED Operation failed
+*
+* @remarks The daemon calls this function in other thread only if the engine has #TTSP_CAPABILITY_THREAD_SAFE.
+*/
+typedef int (* ttspe_preload_voice)(const char* language, ttsp_voice_type_e type);
+
+/**
+* @brief Starts voice synthesis of text which is given in pieces by ttspe_push_stream(), asynchronously. (Version 2)
+*
+* @param[in] language A language
+* @param[in] type A voice type
+* @param[in] speed A speaking speed
+* @param[in] user_data The user data to be passed to the callback function
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTSP_ERROR_NONE Successful
+* @retval #TTSP_ERROR_INVALID_STATE Not initialized or already started synthesis
+* @retval #TTSP_ERROR_INVALID_VOICE Invalid voice
+* @retval #TTSP_ERROR_OPERATION_FAILED Operation failed
+*
+* @post ttspe_result_cb() is called as soon as the engine has sound data of pushed text. \n
+* #TTSP_RESULT_EVENT_FINISH is sent after ttspe_close_stream() and the last sound data. \n
+* ttspe_cancel_synthesis() cancels the stream.
+*
+* @see ttspe_push_stream()
+* @see ttspe_close_stream()
+*/
+typedef int (* ttspe_open_stream)(const char* language, ttsp_voice_type_e type, ttsp_speed_e speed, void* user_data);
+
+/**
+* @brief Adds text to the stream opened by ttspe_open_stream(). (Version 2)
+*
+* @param[in] text A piece of text
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTSP_ERROR_NONE Successful
+* @retval #TTSP_ERROR_INVALID_PARAMETER Invalid parameter
+* @retval #TTSP_ERROR_INVALID_STATE Stream is not opened or already closed
+*/
+typedef int (* ttspe_push_stream)(const char* text);
+
+/**
+* @brief Notifies that no more text is added to the stream. (Version 2)
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTSP_ERROR_NONE Successful
+* @retval #TTSP_ERROR_INVALID_STATE Stream is not opened or already closed
+*/
+typedef int (* ttspe_close_stream)(void);
+
+/**
+* @brief Estimates cost of text without synthesizing it. (Version 3)
+*
+* @param[in] language A language
+* @param[in] type A voice type
+* @param[in] text Texts
+* @param[in] speed A speaking speed
+* @param[out] synth_msec Time to synthesize the whole text in msec
+* @param[out] audio_msec Duration of audio of the text in msec
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTSP_ERROR_NONE Successful
+* @retval #TTSP_ERROR_INVALID_PARAMETER Invalid parameter
+* @retval #TTSP_ERROR_INVALID_VOICE Invalid voice
+* @retval #TTSP_ERROR_OPERATION_FAILED The engine cannot estimate the text
+*
+* @remarks The daemon calls this function in main thread for every text, so it should return at once. \n
+* If it fails, the daemon estimates the text by audio per character and real time factor of previous texts.
+*/
+typedef int (* ttspe_estimate_cost)(const char* language, ttsp_voice_type_e type, const char* text, ttsp_speed_e speed,
+				    int* synth_msec, int* audio_msec);
+
+/**
+* @brief A structure of a text in batch synthesis. (Version 3)
+*/
+typedef struct {
+	const char*		language;	/**< A language */
+	ttsp_voice_type_e	type;		/**< A voice type */
+	const char*		text;		/**< Texts */
+	ttsp_speed_e		speed;		/**< A speaking speed */
+	void*			user_data;	/**< The user data to be passed to the callback function for this text */
+} ttsp_batch_item_s;
+
+/**
+* @brief Starts voice synthesis of several texts at once, asynchronously. (Version 3)
+*
+* @param[in] items Texts to be synthesized in order
+* @param[in] count The number of items
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTSP_ERROR_NONE Successful
+* @retval #TTSP_ERROR_INVALID_PARAMETER Invalid parameter
+* @retval #TTSP_ERROR_INVALID_STATE Not initialized or already started synthesis
+* @retval #TTSP_ERROR_INVALID_VOICE Invalid voice
+* @retval #TTSP_ERROR_OPERATION_FAILED Operation failed
+*
+* @remarks Items and texts are valid only during this call. On failure, no item is started. \n
+* The daemon gives texts of the same voice and speed, so that the engine sets up the voice once for all of them.
+*
+* @post ttspe_result_cb() is called with user_data of each item, in order of items, from #TTSP_RESULT_EVENT_START to
+* #TTSP_RESULT_EVENT_FINISH or #TTSP_RESULT_EVENT_FAIL. \n
+* ttspe_cancel_synthesis() cancels all items which are not finished, each of them gets #TTSP_RESULT_EVENT_CANCEL.
+*
+* @see ttspe_start_synthesis()
+*/
+typedef int (* ttspe_start_batch)(const ttsp_batch_item_s* items, int count);
+
 /**
 * @brief A structure of the engine functions
 */
@@ -295,8 +428,82 @@ typedef struct {
 	/* Engine setting */
 	ttspe_foreach_engine_settings	foreach_engine_setting;	/**< Foreach engine setting */
 	ttspe_set_engine_setting	set_engine_setting;	/**< Set engine setting */
+
+	/* Version 2, optional */
+	int				capability;		/**< Bitwise OR of #ttsp_capability_e */
+	unsigned int			chunk_size;		/**< Preferred size of result data in bytes, 0 if no preference */
+	ttspe_preload_voice		preload_voice;		/**< Prepare voice, NULL if not supported */
+	ttspe_open_stream		open_stream;		/**< Start synthesis of text stream, NULL if not supported */
+	ttspe_push_stream		push_stream;		/**< Add text to stream */
+	ttspe_close_stream		close_stream;		/**< Finish text stream */
+
+	/* Version 3, optional */
+	ttspe_estimate_cost		estimate_cost;		/**< Estimate synthesis time and audio duration, NULL if not supported */
+	ttspe_start_batch		start_batch;		/**< Start synthesis of several texts, NULL if not supported */
 } ttspe_funcs_s;
 
+/**
+* @brief Size of ttspe_funcs_s of version 1
+*/
+#define TTSPE_FUNCS_V1_SIZE	((int)offsetof(ttspe_funcs_s, capability))
+
+/**
+* @brief Size of ttspe_funcs_s of version 2
+*/
+#define TTSPE_FUNCS_V2_SIZE	((int)offsetof(ttspe_funcs_s, estimate_cost))
+
+/**
+* @brief Allocates a buffer for result data, which the daemon takes without copying. (Version 2)
+*
+* @param[in] size Size of buffer in bytes
+*
+* @return Buffer, NULL on failure
+*
+* @remarks This function can be called in any thread. \n
+* A buffer passed to ttspe_result_cb() belongs to the daemon after the call, the engine should not use or release it. \n
+* A buffer of ttspd_funcs_s.chunk_size or less is reused without page faults.
+*
+* @see ttspd_release_buffer()
+*/
+typedef void* (* ttspd_alloc_buffer)(unsigned int size);
+
+/**
+* @brief Releases a buffer which is not passed to ttspe_result_cb(). (Version 2)
+*
+* @param[in] buffer Buffer from ttspd_alloc_buffer()
+*/
+typedef void (* ttspd_release_buffer)(void* buffer);
+
+/**
+* @brief Maps a resource file of the engine, e.g. voice database, read-only. (Version 3)
+*
+* @param[in] path Path of the file
+* @param[out] data Contents of the file
+* @param[out] size Size of the file in bytes
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTSP_ERROR_NONE Successful
+* @retval #TTSP_ERROR_INVALID_PARAMETER Invalid parameter
+* @retval #TTSP_ERROR_OPERATION_FAILED Fail to open or map the file
+*
+* @remarks This function can be called in any thread. \n
+* The same file gives the same view to every engine instance and reload, so pages of the file are shared 
+* in page cache instead of private memory of each engine. The view must not be written. \n
+* A file replaced after it is mapped gives a new view, and the old view is valid until it is unmapped.
+*
+* @see ttspd_unmap_resource()
+*/
+typedef int (* ttspd_map_resource)(const char* path, const void** data, unsigned int* size);
+
+/**
+* @brief Releases a view from ttspd_map_resource(). (Version 3)
+*
+* @param[in] data Contents from ttspd_map_resource()
+*
+* @remarks The engine should release its views before ttsp_unload_engine() returns.
+*/
+typedef void (* ttspd_unmap_resource)(const void* data);
+
 /**
 * @brief A structure of the daemon functions
 */
@@ -304,8 +511,26 @@ typedef struct {
 	int size;					/**< size */
 	int version;					/**< version */
 
+	/* Version 2, NULL or 0 if the daemon does not provide */
+	ttspd_alloc_buffer	alloc_buffer;		/**< Allocate buffer for result data */
+	ttspd_release_buffer	release_buffer;		/**< Release buffer which is not used */
+	unsigned int		chunk_size;		/**< Size of result data which the daemon handles best */
+
+	/* Version 3, NULL if the daemon does not provide */
+	ttspd_map_resource	map_resource;		/**< Map resource file shared with other engines */
+	ttspd_unmap_resource	unmap_resource;		/**< Release mapped resource */
 }ttspd_funcs_s;
 
+/**
+* @brief Size of ttspd_funcs_s of version 1
+*/
+#define TTSPD_FUNCS_V1_SIZE	((int)offsetof(ttspd_funcs_s, alloc_buffer))
+
+/**
+* @brief Size of ttspd_funcs_s of version 2
+*/
+#define TTSPD_FUNCS_V2_SIZE	((int)offsetof(ttspd_funcs_s, map_resource))
+
 /**
 * @brief Loads the engine by the daemon. 
 *
@@ -317,6 +542,14 @@ typedef struct {
 * @retval #TTSP_ERROR_INVALID_PARAMETER Invalid parameter
 * @retval #TTSP_ERROR_OPERATION_FAILED Operation failed
 *
+* @remarks The daemon gives functions of a higher version only to an engine which shows that it knows them. \n
+* If the engine exports ttsp_get_capability(), pdfuncs has the highest version which the daemon supports when this is called. \n
+* Otherwise pdfuncs has #TTSP_VERSION_1 and #TTSPD_FUNCS_V1_SIZE. If pefuncs has version 2 or higher after the call, \n
+* the daemon fills pdfuncs up to its highest version, and the engine can use them from ttspe_initialize(). \n
+* pdfuncs is valid until ttsp_unload_engine() returns. \n
+* An engine should check that pdfuncs->version and pdfuncs->size are not lower than it needs, 
+* e.g. #TTSP_VERSION_2 <= version and #TTSPD_FUNCS_V2_SIZE <= size.
+*
 * @pre The ttsp_get_engine_info() should be successful.
 * @post The daemon calls the engine functions of ttspe_funcs_s.
 *
@@ -368,6 +601,38 @@ typedef void (*ttsp_engine_info_cb)(const char* engine_uuid, const char* engine_
 */
 int ttsp_get_engine_info(ttsp_engine_info_cb callback, void* user_data);
 
+/**
+* @brief Enumerations of engine capability.
+*/
+typedef enum {
+	TTSP_CAPABILITY_NONE			= 0x00,	/**< No optional capability */
+	TTSP_CAPABILITY_CONCURRENT_SYNTHESIS	= 0x01,	/**< ttspe_start_synthesis() can be called again before previous synthesis is finished */
+	TTSP_CAPABILITY_THREAD_SAFE		= 0x02	/**< Engine functions can be called from other thread while the daemon uses the engine */
+}ttsp_capability_e;
+
+/**
+* @brief Gets optional capabilities of the engine by the daemon.
+*
+* @remarks This function is optional. If the engine does not have it, no capability is used. \n
+* An engine of version 2 can set ttspe_funcs_s.capability instead. \n
+* An engine which exports this function gets daemon functions of the highest version in ttsp_load_engine(). \n
+* An engine with #TTSP_CAPABILITY_CONCURRENT_SYNTHESIS keeps a synthesis context for each request, 
+* and calls ttspe_result_cb() with user data of the request. It may call back from any thread, 
+* the daemon delivers results to its main loop in order of the calls. 
+* ttspe_cancel_synthesis() cancels all requests.
+*
+* @param[out] capability Bitwise OR of #ttsp_capability_e
+*
+* @return 0 on success, otherwise a negative error value
+* @retval #TTSP_ERROR_NONE Successful
+* @retval #TTSP_ERROR_INVALID_PARAMETER Invalid parameter
+*
+* @pre The ttsp_load_engine() should be performed.
+*
+* @see ttsp_load_engine()
+*/
+int ttsp_get_capability(int* capability);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,812 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+/*
+* Conformance and performance benchmark of engine plugins.
+*
+* Each engine is loaded in a child process in the same way as the daemon loads it, and a text corpus is
+* synthesized with every supported voice. The result is written as JSON, and the exit code is not 0
+* if an engine violates the plugin interface, so that it can gate engine upgrades.
+*
+* Usage : ttsp-bench [-e engine path] [-c corpus file] [-o output file] [-t timeout sec] [-v language]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <dirent.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "ttsd_main.h"
+
+#define BENCH_TEXT_MAX		64
+#define BENCH_ERROR_MAX		32
+#define BENCH_THREAD_MAX	8
+#define BENCH_CHUNK_BUCKET	5
+#define BENCH_DAEMON_CHUNK_SIZE	8192
+#define BENCH_CANCEL_WAIT	300
+
+/* Upper bound of chunk size buckets in bytes. The last bucket has no bound. */
+static const unsigned int g_chunk_bound[BENCH_CHUNK_BUCKET - 1] = {1024, 4096, 16384, 65536};
+
+static const char* g_default_corpus[] = {
+	"Hello.",
+	"The quick brown fox jumps over the lazy dog.",
+	"You have three new messages and one missed call.",
+	"Turn left in two hundred meters, then keep right to merge onto the highway.",
+	"Text to speech engines are measured by latency of the first audio and by real time factor, "
+	"which is the time to synthesize audio divided by the duration of the audio.",
+};
+
+/* Base information of engine */
+typedef struct {
+	char*	engine_uuid;
+	char*	engine_name;
+	bool	use_network;
+} bench_info_s;
+
+/* Result of a synthesis, written by result callback */
+typedef struct {
+	bool		is_done;
+	bool		is_canceled;		/**< Cancel is requested */
+	int		last_event;
+	int		event_count;
+	bool		is_sequence_error;
+	long long	start_time;
+	long long	first_time;
+	long long	done_time;
+	long long	cancel_time;		/**< Time when cancel returns */
+	int		late_count;		/**< Callbacks after cancel returns */
+	unsigned long long total_size;
+} bench_synth_s;
+
+/* Statistics of an engine */
+typedef struct {
+	unsigned int	chunk_min;
+	unsigned int	chunk_max;
+	unsigned long long chunk_sum;
+	int		chunk_count;
+	int		chunk_bucket[BENCH_CHUNK_BUCKET];
+
+	int		caller_thread_count;	/**< Callbacks in the thread which starts synthesis */
+	int		other_thread_count;
+	pthread_t	threads[BENCH_THREAD_MAX];
+	int		thread_count;
+
+	const char*	errors[BENCH_ERROR_MAX];
+	int		error_count;
+} bench_stats_s;
+
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_cond = PTHREAD_COND_INITIALIZER;
+
+static bench_synth_s g_synth;
+static bench_stats_s g_stats;
+static pthread_t g_caller;
+
+static const char* g_corpus[BENCH_TEXT_MAX];
+static int g_corpus_count = 0;
+
+static int g_timeout = 30;
+static const char* g_voice_filter = NULL;
+
+static ttspe_funcs_s g_pefuncs;
+
+/* Buffers from __bench_alloc_buffer(), others belong to engine */
+static GHashTable* g_buffers = NULL;
+
+static FILE* g_out = NULL;
+
+
+static long long __bench_get_time()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static void __bench_add_error(const char* error)
+{
+	int i;
+	for (i = 0; i < g_stats.error_count; i++) {
+		if (0 == strcmp(g_stats.errors[i], error))
+			return;
+	}
+
+	if (BENCH_ERROR_MAX > g_stats.error_count)
+		g_stats.errors[g_stats.error_count++] = error;
+
+	fprintf(stderr, "[Bench] Conformance error : %s\n", error);
+}
+
+/* Buffers of daemon, the engine gives them to result callback */
+static void* __bench_alloc_buffer(unsigned int size)
+{
+	void* buffer = malloc(size);
+	if (NULL == buffer)
+		return NULL;
+
+	pthread_mutex_lock(&g_mutex);
+	g_hash_table_insert(g_buffers, buffer, buffer);
+	pthread_mutex_unlock(&g_mutex);
+
+	return buffer;
+}
+
+static void __bench_release_buffer(void* buffer)
+{
+	pthread_mutex_lock(&g_mutex);
+	bool is_found = g_hash_table_remove(g_buffers, buffer);
+	pthread_mutex_unlock(&g_mutex);
+
+	if (true == is_found)
+		free(buffer);
+}
+
+static void __bench_set_daemon_funcs(ttspd_funcs_s* pdfuncs, int version)
+{
+	memset(pdfuncs, 0, sizeof(ttspd_funcs_s));
+
+	if (TTSP_VERSION_1 == version) {
+		pdfuncs->version = TTSP_VERSION_1;
+		pdfuncs->size = TTSPD_FUNCS_V1_SIZE;
+		return;
+	}
+
+	pdfuncs->version = TTSP_VERSION_2;
+	pdfuncs->size = TTSPD_FUNCS_V2_SIZE;
+	pdfuncs->alloc_buffer = __bench_alloc_buffer;
+	pdfuncs->release_buffer = __bench_release_buffer;
+	pdfuncs->chunk_size = BENCH_DAEMON_CHUNK_SIZE;
+}
+
+static void __bench_add_thread()
+{
+	pthread_t self = pthread_self();
+
+	if (pthread_equal(self, g_caller))
+		g_stats.caller_thread_count++;
+	else
+		g_stats.other_thread_count++;
+
+	int i;
+	for (i = 0; i < g_stats.thread_count; i++) {
+		if (pthread_equal(self, g_stats.threads[i]))
+			return;
+	}
+
+	if (BENCH_THREAD_MAX > g_stats.thread_count)
+		g_stats.threads[g_stats.thread_count++] = self;
+}
+
+static void __bench_add_chunk(unsigned int size)
+{
+	if (0 == g_stats.chunk_count || size < g_stats.chunk_min)
+		g_stats.chunk_min = size;
+	if (size > g_stats.chunk_max)
+		g_stats.chunk_max = size;
+
+	g_stats.chunk_sum += size;
+	g_stats.chunk_count++;
+
+	int i;
+	for (i = 0; i < BENCH_CHUNK_BUCKET - 1; i++) {
+		if (size <= g_chunk_bound[i])
+			break;
+	}
+	g_stats.chunk_bucket[i]++;
+}
+
+static bool __bench_result_cb(ttsp_result_event_e event, const void* data, unsigned int data_size, void* user_data)
+{
+	long long now = __bench_get_time();
+
+	pthread_mutex_lock(&g_mutex);
+
+	__bench_add_thread();
+
+	if (0 < g_synth.cancel_time && TTSP_RESULT_EVENT_CANCEL != event)
+		g_synth.late_count++;
+
+	/* START or only one result comes first, and nothing comes after the last result */
+	if (true == g_synth.is_done) {
+		if (TTSP_RESULT_EVENT_CANCEL != event)
+			g_synth.is_sequence_error = true;
+	} else if (0 == g_synth.event_count) {
+		if (TTSP_RESULT_EVENT_CONTINUE == event)
+			g_synth.is_sequence_error = true;
+	} else if (TTSP_RESULT_EVENT_START == event) {
+		g_synth.is_sequence_error = true;
+	}
+
+	if (TTSP_RESULT_EVENT_CANCEL == event && false == g_synth.is_canceled)
+		g_synth.is_sequence_error = true;
+
+	if (0 < data_size && NULL != data) {
+		if (0 == g_synth.first_time)
+			g_synth.first_time = now;
+		g_synth.total_size += data_size;
+		__bench_add_chunk(data_size);
+	}
+
+	g_synth.event_count++;
+	g_synth.last_event = event;
+
+	if (TTSP_RESULT_EVENT_FINISH == event || TTSP_RESULT_EVENT_FAIL == event || TTSP_RESULT_EVENT_CANCEL == event) {
+		if (false == g_synth.is_done)
+			g_synth.done_time = now;
+		g_synth.is_done = true;
+	}
+
+	bool is_daemon_buffer = (NULL != data && g_hash_table_remove(g_buffers, data));
+
+	pthread_cond_broadcast(&g_cond);
+	pthread_mutex_unlock(&g_mutex);
+
+	/* buffer of daemon belongs to daemon after callback */
+	if (true == is_daemon_buffer)
+		free((void*)data);
+
+	return true;
+}
+
+/* Wait until the condition of synthesis or timeout. It should be called with mutex locked. */
+static bool __bench_wait(bool is_first_chunk)
+{
+	long long end = __bench_get_time() + (long long)g_timeout * 1000;
+
+	while (false == g_synth.is_done && (false == is_first_chunk || 0 == g_synth.first_time)) {
+		struct timespec ts;
+		clock_gettime(CLOCK_REALTIME, &ts);
+		ts.tv_nsec += 10 * 1000000L;
+		if (ts.tv_nsec >= 1000000000L) {
+			ts.tv_sec++;
+			ts.tv_nsec -= 1000000000L;
+		}
+		pthread_cond_timedwait(&g_cond, &g_mutex, &ts);
+
+		if (__bench_get_time() > end)
+			return false;
+	}
+
+	return true;
+}
+
+static int __bench_compare_time(const void* a, const void* b)
+{
+	long long x = *(const long long*)a;
+	long long y = *(const long long*)b;
+	return (x > y) - (x < y);
+}
+
+static void __bench_print_string(const char* str)
+{
+	fputc('"', g_out);
+	for (; NULL != str && '\0' != *str; str++) {
+		unsigned char ch = (unsigned char)*str;
+		if ('"' == ch || '\\' == ch)
+			fprintf(g_out, "\\%c", ch);
+		else if (ch < 0x20)
+			fprintf(g_out, "\\u%04x", ch);
+		else
+			fputc(ch, g_out);
+	}
+	fputc('"', g_out);
+}
+
+static void __bench_engine_info_cb(const char* engine_uuid, const char* engine_name, const char* setting_ug_name,
+				   bool use_network, void* user_data)
+{
+	bench_info_s* info = (bench_info_s*)user_data;
+
+	info->engine_uuid = g_strdup(engine_uuid);
+	info->engine_name = g_strdup(engine_name);
+	info->use_network = use_network;
+}
+
+static bool __bench_voice_cb(const char* language, ttsp_voice_type_e type, void* user_data)
+{
+	GList** voices = (GList**)user_data;
+
+	voice_s* voice = (voice_s*)g_malloc0(sizeof(voice_s));
+	voice->language = g_strdup(language);
+	voice->type = type;
+	*voices = g_list_append(*voices, voice);
+
+	return true;
+}
+
+/* Synthesize corpus with a voice and write result of the voice */
+static void __bench_run_voice(const voice_s* voice, int rate, int channels, ttsp_audio_type_e audio_type, bool is_first)
+{
+	long long ttfc[BENCH_TEXT_MAX];
+	double rtf_sum = 0;
+	double rtf_max = 0;
+	int rtf_count = 0;
+	int fail_count = 0;
+	int timeout_count = 0;
+	int i;
+
+	fprintf(stderr, "[Bench] Voice : %s(%d)\n", voice->language, voice->type);
+
+	if (true != g_pefuncs.is_valid_voice(voice->language, voice->type))
+		__bench_add_error("is_valid_voice is false for listed voice");
+
+	long long preload_ms = -1;
+	if (NULL != g_pefuncs.preload_voice) {
+		long long start = __bench_get_time();
+		if (0 != g_pefuncs.preload_voice(voice->language, voice->type))
+			__bench_add_error("preload_voice fails for listed voice");
+		preload_ms = __bench_get_time() - start;
+	}
+
+	int count = 0;
+	for (i = 0; i < g_corpus_count; i++) {
+		pthread_mutex_lock(&g_mutex);
+		memset(&g_synth, 0, sizeof(bench_synth_s));
+		g_synth.start_time = __bench_get_time();
+		pthread_mutex_unlock(&g_mutex);
+
+		int ret = g_pefuncs.start_synth(voice->language, voice->type, g_corpus[i], TTSP_SPEED_NORMAL, (void*)&g_synth);
+		if (0 != ret) {
+			fprintf(stderr, "[Bench] Fail to start synthesis : result(%d)\n", ret);
+			fail_count++;
+			continue;
+		}
+
+		pthread_mutex_lock(&g_mutex);
+		if (false == __bench_wait(false)) {
+			timeout_count++;
+			pthread_mutex_unlock(&g_mutex);
+			g_pefuncs.cancel_synth();
+			continue;
+		}
+
+		if (true == g_synth.is_sequence_error)
+			__bench_add_error("wrong order of result events");
+
+		if (TTSP_RESULT_EVENT_FINISH != g_synth.last_event || 0 == g_synth.first_time) {
+			fail_count++;
+			pthread_mutex_unlock(&g_mutex);
+			continue;
+		}
+
+		ttfc[count++] = g_synth.first_time - g_synth.start_time;
+
+		/* real-time factor is known only for PCM */
+		if (TTSP_AUDIO_TYPE_RAW == audio_type && 0 < rate && 0 < channels) {
+			double duration = (double)g_synth.total_size / (rate * channels * 2) * 1000;
+			if (0 < duration) {
+				double rtf = (double)(g_synth.done_time - g_synth.start_time) / duration;
+				rtf_sum += rtf;
+				if (rtf > rtf_max)
+					rtf_max = rtf;
+				rtf_count++;
+			}
+		}
+		pthread_mutex_unlock(&g_mutex);
+	}
+
+	/* cancel in the middle of the longest text */
+	const char* longest = g_corpus[0];
+	for (i = 1; i < g_corpus_count; i++) {
+		if (strlen(g_corpus[i]) > strlen(longest))
+			longest = g_corpus[i];
+	}
+
+	long long cancel_ms = -1;
+	int late_count = 0;
+
+	pthread_mutex_lock(&g_mutex);
+	memset(&g_synth, 0, sizeof(bench_synth_s));
+	g_synth.start_time = __bench_get_time();
+	pthread_mutex_unlock(&g_mutex);
+
+	if (0 == g_pefuncs.start_synth(voice->language, voice->type, longest, TTSP_SPEED_VERY_SLOW, (void*)&g_synth)) {
+		pthread_mutex_lock(&g_mutex);
+		__bench_wait(true);
+		bool is_done = g_synth.is_done;
+		g_synth.is_canceled = true;
+		pthread_mutex_unlock(&g_mutex);
+
+		if (false == is_done) {
+			long long start = __bench_get_time();
+			if (0 != g_pefuncs.cancel_synth())
+				__bench_add_error("cancel_synth fails while synthesis");
+			long long end = __bench_get_time();
+			cancel_ms = end - start;
+
+			pthread_mutex_lock(&g_mutex);
+			g_synth.cancel_time = end;
+			pthread_mutex_unlock(&g_mutex);
+
+			usleep(BENCH_CANCEL_WAIT * 1000);
+
+			pthread_mutex_lock(&g_mutex);
+			late_count = g_synth.late_count;
+			pthread_mutex_unlock(&g_mutex);
+
+			if (0 < late_count)
+				__bench_add_error("result callback after cancel_synth returns");
+		}
+	}
+
+	qsort(ttfc, count, sizeof(long long), __bench_compare_time);
+
+	long long ttfc_sum = 0;
+	for (i = 0; i < count; i++)
+		ttfc_sum += ttfc[i];
+
+	fprintf(g_out, "%s\n\t\t\t{\"language\": ", true == is_first ? "" : ",");
+	__bench_print_string(voice->language);
+	fprintf(g_out, ", \"type\": %d, \"texts\": %d, \"failed\": %d, \"timed_out\": %d,\n",
+		voice->type, g_corpus_count, fail_count, timeout_count);
+	fprintf(g_out, "\t\t\t \"first_chunk_msec\": {\"avg\": %lld, \"p50\": %lld, \"p95\": %lld, \"max\": %lld},\n",
+		0 < count ? ttfc_sum / count : -1,
+		0 < count ? ttfc[(count - 1) / 2] : -1,
+		0 < count ? ttfc[(count * 95 + 99) / 100 - 1] : -1,
+		0 < count ? ttfc[count - 1] : -1);
+	if (0 < rtf_count)
+		fprintf(g_out, "\t\t\t \"rtf\": {\"avg\": %.4f, \"max\": %.4f},\n", rtf_sum / rtf_count, rtf_max);
+	else
+		fprintf(g_out, "\t\t\t \"rtf\": null,\n");
+	fprintf(g_out, "\t\t\t \"preload_msec\": %lld, \"cancel_msec\": %lld, \"late_callbacks\": %d}",
+		preload_ms, cancel_ms, late_count);
+}
+
+/* Load engine as daemon does, and write result of the engine. It runs in child process. */
+static int __bench_run_engine(const char* path)
+{
+	char* error;
+	int i;
+
+	memset(&g_stats, 0, sizeof(bench_stats_s));
+	g_caller = pthread_self();
+
+	fprintf(g_out, "\t{\"path\": ");
+	__bench_print_string(path);
+
+	long long load_start = __bench_get_time();
+
+	void* handle = dlopen(path, RTLD_LAZY);
+	if (NULL == handle) {
+		fprintf(g_out, ", \"error\": ");
+		__bench_print_string(dlerror());
+		fprintf(g_out, "}");
+		return -1;
+	}
+
+	int (*get_engine_info)(ttsp_engine_info_cb callback, void* user_data);
+	int (*load_engine)(ttspd_funcs_s* pdfuncs, ttspe_funcs_s* pefuncs);
+	void (*unload_engine)(void);
+	int (*get_capability)(int* capability);
+
+	get_engine_info = (int (*)(ttsp_engine_info_cb, void*))dlsym(handle, "ttsp_get_engine_info");
+	load_engine = (int (*)(ttspd_funcs_s*, ttspe_funcs_s*))dlsym(handle, "ttsp_load_engine");
+	unload_engine = (void (*)(void))dlsym(handle, "ttsp_unload_engine");
+	if (NULL != (error = dlerror()) || NULL == get_engine_info || NULL == load_engine || NULL == unload_engine) {
+		fprintf(g_out, ", \"error\": \"not an engine\"}");
+		dlclose(handle);
+		return -1;
+	}
+	get_capability = (int (*)(int*))dlsym(handle, "ttsp_get_capability");
+	dlerror();
+
+	bench_info_s info;
+	memset(&info, 0, sizeof(bench_info_s));
+	if (0 != get_engine_info(__bench_engine_info_cb, &info))
+		__bench_add_error("ttsp_get_engine_info fails");
+
+	/* same as daemon, engine of version 1 gets daemon functions of version 1 */
+	ttspd_funcs_s pdfuncs;
+	__bench_set_daemon_funcs(&pdfuncs, NULL != get_capability ? TTSP_VERSION_2 : TTSP_VERSION_1);
+
+	memset(&g_pefuncs, 0, sizeof(ttspe_funcs_s));
+	if (0 != load_engine(&pdfuncs, &g_pefuncs)) {
+		fprintf(g_out, ", \"error\": \"ttsp_load_engine fails\"}");
+		dlclose(handle);
+		return -1;
+	}
+
+	if (TTSP_VERSION_1 == pdfuncs.version && TTSP_VERSION_2 <= g_pefuncs.version && TTSPE_FUNCS_V2_SIZE <= g_pefuncs.size)
+		__bench_set_daemon_funcs(&pdfuncs, TTSP_VERSION_2);
+
+	/* same check as daemon, engine of version 1 has only basic functions */
+	int version = g_pefuncs.version;
+	int size = g_pefuncs.size;
+	if (TTSP_VERSION_1 > version || TTSPE_FUNCS_V1_SIZE > size) {
+		fprintf(g_out, ", \"version\": %d, \"size\": %d, \"error\": \"invalid engine functions\"}", version, size);
+		unload_engine();
+		dlclose(handle);
+		return -1;
+	}
+
+	int capability = TTSP_CAPABILITY_NONE;
+	if (NULL != get_capability && 0 != get_capability(&capability))
+		capability = TTSP_CAPABILITY_NONE;
+
+	if (TTSP_VERSION_2 > version || TTSPE_FUNCS_V2_SIZE > size)
+		memset((char*)&g_pefuncs + TTSPE_FUNCS_V1_SIZE, 0, sizeof(ttspe_funcs_s) - TTSPE_FUNCS_V1_SIZE);
+	else
+		capability |= g_pefuncs.capability;
+
+	if (NULL == g_pefuncs.initialize || NULL == g_pefuncs.deinitialize || NULL == g_pefuncs.foreach_voices ||
+	    NULL == g_pefuncs.is_valid_voice || NULL == g_pefuncs.get_audio_format ||
+	    NULL == g_pefuncs.start_synth || NULL == g_pefuncs.cancel_synth) {
+		fprintf(g_out, ", \"version\": %d, \"size\": %d, \"error\": \"missing engine function\"}", version, size);
+		unload_engine();
+		dlclose(handle);
+		return -1;
+	}
+
+	if (NULL != g_pefuncs.open_stream && (NULL == g_pefuncs.push_stream || NULL == g_pefuncs.close_stream))
+		__bench_add_error("stream functions are not complete");
+
+	long long init_start = __bench_get_time();
+	if (0 != g_pefuncs.initialize(__bench_result_cb)) {
+		fprintf(g_out, ", \"error\": \"initialize fails\"}");
+		unload_engine();
+		dlclose(handle);
+		return -1;
+	}
+	long long load_ms = __bench_get_time() - load_start;
+	long long init_ms = __bench_get_time() - init_start;
+
+	ttsp_audio_type_e audio_type = TTSP_AUDIO_TYPE_RAW;
+	int rate = 0;
+	int channels = 0;
+	if (0 != g_pefuncs.get_audio_format(&audio_type, &rate, &channels))
+		__bench_add_error("get_audio_format fails");
+
+	if (true == g_pefuncs.is_valid_voice("xx_XX", TTSP_VOICE_TYPE_USER3))
+		__bench_add_error("is_valid_voice is true for unknown voice");
+
+	if (0 != g_pefuncs.cancel_synth())
+		fprintf(stderr, "[Bench] cancel_synth fails without synthesis\n");
+
+	GList* voices = NULL;
+	if (0 != g_pefuncs.foreach_voices(__bench_voice_cb, &voices) || NULL == voices)
+		__bench_add_error("no supported voice");
+
+	fprintf(g_out, ",\n\t \"uuid\": ");
+	__bench_print_string(info.engine_uuid);
+	fprintf(g_out, ", \"name\": ");
+	__bench_print_string(info.engine_name);
+	fprintf(g_out, ", \"use_network\": %s,\n", true == info.use_network ? "true" : "false");
+	fprintf(g_out, "\t \"version\": %d, \"size\": %d, \"capability\": %d, \"chunk_size\": %u, \"preload\": %s, \"stream\": %s,\n",
+		version, size, capability, g_pefuncs.chunk_size,
+		NULL != g_pefuncs.preload_voice ? "true" : "false", NULL != g_pefuncs.open_stream ? "true" : "false");
+	fprintf(g_out, "\t \"audio\": {\"type\": %d, \"rate\": %d, \"channels\": %d}, \"load_msec\": %lld, \"init_msec\": %lld,\n",
+		audio_type, rate, channels, load_ms, init_ms);
+	fprintf(g_out, "\t \"voices\": [");
+
+	GList* iter = g_list_first(voices);
+	bool is_first = true;
+	while (NULL != iter) {
+		voice_s* voice = (voice_s*)iter->data;
+		if (NULL == g_voice_filter || 0 == strcmp(g_voice_filter, voice->language)) {
+			__bench_run_voice(voice, rate, channels, audio_type, is_first);
+			is_first = false;
+		}
+		iter = g_list_next(iter);
+	}
+	fprintf(g_out, "],\n");
+
+	if (0 != g_pefuncs.deinitialize())
+		__bench_add_error("deinitialize fails");
+	unload_engine();
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	fprintf(g_out, "\t \"chunks\": {\"count\": %d, \"min\": %u, \"max\": %u, \"avg\": %llu, \"histogram\": [",
+		g_stats.chunk_count, g_stats.chunk_min, g_stats.chunk_max,
+		0 < g_stats.chunk_count ? g_stats.chunk_sum / g_stats.chunk_count : 0);
+	for (i = 0; i < BENCH_CHUNK_BUCKET; i++) {
+		if (BENCH_CHUNK_BUCKET - 1 > i)
+			fprintf(g_out, "%s{\"max\": %u, \"count\": %d}", 0 == i ? "" : ", ", g_chunk_bound[i], g_stats.chunk_bucket[i]);
+		else
+			fprintf(g_out, ", {\"max\": null, \"count\": %d}", g_stats.chunk_bucket[i]);
+	}
+	fprintf(g_out, "]},\n");
+	fprintf(g_out, "\t \"callback_threads\": {\"caller\": %d, \"other\": %d, \"distinct\": %d},\n",
+		g_stats.caller_thread_count, g_stats.other_thread_count, g_stats.thread_count);
+	fprintf(g_out, "\t \"peak_rss_kb\": %ld,\n", usage.ru_maxrss);
+	fprintf(g_out, "\t \"errors\": [");
+	for (i = 0; i < g_stats.error_count; i++) {
+		fprintf(g_out, "%s", 0 == i ? "" : ", ");
+		__bench_print_string(g_stats.errors[i]);
+	}
+	fprintf(g_out, "]}");
+
+	dlclose(handle);
+
+	return (0 == g_stats.error_count) ? 0 : -1;
+}
+
+/* Engine is tested in child process, so that crash or memory of an engine does not affect others */
+static int __bench_fork_engine(const char* path, bool is_first)
+{
+	FILE* out = g_out;
+	int fds[2];
+
+	if (false == is_first)
+		fprintf(out, ",\n");
+	fflush(out);
+
+	fprintf(stderr, "[Bench] Engine : %s\n", path);
+
+	if (0 != pipe(fds)) {
+		fprintf(stderr, "[Bench ERROR] Fail to make pipe\n");
+		return -1;
+	}
+
+	pid_t pid = fork();
+	if (0 > pid) {
+		fprintf(stderr, "[Bench ERROR] Fail to fork\n");
+		close(fds[0]);
+		close(fds[1]);
+		return -1;
+	}
+
+	if (0 == pid) {
+		close(fds[0]);
+		g_out = fdopen(fds[1], "w");
+		g_buffers = g_hash_table_new(g_direct_hash, g_direct_equal);
+		int ret = (NULL != g_out) ? __bench_run_engine(path) : -1;
+		if (NULL != g_out)
+			fclose(g_out);
+		_exit(0 == ret ? 0 : 1);
+	}
+
+	/* output of child is written only if child is not crashed */
+	close(fds[1]);
+	GString* result = g_string_new(NULL);
+	char buf[4096];
+	ssize_t len;
+	while (0 < (len = read(fds[0], buf, sizeof(buf))) || (0 > len && EINTR == errno)) {
+		if (0 < len)
+			g_string_append_len(result, buf, len);
+	}
+	close(fds[0]);
+
+	int status = 0;
+	waitpid(pid, &status, 0);
+
+	if (WIFSIGNALED(status)) {
+		fprintf(out, "\t{\"path\": ");
+		__bench_print_string(path);
+		fprintf(out, ", \"error\": \"crashed\", \"signal\": %d}", WTERMSIG(status));
+		g_string_free(result, TRUE);
+		return -1;
+	}
+
+	fwrite(result->str, 1, result->len, out);
+	g_string_free(result, TRUE);
+
+	return (WIFEXITED(status) && 0 == WEXITSTATUS(status)) ? 0 : -1;
+}
+
+static int __bench_run_directory(const char* directory, bool* is_first)
+{
+	DIR* dp = opendir(directory);
+	if (NULL == dp) {
+		fprintf(stderr, "[Bench] No engine directory : %s\n", directory);
+		return 0;
+	}
+
+	int ret = 0;
+	struct dirent* dirp;
+	while (NULL != (dirp = readdir(dp))) {
+		if (0 == strcmp(dirp->d_name, ".") || 0 == strcmp(dirp->d_name, ".."))
+			continue;
+
+		char* filepath = g_strdup_printf("%s/%s", directory, dirp->d_name);
+		if (0 != __bench_fork_engine(filepath, *is_first))
+			ret = -1;
+		*is_first = false;
+		g_free(filepath);
+	}
+
+	closedir(dp);
+
+	return ret;
+}
+
+static int __bench_load_corpus(const char* path)
+{
+	FILE* fp = fopen(path, "r");
+	if (NULL == fp) {
+		fprintf(stderr, "[Bench ERROR] Fail to open corpus : %s\n", path);
+		return -1;
+	}
+
+	char line[4096];
+	while (BENCH_TEXT_MAX > g_corpus_count && NULL != fgets(line, sizeof(line), fp)) {
+		line[strcspn(line, "\r\n")] = '\0';
+		if ('\0' != line[0])
+			g_corpus[g_corpus_count++] = g_strdup(line);
+	}
+
+	fclose(fp);
+
+	return (0 < g_corpus_count) ? 0 : -1;
+}
+
+int main(int argc, char** argv)
+{
+	const char* engine_path = NULL;
+	const char* corpus_path = NULL;
+	const char* output_path = NULL;
+	int opt;
+
+	while (-1 != (opt = getopt(argc, argv, "e:c:o:t:v:"))) {
+		switch (opt) {
+		case 'e':	engine_path = optarg;		break;
+		case 'c':	corpus_path = optarg;		break;
+		case 'o':	output_path = optarg;		break;
+		case 't':	g_timeout = atoi(optarg);	break;
+		case 'v':	g_voice_filter = optarg;	break;
+		default:
+			fprintf(stderr, "Usage : %s [-e engine path] [-c corpus file] [-o output file] [-t timeout sec] [-v language]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (0 >= g_timeout)
+		g_timeout = 30;
+
+	if (NULL != corpus_path) {
+		if (0 != __bench_load_corpus(corpus_path))
+			return 2;
+	} else {
+		for (g_corpus_count = 0; g_corpus_count < (int)(sizeof(g_default_corpus) / sizeof(g_default_corpus[0])); g_corpus_count++)
+			g_corpus[g_corpus_count] = g_default_corpus[g_corpus_count];
+	}
+
+	g_out = stdout;
+	if (NULL != output_path) {
+		g_out = fopen(output_path, "w");
+		if (NULL == g_out) {
+			fprintf(stderr, "[Bench ERROR] Fail to open output : %s\n", output_path);
+			return 2;
+		}
+	}
+
+	fprintf(g_out, "{\"texts\": %d, \"timeout_sec\": %d, \"engines\": [\n", g_corpus_count, g_timeout);
+
+	int ret = 0;
+	bool is_first = true;
+	if (NULL != engine_path) {
+		ret = __bench_fork_engine(engine_path, true);
+	} else {
+		if (0 != __bench_run_directory(ENGINE_DIRECTORY_DEFAULT, &is_first))
+			ret = -1;
+		if (0 != __bench_run_directory(ENGINE_DIRECTORY_DOWNLOAD, &is_first))
+			ret = -1;
+	}
+
+	fprintf(g_out, "\n]}\n");
+
+	if (stdout != g_out)
+		fclose(g_out);
+
+	return (0 == ret) ? 0 : 1;
+}
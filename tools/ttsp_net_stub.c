@@ -0,0 +1,400 @@
+/*
+*  Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*  http://www.apache.org/licenses/LICENSE-2.0
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+
+/*
+* Local stand-in of a TTS server for tests of the network engine adapter.
+*
+* It answers POST requests with chunked raw PCM made in the same way as the mock engine, a square wave
+* per character. Connections are kept alive and pipelined requests are answered in order. Timing and
+* failures are controlled by options.
+*
+* Usage : ttsp-net-stub [-p port] [-l first latency msec] [-r rtf] [-c chunk bytes] [-d char msec]
+*                       [-f fail percent] [-k requests per connection]
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#define STUB_CLIENT_MAX		64
+#define STUB_SAMPLE_RATE	16000
+#define STUB_AMPLITUDE		3000
+#define STUB_INPUT_MAX		65536
+#define STUB_OUTPUT_HIGH	262144
+
+typedef struct stub_job_s {
+	struct stub_job_s*	next;
+	char*		text;
+	bool		is_started;
+	bool		is_failed;
+	long long	start_time;
+	unsigned long	total;		/**< Samples of audio */
+	unsigned long	sent;
+} stub_job_s;
+
+typedef struct {
+	int		fd;
+	char		in[STUB_INPUT_MAX];
+	size_t		in_len;
+	char*		out;
+	size_t		out_len;
+	size_t		out_size;
+	stub_job_s*	head;
+	stub_job_s*	tail;
+	int		served;
+	bool		is_close;	/**< Close after output is written */
+} stub_client_s;
+
+static int g_port = 8080;
+static int g_first_latency = 100;
+static double g_rtf = 0.2;
+static int g_chunk_size = 4096;
+static int g_char_duration = 60;
+static int g_fail_rate = 0;
+static int g_request_limit = 0;
+
+static stub_client_s g_clients[STUB_CLIENT_MAX];
+static volatile sig_atomic_t g_is_exit = 0;
+
+static long long __stub_get_time()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void __stub_signal_handler(int signo)
+{
+	g_is_exit = 1;
+}
+
+static int __stub_append(stub_client_s* client, const void* data, size_t len)
+{
+	if (client->out_len + len > client->out_size) {
+		size_t size = (0 < client->out_size) ? client->out_size : 4096;
+		while (size < client->out_len + len)
+			size *= 2;
+
+		char* out = (char*)realloc(client->out, size);
+		if (NULL == out)
+			return -1;
+		client->out = out;
+		client->out_size = size;
+	}
+
+	memcpy(client->out + client->out_len, data, len);
+	client->out_len += len;
+	return 0;
+}
+
+static void __stub_close_client(stub_client_s* client)
+{
+	while (NULL != client->head) {
+		stub_job_s* job = client->head;
+		client->head = job->next;
+		free(job->text);
+		free(job);
+	}
+
+	close(client->fd);
+	free(client->out);
+	memset(client, 0, sizeof(stub_client_s));
+	client->fd = -1;
+}
+
+/* Parse complete requests in input. Returns -1 on bad request. */
+static int __stub_parse_requests(stub_client_s* client)
+{
+	while (true) {
+		client->in[client->in_len] = '\0';
+		char* end = strstr(client->in, "\r\n\r\n");
+		if (NULL == end)
+			return (client->in_len + 1 >= STUB_INPUT_MAX) ? -1 : 0;
+
+		if (0 != strncmp(client->in, "POST ", 5))
+			return -1;
+
+		size_t head_len = end + 4 - client->in;
+		size_t body_len = 0;
+		char* length = strcasestr(client->in, "\r\nContent-Length:");
+		if (NULL != length && length < end)
+			body_len = strtoul(length + strlen("\r\nContent-Length:"), NULL, 10);
+
+		if (head_len + body_len >= STUB_INPUT_MAX)
+			return -1;
+		if (client->in_len < head_len + body_len)
+			return 0;
+
+		stub_job_s* job = (stub_job_s*)calloc(1, sizeof(stub_job_s));
+		if (NULL == job)
+			return -1;
+
+		job->text = strndup(client->in + head_len, body_len);
+		job->total = (unsigned long)body_len * g_char_duration * STUB_SAMPLE_RATE / 1000;
+		job->is_failed = (0 < g_fail_rate && rand() % 100 < g_fail_rate);
+
+		if (NULL == client->tail)
+			client->head = job;
+		else
+			client->tail->next = job;
+		client->tail = job;
+
+		memmove(client->in, client->in + head_len + body_len, client->in_len - head_len - body_len);
+		client->in_len -= head_len + body_len;
+	}
+}
+
+static void __stub_make_audio(const stub_job_s* job, unsigned long pos, short* samples, unsigned int count)
+{
+	unsigned long per_char = (unsigned long)g_char_duration * STUB_SAMPLE_RATE / 1000;
+	unsigned int i;
+
+	for (i = 0; i < count; i++) {
+		unsigned long n = pos + i;
+		unsigned char ch = (unsigned char)job->text[n / per_char];
+
+		if (ch <= ' ' || NULL != strchr(".,!?;:", ch)) {
+			samples[i] = 0;
+			continue;
+		}
+
+		unsigned long period = STUB_SAMPLE_RATE / (150 + (ch % 32) * 15);
+		samples[i] = ((n % period) < period / 2) ? STUB_AMPLITUDE : -STUB_AMPLITUDE;
+	}
+}
+
+/* Time when next chunk of the job is ready */
+static long long __stub_next_time(const stub_job_s* job)
+{
+	return job->start_time + g_first_latency + (long long)(job->sent * 1000 / STUB_SAMPLE_RATE * g_rtf);
+}
+
+/* Write chunks of the first job which are ready. Returns msec to next chunk, -1 if nothing is waited. */
+static int __stub_progress(stub_client_s* client, long long now)
+{
+	while (NULL != client->head && false == client->is_close && STUB_OUTPUT_HIGH > client->out_len) {
+		stub_job_s* job = client->head;
+		char header[256];
+
+		if (false == job->is_started) {
+			job->is_started = true;
+			job->start_time = now;
+		}
+
+		long long next = __stub_next_time(job);
+		if (now < next)
+			return (int)(next - now);
+
+		bool is_last = (0 < g_request_limit && client->served + 1 >= g_request_limit);
+
+		if (true == job->is_failed) {
+			snprintf(header, sizeof(header), "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\n%s\r\n",
+				is_last ? "Connection: close\r\n" : "");
+			__stub_append(client, header, strlen(header));
+		} else {
+			if (0 == job->sent) {
+				snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-Type: audio/L16; rate=%d\r\n"
+					"Transfer-Encoding: chunked\r\n%s\r\n", STUB_SAMPLE_RATE, is_last ? "Connection: close\r\n" : "");
+				__stub_append(client, header, strlen(header));
+			}
+
+			unsigned long count = g_chunk_size / sizeof(short);
+			if (count > job->total - job->sent)
+				count = job->total - job->sent;
+
+			if (0 < count) {
+				short* samples = (short*)malloc(count * sizeof(short));
+				if (NULL == samples)
+					return -1;
+
+				__stub_make_audio(job, job->sent, samples, (unsigned int)count);
+				snprintf(header, sizeof(header), "%lx\r\n", (unsigned long)(count * sizeof(short)));
+				__stub_append(client, header, strlen(header));
+				__stub_append(client, samples, count * sizeof(short));
+				__stub_append(client, "\r\n", 2);
+				free(samples);
+
+				job->sent += count;
+				if (job->sent < job->total)
+					continue;
+			}
+
+			__stub_append(client, "0\r\n\r\n", 5);
+		}
+
+		client->head = job->next;
+		if (NULL == client->head)
+			client->tail = NULL;
+		free(job->text);
+		free(job);
+
+		client->served++;
+		client->is_close = is_last;
+	}
+
+	return -1;
+}
+
+static void __stub_print_usage(const char* name)
+{
+	printf("Usage : %s [-p port] [-l first latency msec] [-r rtf] [-c chunk bytes] [-d char msec]\n"
+		"       [-f fail percent] [-k requests per connection]\n", name);
+}
+
+int main(int argc, char** argv)
+{
+	int opt;
+	while (-1 != (opt = getopt(argc, argv, "p:l:r:c:d:f:k:h"))) {
+		switch (opt) {
+		case 'p':	g_port = atoi(optarg);		break;
+		case 'l':	g_first_latency = atoi(optarg);	break;
+		case 'r':	g_rtf = atof(optarg);		break;
+		case 'c':	g_chunk_size = atoi(optarg);	break;
+		case 'd':	g_char_duration = atoi(optarg);	break;
+		case 'f':	g_fail_rate = atoi(optarg);	break;
+		case 'k':	g_request_limit = atoi(optarg);	break;
+		default:
+			__stub_print_usage(argv[0]);
+			return ('h' == opt) ? 0 : 1;
+		}
+	}
+
+	if (0 >= g_port || 2 > g_chunk_size || 0 >= g_char_duration || 0 > g_first_latency || 0 > g_rtf) {
+		__stub_print_usage(argv[0]);
+		return 1;
+	}
+
+	signal(SIGINT, __stub_signal_handler);
+	signal(SIGTERM, __stub_signal_handler);
+	signal(SIGPIPE, SIG_IGN);
+
+	int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+	int reuse = 1;
+	struct sockaddr_in addr;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons((unsigned short)g_port);
+
+	setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+	if (0 > listen_fd || 0 != bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) || 0 != listen(listen_fd, 16)) {
+		fprintf(stderr, "Fail to listen port %d : %s\n", g_port, strerror(errno));
+		return 1;
+	}
+
+	int i;
+	for (i = 0; i < STUB_CLIENT_MAX; i++)
+		g_clients[i].fd = -1;
+
+	printf("Listening on 127.0.0.1:%d\n", g_port);
+	fflush(stdout);
+
+	while (0 == g_is_exit) {
+		struct pollfd fds[STUB_CLIENT_MAX + 1];
+		stub_client_s* clients[STUB_CLIENT_MAX + 1];
+		int count = 1;
+		int timeout = -1;
+		long long now = __stub_get_time();
+
+		fds[0].fd = listen_fd;
+		fds[0].events = POLLIN;
+		fds[0].revents = 0;
+
+		for (i = 0; i < STUB_CLIENT_MAX; i++) {
+			stub_client_s* client = &g_clients[i];
+			if (0 > client->fd)
+				continue;
+
+			int wait = __stub_progress(client, now);
+			if (0 <= wait && (0 > timeout || wait < timeout))
+				timeout = wait;
+
+			fds[count].fd = client->fd;
+			fds[count].events = POLLIN | ((0 < client->out_len) ? POLLOUT : 0);
+			fds[count].revents = 0;
+			clients[count] = client;
+			count++;
+		}
+
+		if (0 > poll(fds, count, timeout))
+			continue;
+
+		if (0 != (fds[0].revents & POLLIN)) {
+			int fd = accept(listen_fd, NULL, NULL);
+			for (i = 0; 0 <= fd && i < STUB_CLIENT_MAX; i++) {
+				if (0 > g_clients[i].fd) {
+					fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+					g_clients[i].fd = fd;
+					break;
+				}
+			}
+			if (0 <= fd && STUB_CLIENT_MAX == i)
+				close(fd);
+		}
+
+		for (i = 1; i < count; i++) {
+			stub_client_s* client = clients[i];
+
+			if (0 != (fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+				ssize_t len = recv(client->fd, client->in + client->in_len, STUB_INPUT_MAX - 1 - client->in_len, 0);
+				if (0 == len || (0 > len && EAGAIN != errno && EINTR != errno)) {
+					__stub_close_client(client);
+					continue;
+				}
+				if (0 < len)
+					client->in_len += len;
+				if (0 != __stub_parse_requests(client)) {
+					__stub_close_client(client);
+					continue;
+				}
+			}
+
+			if (0 != (fds[i].revents & POLLOUT) && 0 < client->out_len) {
+				ssize_t len = send(client->fd, client->out, client->out_len, MSG_NOSIGNAL);
+				if (0 > len && EAGAIN != errno && EINTR != errno) {
+					__stub_close_client(client);
+					continue;
+				}
+				if (0 < len) {
+					memmove(client->out, client->out + len, client->out_len - len);
+					client->out_len -= len;
+				}
+			}
+
+			if (true == client->is_close && 0 == client->out_len)
+				__stub_close_client(client);
+		}
+	}
+
+	for (i = 0; i < STUB_CLIENT_MAX; i++) {
+		if (0 <= g_clients[i].fd)
+			__stub_close_client(&g_clients[i]);
+	}
+	close(listen_fd);
+
+	return 0;
+}